@@ -2,6 +2,9 @@
 # Import Build Environment
 Import("env")
 
+import os
+import sys
+
 ####################################################################################################
 
 # Callback function to skip and ignore file from a build process
@@ -23,3 +26,13 @@ if ("arduino" in build_framework) or ("espidf" in build_framework):
     env.AddBuildMiddleware(skip_file_from_build, "*multihttpsclient/mbedtls/*")
 else:
     print("Generic Native Build detected, using src/utility/multihttpsclient/mbedtls.")
+
+####################################################################################################
+
+# Regenerate Telegram API CA certificate DER source if the PEM certificate has been modified
+# (SConscript current directory is the library root)
+certs_dir = os.path.join(Dir(".").srcnode().abspath, "res", "certs")
+sys.path.insert(0, certs_dir)
+import pem2der
+if pem2der.generate():
+    print("Telegram API CA certificate DER source regenerated.")
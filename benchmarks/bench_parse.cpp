@@ -0,0 +1,284 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: bench_parse.cpp
+// Description: Benchmarks of CPU bound paths (requests body build, getUpdates response
+//              extraction, jsmn JSON parse and commands router dispatch).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "benchmark.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "utlgbotlib.h"
+#include "utlgbotrouter.h"
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Benchmarks Bot token and sendMessage data
+#define BENCH_TOKEN "123456789:ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghi"
+#define BENCH_CHAT_ID "-1001234567890"
+#define BENCH_TEXT "Hello there! This is a benchmark message with some \"quoted\" words, " \
+    "a line break\nand a few more words to get a typical chat message length."
+
+// getUpdates response with a single update (as received from Telegram server)
+#define BENCH_UPDATE "{\"update_id\":123456789,\"message\":{\"message_id\":4242,\"from\":" \
+    "{\"id\":111111111,\"is_bot\":false,\"first_name\":\"John\",\"last_name\":\"Doe\"," \
+    "\"username\":\"johndoe\",\"language_code\":\"en\"},\"chat\":{\"id\":111111111," \
+    "\"first_name\":\"John\",\"last_name\":\"Doe\",\"username\":\"johndoe\",\"type\":" \
+    "\"private\"},\"date\":1700000000,\"text\":\"Hello bot, this is a benchmark message\"}}"
+#define BENCH_UPDATES_BODY "{\"ok\":true,\"result\":[" BENCH_UPDATE "]}"
+#define BENCH_UPDATES_HEADER "HTTP/1.1 200 OK\r\nServer: nginx/1.18.0\r\n" \
+    "Content-Type: application/json\r\nContent-Length: %u\r\nConnection: keep-alive\r\n\r\n"
+
+// Number of updates of jsmn benchmark JSON, and its max number of tokens
+#define BENCH_JSMN_UPDATES 64
+#define BENCH_JSMN_MAX_TOKENS 4096
+
+// Number of router benchmark commands
+#define BENCH_ROUTER_COMMANDS 1000
+
+/**************************************************************************************************/
+
+/* Static Data */
+
+static char updates_response[sizeof(BENCH_UPDATES_HEADER) + sizeof(BENCH_UPDATES_BODY) + 8];
+
+/**************************************************************************************************/
+
+/* Bot Benchmarks Accessors */
+
+// Build a sendMessage request body (first part of the text) in the Bot buffer
+bool uTLGBot::bench_create_msg_body(const char* chat_id, const char* text,
+    const char* parse_mode)
+{
+    uTLGBotTextSplitter splitter(text, parse_mode);
+
+    return create_msg_body(_buffer, HTTP_MAX_RES_LENGTH, chat_id, &splitter, parse_mode, false,
+        false, 0, NULL);
+}
+
+// Check a full getUpdates HTTP response and parse its update into received_msg
+uint8_t uTLGBot::bench_extract_update(const char* response)
+{
+    snprintf(_buffer, HTTP_MAX_RES_LENGTH, "%s", response);
+#if UTLGBOT_DEDUP_WINDOW > 0
+    // Same update is extracted in each iteration, so forget it was already received
+    _dedup_started = false;
+#endif
+    if(!tlg_parse_response(_buffer, HTTP_MAX_RES_LENGTH))
+        return 0;
+    return parse_update(_buffer, &received_msg);
+}
+
+/**************************************************************************************************/
+
+/* Benchmarks Loops */
+
+static bool loop_request_builder(const uint64_t iterations, void* user_data)
+{
+    uTLGBot* bot = (uTLGBot*)user_data;
+
+    for(uint64_t i = 0; i < iterations; i++)
+    {
+        if(!bot->bench_create_msg_body(BENCH_CHAT_ID, BENCH_TEXT, "Markdown"))
+            return false;
+    }
+    return true;
+}
+
+static bool loop_getupdates_extraction(const uint64_t iterations, void* user_data)
+{
+    uTLGBot* bot = (uTLGBot*)user_data;
+
+    for(uint64_t i = 0; i < iterations; i++)
+    {
+        if(bot->bench_extract_update(updates_response) != 1)
+            return false;
+    }
+    return true;
+}
+
+typedef struct jsmn_bench
+{
+    char* json;
+    size_t json_len;
+    jsmntok_t* tokens;
+} jsmn_bench;
+
+static bool loop_jsmn(const uint64_t iterations, void* user_data)
+{
+    jsmn_bench* bench = (jsmn_bench*)user_data;
+    jsmn_parser parser;
+
+    for(uint64_t i = 0; i < iterations; i++)
+    {
+        jsmn_init(&parser);
+        if(jsmn_parse(&parser, bench->json, bench->json_len, bench->tokens,
+            BENCH_JSMN_MAX_TOKENS) <= 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+typedef struct router_bench
+{
+    uTLGBotRouter* router;
+    char commands[BENCH_ROUTER_COMMANDS][16];
+    char texts[BENCH_ROUTER_COMMANDS][32];
+    uint64_t handled;
+} router_bench;
+
+static void router_handler(const tlg_cmd* cmd, void* user_data)
+{
+    (void)cmd;
+    ((router_bench*)user_data)->handled++;
+}
+
+static bool loop_router(const uint64_t iterations, void* user_data)
+{
+    router_bench* bench = (router_bench*)user_data;
+
+    bench->handled = 0;
+    for(uint64_t i = 0; i < iterations; i++)
+    {
+        if(bench->router->dispatch(bench->texts[i % BENCH_ROUTER_COMMANDS]) !=
+            ROUTER_DISPATCHED)
+        {
+            return false;
+        }
+    }
+    return (bench->handled == iterations);
+}
+
+/**************************************************************************************************/
+
+/* Benchmarks */
+
+// Requests body build (sendMessage JSON body with escaped text)
+static void bench_request_builder(uTLGBot* bot)
+{
+    const char* name = "request_builder";
+    bench_measure measure;
+
+    if(!bench_is_selected(name))
+        return;
+    if(!bench_run(loop_request_builder, bot, &measure))
+    {
+        bench_fail(name, "sendMessage body could not be created");
+        return;
+    }
+    bench_report(name, "requests/s", measure.iterations * 1e9 / measure.elapsed_ns, &measure);
+}
+
+// getUpdates response extraction (response check, "result" extraction and message parse)
+static void bench_getupdates_extraction(uTLGBot* bot)
+{
+    const char* name = "getupdates_extraction";
+    bench_measure measure;
+
+    if(!bench_is_selected(name))
+        return;
+
+    snprintf(updates_response, sizeof(updates_response), BENCH_UPDATES_HEADER "%s",
+        (unsigned)strlen(BENCH_UPDATES_BODY), BENCH_UPDATES_BODY);
+    if(!bench_run(loop_getupdates_extraction, bot, &measure))
+    {
+        bench_fail(name, "update could not be extracted");
+        return;
+    }
+    bench_report(name, "ns/update", (double)measure.elapsed_ns / measure.iterations, &measure);
+}
+
+// jsmn JSON tokenizer throughput (getUpdates result with many updates)
+static void bench_jsmn(void)
+{
+    const char* name = "jsmn_parse";
+    static char json[BENCH_JSMN_UPDATES*(sizeof(BENCH_UPDATE) + 1) + 32];
+    static jsmntok_t tokens[BENCH_JSMN_MAX_TOKENS];
+    jsmn_bench bench;
+    bench_measure measure;
+    size_t len;
+
+    if(!bench_is_selected(name))
+        return;
+
+    len = snprintf(json, sizeof(json), "{\"ok\":true,\"result\":[");
+    for(uint16_t i = 0; i < BENCH_JSMN_UPDATES; i++)
+        len = len + snprintf(json + len, sizeof(json) - len, "%s%s", (i == 0) ? "" : ",",
+            BENCH_UPDATE);
+    len = len + snprintf(json + len, sizeof(json) - len, "]}");
+
+    bench.json = json;
+    bench.json_len = len;
+    bench.tokens = tokens;
+    if(!bench_run(loop_jsmn, &bench, &measure))
+    {
+        bench_fail(name, "JSON could not be parsed");
+        return;
+    }
+    bench_report(name, "MB/s", (double)len * measure.iterations * 1e3 / measure.elapsed_ns,
+        &measure);
+}
+
+// Commands router dispatch with 1000 registered commands
+static void bench_router(void)
+{
+    const char* name = "router_dispatch_1000_commands";
+    static uTLGBotRouter router;
+    static router_bench bench;
+    bench_measure measure;
+
+    if(!bench_is_selected(name))
+        return;
+
+    router.clear();
+    bench.router = &router;
+    for(uint16_t i = 0; i < BENCH_ROUTER_COMMANDS; i++)
+    {
+        snprintf(bench.commands[i], sizeof(bench.commands[i]), "/command%u", i);
+        snprintf(bench.texts[i], sizeof(bench.texts[i]), "/command%u arg1 arg2", i);
+        if(!router.add(bench.commands[i], router_handler, &bench))
+        {
+            bench_fail(name, "command could not be added to router");
+            return;
+        }
+    }
+    if(!router.compile())
+    {
+        bench_fail(name, "router perfect hash table could not be built");
+        return;
+    }
+
+    if(!bench_run(loop_router, &bench, &measure))
+    {
+        bench_fail(name, "command was not dispatched");
+        return;
+    }
+    bench_report(name, "ns/dispatch", (double)measure.elapsed_ns / measure.iterations, &measure);
+}
+
+/**************************************************************************************************/
+
+/* Benchmarks Group */
+
+void bench_parse(void)
+{
+    static uTLGBot bot(BENCH_TOKEN);
+
+    bench_request_builder(&bot);
+    bench_getupdates_extraction(&bot);
+    bench_jsmn();
+    bench_router();
+}
+
+/**************************************************************************************************/
@@ -0,0 +1,158 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: bench_tls.cpp
+// Description: Benchmarks of network paths against a local TLS mock server (full and resumed TLS
+//              handshakes, and sendMessage end to end requests).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "benchmark.h"
+#include "bench_tls_server.h"
+
+#include <stdio.h>
+
+#include "utlgbotlib.h"
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Benchmarks Bot token and sendMessage data
+#define BENCH_TOKEN "123456789:ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghi"
+#define BENCH_CHAT_ID "111111111"
+#define BENCH_TEXT "Hello"
+
+// Mock server port of full handshakes benchmark (server without sessions cache)
+#define BENCH_FULL_HANDSHAKE_PORT (HTTPS_PORT + 1)
+
+// A sendMessage over loopback slower than this is stalled by the network stack, not by the
+// library (i.e. small request writes held by Nagle algorithm until server delayed ACK, ~40 ms)
+#define BENCH_SEND_STALL_NS 20000000ULL
+
+/**************************************************************************************************/
+
+/* Benchmarks Loops */
+
+typedef struct handshake_bench
+{
+    MultiHTTPSClient* client;
+    uint16_t port;
+} handshake_bench;
+
+static bool loop_handshake(const uint64_t iterations, void* user_data)
+{
+    handshake_bench* bench = (handshake_bench*)user_data;
+
+    for(uint64_t i = 0; i < iterations; i++)
+    {
+        if(bench->client->connect(TELEGRAM_HOST, bench->port) != 1)
+            return false;
+        bench->client->disconnect();
+    }
+    return true;
+}
+
+static bool loop_send_message(const uint64_t iterations, void* user_data)
+{
+    uTLGBot* bot = (uTLGBot*)user_data;
+
+    for(uint64_t i = 0; i < iterations; i++)
+    {
+        if(!bot->sendMessage(BENCH_CHAT_ID, BENCH_TEXT))
+            return false;
+    }
+    return true;
+}
+
+/**************************************************************************************************/
+
+/* Benchmarks */
+
+// TLS handshake (TCP connection, handshake and certificate verify, and close)
+static void bench_handshake(const char* name, uTLGBotBenchServer* server, const uint16_t port)
+{
+    static MultiHTTPSClient client;
+    handshake_bench bench;
+    bench_measure measure;
+
+    if(!bench_is_selected(name))
+        return;
+
+    client.set_cert(server->cert_pem());
+    bench.client = &client;
+    bench.port = port;
+
+    // First connection (get the session to resume)
+    if(!loop_handshake(1, &bench) || !bench_run(loop_handshake, &bench, &measure))
+    {
+        bench_fail(name, "connection to mock server fail");
+        return;
+    }
+    bench_report(name, "handshakes/s", measure.iterations * 1e9 / measure.elapsed_ns, &measure);
+}
+
+// sendMessage request and response through a kept alive connection
+static void bench_send_message(uTLGBotBenchServer* server)
+{
+    const char* name = "send_message_end_to_end";
+    static uTLGBot bot(BENCH_TOKEN);
+    bench_measure measure;
+
+    if(!bench_is_selected(name))
+        return;
+
+    // First request (connect to server)
+    bot.set_cert(server->cert_pem());
+    if(!loop_send_message(1, &bot) || !bench_run(loop_send_message, &bot, &measure))
+    {
+        bench_fail(name, "message could not be sent to mock server");
+        return;
+    }
+    bench_report(name, "sends/s", measure.iterations * 1e9 / measure.elapsed_ns, &measure);
+    if(measure.elapsed_ns / measure.iterations >= BENCH_SEND_STALL_NS)
+    {
+        fprintf(stderr, "%-32s WARNING: %.1f ms per send, requests are stalled (Nagle algorithm "
+            "and delayed ACK?)\n", name, (measure.elapsed_ns / measure.iterations) / 1e6);
+    }
+#ifdef MULTIHTTPSCLIENT_MEMORY_STATS
+    bench_report("send_message_heap_peak", "bytes", bot.get_memory_stats()->peak_bytes, &measure);
+    bench_report("send_message_stack_peak", "bytes", bot.get_memory_stats()->stack_peak_bytes,
+        &measure);
+#endif
+    bot.disconnect();
+}
+
+/**************************************************************************************************/
+
+/* Benchmarks Group */
+
+void bench_tls(void)
+{
+    static uTLGBotBenchServer server;
+    static uTLGBotBenchServer server_no_cache;
+
+    if(!bench_is_selected("tls_handshake_full") && !bench_is_selected("tls_handshake_resumed")
+        && !bench_is_selected("send_message_end_to_end"))
+    {
+        return;
+    }
+
+    if(!server.start(HTTPS_PORT) || !server_no_cache.start(BENCH_FULL_HANDSHAKE_PORT, false))
+    {
+        bench_fail("tls_handshake_full", "mock server could not be started");
+        return;
+    }
+
+    bench_handshake("tls_handshake_full", &server_no_cache, BENCH_FULL_HANDSHAKE_PORT);
+    bench_handshake("tls_handshake_resumed", &server, HTTPS_PORT);
+    bench_send_message(&server);
+
+    server_no_cache.stop();
+    server.stop();
+}
+
+/**************************************************************************************************/
@@ -0,0 +1,363 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: bench_tls_server.cpp
+// Description: Local TLS mock of Telegram Bot API server for benchmarks (mbedtls server with a
+//              self-signed certificate, keep-alive connections and TLS sessions cache).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "bench_tls_server.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <chrono>
+
+#if defined(WIN32) || defined(_WIN32)
+    #include <winsock2.h>
+#else
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <sys/socket.h>
+#endif
+
+#include "mbedtls/ecp.h"
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Responses bodies (sendMessage and getUpdates without updates)
+#define BENCH_SEND_RESPONSE "{\"ok\":true,\"result\":{\"message_id\":4242,\"from\":{\"id\":" \
+    "123456789,\"is_bot\":true,\"first_name\":\"Bench\",\"username\":\"bench_bot\"},\"chat\":" \
+    "{\"id\":111111111,\"first_name\":\"John\",\"type\":\"private\"},\"date\":1700000000," \
+    "\"text\":\"Hello\"}}"
+#define BENCH_UPDATES_RESPONSE "{\"ok\":true,\"result\":[]}"
+#define BENCH_UPDATES_MESSAGE_RESPONSE "{\"ok\":true,\"result\":[{\"update_id\":%u," \
+    "\"message\":%s}]}"
+
+#define BENCH_RESPONSE_HEADER "HTTP/1.1 200 OK\r\nServer: utlgbot-bench\r\n" \
+    "Content-Type: application/json\r\nContent-Length: %u\r\nConnection: keep-alive\r\n\r\n%s"
+
+/**************************************************************************************************/
+
+/* Constructor and Destructor */
+
+uTLGBotBenchServer::uTLGBotBenchServer() : _stop(false), _num_requests(0),
+    _updates_message(NULL), _update_id(BENCH_SERVER_FIRST_UPDATE_ID), _response_delay_ms(0)
+{
+    _cert_pem[0] = '\0';
+    mbedtls_net_init(&_listen_fd);
+    mbedtls_entropy_init(&_entropy);
+    mbedtls_ctr_drbg_init(&_ctr_drbg);
+    mbedtls_ssl_config_init(&_conf);
+    mbedtls_x509_crt_init(&_cert);
+    mbedtls_pk_init(&_key);
+    mbedtls_ssl_cache_init(&_cache);
+}
+
+uTLGBotBenchServer::~uTLGBotBenchServer()
+{
+    stop();
+    mbedtls_ssl_cache_free(&_cache);
+    mbedtls_pk_free(&_key);
+    mbedtls_x509_crt_free(&_cert);
+    mbedtls_ssl_config_free(&_conf);
+    mbedtls_ctr_drbg_free(&_ctr_drbg);
+    mbedtls_entropy_free(&_entropy);
+}
+
+/**************************************************************************************************/
+
+/* Public Methods */
+
+// Setup TLS (new self-signed server certificate) and launch server thread
+// Without sessions cache, all client connections need a full handshake
+bool uTLGBotBenchServer::start(const uint16_t port, const bool sessions_cache)
+{
+    static const char* entropy_generation_key = "utlgbot_bench_server";
+    char str_port[6];
+
+    if(mbedtls_ctr_drbg_seed(&_ctr_drbg, mbedtls_entropy_func, &_entropy,
+        (const unsigned char*)entropy_generation_key, strlen(entropy_generation_key)) != 0)
+    {
+        return false;
+    }
+    if(!create_cert())
+    {
+        fprintf(stderr, "Bench server certificate could not be created\n");
+        return false;
+    }
+
+    if(mbedtls_ssl_config_defaults(&_conf, MBEDTLS_SSL_IS_SERVER, MBEDTLS_SSL_TRANSPORT_STREAM,
+        MBEDTLS_SSL_PRESET_DEFAULT) != 0)
+    {
+        return false;
+    }
+    mbedtls_ssl_conf_rng(&_conf, mbedtls_ctr_drbg_random, &_ctr_drbg);
+    mbedtls_ssl_conf_read_timeout(&_conf, BENCH_SERVER_POLL_MS);
+    if(sessions_cache)
+    {
+        mbedtls_ssl_conf_session_cache(&_conf, &_cache, mbedtls_ssl_cache_get,
+            mbedtls_ssl_cache_set);
+    }
+    if(mbedtls_ssl_conf_own_cert(&_conf, &_cert, &_key) != 0)
+        return false;
+
+    snprintf(str_port, sizeof(str_port), "%u", port);
+    if(mbedtls_net_bind(&_listen_fd, BENCH_SERVER_ADDRESS, str_port, MBEDTLS_NET_PROTO_TCP) != 0)
+    {
+        fprintf(stderr, "Bench server can't listen at %s:%s\n", BENCH_SERVER_ADDRESS, str_port);
+        return false;
+    }
+
+    _stop = false;
+    _thread = std::thread(&uTLGBotBenchServer::server_loop, this);
+    return true;
+}
+
+// Stop server thread
+void uTLGBotBenchServer::stop()
+{
+    _stop = true;
+    if(_thread.joinable())
+        _thread.join();
+    mbedtls_net_free(&_listen_fd);
+}
+
+// Get number of served requests
+uint32_t uTLGBotBenchServer::num_requests()
+{
+    return _num_requests;
+}
+
+// Get server certificate (PEM), to be set as trusted certificate by the clients
+const char* uTLGBotBenchServer::cert_pem()
+{
+    return (const char*)_cert_pem;
+}
+
+// Set a message (JSON object) to be sent in each getUpdates response, with a new update_id each
+// time (NULL to send responses without updates)
+// Note: The message is not copied, so it must be kept alive while the server is running
+void uTLGBotBenchServer::set_updates_message(const char* message)
+{
+    _updates_message = message;
+}
+
+// Set a delay before write each response (i.e. longer than client timeout, to test it)
+void uTLGBotBenchServer::set_response_delay(const uint32_t delay_ms)
+{
+    _response_delay_ms = delay_ms;
+}
+
+/**************************************************************************************************/
+
+/* Private Methods */
+
+// Create a new ECDSA P-256 key and a self-signed certificate for "localhost" (mbedtls test
+// certificates has expired and are signed with SHA-1, so they can't be used)
+bool uTLGBotBenchServer::create_cert()
+{
+    mbedtls_x509write_cert crt;
+    mbedtls_mpi serial;
+    char not_before[16], not_after[16];
+    time_t now;
+    bool ok = false;
+
+    now = time(NULL);
+    strftime(not_before, sizeof(not_before), "%Y%m%d%H%M%S", gmtime(&now));
+    now = now + (BENCH_SERVER_CERT_DAYS * 86400);
+    strftime(not_after, sizeof(not_after), "%Y%m%d%H%M%S", gmtime(&now));
+
+    if(mbedtls_pk_setup(&_key, mbedtls_pk_info_from_type(MBEDTLS_PK_ECKEY)) != 0)
+        return false;
+    if(mbedtls_ecp_gen_key(MBEDTLS_ECP_DP_SECP256R1, mbedtls_pk_ec(_key),
+        mbedtls_ctr_drbg_random, &_ctr_drbg) != 0)
+    {
+        return false;
+    }
+
+    mbedtls_x509write_crt_init(&crt);
+    mbedtls_mpi_init(&serial);
+    mbedtls_x509write_crt_set_md_alg(&crt, MBEDTLS_MD_SHA256);
+    mbedtls_x509write_crt_set_subject_key(&crt, &_key);
+    mbedtls_x509write_crt_set_issuer_key(&crt, &_key);
+    if((mbedtls_mpi_lset(&serial, 1) == 0) &&
+       (mbedtls_x509write_crt_set_serial(&crt, &serial) == 0) &&
+       (mbedtls_x509write_crt_set_subject_name(&crt, BENCH_SERVER_CERT_SUBJECT) == 0) &&
+       (mbedtls_x509write_crt_set_issuer_name(&crt, BENCH_SERVER_CERT_SUBJECT) == 0) &&
+       (mbedtls_x509write_crt_set_validity(&crt, not_before, not_after) == 0) &&
+       (mbedtls_x509write_crt_set_basic_constraints(&crt, 1, 0) == 0) &&
+       (mbedtls_x509write_crt_pem(&crt, _cert_pem, sizeof(_cert_pem), mbedtls_ctr_drbg_random,
+            &_ctr_drbg) == 0))
+    {
+        ok = (mbedtls_x509_crt_parse(&_cert, _cert_pem, strlen((char*)_cert_pem) + 1) == 0);
+    }
+    mbedtls_mpi_free(&serial);
+    mbedtls_x509write_crt_free(&crt);
+
+    return ok;
+}
+
+// Accept and serve connections (one at a time, benchmarks use a single client)
+void uTLGBotBenchServer::server_loop()
+{
+    mbedtls_net_context client_fd;
+
+    while(!_stop)
+    {
+        if(mbedtls_net_poll(&_listen_fd, MBEDTLS_NET_POLL_READ, BENCH_SERVER_POLL_MS) <= 0)
+            continue;
+
+        mbedtls_net_init(&client_fd);
+        if(mbedtls_net_accept(&_listen_fd, &client_fd, NULL, 0, NULL) != 0)
+            continue;
+        no_delay(&client_fd);
+        serve(&client_fd);
+        mbedtls_net_free(&client_fd);
+    }
+}
+
+// Disable Nagle algorithm in a client connection (as Telegram server, handshake records and
+// responses are sent right away, so measures are not stalled by client delayed ACKs)
+void uTLGBotBenchServer::no_delay(mbedtls_net_context* client_fd)
+{
+    int enable = 1;
+
+    setsockopt(client_fd->fd, IPPROTO_TCP, TCP_NODELAY, (const char*)&enable, sizeof(enable));
+}
+
+// Serve requests of a connection until client close it
+void uTLGBotBenchServer::serve(mbedtls_net_context* client_fd)
+{
+    mbedtls_ssl_context ssl;
+
+    mbedtls_ssl_init(&ssl);
+    if(mbedtls_ssl_setup(&ssl, &_conf) == 0)
+    {
+        mbedtls_ssl_set_bio(&ssl, client_fd, mbedtls_net_send, NULL, mbedtls_net_recv_timeout);
+        if(handshake(&ssl))
+        {
+            while(read_request(&ssl) && write_response(&ssl))
+                _num_requests++;
+            mbedtls_ssl_close_notify(&ssl);
+        }
+    }
+    mbedtls_ssl_free(&ssl);
+}
+
+// Perform TLS handshake (full or resumed from sessions cache)
+bool uTLGBotBenchServer::handshake(mbedtls_ssl_context* ssl)
+{
+    int ret;
+
+    while((ret = mbedtls_ssl_handshake(ssl)) != 0)
+    {
+        if(_stop || (mbedtls_net_poll(&_listen_fd, MBEDTLS_NET_POLL_READ, 0) > 0))
+            return false;
+        if((ret != MBEDTLS_ERR_SSL_WANT_READ) && (ret != MBEDTLS_ERR_SSL_WANT_WRITE) &&
+            (ret != MBEDTLS_ERR_SSL_TIMEOUT))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Read a full HTTP request (header and Content-Length body)
+bool uTLGBotBenchServer::read_request(mbedtls_ssl_context* ssl)
+{
+    const char* header_end;
+    const char* content_length;
+    size_t len = 0;
+    size_t request_len = 0;
+    int ret;
+
+    while((request_len == 0) || (len < request_len))
+    {
+        if(len >= BENCH_SERVER_MAX_REQUEST_LENGTH - 1)
+            return false;
+        ret = mbedtls_ssl_read(ssl, (unsigned char*)_request + len,
+            BENCH_SERVER_MAX_REQUEST_LENGTH - 1 - len);
+        if((ret == MBEDTLS_ERR_SSL_WANT_READ) || (ret == MBEDTLS_ERR_SSL_WANT_WRITE) ||
+            (ret == MBEDTLS_ERR_SSL_TIMEOUT))
+        {
+            // Drop idle connection on stop or if a new client is waiting (client that left its
+            // connection open)
+            if(_stop || (mbedtls_net_poll(&_listen_fd, MBEDTLS_NET_POLL_READ, 0) > 0))
+                return false;
+            continue;
+        }
+        if(ret <= 0)
+            return false;
+        len = len + ret;
+        _request[len] = '\0';
+
+        // Get full request length when header is complete
+        if(request_len == 0)
+        {
+            header_end = strstr(_request, "\r\n\r\n");
+            if(header_end == NULL)
+                continue;
+            request_len = (header_end - _request) + 4;
+            content_length = strstr(_request, "Content-Length: ");
+            if((content_length != NULL) && (content_length < header_end))
+                request_len = request_len + strtoul(content_length + 16, NULL, 10);
+        }
+    }
+
+    return true;
+}
+
+// Write the response of last request (in a single TLS record, as Telegram server does for small
+// responses)
+bool uTLGBotBenchServer::write_response(mbedtls_ssl_context* ssl)
+{
+    char response[1024];
+    char updates[768];
+    const char* message;
+    const char* body;
+    size_t len, written;
+    int ret;
+
+    if(_response_delay_ms != 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(_response_delay_ms));
+
+    body = BENCH_SEND_RESPONSE;
+    if(strstr(_request, "/getUpdates ") != NULL)
+    {
+        body = BENCH_UPDATES_RESPONSE;
+        message = _updates_message;
+        if(message != NULL)
+        {
+            snprintf(updates, sizeof(updates), BENCH_UPDATES_MESSAGE_RESPONSE,
+                (unsigned)_update_id, message);
+            _update_id = _update_id + 1;
+            body = updates;
+        }
+    }
+    len = snprintf(response, sizeof(response), BENCH_RESPONSE_HEADER, (unsigned)strlen(body),
+        body);
+
+    written = 0;
+    while(written < len)
+    {
+        ret = mbedtls_ssl_write(ssl, (const unsigned char*)response + written, len - written);
+        if((ret == MBEDTLS_ERR_SSL_WANT_READ) || (ret == MBEDTLS_ERR_SSL_WANT_WRITE))
+            continue;
+        if(ret <= 0)
+            return false;
+        written = written + ret;
+    }
+
+    return true;
+}
+
+/**************************************************************************************************/
@@ -0,0 +1,97 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: bench_tls_server.h
+// Description: Local TLS mock of Telegram Bot API server for benchmarks (mbedtls server with a
+//              self-signed certificate, keep-alive connections and TLS sessions cache).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef BENCHTLSSERVER_H_
+#define BENCHTLSSERVER_H_
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <atomic>
+#include <thread>
+
+#include "mbedtls/ctr_drbg.h"
+#include "mbedtls/entropy.h"
+#include "mbedtls/net_sockets.h"
+#include "mbedtls/ssl.h"
+#include "mbedtls/ssl_cache.h"
+#include "mbedtls/x509_crt.h"
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Server address and poll period to check for stop (ms)
+#define BENCH_SERVER_ADDRESS "127.0.0.1"
+#define BENCH_SERVER_POLL_MS 100
+
+// Update identifier of first update sent by the server
+#define BENCH_SERVER_FIRST_UPDATE_ID 5000
+
+// Server certificate Common Name and validity (days)
+#define BENCH_SERVER_CERT_SUBJECT "CN=localhost,O=uTLGBotLib,OU=Benchmarks"
+#define BENCH_SERVER_CERT_DAYS 365
+
+// Max request length and max server certificate PEM length
+#define BENCH_SERVER_MAX_REQUEST_LENGTH 8192
+#define BENCH_SERVER_MAX_CERT_LENGTH 2048
+
+/**************************************************************************************************/
+
+class uTLGBotBenchServer
+{
+    public:
+        // Public Methods
+        uTLGBotBenchServer();
+        ~uTLGBotBenchServer();
+        bool start(const uint16_t port, const bool sessions_cache=true);
+        void stop();
+        uint32_t num_requests();
+        const char* cert_pem();
+        void set_updates_message(const char* message);
+        void set_response_delay(const uint32_t delay_ms);
+
+    private:
+        // Private Attributtes
+        mbedtls_net_context _listen_fd;
+        mbedtls_entropy_context _entropy;
+        mbedtls_ctr_drbg_context _ctr_drbg;
+        mbedtls_ssl_config _conf;
+        mbedtls_x509_crt _cert;
+        mbedtls_pk_context _key;
+        mbedtls_ssl_cache_context _cache;
+        std::thread _thread;
+        std::atomic<bool> _stop;
+        std::atomic<uint32_t> _num_requests;
+        std::atomic<const char*> _updates_message;
+        uint32_t _update_id;
+        std::atomic<uint32_t> _response_delay_ms;
+        char _request[BENCH_SERVER_MAX_REQUEST_LENGTH];
+        unsigned char _cert_pem[BENCH_SERVER_MAX_CERT_LENGTH];
+
+        // Private Methods
+        bool create_cert();
+        void server_loop();
+        void no_delay(mbedtls_net_context* client_fd);
+        void serve(mbedtls_net_context* client_fd);
+        bool handshake(mbedtls_ssl_context* ssl);
+        bool read_request(mbedtls_ssl_context* ssl);
+        bool write_response(mbedtls_ssl_context* ssl);
+};
+
+/**************************************************************************************************/
+
+#endif
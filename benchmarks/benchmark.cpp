@@ -0,0 +1,191 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: benchmark.cpp
+// Description: Native benchmarks suite runner (measure loops, collect results and write them as
+//              JSON).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "benchmark.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(WIN32) || defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+/**************************************************************************************************/
+
+/* Data Types */
+
+typedef struct bench_result
+{
+    const char* name;
+    const char* unit;
+    double value;
+    bench_measure measure;
+} bench_result;
+
+/**************************************************************************************************/
+
+/* Static Data */
+
+static bench_result results[BENCH_MAX_RESULTS];
+static uint8_t num_results = 0;
+static uint8_t num_failures = 0;
+static bool quick = false;
+static const char* filter = NULL;
+
+/**************************************************************************************************/
+
+/* Functions */
+
+// Get monotonic time in nanoseconds
+uint64_t bench_now_ns(void)
+{
+#if defined(WIN32) || defined(_WIN32)
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (uint64_t)((count.QuadPart*1000000000.0) / freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)((ts.tv_sec*1000000000ULL) + ts.tv_nsec);
+#endif
+}
+
+// Check for quick run (just check that benchmarks work)
+bool bench_is_quick(void)
+{
+    return quick;
+}
+
+// Check if a benchmark has to be run (its name contains the filter)
+bool bench_is_selected(const char* name)
+{
+    return ((filter == NULL) || (strstr(name, filter) != NULL));
+}
+
+// Run a benchmark loop with an increasing number of iterations until it takes the minimum time
+bool bench_run(bench_loop loop, void* user_data, bench_measure* measure)
+{
+    uint64_t min_time_ns = quick ? BENCH_QUICK_MIN_TIME_NS : BENCH_MIN_TIME_NS;
+    uint64_t iterations = 1;
+    uint64_t t0;
+
+    while(true)
+    {
+        t0 = bench_now_ns();
+        if(!loop(iterations, user_data))
+            return false;
+        measure->iterations = iterations;
+        measure->elapsed_ns = bench_now_ns() - t0;
+        if(measure->elapsed_ns >= min_time_ns)
+            return true;
+
+        // Estimate iterations for the minimum time (at least doubling them)
+        if(measure->elapsed_ns < (min_time_ns / 100))
+            iterations = iterations * 100;
+        else if(measure->elapsed_ns > (min_time_ns / 2))
+            iterations = iterations * 2;
+        else
+            iterations = (iterations * min_time_ns * 12) / (measure->elapsed_ns * 10);
+    }
+}
+
+// Add a benchmark result
+void bench_report(const char* name, const char* unit, const double value,
+    const bench_measure* measure)
+{
+    fprintf(stderr, "%-32s %14.3f %-12s (%" PRIu64 " iterations in %.3f s)\n", name, value, unit,
+        measure->iterations, measure->elapsed_ns / 1e9);
+    if(num_results >= BENCH_MAX_RESULTS)
+        return;
+    results[num_results].name = name;
+    results[num_results].unit = unit;
+    results[num_results].value = value;
+    results[num_results].measure = *measure;
+    num_results = num_results + 1;
+}
+
+// Account a benchmark that could not be run
+void bench_fail(const char* name, const char* reason)
+{
+    fprintf(stderr, "%-32s FAIL: %s\n", name, reason);
+    num_failures = num_failures + 1;
+}
+
+/**************************************************************************************************/
+
+/* Results Output */
+
+// Write results as JSON
+static void write_json(FILE* file)
+{
+    fprintf(file, "{\n  \"suite\": \"uTLGBotLib\",\n  \"commit\": \"%s\",\n  \"quick\": %s,\n" \
+        "  \"failures\": %u,\n  \"benchmarks\": [", UTLGBOT_BENCH_COMMIT,
+        quick ? "true" : "false", num_failures);
+    for(uint8_t i = 0; i < num_results; i++)
+    {
+        fprintf(file, "%s\n    {\"name\": \"%s\", \"unit\": \"%s\", \"value\": %.3f, " \
+            "\"iterations\": %" PRIu64 ", \"elapsed_ns\": %" PRIu64 "}", (i == 0) ? "" : ",",
+            results[i].name, results[i].unit, results[i].value, results[i].measure.iterations,
+            results[i].measure.elapsed_ns);
+    }
+    fprintf(file, "\n  ]\n}\n");
+}
+
+/**************************************************************************************************/
+
+/* Main Function */
+
+// Usage: utlgbot_benchmarks [--quick] [--filter name] [--output results.json]
+int main(int argc, char* argv[])
+{
+    const char* output = NULL;
+    FILE* file;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "--quick") == 0)
+            quick = true;
+        else if((strcmp(argv[i], "--filter") == 0) && (i + 1 < argc))
+            filter = argv[++i];
+        else if((strcmp(argv[i], "--output") == 0) && (i + 1 < argc))
+            output = argv[++i];
+        else
+        {
+            fprintf(stderr, "Usage: %s [--quick] [--filter name] [--output file]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    bench_parse();
+    bench_tls();
+
+    if(output == NULL)
+        write_json(stdout);
+    else
+    {
+        file = fopen(output, "w");
+        if(file == NULL)
+        {
+            fprintf(stderr, "Can't open output file %s\n", output);
+            return 1;
+        }
+        write_json(file);
+        fclose(file);
+    }
+
+    return (num_failures == 0) ? 0 : 1;
+}
+
+/**************************************************************************************************/
@@ -0,0 +1,67 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: benchmark.h
+// Description: Native benchmarks suite runner (measure loops, collect results and write them as
+//              JSON).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Minimum measured time of each benchmark (normal and quick run)
+#define BENCH_MIN_TIME_NS 500000000ULL
+#define BENCH_QUICK_MIN_TIME_NS 20000000ULL
+
+// Maximum number of results
+#define BENCH_MAX_RESULTS 32
+
+/**************************************************************************************************/
+
+/* Data Types */
+
+// Benchmark loop function (run the measured code the given number of times, false on error)
+typedef bool (*bench_loop)(const uint64_t iterations, void* user_data);
+
+// Benchmark measure
+typedef struct bench_measure
+{
+    uint64_t iterations;
+    uint64_t elapsed_ns;
+} bench_measure;
+
+/**************************************************************************************************/
+
+/* Functions */
+
+uint64_t bench_now_ns();
+bool bench_is_quick();
+bool bench_is_selected(const char* name);
+bool bench_run(bench_loop loop, void* user_data, bench_measure* measure);
+void bench_report(const char* name, const char* unit, const double value,
+    const bench_measure* measure);
+void bench_fail(const char* name, const char* reason);
+
+// Benchmarks groups
+void bench_parse();
+void bench_tls();
+
+/**************************************************************************************************/
+
+#endif
@@ -96,7 +96,7 @@ void loop()
     if(Bot.getUpdates())
     {
         // Send an echo message back
-        Bot.sendMessage(Bot.received_msg.chat.id, Bot.received_msg.text);
+        Bot.sendEscapedMessage(Bot.received_msg.chat.id, Bot.received_msg.text);
     }
 
     // Wait 1s for next iteration
@@ -65,6 +65,11 @@ const char TEXT_HELP[] =
 
 void wifi_init_stat(void);
 bool wifi_handle_connection(void);
+void cmd_start(const tlg_cmd* cmd, void* user_data);
+void cmd_help(const tlg_cmd* cmd, void* user_data);
+void cmd_ledon(const tlg_cmd* cmd, void* user_data);
+void cmd_ledoff(const tlg_cmd* cmd, void* user_data);
+void cmd_ledstatus(const tlg_cmd* cmd, void* user_data);
 
 /**************************************************************************************************/
 
@@ -73,6 +78,9 @@ bool wifi_handle_connection(void);
 // Create Bot object
 uTLGBot Bot(TLG_TOKEN);
 
+// Create Bot commands router
+uTLGBotRouter Router;
+
 // LED status
 uint8_t led_status;
 
@@ -93,6 +101,14 @@ void setup(void)
     pinMode(PIN_LED, OUTPUT);
     led_status = 0;
 
+    // Register Bot commands
+    Router.add("/start", cmd_start);
+    Router.add("/help", cmd_help);
+    Router.add("/ledon", cmd_ledon);
+    Router.add("/ledoff", cmd_ledoff);
+    Router.add("/ledstatus", cmd_ledstatus);
+    Router.compile();
+
     // Initialize WiFi station connection
     wifi_init_stat();
 
@@ -127,66 +143,70 @@ void loop()
         Serial.println(Bot.received_msg.text);
         Serial.println("");
 
-        // If /start command was received
-        if(strncmp(Bot.received_msg.text, "/start", strlen("/start")) == 0)
-        {
-            // Send a Telegram message for start
-            Bot.sendMessage(Bot.received_msg.chat.id, TEXT_START);
-        }
+        // Call the handler of received command
+        Router.dispatch(Bot.received_msg.text);
 
-        // If /help command was received
-        else if(strncmp(Bot.received_msg.text, "/help", strlen("/help")) == 0)
-        {
-            // Send a Telegram message for start
-            Bot.sendMessage(Bot.received_msg.chat.id, TEXT_HELP);
-        }
+        // Feed the Watchdog
+        yield();
+    }
 
-        // If /ledon command was received
-        else if(strncmp(Bot.received_msg.text, "/ledon", strlen("/ledon")) == 0)
-        {
-            // Turn on LED
-            led_status = 1;
-            digitalWrite(PIN_LED, HIGH);
+    // Wait 1s for next iteration
+    delay(1000);
+}
 
-            // Show command reception through Serial
-            Serial.println("Command /ledon received.");
-            Serial.println("Turning on the LED.");
+/**************************************************************************************************/
 
-            // Send a Telegram message to notify that the LED has been turned on
-            Bot.sendMessage(Bot.received_msg.chat.id, "Led turned on.");
-        }
+/* Bot Commands Handlers */
 
-        // If /ledoff command was received
-        else if(strncmp(Bot.received_msg.text, "/ledoff", strlen("/ledoff")) == 0)
-        {
-            // Turn off LED
-            led_status = 0;
-            digitalWrite(PIN_LED, LOW);
+// Command /start: Send a Telegram message for start
+void cmd_start(const tlg_cmd* cmd, void* user_data)
+{
+    Bot.sendMessage(Bot.received_msg.chat.id, TEXT_START);
+}
 
-            // Show command reception through Serial
-            Serial.println("Command /ledoff received.");
-            Serial.println("Turning off the LED.");
+// Command /help: Send a Telegram message with commands help
+void cmd_help(const tlg_cmd* cmd, void* user_data)
+{
+    Bot.sendMessage(Bot.received_msg.chat.id, TEXT_HELP);
+}
 
-            // Send a Telegram message to notify that the LED has been turned off
-            Bot.sendMessage(Bot.received_msg.chat.id, "Led turned off.");
-        }
+// Command /ledon: Turn on the LED
+void cmd_ledon(const tlg_cmd* cmd, void* user_data)
+{
+    // Turn on LED
+    led_status = 1;
+    digitalWrite(PIN_LED, HIGH);
 
-        // If /ledstatus command was received
-        else if(strncmp(Bot.received_msg.text, "/ledstatus", strlen("/ledstatus")) == 0)
-        {
-            // Send a Telegram message to notify actual LED status
-            if(led_status)
-                Bot.sendMessage(Bot.received_msg.chat.id, "The LED is on.");
-            else
-                Bot.sendMessage(Bot.received_msg.chat.id, "The LED is off.");
-        }
+    // Show command reception through Serial
+    Serial.println("Command /ledon received.");
+    Serial.println("Turning on the LED.");
 
-        // Feed the Watchdog
-        yield();
-    }
+    // Send a Telegram message to notify that the LED has been turned on
+    Bot.sendMessage(Bot.received_msg.chat.id, "Led turned on.");
+}
 
-    // Wait 1s for next iteration
-    delay(1000);
+// Command /ledoff: Turn off the LED
+void cmd_ledoff(const tlg_cmd* cmd, void* user_data)
+{
+    // Turn off LED
+    led_status = 0;
+    digitalWrite(PIN_LED, LOW);
+
+    // Show command reception through Serial
+    Serial.println("Command /ledoff received.");
+    Serial.println("Turning off the LED.");
+
+    // Send a Telegram message to notify that the LED has been turned off
+    Bot.sendMessage(Bot.received_msg.chat.id, "Led turned off.");
+}
+
+// Command /ledstatus: Send a Telegram message to notify actual LED status
+void cmd_ledstatus(const tlg_cmd* cmd, void* user_data)
+{
+    if(led_status)
+        Bot.sendMessage(Bot.received_msg.chat.id, "The LED is on.");
+    else
+        Bot.sendMessage(Bot.received_msg.chat.id, "The LED is off.");
 }
 
 /**************************************************************************************************/
@@ -93,7 +93,7 @@ void loop()
     while(Bot.getUpdates())
     {
         // Send an echo message back
-        Bot.sendMessage(Bot.received_msg.chat.id, Bot.received_msg.text);
+        Bot.sendEscapedMessage(Bot.received_msg.chat.id, Bot.received_msg.text);
 
         // Feed the Watchdog
         yield();
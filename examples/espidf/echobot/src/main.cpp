@@ -30,6 +30,7 @@
 
 // Telegram libraries
 #include "utlgbotlib.h"
+#include "utlgbotrxengine.h"
 
 /**************************************************************************************************/
 
@@ -75,19 +76,26 @@ static EventGroupHandle_t s_wifi_event_group;
 // Number of connection retries
 static int s_retry_num = 0;
 
+// Telegram messages receive engine (background task with its own connection and static pool)
+static uTLGBotRxEngine RxEngine(TLG_TOKEN);
+
 /**************************************************************************************************/
 
 /* Main Function */
 
 void app_main(void)
 {
-    // Create Bot object
+    // Create Bot object (to send messages)
     uTLGBot Bot(TLG_TOKEN);
+    tlg_type_message* msg;
 
     // Initialize Non-Volatile-Storage and WiFi station connection
     nvs_init();
     wifi_init_stat();
 
+    // Start receiving messages in background
+    RxEngine.start();
+
     // Main loop
     while(1)
     {
@@ -99,21 +107,18 @@ void app_main(void)
             continue;
         }
 
-        // Check and handle any received message
-        while(Bot.getUpdates())
-        {
-            ESP_LOGI(TAG, "Message received from %s, echo it back...\n",
-                Bot.received_msg.from.first_name);
-            if(!Bot.sendMessage(Bot.received_msg.chat.id, Bot.received_msg.text))
-            {
-                ESP_LOGI(TAG, "Send fail.\n");
-                continue;
-            }
+        // Wait up to 1s for a received message and handle it
+        msg = RxEngine.receive(1000/portTICK_PERIOD_MS);
+        if(msg == NULL)
+            continue;
+        ESP_LOGI(TAG, "Message received from %s, echo it back...\n", msg->from.first_name);
+        if(!Bot.sendEscapedMessage(msg->chat.id, msg->text))
+            ESP_LOGI(TAG, "Send fail.\n");
+        else
             ESP_LOGI(TAG, "Send OK.\n\n");
-        }
 
-        // Wait 1s for next iteration
-        vTaskDelay(1000/portTICK_PERIOD_MS);
+        // Give back the message slot to the receive engine
+        RxEngine.release(msg);
     }
 }
 
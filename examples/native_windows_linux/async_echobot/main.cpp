@@ -0,0 +1,67 @@
+/**************************************************************************************************/
+// Example: async_echobot
+// Description:
+//   Bot that response to any received text message with the same text received (echo messages),
+//   using C++20 coroutines. Each received message is echoed by its own flow, so a slow send
+//   doesn't block the reception of next messages (build with -std=c++20).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+// Standard C/C++ libraries
+#include <string.h>
+
+// Custom libraries
+#include "utlgbotlib.h"
+#include "utlgbotasync.h"
+
+/**************************************************************************************************/
+
+// Telegram Bot Token (Get from Botfather)
+#define TLG_TOKEN "XXXXXXXXX:XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX"
+
+/**************************************************************************************************/
+
+/* Conversational Flows */
+
+// Echo flow: send back the received text and release the message
+tlg_task echo_flow(uTLGBotAsync& bot, tlg_type_message* msg)
+{
+    if(!co_await bot.send_escaped(msg->chat.id, msg->text))
+        printf("Send to %s fail.\n", msg->from.first_name);
+    bot.release(msg);
+}
+
+// Main flow: start a new echo flow for each received message (the message is passed to it, so
+// it is released there)
+tlg_task main_flow(uTLGBotAsync& bot)
+{
+    while(true)
+    {
+        tlg_type_message* msg = co_await bot.next_update();
+        printf("Message received from %s, sending it back.\n", msg->from.first_name);
+        echo_flow(bot, msg);
+    }
+}
+
+/**************************************************************************************************/
+
+/* Main Function */
+
+int main(void)
+{
+    // Create Bot object and its coroutines layer
+    uTLGBot Bot(TLG_TOKEN);
+    uTLGBotAsync BotAsync(Bot);
+
+    // Start main flow and run the scheduler
+    main_flow(BotAsync);
+    BotAsync.run();
+
+    return 0;
+}
+
+/**************************************************************************************************/
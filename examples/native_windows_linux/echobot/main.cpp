@@ -46,7 +46,7 @@ int main(void)
         {
             printf("Message received from %s at %s, sending it back.\n",
                 Bot.received_msg.from.first_name, Bot.received_msg.chat.title);
-            Bot.sendMessage(Bot.received_msg.chat.id, Bot.received_msg.text);
+            Bot.sendEscapedMessage(Bot.received_msg.chat.id, Bot.received_msg.text);
         }
 
         // Wait 1s for next iteration
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+
+# Project: uTLGBotLib
+# File: pem2der.py
+# Description: Convert the Telegram API CA certificate from PEM to DER and write it as a C++
+#              constant array source (src/utlgbotcerts.cpp), so the certificate can be parsed in
+#              place from flash without base64 decoding nor copying it.
+# Created on: 17 oct. 2026
+# Last modified date: 17 oct. 2026
+# Version: 1.0.0
+
+####################################################################################################
+
+# Imports
+
+import base64
+import os
+import sys
+
+####################################################################################################
+
+# Constants
+
+CERTS_DIR = os.path.dirname(os.path.abspath(__file__))
+DEFAULT_PEM = os.path.join(CERTS_DIR, "api-telegram-org.pem")
+DEFAULT_OUTPUT = os.path.join(CERTS_DIR, "..", "..", "src", "utlgbotcerts.cpp")
+PEM_BEGIN = "-----BEGIN CERTIFICATE-----"
+PEM_END = "-----END CERTIFICATE-----"
+BYTES_PER_LINE = 16
+
+SOURCE_HEADER = '''\
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotcerts.cpp
+// Description: Telegram API CA certificate in DER format.
+//              Note: This file is generated from res/certs/{pem} by
+//              res/certs/pem2der.py (don't modify it by hand).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "utlgbotcerts.h"
+
+// Certificate is kept in flash in ESP8266 (BearSSL copies it with memcpy_P() when it is loaded)
+#if defined(ESP8266)
+    #include <pgmspace.h>
+#else
+    #define PROGMEM
+#endif
+
+/**************************************************************************************************/
+
+/* Telegram API CA Certificate */
+
+const uint8_t tlg_api_ca_der[] PROGMEM =
+{{
+{data}
+}};
+
+const size_t tlg_api_ca_der_len = sizeof(tlg_api_ca_der);
+
+/**************************************************************************************************/
+'''
+
+####################################################################################################
+
+# Functions
+
+def pem_to_der(pem):
+    '''Get the DER data of the certificate in a PEM text (just one certificate is expected).'''
+    begin = pem.find(PEM_BEGIN)
+    end = pem.find(PEM_END)
+    if (begin < 0) or (end < begin):
+        raise ValueError("No PEM certificate found")
+    if pem.find(PEM_BEGIN, end) >= 0:
+        raise ValueError("Just one PEM certificate is supported")
+    return base64.b64decode("".join(pem[begin + len(PEM_BEGIN):end].split()))
+
+
+def der_to_source(der, pem_name):
+    '''Get the C++ source of the DER data constant array.'''
+    lines = []
+    for i in range(0, len(der), BYTES_PER_LINE):
+        chunk = der[i:i + BYTES_PER_LINE]
+        lines.append("    " + ", ".join("0x{:02x}".format(b) for b in chunk) + ",")
+    return SOURCE_HEADER.format(pem=pem_name, data="\n".join(lines))
+
+
+def generate(pem_path=DEFAULT_PEM, output_path=DEFAULT_OUTPUT):
+    '''Generate the DER source from the PEM file (output is not rewritten if unchanged).'''
+    with open(pem_path, "r") as pem_file:
+        der = pem_to_der(pem_file.read())
+    source = der_to_source(der, os.path.basename(pem_path))
+    if os.path.exists(output_path):
+        with open(output_path, "r") as output_file:
+            if output_file.read() == source:
+                return False
+    with open(output_path, "w") as output_file:
+        output_file.write(source)
+    return True
+
+####################################################################################################
+
+# Main
+
+if __name__ == "__main__":
+    args = sys.argv[1:]
+    if len(args) > 2:
+        print("Usage: pem2der.py [cert.pem] [output.cpp]")
+        sys.exit(1)
+    generate(*args)
@@ -179,6 +179,11 @@
  */
 //#define MBEDTLS_PLATFORM_MEMORY
 
+/* multihttpsclient memory accounting routes mbedtls allocations through its hooks */
+#if defined(MULTIHTTPSCLIENT_MEMORY_STATS) || defined(UTLGBOT_MEMORY_STATS)
+#define MBEDTLS_PLATFORM_MEMORY
+#endif
+
 /**
  * \def MBEDTLS_PLATFORM_NO_STD_FUNCTIONS
  *
@@ -2736,6 +2741,24 @@
  */
 #define MBEDTLS_SHA512_C
 
+/**
+ * \def MBEDTLS_SHAEXT_C
+ *
+ * Enable SHA-1 and SHA-256 hardware acceleration on x86 (SHA extensions) and
+ * AArch64 (Cryptographic Extension).
+ *
+ * Module:  library/shaext.c
+ * Caller:  library/sha1.c
+ *          library/sha256.c
+ *
+ * Requires: MBEDTLS_HAVE_ASM
+ *
+ * This module adds support for the SHA instructions, they are used if the
+ * CPU has them (checked at runtime) and the portable code otherwise. It has
+ * no effect with MBEDTLS_SHA1_PROCESS_ALT or MBEDTLS_SHA256_PROCESS_ALT.
+ */
+#define MBEDTLS_SHAEXT_C
+
 /**
  * \def MBEDTLS_SSL_CACHE_C
  *
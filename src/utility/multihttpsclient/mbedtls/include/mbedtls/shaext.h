@@ -0,0 +1,122 @@
+/**
+ * \file shaext.h
+ *
+ * \brief SHA-1 and SHA-256 hardware acceleration with the x86 SHA
+ *        extensions and the ARMv8 cryptography extensions
+ *
+ * \warning These functions are only for internal use by other library
+ *          functions; you must not call them directly.
+ */
+/*
+ *  Copyright (C) 2006-2015, ARM Limited, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  This file is part of mbed TLS (https://tls.mbed.org)
+ */
+#ifndef MBEDTLS_SHAEXT_H
+#define MBEDTLS_SHAEXT_H
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define MBEDTLS_SHAEXT_SHA1    0x00000001u
+#define MBEDTLS_SHAEXT_SHA256  0x00000002u
+
+/*
+ * The instructions are used through compiler intrinsics enabled per
+ * function, so the library itself can still be built for any CPU of the
+ * architecture (GCC >= 5 or Clang >= 4 for x86, GCC >= 6 or Clang >= 4
+ * for AArch64).
+ */
+#if defined(MBEDTLS_HAVE_ASM) && defined(__GNUC__) &&                     \
+    ( defined(__i386__) || defined(__amd64__) || defined(__x86_64__) ) && \
+    ( ( defined(__clang__) && __clang_major__ >= 4 ) ||                   \
+      ( !defined(__clang__) && __GNUC__ >= 5 ) ) &&                       \
+    ! defined(MBEDTLS_HAVE_SHAEXT_X86)
+#define MBEDTLS_HAVE_SHAEXT_X86
+#endif
+
+#if defined(MBEDTLS_HAVE_ASM) && defined(__GNUC__) &&                     \
+    defined(__aarch64__) &&                                               \
+    ( ( defined(__clang__) && __clang_major__ >= 4 ) ||                   \
+      ( !defined(__clang__) && __GNUC__ >= 6 ) ) &&                       \
+    ! defined(MBEDTLS_HAVE_SHAEXT_A64)
+#define MBEDTLS_HAVE_SHAEXT_A64
+#endif
+
+#if defined(MBEDTLS_HAVE_SHAEXT_X86) || defined(MBEDTLS_HAVE_SHAEXT_A64)
+#define MBEDTLS_HAVE_SHAEXT
+#endif
+
+#if defined(MBEDTLS_HAVE_SHAEXT)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * \brief          Internal function to detect the SHA extensions in CPUs.
+ *
+ * \note           This function is only for internal use by other library
+ *                 functions; you must not call it directly.
+ *
+ * \param what     The feature to detect
+ *                 (MBEDTLS_SHAEXT_SHA1 or MBEDTLS_SHAEXT_SHA256)
+ *
+ * \return         1 if CPU has support for the feature, 0 otherwise
+ */
+int mbedtls_shaext_has_support( unsigned int what );
+
+/**
+ * \brief          Internal SHA-1 compression of consecutive 64-byte blocks
+ *
+ * \note           This function is only for internal use by other library
+ *                 functions; you must not call it directly.
+ *
+ * \param state    SHA-1 intermediate digest state
+ * \param data     Blocks to process
+ * \param blocks   Number of 64-byte blocks
+ */
+void mbedtls_shaext_sha1_process( uint32_t state[5],
+                                  const unsigned char *data,
+                                  size_t blocks );
+
+/**
+ * \brief          Internal SHA-256 compression of consecutive 64-byte blocks
+ *
+ * \note           This function is only for internal use by other library
+ *                 functions; you must not call it directly.
+ *
+ * \param state    SHA-256 intermediate digest state
+ * \param data     Blocks to process
+ * \param blocks   Number of 64-byte blocks
+ */
+void mbedtls_shaext_sha256_process( uint32_t state[8],
+                                    const unsigned char *data,
+                                    size_t blocks );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MBEDTLS_HAVE_SHAEXT */
+
+#endif /* MBEDTLS_SHAEXT_H */
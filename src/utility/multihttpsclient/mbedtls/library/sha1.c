@@ -34,6 +34,9 @@
 
 #include "mbedtls/sha1.h"
 #include "mbedtls/platform_util.h"
+#if defined(MBEDTLS_SHAEXT_C)
+#include "mbedtls/shaext.h"
+#endif
 
 #include <string.h>
 
@@ -135,6 +138,14 @@ int mbedtls_internal_sha1_process( mbedtls_sha1_context *ctx,
     SHA1_VALIDATE_RET( ctx != NULL );
     SHA1_VALIDATE_RET( (const unsigned char *)data != NULL );
 
+#if defined(MBEDTLS_SHAEXT_C) && defined(MBEDTLS_HAVE_SHAEXT)
+    if( mbedtls_shaext_has_support( MBEDTLS_SHAEXT_SHA1 ) )
+    {
+        mbedtls_shaext_sha1_process( ctx->state, data, 1 );
+        return( 0 );
+    }
+#endif
+
     GET_UINT32_BE( W[ 0], data,  0 );
     GET_UINT32_BE( W[ 1], data,  4 );
     GET_UINT32_BE( W[ 2], data,  8 );
@@ -336,6 +347,17 @@ int mbedtls_sha1_update_ret( mbedtls_sha1_context *ctx,
         left = 0;
     }
 
+#if defined(MBEDTLS_SHAEXT_C) && defined(MBEDTLS_HAVE_SHAEXT) && \
+    !defined(MBEDTLS_SHA1_PROCESS_ALT)
+    /* Consecutive blocks are processed without leaving the SHA instructions */
+    if( ilen >= 64 && mbedtls_shaext_has_support( MBEDTLS_SHAEXT_SHA1 ) )
+    {
+        mbedtls_shaext_sha1_process( ctx->state, input, ilen / 64 );
+        input += ilen & ~( (size_t) 0x3F );
+        ilen  &= 0x3F;
+    }
+#endif
+
     while( ilen >= 64 )
     {
         if( ( ret = mbedtls_internal_sha1_process( ctx, input ) ) != 0 )
@@ -34,6 +34,9 @@
 
 #include "mbedtls/sha256.h"
 #include "mbedtls/platform_util.h"
+#if defined(MBEDTLS_SHAEXT_C)
+#include "mbedtls/shaext.h"
+#endif
 
 #include <string.h>
 
@@ -207,6 +210,14 @@ int mbedtls_internal_sha256_process( mbedtls_sha256_context *ctx,
     SHA256_VALIDATE_RET( ctx != NULL );
     SHA256_VALIDATE_RET( (const unsigned char *)data != NULL );
 
+#if defined(MBEDTLS_SHAEXT_C) && defined(MBEDTLS_HAVE_SHAEXT)
+    if( mbedtls_shaext_has_support( MBEDTLS_SHAEXT_SHA256 ) )
+    {
+        mbedtls_shaext_sha256_process( ctx->state, data, 1 );
+        return( 0 );
+    }
+#endif
+
     for( i = 0; i < 8; i++ )
         A[i] = ctx->state[i];
 
@@ -305,6 +316,17 @@ int mbedtls_sha256_update_ret( mbedtls_sha256_context *ctx,
         left = 0;
     }
 
+#if defined(MBEDTLS_SHAEXT_C) && defined(MBEDTLS_HAVE_SHAEXT) && \
+    !defined(MBEDTLS_SHA256_PROCESS_ALT)
+    /* Consecutive blocks are processed without leaving the SHA instructions */
+    if( ilen >= 64 && mbedtls_shaext_has_support( MBEDTLS_SHAEXT_SHA256 ) )
+    {
+        mbedtls_shaext_sha256_process( ctx->state, input, ilen / 64 );
+        input += ilen & ~( (size_t) 0x3F );
+        ilen  &= 0x3F;
+    }
+#endif
+
     while( ilen >= 64 )
     {
         if( ( ret = mbedtls_internal_sha256_process( ctx, input ) ) != 0 )
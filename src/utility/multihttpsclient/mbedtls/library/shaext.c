@@ -0,0 +1,430 @@
+/*
+ *  SHA-1 and SHA-256 hardware acceleration support functions
+ *
+ *  Copyright (C) 2006-2015, ARM Limited, All Rights Reserved
+ *  SPDX-License-Identifier: Apache-2.0
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *  not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ *  WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *  This file is part of mbed TLS (https://tls.mbed.org)
+ */
+
+/*
+ * [SHA-WP] https://software.intel.com/en-us/articles/intel-sha-extensions
+ * [ARMv8]  Arm Architecture Reference Manual for Armv8-A, SHA1C, SHA256H
+ *          and related instructions (Cryptographic Extension)
+ *
+ * Both instruction sets work on four words of the message schedule and
+ * four rounds (two for each SHA256RNDS2) at a time. The processing
+ * functions take several blocks so that the state is kept in vector
+ * registers between them.
+ */
+
+#if !defined(MBEDTLS_CONFIG_FILE)
+#include "mbedtls/config.h"
+#else
+#include MBEDTLS_CONFIG_FILE
+#endif
+
+#if defined(MBEDTLS_SHAEXT_C)
+
+#include "mbedtls/shaext.h"
+
+#if defined(MBEDTLS_HAVE_SHAEXT)
+
+/*
+ * SHA-256 round constants
+ */
+static const uint32_t K256[] =
+{
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5,
+    0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3,
+    0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC,
+    0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7,
+    0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13,
+    0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3,
+    0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5,
+    0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208,
+    0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
+};
+
+/*
+ * SHA-1 four rounds groups, with the message words of the group in m and
+ * the round function selector (or constant) in f. The E input of a group
+ * is derived from A of the state before the previous group, so e_in and
+ * e_out are two variables used alternately.
+ */
+#define SHA1_GROUPS                                                         \
+    SHA1_FIRST_ROUNDS( m0 );                                                \
+    SHA1_ROUNDS( e1, e0, m1, SHA1_F0 );                                     \
+    SHA1_ROUNDS( e0, e1, m2, SHA1_F0 );                                     \
+    SHA1_ROUNDS( e1, e0, m3, SHA1_F0 );                                     \
+    SHA1_SCHED( m0, m1, m2, m3 ); SHA1_ROUNDS( e0, e1, m0, SHA1_F0 );       \
+    SHA1_SCHED( m1, m2, m3, m0 ); SHA1_ROUNDS( e1, e0, m1, SHA1_F1 );       \
+    SHA1_SCHED( m2, m3, m0, m1 ); SHA1_ROUNDS( e0, e1, m2, SHA1_F1 );       \
+    SHA1_SCHED( m3, m0, m1, m2 ); SHA1_ROUNDS( e1, e0, m3, SHA1_F1 );       \
+    SHA1_SCHED( m0, m1, m2, m3 ); SHA1_ROUNDS( e0, e1, m0, SHA1_F1 );       \
+    SHA1_SCHED( m1, m2, m3, m0 ); SHA1_ROUNDS( e1, e0, m1, SHA1_F1 );       \
+    SHA1_SCHED( m2, m3, m0, m1 ); SHA1_ROUNDS( e0, e1, m2, SHA1_F2 );       \
+    SHA1_SCHED( m3, m0, m1, m2 ); SHA1_ROUNDS( e1, e0, m3, SHA1_F2 );       \
+    SHA1_SCHED( m0, m1, m2, m3 ); SHA1_ROUNDS( e0, e1, m0, SHA1_F2 );       \
+    SHA1_SCHED( m1, m2, m3, m0 ); SHA1_ROUNDS( e1, e0, m1, SHA1_F2 );       \
+    SHA1_SCHED( m2, m3, m0, m1 ); SHA1_ROUNDS( e0, e1, m2, SHA1_F2 );       \
+    SHA1_SCHED( m3, m0, m1, m2 ); SHA1_ROUNDS( e1, e0, m3, SHA1_F3 );       \
+    SHA1_SCHED( m0, m1, m2, m3 ); SHA1_ROUNDS( e0, e1, m0, SHA1_F3 );       \
+    SHA1_SCHED( m1, m2, m3, m0 ); SHA1_ROUNDS( e1, e0, m1, SHA1_F3 );       \
+    SHA1_SCHED( m2, m3, m0, m1 ); SHA1_ROUNDS( e0, e1, m2, SHA1_F3 );       \
+    SHA1_SCHED( m3, m0, m1, m2 ); SHA1_ROUNDS( e1, e0, m3, SHA1_F3 )
+
+/*
+ * SHA-256 rounds 16 to 63, four rounds for each message schedule update
+ */
+#define SHA256_GROUPS                                                       \
+    for( i = 16; i < 64; i += 16 )                                          \
+    {                                                                       \
+        SHA256_SCHED( m0, m1, m2, m3 ); SHA256_ROUNDS( m0, i );             \
+        SHA256_SCHED( m1, m2, m3, m0 ); SHA256_ROUNDS( m1, i + 4 );         \
+        SHA256_SCHED( m2, m3, m0, m1 ); SHA256_ROUNDS( m2, i + 8 );         \
+        SHA256_SCHED( m3, m0, m1, m2 ); SHA256_ROUNDS( m3, i + 12 );        \
+    }
+
+#if defined(MBEDTLS_HAVE_SHAEXT_X86)
+
+#include <cpuid.h>
+#include <immintrin.h>
+
+#define SHAEXT_X86_TARGET __attribute__((target("sha,sse4.1,ssse3")))
+
+/*
+ * SHA extensions support detection routine, the processing functions also
+ * use SSSE3 and SSE 4.1 instructions (all CPUs with SHA have them)
+ */
+int mbedtls_shaext_has_support( unsigned int what )
+{
+    static int done = 0;
+    static unsigned int flags = 0;
+    unsigned int a, b, c, d;
+
+    if( ! done )
+    {
+        if( __get_cpuid_max( 0, NULL ) >= 7 &&
+            __get_cpuid( 1, &a, &b, &c, &d ) &&
+            ( c & ( 1u << 9 ) ) != 0 && ( c & ( 1u << 19 ) ) != 0 )
+        {
+            __cpuid_count( 7, 0, a, b, c, d );
+            if( ( b & ( 1u << 29 ) ) != 0 )
+                flags = MBEDTLS_SHAEXT_SHA1 | MBEDTLS_SHAEXT_SHA256;
+        }
+        done = 1;
+    }
+
+    return( ( flags & what ) != 0 );
+}
+
+#define SHA1_F0 0
+#define SHA1_F1 1
+#define SHA1_F2 2
+#define SHA1_F3 3
+
+#define SHA1_LOAD( m, n )                                                   \
+    m = _mm_shuffle_epi8( _mm_loadu_si128(                                  \
+            (const __m128i *) ( data + 16 * ( n ) ) ), mask )
+
+#define SHA1_SCHED( m0, m1, m2, m3 )                                        \
+    m0 = _mm_sha1msg2_epu32( _mm_xor_si128(                                 \
+            _mm_sha1msg1_epu32( m0, m1 ), m2 ), m3 )
+
+#define SHA1_FIRST_ROUNDS( m )                                              \
+    do {                                                                    \
+        e0 = _mm_add_epi32( e0, m );                                        \
+        e1 = abcd;                                                          \
+        abcd = _mm_sha1rnds4_epu32( abcd, e0, SHA1_F0 );                    \
+    } while( 0 )
+
+#define SHA1_ROUNDS( e_in, e_out, m, f )                                    \
+    do {                                                                    \
+        e_in = _mm_sha1nexte_epu32( e_in, m );                              \
+        e_out = abcd;                                                       \
+        abcd = _mm_sha1rnds4_epu32( abcd, e_in, f );                        \
+    } while( 0 )
+
+SHAEXT_X86_TARGET
+void mbedtls_shaext_sha1_process( uint32_t state[5],
+                                  const unsigned char *data,
+                                  size_t blocks )
+{
+    const __m128i mask = _mm_set_epi64x( 0x0001020304050607ULL,
+                                         0x08090a0b0c0d0e0fULL );
+    __m128i abcd, abcd_save, e0, e0_save, e1;
+    __m128i m0, m1, m2, m3;
+
+    /* A, B, C and D from the most significant word down, E on top */
+    abcd = _mm_shuffle_epi32(
+               _mm_loadu_si128( (const __m128i *) state ), 0x1B );
+    e0 = _mm_set_epi32( (int) state[4], 0, 0, 0 );
+
+    for( ; blocks > 0; blocks--, data += 64 )
+    {
+        abcd_save = abcd;
+        e0_save = e0;
+
+        SHA1_LOAD( m0, 0 );
+        SHA1_LOAD( m1, 1 );
+        SHA1_LOAD( m2, 2 );
+        SHA1_LOAD( m3, 3 );
+
+        SHA1_GROUPS;
+
+        e0 = _mm_sha1nexte_epu32( e0, e0_save );
+        abcd = _mm_add_epi32( abcd, abcd_save );
+    }
+
+    _mm_storeu_si128( (__m128i *) state, _mm_shuffle_epi32( abcd, 0x1B ) );
+    state[4] = (uint32_t) _mm_extract_epi32( e0, 3 );
+}
+
+#define SHA256_LOAD( m, n )                                                 \
+    m = _mm_shuffle_epi8( _mm_loadu_si128(                                  \
+            (const __m128i *) ( data + 16 * ( n ) ) ), mask )
+
+#define SHA256_SCHED( m0, m1, m2, m3 )                                      \
+    m0 = _mm_sha256msg2_epu32( _mm_add_epi32(                               \
+            _mm_sha256msg1_epu32( m0, m1 ),                                 \
+            _mm_alignr_epi8( m3, m2, 4 ) ), m3 )
+
+#define SHA256_ROUNDS( m, k )                                               \
+    do {                                                                    \
+        msg = _mm_add_epi32( m,                                             \
+                  _mm_loadu_si128( (const __m128i *) ( K256 + ( k ) ) ) );  \
+        cdgh = _mm_sha256rnds2_epu32( cdgh, abef, msg );                    \
+        abef = _mm_sha256rnds2_epu32( abef, cdgh,                           \
+                                      _mm_shuffle_epi32( msg, 0x0E ) );     \
+    } while( 0 )
+
+SHAEXT_X86_TARGET
+void mbedtls_shaext_sha256_process( uint32_t state[8],
+                                    const unsigned char *data,
+                                    size_t blocks )
+{
+    const __m128i mask = _mm_set_epi64x( 0x0c0d0e0f08090a0bULL,
+                                         0x0405060700010203ULL );
+    __m128i abef, abef_save, cdgh, cdgh_save, msg, tmp;
+    __m128i m0, m1, m2, m3;
+    int i;
+
+    /* SHA256RNDS2 takes the state as A, B, E, F and C, D, G, H */
+    tmp = _mm_shuffle_epi32(
+              _mm_loadu_si128( (const __m128i *) state ), 0xB1 );
+    cdgh = _mm_shuffle_epi32(
+               _mm_loadu_si128( (const __m128i *) ( state + 4 ) ), 0x1B );
+    abef = _mm_alignr_epi8( tmp, cdgh, 8 );
+    cdgh = _mm_blend_epi16( cdgh, tmp, 0xF0 );
+
+    for( ; blocks > 0; blocks--, data += 64 )
+    {
+        abef_save = abef;
+        cdgh_save = cdgh;
+
+        SHA256_LOAD( m0, 0 ); SHA256_ROUNDS( m0, 0 );
+        SHA256_LOAD( m1, 1 ); SHA256_ROUNDS( m1, 4 );
+        SHA256_LOAD( m2, 2 ); SHA256_ROUNDS( m2, 8 );
+        SHA256_LOAD( m3, 3 ); SHA256_ROUNDS( m3, 12 );
+
+        SHA256_GROUPS;
+
+        abef = _mm_add_epi32( abef, abef_save );
+        cdgh = _mm_add_epi32( cdgh, cdgh_save );
+    }
+
+    tmp = _mm_shuffle_epi32( abef, 0x1B );
+    cdgh = _mm_shuffle_epi32( cdgh, 0xB1 );
+    _mm_storeu_si128( (__m128i *) state, _mm_blend_epi16( tmp, cdgh, 0xF0 ) );
+    _mm_storeu_si128( (__m128i *) ( state + 4 ),
+                      _mm_alignr_epi8( cdgh, tmp, 8 ) );
+}
+
+#endif /* MBEDTLS_HAVE_SHAEXT_X86 */
+
+#if defined(MBEDTLS_HAVE_SHAEXT_A64)
+
+#if defined(__linux__)
+#include <sys/auxv.h>
+#endif
+
+#if !defined(HWCAP_SHA1)
+#define HWCAP_SHA1  ( 1 << 5 )
+#endif
+#if !defined(HWCAP_SHA2)
+#define HWCAP_SHA2  ( 1 << 6 )
+#endif
+
+/*
+ * Cryptographic Extension support detection routine (the instructions are
+ * always present if the compiler targets them, and in Apple CPUs)
+ */
+int mbedtls_shaext_has_support( unsigned int what )
+{
+    static int done = 0;
+    static unsigned int flags = 0;
+
+    if( ! done )
+    {
+#if defined(__ARM_FEATURE_CRYPTO) || defined(__APPLE__)
+        flags = MBEDTLS_SHAEXT_SHA1 | MBEDTLS_SHAEXT_SHA256;
+#elif defined(__linux__)
+        unsigned long hwcap = getauxval( AT_HWCAP );
+
+        if( ( hwcap & HWCAP_SHA1 ) != 0 )
+            flags |= MBEDTLS_SHAEXT_SHA1;
+        if( ( hwcap & HWCAP_SHA2 ) != 0 )
+            flags |= MBEDTLS_SHAEXT_SHA256;
+#endif
+        done = 1;
+    }
+
+    return( ( flags & what ) != 0 );
+}
+
+/*
+ * The intrinsics need the Cryptographic Extension enabled for the functions
+ * that use them (and before arm_neon.h is included)
+ */
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("crypto"))), apply_to=function)
+#else
+#pragma GCC push_options
+#pragma GCC target ("arch=armv8-a+crypto")
+#endif
+
+#include <arm_neon.h>
+
+#define SHA1_F0 0x5A827999
+#define SHA1_F1 0x6ED9EBA1
+#define SHA1_F2 0x8F1BBCDC
+#define SHA1_F3 0xCA62C1D6
+
+#define SHA1_LOAD( m, n )                                                   \
+    m = vreinterpretq_u32_u8( vrev32q_u8( vld1q_u8( data + 16 * ( n ) ) ) )
+
+#define SHA1_SCHED( m0, m1, m2, m3 )                                        \
+    m0 = vsha1su1q_u32( vsha1su0q_u32( m0, m1, m2 ), m3 )
+
+/* The round function of each group comes from its constant */
+#define SHA1_A64_HASH( abcd, e, wk, f )                                     \
+    ( ( f ) == SHA1_F0 ? vsha1cq_u32( abcd, e, wk ) :                       \
+      ( f ) == SHA1_F2 ? vsha1mq_u32( abcd, e, wk ) :                       \
+                         vsha1pq_u32( abcd, e, wk ) )
+
+#define SHA1_ROUNDS( e_in, e_out, m, f )                                    \
+    do {                                                                    \
+        e_out = vsha1h_u32( vgetq_lane_u32( abcd, 0 ) );                    \
+        abcd = SHA1_A64_HASH( abcd, e_in,                                   \
+                              vaddq_u32( m, vdupq_n_u32( f ) ), f );        \
+    } while( 0 )
+
+#define SHA1_FIRST_ROUNDS( m )    SHA1_ROUNDS( e0, e1, m, SHA1_F0 )
+
+void mbedtls_shaext_sha1_process( uint32_t state[5],
+                                  const unsigned char *data,
+                                  size_t blocks )
+{
+    uint32x4_t abcd, abcd_save;
+    uint32x4_t m0, m1, m2, m3;
+    uint32_t e0, e0_save, e1;
+
+    abcd = vld1q_u32( state );
+    e0 = state[4];
+
+    for( ; blocks > 0; blocks--, data += 64 )
+    {
+        abcd_save = abcd;
+        e0_save = e0;
+
+        SHA1_LOAD( m0, 0 );
+        SHA1_LOAD( m1, 1 );
+        SHA1_LOAD( m2, 2 );
+        SHA1_LOAD( m3, 3 );
+
+        SHA1_GROUPS;
+
+        e0 += e0_save;
+        abcd = vaddq_u32( abcd, abcd_save );
+    }
+
+    vst1q_u32( state, abcd );
+    state[4] = e0;
+}
+
+#define SHA256_LOAD( m, n )                                                 \
+    m = vreinterpretq_u32_u8( vrev32q_u8( vld1q_u8( data + 16 * ( n ) ) ) )
+
+#define SHA256_SCHED( m0, m1, m2, m3 )                                      \
+    m0 = vsha256su1q_u32( vsha256su0q_u32( m0, m1 ), m2, m3 )
+
+#define SHA256_ROUNDS( m, k )                                               \
+    do {                                                                    \
+        msg = vaddq_u32( m, vld1q_u32( K256 + ( k ) ) );                    \
+        tmp = abcd;                                                         \
+        abcd = vsha256hq_u32( abcd, efgh, msg );                            \
+        efgh = vsha256h2q_u32( efgh, tmp, msg );                            \
+    } while( 0 )
+
+void mbedtls_shaext_sha256_process( uint32_t state[8],
+                                    const unsigned char *data,
+                                    size_t blocks )
+{
+    uint32x4_t abcd, abcd_save, efgh, efgh_save, msg, tmp;
+    uint32x4_t m0, m1, m2, m3;
+    int i;
+
+    abcd = vld1q_u32( state );
+    efgh = vld1q_u32( state + 4 );
+
+    for( ; blocks > 0; blocks--, data += 64 )
+    {
+        abcd_save = abcd;
+        efgh_save = efgh;
+
+        SHA256_LOAD( m0, 0 ); SHA256_ROUNDS( m0, 0 );
+        SHA256_LOAD( m1, 1 ); SHA256_ROUNDS( m1, 4 );
+        SHA256_LOAD( m2, 2 ); SHA256_ROUNDS( m2, 8 );
+        SHA256_LOAD( m3, 3 ); SHA256_ROUNDS( m3, 12 );
+
+        SHA256_GROUPS;
+
+        abcd = vaddq_u32( abcd, abcd_save );
+        efgh = vaddq_u32( efgh, efgh_save );
+    }
+
+    vst1q_u32( state, abcd );
+    vst1q_u32( state + 4, efgh );
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#endif /* MBEDTLS_HAVE_SHAEXT_A64 */
+
+#endif /* MBEDTLS_HAVE_SHAEXT */
+
+#endif /* MBEDTLS_SHAEXT_C */
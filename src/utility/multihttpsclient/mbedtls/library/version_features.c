@@ -702,6 +702,9 @@ static const char *features[] = {
 #if defined(MBEDTLS_SHA512_C)
     "MBEDTLS_SHA512_C",
 #endif /* MBEDTLS_SHA512_C */
+#if defined(MBEDTLS_SHAEXT_C)
+    "MBEDTLS_SHAEXT_C",
+#endif /* MBEDTLS_SHAEXT_C */
 #if defined(MBEDTLS_SSL_CACHE_C)
     "MBEDTLS_SSL_CACHE_C",
 #endif /* MBEDTLS_SSL_CACHE_C */
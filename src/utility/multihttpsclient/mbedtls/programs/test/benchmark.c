@@ -58,6 +58,9 @@ int main( void )
 #include "mbedtls/sha1.h"
 #include "mbedtls/sha256.h"
 #include "mbedtls/sha512.h"
+#if defined(MBEDTLS_SHAEXT_C)
+#include "mbedtls/shaext.h"
+#endif
 
 #include "mbedtls/arc4.h"
 #include "mbedtls/des.h"
@@ -379,12 +382,28 @@ int main( int argc, char *argv[] )
 
 #if defined(MBEDTLS_SHA1_C)
     if( todo.sha1 )
+    {
+#if defined(MBEDTLS_SHAEXT_C) && defined(MBEDTLS_HAVE_SHAEXT)
+        if( mbedtls_shaext_has_support( MBEDTLS_SHAEXT_SHA1 ) )
+            TIME_AND_TSC( "SHA-1 (SHA ext)",
+                          mbedtls_sha1_ret( buf, BUFSIZE, tmp ) );
+        else
+#endif
         TIME_AND_TSC( "SHA-1", mbedtls_sha1_ret( buf, BUFSIZE, tmp ) );
+    }
 #endif
 
 #if defined(MBEDTLS_SHA256_C)
     if( todo.sha256 )
+    {
+#if defined(MBEDTLS_SHAEXT_C) && defined(MBEDTLS_HAVE_SHAEXT)
+        if( mbedtls_shaext_has_support( MBEDTLS_SHAEXT_SHA256 ) )
+            TIME_AND_TSC( "SHA-256 (SHA ext)",
+                          mbedtls_sha256_ret( buf, BUFSIZE, tmp, 0 ) );
+        else
+#endif
         TIME_AND_TSC( "SHA-256", mbedtls_sha256_ret( buf, BUFSIZE, tmp, 0 ) );
+    }
 #endif
 
 #if defined(MBEDTLS_SHA512_C)
@@ -0,0 +1,65 @@
+/**************************************************************************************************/
+// File: multihttpsclient_async.cpp
+// Description: Portable driver of HALs non-blocking operations. It waits for the connection socket
+//              to be ready (select()) between poll() calls, so each connection and request step
+//              runs as soon as the socket allows it, and the caller sleeps in between.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Check Build System (Arduino clients has no socket to wait for) */
+
+#if !defined(ARDUINO)
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "multihttpsclient_async.h"
+
+#include <stddef.h>
+
+#if defined(WIN32) || defined(_WIN32) // Windows
+    #include <winsock2.h>
+#else // Linux and ESP-IDF (lwIP sockets)
+    #include <sys/select.h>
+    #include <sys/time.h>
+#endif
+
+/**************************************************************************************************/
+
+/* Functions */
+
+// Wait until a socket is readable (or writable) or the timeout expires
+// Returns HTTP_SOCKET_READY, HTTP_SOCKET_TIMEOUT or HTTP_SOCKET_ERROR
+// Note: A socket with a pending error (i.e. a refused connection) is reported as ready, so the
+// operation that waits for it gets the error
+int8_t http_socket_wait(const int socket, const bool write, const unsigned long timeout_ms)
+{
+    fd_set fds;
+    struct timeval tv;
+    int ret;
+
+    if(socket < 0)
+        return HTTP_SOCKET_ERROR;
+
+    FD_ZERO(&fds);
+    FD_SET(socket, &fds);
+    tv.tv_sec = (long)(timeout_ms / 1000);
+    tv.tv_usec = (long)((timeout_ms % 1000) * 1000);
+    if(write)
+        ret = select(socket + 1, NULL, &fds, NULL, &tv);
+    else
+        ret = select(socket + 1, &fds, NULL, NULL, &tv);
+
+    if(ret > 0)
+        return HTTP_SOCKET_READY;
+    if(ret == 0)
+        return HTTP_SOCKET_TIMEOUT;
+    return HTTP_SOCKET_ERROR;
+}
+
+/**************************************************************************************************/
+
+#endif
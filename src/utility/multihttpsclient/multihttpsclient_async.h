@@ -0,0 +1,64 @@
+/**************************************************************************************************/
+// File: multihttpsclient_async.h
+// Description: Portable driver of HALs non-blocking operations. It waits for the connection socket
+//              to be ready (select()) between poll() calls, so each connection and request step
+//              runs as soon as the socket allows it, and the caller sleeps in between.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef MULTIHTTPSCLIENTASYNC_H_
+#define MULTIHTTPSCLIENTASYNC_H_
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <stdint.h>
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Non-blocking operations poll() results
+#define ASYNC_ERROR       -1
+#define ASYNC_IN_PROGRESS  0
+#define ASYNC_DONE         1
+
+// http_socket_wait() results
+#define HTTP_SOCKET_ERROR   -1
+#define HTTP_SOCKET_TIMEOUT  0
+#define HTTP_SOCKET_READY    1
+
+/**************************************************************************************************/
+
+/* Functions */
+
+#if !defined(ARDUINO)
+
+// Wait until a socket is readable (or writable) or the timeout expires
+int8_t http_socket_wait(const int socket, const bool write, const unsigned long timeout_ms);
+
+// Drive a client non-blocking operation until it ends, from the result of the call that started
+// it (connect_async(), post_async() or poll()). Between poll() calls, it sleeps until the socket
+// is ready for what the operation is waiting for, or until the operation timeout expires
+template <class client_t>
+int8_t http_async_run(client_t* client, int8_t result)
+{
+    while(result == ASYNC_IN_PROGRESS)
+    {
+        http_socket_wait(client->get_socket(), client->poll_wants_write(),
+            client->poll_time_left());
+        result = client->poll();
+    }
+    return result;
+}
+
+#endif
+
+/**************************************************************************************************/
+
+#endif
@@ -0,0 +1,55 @@
+/**************************************************************************************************/
+// File: multihttpsclient_counters.h
+// Description: Optional HTTPS client traffic counters (build with MULTIHTTPSCLIENT_COUNTERS).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef MULTIHTTPSCLIENTCOUNTERS_H_
+#define MULTIHTTPSCLIENTCOUNTERS_H_
+
+/**************************************************************************************************/
+
+/* Libraries Configurations */
+
+// Enable traffic counters if uTLGBot metrics are enabled
+#if defined(UTLGBOT_METRICS) && !defined(MULTIHTTPSCLIENT_COUNTERS)
+    #define MULTIHTTPSCLIENT_COUNTERS
+#endif
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <stdint.h>
+
+/**************************************************************************************************/
+
+/* Data Types */
+
+// Traffic counters since last clear
+typedef struct http_counters
+{
+    uint32_t bytes_out;
+    uint32_t bytes_in;
+    uint16_t handshakes_full;
+    uint16_t handshakes_resumed;
+} http_counters;
+
+/**************************************************************************************************/
+
+/* Counters Macros (no code at all if counters are disabled) */
+
+// Note: Each HAL provides a http_counters _counters attribute
+#ifdef MULTIHTTPSCLIENT_COUNTERS
+    #define _counter_add(counter, n) do { _counters.counter = _counters.counter + (n); } while(0)
+#else
+    #define _counter_add(counter, n) do { } while(0)
+#endif
+
+/**************************************************************************************************/
+
+#endif
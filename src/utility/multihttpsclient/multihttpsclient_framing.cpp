@@ -0,0 +1,310 @@
+/**************************************************************************************************/
+// File: multihttpsclient_framing.cpp
+// Description: Portable HTTP/1.1 response framing parser. It tells when a response has been fully
+//              received from its framing (Content-Length, chunked transfer encoding or a status
+//              without body), so HALs doesn't need to wait for an idle time after last bytes.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "multihttpsclient_framing.h"
+
+#include <ctype.h>
+#include <string.h>
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Header end sequence
+#define HEADER_END "\r\n\r\n"
+#define HEADER_END_LENGTH 4
+
+// Maximum chunk size before adding next hex digit (to detect overflow)
+#define CHUNK_SIZE_MAX_SHIFTABLE (((size_t)-1) >> 4)
+
+/**************************************************************************************************/
+
+/* Response Framing Parser */
+
+// Framing parser constructor
+http_response_framing::http_response_framing(void)
+{
+    reset();
+}
+
+// Reset the parser to start a new response
+void http_response_framing::reset(void)
+{
+    _state = FRAMING_HEADER;
+    _offset = 0;
+    _header_length = 0;
+    _remaining = 0;
+    _line_length = 0;
+    _header_end_match = 0;
+    _chunk_size_digits = false;
+}
+
+// Parse the new received bytes of the response (response is the whole response received so far,
+// it doesn't need to be NUL terminated), and get if the response has been fully received
+uint8_t http_response_framing::update(const char* response, const size_t length)
+{
+    size_t n;
+
+    while((_offset < length) && (_state != FRAMING_COMPLETE) && (_state != FRAMING_ERROR))
+    {
+        switch(_state)
+        {
+            // Look for header end, and get response framing from header fields
+            case FRAMING_HEADER:
+                if(response[_offset] == HEADER_END[_header_end_match])
+                    _header_end_match = _header_end_match + 1;
+                else
+                    _header_end_match = (response[_offset] == '\r') ? 1 : 0;
+                _offset = _offset + 1;
+                if(_header_end_match == HEADER_END_LENGTH)
+                {
+                    _header_length = _offset;
+                    parse_header(response);
+                }
+                break;
+
+            // Content-Length body
+            case FRAMING_LENGTH:
+                n = length - _offset;
+                if(n > _remaining)
+                    n = _remaining;
+                _offset = _offset + n;
+                _remaining = _remaining - n;
+                if(_remaining == 0)
+                    _state = FRAMING_COMPLETE;
+                break;
+
+            // Body without framing, response ends when server closes the connection
+            case FRAMING_UNTIL_CLOSE:
+                _offset = length;
+                break;
+
+            // Chunked body
+            default:
+                _offset = _offset + parse_chunked(response + _offset, length - _offset);
+                break;
+        }
+    }
+
+    if(_state == FRAMING_COMPLETE)
+        return HTTP_FRAMING_COMPLETE;
+    if(_state == FRAMING_ERROR)
+        return HTTP_FRAMING_ERROR;
+    return HTTP_FRAMING_INCOMPLETE;
+}
+
+// Check if response end is just given by the server closing the connection (response without
+// framing, or with an invalid one)
+bool http_response_framing::until_close(void)
+{
+    return ((_state == FRAMING_UNTIL_CLOSE) || (_state == FRAMING_ERROR));
+}
+
+// Get response header length (0 if header has not been fully received yet)
+size_t http_response_framing::header_length(void)
+{
+    return _header_length;
+}
+
+// Check if a header line starts with given field name (name must be lowercase)
+bool http_response_framing::header_field_is(const char* line, const char* name)
+{
+    while(*name != '\0')
+    {
+        if(tolower((unsigned char)*line) != *name)
+            return false;
+        line = line + 1;
+        name = name + 1;
+    }
+    return true;
+}
+
+/**************************************************************************************************/
+
+/* Private Methods */
+
+// Get response framing from its header (Transfer-Encoding chunked takes precedence over
+// Content-Length, and 1xx, 204 and 304 status responses have no body)
+void http_response_framing::parse_header(const char* header)
+{
+    const char* header_end = header + _header_length - HEADER_END_LENGTH;
+    const char* line = header;
+    const char* value;
+    unsigned long status = 0;
+    size_t content_length = 0;
+    bool has_length = false;
+    bool chunked = false;
+
+    // Status line ("HTTP/1.1 200 OK")
+    if(header_field_is(line, "http/"))
+    {
+        value = (const char*)memchr(line, ' ', header_end - line);
+        while((value != NULL) && (value < header_end) && isdigit((unsigned char)*(++value)))
+            status = (status * 10) + (*value - '0');
+    }
+
+    // Header fields (one per line until header end)
+    while(line < header_end)
+    {
+        line = (const char*)memchr(line, '\n', header_end - line);
+        if(line == NULL)
+            break;
+        line = line + 1;
+        if(header_field_is(line, "content-length:"))
+        {
+            value = line + strlen("content-length:");
+            while((*value == ' ') || (*value == '\t'))
+                value = value + 1;
+            has_length = isdigit((unsigned char)*value);
+            content_length = 0;
+            while(isdigit((unsigned char)*value))
+            {
+                content_length = (content_length * 10) + (*value - '0');
+                value = value + 1;
+            }
+        }
+        else if(header_field_is(line, "transfer-encoding:"))
+        {
+            for(value = line + strlen("transfer-encoding:"); *value != '\r'; value++)
+            {
+                if(header_field_is(value, "chunked"))
+                    chunked = true;
+            }
+        }
+    }
+
+    if(((status >= 100) && (status < 200)) || (status == 204) || (status == 304))
+        _state = FRAMING_COMPLETE;
+    else if(chunked)
+    {
+        _state = FRAMING_CHUNK_SIZE;
+        _remaining = 0;
+        _chunk_size_digits = false;
+    }
+    else if(has_length)
+    {
+        _remaining = content_length;
+        _state = (_remaining == 0) ? FRAMING_COMPLETE : FRAMING_LENGTH;
+    }
+    else
+        _state = FRAMING_UNTIL_CLOSE;
+}
+
+// Parse chunked body bytes (size line, data and CRLF of each chunk, and the trailer fields after
+// last zero size chunk), and get the number of parsed bytes
+size_t http_response_framing::parse_chunked(const char* data, const size_t length)
+{
+    size_t i = 0;
+    size_t n;
+    int8_t digit;
+    char c;
+
+    while((i < length) && (_state != FRAMING_COMPLETE) && (_state != FRAMING_ERROR))
+    {
+        c = data[i];
+        switch(_state)
+        {
+            case FRAMING_CHUNK_SIZE:
+                digit = hex_value(c);
+                if((digit >= 0) && (_remaining > CHUNK_SIZE_MAX_SHIFTABLE))
+                    _state = FRAMING_ERROR;
+                else if(digit >= 0)
+                {
+                    _remaining = (_remaining << 4) | (size_t)digit;
+                    _chunk_size_digits = true;
+                }
+                else if(!_chunk_size_digits)
+                    _state = FRAMING_ERROR;
+                else if((c == ';') || (c == ' ') || (c == '\t'))
+                    _state = FRAMING_CHUNK_EXTENSION;
+                else if(c == '\r')
+                    _state = FRAMING_CHUNK_SIZE_LF;
+                else
+                    _state = FRAMING_ERROR;
+                i = i + 1;
+                break;
+
+            case FRAMING_CHUNK_EXTENSION:
+                if(c == '\r')
+                    _state = FRAMING_CHUNK_SIZE_LF;
+                i = i + 1;
+                break;
+
+            case FRAMING_CHUNK_SIZE_LF:
+                if(c != '\n')
+                    _state = FRAMING_ERROR;
+                else if(_remaining == 0)
+                {
+                    _state = FRAMING_TRAILER;
+                    _line_length = 0;
+                }
+                else
+                    _state = FRAMING_CHUNK_DATA;
+                i = i + 1;
+                break;
+
+            case FRAMING_CHUNK_DATA:
+                n = length - i;
+                if(n > _remaining)
+                    n = _remaining;
+                i = i + n;
+                _remaining = _remaining - n;
+                if(_remaining == 0)
+                    _state = FRAMING_CHUNK_DATA_CR;
+                break;
+
+            case FRAMING_CHUNK_DATA_CR:
+                _state = (c == '\r') ? FRAMING_CHUNK_DATA_LF : FRAMING_ERROR;
+                i = i + 1;
+                break;
+
+            case FRAMING_CHUNK_DATA_LF:
+                _state = (c == '\n') ? FRAMING_CHUNK_SIZE : FRAMING_ERROR;
+                _chunk_size_digits = false;
+                i = i + 1;
+                break;
+
+            // Trailer fields lines, up to an empty line
+            case FRAMING_TRAILER:
+                if(c == '\n')
+                {
+                    if(_line_length == 0)
+                        _state = FRAMING_COMPLETE;
+                    _line_length = 0;
+                }
+                else if(c != '\r')
+                    _line_length = _line_length + 1;
+                i = i + 1;
+                break;
+
+            default:
+                _state = FRAMING_ERROR;
+                break;
+        }
+    }
+
+    return i;
+}
+
+// Get the value of an hexadecimal digit (-1 if it is not an hexadecimal digit)
+int8_t http_response_framing::hex_value(const char c)
+{
+    if((c >= '0') && (c <= '9'))
+        return (int8_t)(c - '0');
+    if((c >= 'a') && (c <= 'f'))
+        return (int8_t)(c - 'a' + 10);
+    if((c >= 'A') && (c <= 'F'))
+        return (int8_t)(c - 'A' + 10);
+    return -1;
+}
+
+/**************************************************************************************************/
@@ -0,0 +1,80 @@
+/**************************************************************************************************/
+// File: multihttpsclient_framing.h
+// Description: Portable HTTP/1.1 response framing parser. It tells when a response has been fully
+//              received from its framing (Content-Length, chunked transfer encoding or a status
+//              without body), so HALs doesn't need to wait for an idle time after last bytes.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef MULTIHTTPSCLIENTFRAMING_H_
+#define MULTIHTTPSCLIENTFRAMING_H_
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// update() results
+#define HTTP_FRAMING_INCOMPLETE 0 // More bytes are expected
+#define HTTP_FRAMING_COMPLETE   1 // Full response received
+#define HTTP_FRAMING_ERROR      2 // Invalid framing (response end is unknown)
+
+/**************************************************************************************************/
+
+/* Response Framing Parser */
+
+// Incremental parser of a response that is being received into a contiguous buffer: each
+// update() call gets the whole response received so far, and just parses the new bytes
+class http_response_framing
+{
+    public:
+        http_response_framing();
+        void reset();
+        uint8_t update(const char* response, const size_t length);
+        bool until_close();
+        size_t header_length();
+        static bool header_field_is(const char* line, const char* name);
+
+    private:
+        typedef enum framing_state
+        {
+            FRAMING_HEADER,
+            FRAMING_LENGTH,
+            FRAMING_UNTIL_CLOSE,
+            FRAMING_CHUNK_SIZE,
+            FRAMING_CHUNK_EXTENSION,
+            FRAMING_CHUNK_SIZE_LF,
+            FRAMING_CHUNK_DATA,
+            FRAMING_CHUNK_DATA_CR,
+            FRAMING_CHUNK_DATA_LF,
+            FRAMING_TRAILER,
+            FRAMING_COMPLETE,
+            FRAMING_ERROR
+        } framing_state;
+
+        framing_state _state;
+        size_t _offset;
+        size_t _header_length;
+        size_t _remaining;
+        size_t _line_length;
+        uint8_t _header_end_match;
+        bool _chunk_size_digits;
+
+        void parse_header(const char* header);
+        size_t parse_chunked(const char* data, const size_t length);
+        static int8_t hex_value(const char c);
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -23,15 +23,27 @@
     #define _println(x) do { if(_debug) Serial.println(x); } while(0)
     #define _printf(...) do { if(_debug) Serial.printf(__VA_ARGS__); } while(0)
 #else
-    #define _print(x)
-    #define _println(x)
-    #define _printf(...)
+    #define _print(x) do { } while(0)
+    #define _println(x) do { } while(0)
+    #define _printf(...) do { } while(0)
 #endif
 
+// Requests and responses go to the log ring instead (no slow synchronous prints while requesting)
+#ifndef MULTIHTTPSCLIENT_NO_DEBUG
+    #define _log(level, phase, data, length) \
+        do { if(_debug) http_log_write(level, phase, data, length); } while(0)
+#else
+    #define _log(level, phase, data, length) do { } while(0)
+#endif
+
+// Trace points of this client (no code at all if trace is disabled)
+#define _trace(point, arg) HTTP_TRACE(point, this, arg)
+
 #define sscanf_P(...) do { sscanf(__VA_ARGS__); } while(0)
 
-#define _millis_setup()
+#define _millis_setup() do { } while(0)
 #define _millis() millis()
+#define _micros() micros()
 #define _delay(x) delay(x)
 #define _yield() yield()
 
@@ -44,8 +56,11 @@ MultiHTTPSClient::MultiHTTPSClient(void)
 {
     _debug = false;
     _connected = false;
-    _http_header[0] = '\0';
     _cert_https_server = NULL;
+    _cert_der = NULL;
+    clear_timings();
+    clear_counters();
+    memset(&_memory, 0, sizeof(_memory));
 #if defined(ESP8266)
     _client.setBufferSizes(512, 512);
 #endif
@@ -89,28 +104,63 @@ void MultiHTTPSClient::set_cert(const char* cert_https_server)
     {   _client.setInsecure();   }
 }
 
+// Setup Server Certificate from DER data (no base64 decoding)
+bool MultiHTTPSClient::set_cert_der(const uint8_t* ca_der, const size_t ca_der_len)
+{
+    #ifdef ESP8266
+        _cert_https_server = NULL;
+        _cert_der = ca_der;
+        if(!_cert.append(ca_der, ca_der_len))
+        {
+            _println(F("[HTTPS] Error: Cannot load DER certificate."));
+            return false;
+        }
+        _client.setTrustAnchors(&_cert);
+        return true;
+    #else
+        // ESP32 WiFiClientSecure just supports PEM certificates
+        _println(F("[HTTPS] Error: DER certificates are not supported, use set_cert()."));
+        return false;
+    #endif
+}
+
 // Make HTTPS client connection to server
 int8_t MultiHTTPSClient::connect(const char* host, uint16_t port)
 {
+    // Note: DNS, TCP connection and TLS handshake are done inside WiFiClientSecure, so all of
+    // them are measured as TLS handshake phase (and traced as a single connect span)
+    _memory_scope();
+    _timing_start();
+    _trace(CONNECT_BEGIN, 0);
     int8_t conn_result = _client.connect(host, port);
     if(conn_result)
+    {
+        _timing_phase(HTTP_PHASE_TLS_HANDSHAKE);
+        _counter_add(handshakes_full, 1);
         _connected = true;
+    }
     else
     {
         _connected = false;
 
         // Connection fail, if we are in ESP8266 and cert is configured
         #ifdef ESP8266
-            if(_cert_https_server != NULL)
+            if((_cert_https_server != NULL) || (_cert_der != NULL))
             {
                 // Set system clock from a NTP server to verify certs
                 setClock();
+                _timing_start();
                 conn_result = _client.connect(host, port);
                 if(conn_result)
+                {
+                    _timing_phase(HTTP_PHASE_TLS_HANDSHAKE);
+                    _counter_add(handshakes_full, 1);
                     _connected = true;
+                }
             }
         #endif
     }
+    _trace(CONNECT_END, _connected);
 
     return _connected;
 }
@@ -118,6 +168,7 @@ int8_t MultiHTTPSClient::connect(const char* host, uint16_t port)
 // HTTPS client disconnect from server
 void MultiHTTPSClient::disconnect(void)
 {
+    _memory_scope();
     _client.stop();
     _connected = false;
 }
@@ -133,31 +184,37 @@ bool MultiHTTPSClient::is_connected(void)
 uint8_t MultiHTTPSClient::get(const char* uri, const char* host, char* response,
         const size_t response_len, const unsigned long response_timeout)
 {
-    // Lets use response buffer for make the request first (for the sake of save memory)
-    char* request = response;
+    const char* request;
     uint8_t rc = 1;
+    _memory_scope();
 
-    // Create header request
-    snprintf_P(request, HTTP_HEADER_MAX_LENGTH, PSTR("GET %s HTTP/1.1\r\nHost: %s\r\n" \
-        "User-Agent: MultiHTTPSClient\r\nAccept: text/html,application/xml,application/json" \
-        "\r\n\r\n"), uri, host);
+    // Create header request (from the templates)
+    if(_header.build(HTTP_METHOD_GET, uri, host) == 0)
+    {
+        _println(F("[HTTPS] Error: HTTP request header doesn't fit."));
+        return 1;
+    }
+    request = _header.get();
 
     // Send request
-    _println(F("HTTP GET request to send: "));
-    _println(request);
-    _println();
+    _log(HTTP_LOG_DEBUG, HTTP_PHASE_WRITE, request, strlen(request));
+    _timing_start();
+    _trace(WRITE_BEGIN, 0);
     if(write(request) != strlen(request))
     {
         _println(F("[HTTPS] Error: Incomplete HTTP request sent (sent less bytes than expected)."));
+        _trace(WRITE_END, 0);
         return 1;
     }
+    _timing_phase(HTTP_PHASE_WRITE);
+    _trace(WRITE_END, strlen(request));
     _println(F("[HTTPS] GET request successfully sent."));
     memset(response, '\0', response_len);
 
     // Wait and read response
     _println(F("[HTTPS] Waiting for response..."));
     rc = read_response(response, response_len, response_timeout);
-    _printf("[HTTPS] Response: %s\n\n", response);
+    _log(HTTP_LOG_DEBUG, HTTP_PHASE_TRANSFER, response, strlen(response));
 
     return rc;
 }
@@ -169,40 +226,90 @@ uint8_t MultiHTTPSClient::post(const char* uri, const char* host, char* request_
         const size_t request_len, const size_t request_response_max_size,
         const unsigned long response_timeout)
 {
+    size_t request_size;
+    bool sent;
     uint8_t rc = 1;
+    _memory_scope();
 
-    // Create header request
-    snprintf_P(_http_header, HTTP_HEADER_MAX_LENGTH, PSTR("POST %s HTTP/1.1\r\nHost: %s\r\n" \
-        "User-Agent: MultiHTTPSClient\r\nAccept: text/html,application/xml,application/json" \
-        "\r\nContent-Type: application/json\r\nContent-Length: %" PRIu64 "\r\n\r\n"), uri,
-        host, (uint64_t)request_len);
-
-    // Send request
-    _println(F("HTTP POST request to send: "));
-    _println(_http_header);
-    _println(request_response);
-    _println();
-    if(write(_http_header) != strlen(_http_header))
+    // Create header request (from the templates)
+    if(_header.build(HTTP_METHOD_POST, uri, host, request_len) == 0)
     {
-        _println(F("[HTTPS] Error: Incomplete HTTP request sent (sent less bytes than expected)."));
+        _println(F("[HTTPS] Error: HTTP request header doesn't fit."));
         return 1;
     }
-    if(write(request_response) != strlen(request_response))
+
+    // Send request (header and body in a single write if the body buffer has room for both)
+    _log(HTTP_LOG_DEBUG, HTTP_PHASE_WRITE, _header.get(), _header.length());
+    _log(HTTP_LOG_DEBUG, HTTP_PHASE_WRITE, request_response, request_len);
+    _timing_start();
+    _trace(WRITE_BEGIN, 0);
+    request_size = _header.prepend(request_response, request_len, request_response_max_size);
+    if(request_size != 0)
+        sent = (write(request_response) == request_size);
+    else
+    {
+        sent = (write(_header.get()) == _header.length()) &&
+            (write(request_response) == strlen(request_response));
+    }
+    if(!sent)
     {
         _println(F("[HTTPS] Error: Incomplete HTTP request sent (sent less bytes than expected)."));
+        _trace(WRITE_END, 0);
         return 1;
     }
+    _timing_phase(HTTP_PHASE_WRITE);
+    _trace(WRITE_END, _header.length() + request_len);
     _println(F("[HTTPS] POST request successfully sent."));
     memset(request_response, '\0', request_response_max_size);
 
     // Wait and read response
     _println(F("[HTTPS] Waiting for response..."));
     rc = read_response(request_response, request_response_max_size, response_timeout);
-    _printf("[HTTPS] Response: %s\n\n", request_response);
+    _log(HTTP_LOG_DEBUG, HTTP_PHASE_TRANSFER, request_response, strlen(request_response));
 
     return rc;
 }
 
+// Get last connection and request phases timings (just measured in MULTIHTTPSCLIENT_TIMINGS
+// builds, check measured phases bit mask)
+const http_timings* MultiHTTPSClient::get_timings(void)
+{
+    return &_timings;
+}
+
+// Clear measured phases timings
+void MultiHTTPSClient::clear_timings(void)
+{
+    memset(&_timings, 0, sizeof(_timings));
+}
+
+// Get traffic counters since last clear (just counted in MULTIHTTPSCLIENT_COUNTERS builds)
+const http_counters* MultiHTTPSClient::get_counters(void)
+{
+    return &_counters;
+}
+
+// Clear traffic counters
+void MultiHTTPSClient::clear_counters(void)
+{
+    memset(&_counters, 0, sizeof(_counters));
+}
+
+// Get heap (mbedtls allocations) and stack usage (just accounted in MULTIHTTPSCLIENT_MEMORY_STATS
+// builds)
+const http_memory_stats* MultiHTTPSClient::get_memory_stats(void)
+{
+    return &_memory;
+}
+
+// Clear memory stats (allocations counts and stack peak, heap peak restarts from current usage)
+void MultiHTTPSClient::clear_memory_stats(void)
+{
+#ifdef MULTIHTTPSCLIENT_MEMORY_STATS
+    http_memory_clear(&_memory);
+#endif
+}
+
 /**************************************************************************************************/
 
 /* Private Methods */
@@ -216,7 +323,13 @@ void MultiHTTPSClient::release_tls_elements(void)
 // HTTPS Write
 size_t MultiHTTPSClient::write(const char* request)
 {
-    return _client.print(request);
+    size_t written_bytes;
+
+    _stack_probe();
+    written_bytes = _client.print(request);
+
+    _counter_add(bytes_out, written_bytes);
+    return written_bytes;
 }
 
 // HTTPS Read
@@ -225,6 +338,7 @@ size_t MultiHTTPSClient::read(char* response, const size_t response_len)
     char c;
     size_t i = 0;
 
+    _stack_probe();
     while(_client.available())
     {
         c = _client.read();
@@ -248,7 +362,9 @@ uint8_t MultiHTTPSClient::read_response(char* response, const size_t response_ma
     size_t num_bytes_read = 0;
     size_t total_bytes_read = 0;
     size_t response_len = response_max_len;
+    const char* response_start = response;
 
+    _framing.reset();
     t0 = _millis();
     while(true)
     {
@@ -280,8 +396,9 @@ uint8_t MultiHTTPSClient::read_response(char* response, const size_t response_ma
         }
         if(num_bytes_read == 0)
         {
-            // Check for timeout without any incomming byte
-            if(t2 != 0)
+            // Check for timeout without any incomming byte (just for responses without framing,
+            // that ends when the server closes the connection)
+            if((t2 != 0) && _framing.until_close())
             {
                 t1 = _millis();
                 if(t1 < t2)
@@ -290,17 +407,32 @@ uint8_t MultiHTTPSClient::read_response(char* response, const size_t response_ma
                 {
                     // Assume full reception
                     _println(F("[HTTPS] Response successfully received."));
+                    _trace(LAST_BYTE, total_bytes_read);
                     break;
                 }
             }
         }
         else
         {
-            _println(F("[HTTPS] Something partially received:"));
-            _println(response);
+            // First response bytes ends server wait phase, last ones ends transfer phase
+            if(total_bytes_read == num_bytes_read)
+            {
+                _timing_phase(HTTP_PHASE_WAIT);
+                _trace(FIRST_BYTE, num_bytes_read);
+            }
+            _timing_update(HTTP_PHASE_TRANSFER);
+            _counter_add(bytes_in, num_bytes_read);
             response = response + num_bytes_read;
             response_len = response_len - num_bytes_read;
             t2 = _millis();
+
+            // Check for full reception (as given by response framing)
+            if(_framing.update(response_start, total_bytes_read) == HTTP_FRAMING_COMPLETE)
+            {
+                _println(F("[HTTPS] Response successfully received."));
+                _trace(LAST_BYTE, total_bytes_read);
+                break;
+            }
         }
 
         _yield();
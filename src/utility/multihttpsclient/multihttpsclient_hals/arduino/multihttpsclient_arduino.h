@@ -26,6 +26,19 @@
 #include <stdint.h>
 #include <string.h>
 
+// Requests phases timings, traffic counters and memory accounting
+#include "../../multihttpsclient_timings.h"
+#include "../../multihttpsclient_counters.h"
+#include "../../multihttpsclient_memory.h"
+#include "../../multihttpsclient_log.h"
+#include "../../multihttpsclient_trace.h"
+
+// HTTP response framing parser
+#include "../../multihttpsclient_framing.h"
+
+// HTTP request header templates
+#include "../../multihttpsclient_header.h"
+
 /**************************************************************************************************/
 
 /* Constants */
@@ -33,12 +46,10 @@
 // HTTP response wait timeout (ms)
 #define HTTP_WAIT_RESPONSE_TIMEOUT 5000
 
-// HTTP response between bytes receptions timeout (ms)
+// HTTP response between bytes receptions timeout (ms), it ends responses without framing
+// (responses with Content-Length or chunked transfer encoding end as soon as they are received)
 #define HTTP_RESPONSE_BETWEEN_BYTES_TIMEOUT 500
 
-// HTTP Request header max length
-#define HTTP_HEADER_MAX_LENGTH 256
-
 /**************************************************************************************************/
 
 class MultiHTTPSClient
@@ -49,6 +60,7 @@ class MultiHTTPSClient
         void set_debug(const bool debug);
         void set_cert(const char* cert_https_server);
         void set_cert(const uint8_t* ca_pem_start, const uint8_t* ca_pem_end);
+        bool set_cert_der(const uint8_t* ca_der, const size_t ca_der_len);
         int8_t connect(const char* host, uint16_t port);
         void disconnect();
         bool is_connected();
@@ -58,16 +70,33 @@ class MultiHTTPSClient
                 const size_t request_len, const size_t request_response_max_size,
                 const unsigned long response_timeout=HTTP_WAIT_RESPONSE_TIMEOUT);
 
+        // Last connection and request phases timings (MULTIHTTPSCLIENT_TIMINGS builds)
+        const http_timings* get_timings();
+        void clear_timings();
+
+        // Traffic counters since last clear (MULTIHTTPSCLIENT_COUNTERS builds)
+        const http_counters* get_counters();
+        void clear_counters();
+
+        // Heap and stack usage (MULTIHTTPSCLIENT_MEMORY_STATS builds)
+        const http_memory_stats* get_memory_stats();
+        void clear_memory_stats();
+
     private:
         // Private Attributtes
-        char _http_header[HTTP_HEADER_MAX_LENGTH];
+        http_request_header _header;
         WiFiClientSecure _client;
         #ifdef ESP8266
             X509List _cert;
         #endif
         const char* _cert_https_server;
+        const uint8_t* _cert_der;
         bool _connected;
         bool _debug;
+        http_timings _timings;
+        http_counters _counters;
+        http_memory_stats _memory;
+        http_response_framing _framing;
 
         // Private Methods
         void release_tls_elements();
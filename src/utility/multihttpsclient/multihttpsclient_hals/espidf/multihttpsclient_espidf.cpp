@@ -28,18 +28,30 @@
     #define _println(x) do { if(_debug) printf("%s\n", x); } while(0)
     #define _printf(...) do { if(_debug) printf(__VA_ARGS__); } while(0)
 #else
-    #define _print(x)
-    #define _println(x)
-    #define _printf(...)
+    #define _print(x) do { } while(0)
+    #define _println(x) do { } while(0)
+    #define _printf(...) do { } while(0)
 #endif
 
+// Requests and responses go to the log ring instead (no slow synchronous prints while requesting)
+#ifndef MULTIHTTPSCLIENT_NO_DEBUG
+    #define _log(level, phase, data, length) \
+        do { if(_debug) http_log_write(level, phase, data, length); } while(0)
+#else
+    #define _log(level, phase, data, length) do { } while(0)
+#endif
+
+// Trace points of this client (no code at all if trace is disabled)
+#define _trace(point, arg) HTTP_TRACE(point, this, arg)
+
 #define F(x) x
 #define PSTR(x) x
 #define snprintf_P(...) do { snprintf(__VA_ARGS__); } while(0)
 #define sscanf_P(...) do { sscanf(__VA_ARGS__); } while(0)
 
-#define _millis_setup()
+#define _millis_setup() do { } while(0)
 #define _millis() (unsigned long)(esp_timer_get_time()/1000)
+#define _micros() (unsigned long)(esp_timer_get_time())
 #define _delay(x) do { vTaskDelay(x/portTICK_PERIOD_MS); } while(0)
 #define _yield() do { taskYIELD(); } while(0)
 
@@ -54,9 +66,22 @@ MultiHTTPSClient::MultiHTTPSClient(void)
 {
     _debug = false;
     _connected = false;
-    _http_header[0] = '\0';
     _tls = NULL;
     _tls_cfg = NULL;
+    _async_state = ASYNC_STATE_IDLE;
+    _async_host = NULL;
+    _async_port = 0;
+    _async_buffer = NULL;
+    _async_len = 0;
+    _async_body_len = 0;
+    _async_done = 0;
+    _async_max_size = 0;
+    _async_t0 = 0;
+    _async_timeout = 0;
+    _async_want_write = false;
+    clear_timings();
+    clear_counters();
+    memset(&_memory, 0, sizeof(_memory));
     set_cert(NULL, NULL);
 }
 
@@ -83,68 +108,30 @@ void MultiHTTPSClient::set_cert(const uint8_t* ca_pem_start, const uint8_t* ca_p
     _println(F("[HTTPS] Server Certificate setup."));
 }
 
+// Setup Server Certificate from DER data (esp-tls parses it without base64 decoding)
+bool MultiHTTPSClient::set_cert_der(const uint8_t* ca_der, const size_t ca_der_len)
+{
+    set_cert(NULL, NULL);
+    _tls_cfg->cacert_buf = ca_der;
+    _tls_cfg->cacert_bytes = ca_der_len;
+    return true;
+}
+
 // Make HTTPS client connection to server
+// Note: The task sleeps until the socket is ready for next connection step (no polling delays)
 int8_t MultiHTTPSClient::connect(const char* host, uint16_t port)
 {
-    unsigned long t0, t1;
-    int conn_status;
-
-    // Reserve memory for TLS (Warning, here we are dynamically reserving some memory in HEAP)
-    _tls = esp_tls_init();
-    if(!_tls)
-    {
-        _println(F("[HTTPS] Error: Cannot reserve memory for TLS."));
-        return false;
-    }
-
-    t0 = _millis();
-    conn_status = 0;
-    while(conn_status == 0)
-    {
-        t1 = _millis();
-
-        // Check for overflow
-        // Note: Due Arduino millis() return an unsigned long instead specific size type,
-        // lets just handle overflow by reseting counter (this time the timeout can
-        // be < 2*expected_timeout)
-        if(t1 < t0)
-        {
-            t0 = 0;
-            continue;
-        }
-
-        // Check for timeout
-        if(t1-t0 >= HTTP_CONNECT_TIMEOUT)
-        {
-            _println(F("[HTTPS] Error: Can't connect to server (connection timeout)."));
-            break;
-        }
-
-        // Check connection
-        conn_status = esp_tls_conn_new_async(host, strlen(host), port, _tls_cfg, _tls);
-        if(conn_status == 0) // Connection in progress
-            continue;
-        else if(conn_status == -1) // Connection Fail
-        {
-            _println(F("[HTTPS] Error: Can't connect to server (connection fail)."));
-            break;
-        }
-        else if(conn_status == 1) // Connection Success
-        {
-            _connected = true;
-            break;
-        }
-
-        // Release CPU usage
-        _delay(10);
-    }
+    _memory_scope();
 
+    http_async_run(this, connect_async(host, port));
     return is_connected();
 }
 
 // HTTPS client disconnect from server
 void MultiHTTPSClient::disconnect(void)
 {
+    _memory_scope();
+
     if(_tls != NULL)
     {
         esp_tls_conn_destroy(_tls);
@@ -163,29 +150,37 @@ bool MultiHTTPSClient::is_connected(void)
 uint8_t MultiHTTPSClient::get(const char* uri, const char* host, char* response,
         const size_t response_len, const unsigned long response_timeout)
 {
-    // Lets use response buffer for make the request first (for the sake of save memory)
-    char* request = response;
+    const char* request;
     uint8_t rc = 1;
+    _memory_scope();
 
-    // Create header request
-    snprintf_P(request, HTTP_HEADER_MAX_LENGTH, PSTR("GET %s HTTP/1.1\r\nHost: %s\r\n" \
-        "User-Agent: MultiHTTPSClient\r\nAccept: text/html,application/xml,application/json" \
-        "\r\n\r\n"), uri, host);
+    // Create header request (from the templates)
+    if(_header.build(HTTP_METHOD_GET, uri, host) == 0)
+    {
+        _println(F("[HTTPS] Error: HTTP request header doesn't fit."));
+        return 1;
+    }
+    request = _header.get();
 
     // Send request
-    _printf("HTTP GET request to send:\n%s\n", request);
+    _log(HTTP_LOG_DEBUG, HTTP_PHASE_WRITE, request, strlen(request));
+    _timing_start();
+    _trace(WRITE_BEGIN, 0);
     if(write(request) != strlen(request))
     {
         _println(F("[HTTPS] Error: Incomplete HTTP request sent (sent less bytes than expected)."));
+        _trace(WRITE_END, 0);
         return 1;
     }
+    _timing_phase(HTTP_PHASE_WRITE);
+    _trace(WRITE_END, strlen(request));
     _println(F("[HTTPS] GET request successfully sent."));
     memset(response, '\0', response_len);
 
     // Wait and read response
     _println(F("[HTTPS] Waiting for response..."));
     rc = read_response(response, response_len, response_timeout);
-    _printf("[HTTPS] Response: %s\n\n", response);
+    _log(HTTP_LOG_DEBUG, HTTP_PHASE_TRANSFER, response, strlen(response));
 
     return rc;
 }
@@ -197,37 +192,335 @@ uint8_t MultiHTTPSClient::post(const char* uri, const char* host, char* request_
         const size_t request_len, const size_t request_response_max_size,
         const unsigned long response_timeout)
 {
+    size_t request_size;
+    bool sent;
     uint8_t rc = 1;
+    _memory_scope();
 
-    // Create header request
-    snprintf_P(_http_header, HTTP_HEADER_MAX_LENGTH, PSTR("POST %s HTTP/1.1\r\nHost: %s\r\n" \
-        "User-Agent: MultiHTTPSClient\r\nAccept: text/html,application/xml,application/json" \
-        "\r\nContent-Type: application/json\r\nContent-Length: %" PRIu64 "\r\n\r\n"), uri,
-        host, (uint64_t)request_len);
-
-    // Send request
-    _printf("HTTP POST request to send:\n%s%s\n", _http_header, request_response);
-    if(write(_http_header) != strlen(_http_header))
+    // Create header request (from the templates)
+    if(_header.build(HTTP_METHOD_POST, uri, host, request_len) == 0)
     {
-        _println(F("[HTTPS] Error: Incomplete HTTP request sent (sent less bytes than expected)."));
+        _println(F("[HTTPS] Error: HTTP request header doesn't fit."));
         return 1;
     }
-    if(write(request_response) != strlen(request_response))
+
+    // Send request (header and body in a single write if the body buffer has room for both)
+    _log(HTTP_LOG_DEBUG, HTTP_PHASE_WRITE, _header.get(), _header.length());
+    _log(HTTP_LOG_DEBUG, HTTP_PHASE_WRITE, request_response, request_len);
+    _timing_start();
+    _trace(WRITE_BEGIN, 0);
+    request_size = _header.prepend(request_response, request_len, request_response_max_size);
+    if(request_size != 0)
+        sent = (write(request_response) == request_size);
+    else
+    {
+        sent = (write(_header.get()) == _header.length()) &&
+            (write(request_response) == strlen(request_response));
+    }
+    if(!sent)
     {
         _println(F("[HTTPS] Error: Incomplete HTTP request sent (sent less bytes than expected)."));
+        _trace(WRITE_END, 0);
         return 1;
     }
+    _timing_phase(HTTP_PHASE_WRITE);
+    _trace(WRITE_END, _header.length() + request_len);
     _println(F("[HTTPS] POST request successfully sent."));
     memset(request_response, '\0', request_response_max_size);
 
     // Wait and read response
     _println(F("[HTTPS] Waiting for response..."));
     rc = read_response(request_response, request_response_max_size, response_timeout);
-    _printf("[HTTPS] Response: %s\n\n", request_response);
+    _log(HTTP_LOG_DEBUG, HTTP_PHASE_TRANSFER, request_response, strlen(request_response));
 
     return rc;
 }
 
+// Start a non-blocking connection to server (use poll() until it returns ASYNC_DONE)
+// Note: Host string must be kept until the connection ends (esp-tls gets it in each step), and
+// DNS resolution is still blocking
+int8_t MultiHTTPSClient::connect_async(const char* host, uint16_t port)
+{
+    _memory_scope();
+
+    if(_async_state != ASYNC_STATE_IDLE)
+        return ASYNC_ERROR;
+    if(_connected)
+        return ASYNC_DONE;
+
+    // Reserve memory for TLS (Warning, here we are dynamically reserving some memory in HEAP)
+    _tls = esp_tls_init();
+    if(!_tls)
+    {
+        _println(F("[HTTPS] Error: Cannot reserve memory for TLS."));
+        return ASYNC_ERROR;
+    }
+
+    // Note: DNS, TCP connection and TLS handshake are done inside esp-tls, so all of them are
+    // measured as TLS handshake phase (and traced as a single connect span)
+    _timing_start();
+    _trace(CONNECT_BEGIN, 0);
+    _async_state = ASYNC_STATE_CONNECT;
+    _async_host = host;
+    _async_port = port;
+    _async_t0 = _millis();
+    _async_timeout = HTTP_CONNECT_TIMEOUT;
+    _async_want_write = true;
+
+    return poll();
+}
+
+// Start a non-blocking HTTP POST request (use poll() until it returns ASYNC_DONE)
+// Provide HTTP body in request_response argument
+// Argument request_response will be modified and returned as request response
+int8_t MultiHTTPSClient::post_async(const char* uri, const char* host, char* request_response,
+        const size_t request_len, const size_t request_response_max_size,
+        const unsigned long response_timeout)
+{
+    if(!_connected || (_async_state != ASYNC_STATE_IDLE))
+        return ASYNC_ERROR;
+
+    // Create header request (from the templates)
+    if(_header.build(HTTP_METHOD_POST, uri, host, request_len) == 0)
+    {
+        _println(F("[HTTPS] Error: HTTP request header doesn't fit."));
+        return ASYNC_ERROR;
+    }
+    _log(HTTP_LOG_DEBUG, HTTP_PHASE_WRITE, _header.get(), _header.length());
+    _log(HTTP_LOG_DEBUG, HTTP_PHASE_WRITE, request_response, request_len);
+    _timing_start();
+    _trace(WRITE_BEGIN, 0);
+
+    // Write header and body at once if the body buffer has room for both
+    _async_state = ASYNC_STATE_WRITE_BODY;
+    _async_len = _header.prepend(request_response, request_len, request_response_max_size);
+    if(_async_len == 0)
+    {
+        _async_state = ASYNC_STATE_WRITE_HEADER;
+        _async_len = _header.length();
+    }
+    _async_buffer = request_response;
+    _async_body_len = request_len;
+    _async_done = 0;
+    _async_max_size = request_response_max_size;
+    _async_t0 = _millis();
+    _async_timeout = response_timeout;
+    _async_want_write = true;
+
+    return poll();
+}
+
+// Drive the non-blocking operation in progress as far as possible without blocking
+// Returns ASYNC_IN_PROGRESS (wait for socket and call it again), ASYNC_DONE or ASYNC_ERROR
+int8_t MultiHTTPSClient::poll(void)
+{
+    int ret;
+    _memory_scope();
+
+    while(true)
+    {
+        if(_async_state == ASYNC_STATE_IDLE)
+            return ASYNC_DONE;
+
+        // Check for timeout
+        if(_millis() - _async_t0 >= _async_timeout)
+        {
+            if(_async_state == ASYNC_STATE_CONNECT)
+                _println(F("[HTTPS] Error: Can't connect to server (connection timeout)."));
+            else
+                _println(F("[HTTPS] Error: No response from server (timeout)."));
+            return async_fail();
+        }
+
+        switch(_async_state)
+        {
+            case ASYNC_STATE_CONNECT:
+                ret = esp_tls_conn_new_async(_async_host, strlen(_async_host), _async_port,
+                    _tls_cfg, _tls);
+                if(ret == 0)
+                {
+                    // Wait for the TCP connection (writable socket), and then for each server
+                    // handshake flight (readable socket)
+                    _async_want_write = tls_connecting();
+                    return ASYNC_IN_PROGRESS;
+                }
+                if(ret < 0)
+                {
+                    _println(F("[HTTPS] Error: Can't connect to server (connection fail)."));
+                    return async_fail();
+                }
+                _timing_phase(HTTP_PHASE_TLS_HANDSHAKE);
+                _counter_add(handshakes_full, 1);
+                _trace(CONNECT_END, 1);
+                _connected = true;
+                _async_state = ASYNC_STATE_IDLE;
+                _async_want_write = false;
+                return ASYNC_DONE;
+
+            case ASYNC_STATE_WRITE_HEADER:
+            case ASYNC_STATE_WRITE_BODY:
+            {
+                const char* data = (_async_state == ASYNC_STATE_WRITE_HEADER) ?
+                    _header.get() : _async_buffer;
+                ret = esp_tls_conn_write(_tls, data + _async_done, _async_len - _async_done);
+                if((ret == MBEDTLS_ERR_SSL_WANT_READ) || (ret == MBEDTLS_ERR_SSL_WANT_WRITE))
+                {
+                    _async_want_write = (ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+                    return ASYNC_IN_PROGRESS;
+                }
+                if(ret < 0)
+                {
+                    _printf(F("[HTTPS] Client write error -0x%x\n"), -ret);
+                    return async_fail();
+                }
+                _counter_add(bytes_out, ret);
+                _async_done = _async_done + ret;
+                if(_async_done < _async_len)
+                    break;
+
+                // Header sent, continue with body; or body sent, wait for the response
+                _async_done = 0;
+                if(_async_state == ASYNC_STATE_WRITE_HEADER)
+                {
+                    _async_state = ASYNC_STATE_WRITE_BODY;
+                    _async_len = _async_body_len;
+                }
+                else
+                {
+                    _timing_phase(HTTP_PHASE_WRITE);
+                    _trace(WRITE_END, _header.length() + _async_body_len);
+                    _println(F("[HTTPS] POST request successfully sent."));
+                    memset(_async_buffer, '\0', _async_max_size);
+                    _framing.reset();
+                    _async_state = ASYNC_STATE_READ;
+                    _async_want_write = false;
+                }
+                break;
+            }
+
+            case ASYNC_STATE_READ:
+                ret = esp_tls_conn_read(_tls, _async_buffer + _async_done,
+                    _async_max_size - 1 - _async_done);
+                if((ret == MBEDTLS_ERR_SSL_WANT_READ) || (ret == MBEDTLS_ERR_SSL_WANT_WRITE))
+                {
+                    _async_want_write = (ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+                    return ASYNC_IN_PROGRESS;
+                }
+                if(ret == 0)
+                {
+                    // Server closed the connection, response is complete if something was
+                    // received
+                    _async_state = ASYNC_STATE_IDLE;
+                    if(_async_done == 0)
+                        return async_fail();
+                    _trace(LAST_BYTE, _async_done);
+                    disconnect();
+                    return ASYNC_DONE;
+                }
+                if(ret < 0)
+                {
+                    _printf(F("[HTTPS] Client read error -0x%x\n"), -ret);
+                    return async_fail();
+                }
+                if(_async_done == 0)
+                {
+                    _timing_phase(HTTP_PHASE_WAIT);
+                    _trace(FIRST_BYTE, ret);
+                }
+                _timing_update(HTTP_PHASE_TRANSFER);
+                _counter_add(bytes_in, ret);
+                _async_done = _async_done + ret;
+                if(_framing.update(_async_buffer, _async_done) == HTTP_FRAMING_COMPLETE)
+                {
+                    _trace(LAST_BYTE, _async_done);
+                    _log(HTTP_LOG_DEBUG, HTTP_PHASE_TRANSFER, _async_buffer, _async_done);
+                    _async_state = ASYNC_STATE_IDLE;
+                    return ASYNC_DONE;
+                }
+                if(_async_done >= _async_max_size - 1)
+                {
+                    _println(F("[HTTPS] Response read buffer full."));
+                    return async_fail();
+                }
+                break;
+
+            default:
+                return async_fail();
+        }
+    }
+}
+
+// Get connection socket file descriptor (to wait for it with select())
+int MultiHTTPSClient::get_socket(void)
+{
+    int socket = -1;
+
+    if((_tls == NULL) || (esp_tls_get_conn_sockfd(_tls, &socket) != ESP_OK))
+        return -1;
+    return socket;
+}
+
+// Check if the non-blocking operation in progress is waiting for the socket to be writable
+// (otherwise, it is waiting for the socket to be readable)
+bool MultiHTTPSClient::poll_wants_write(void)
+{
+    return _async_want_write;
+}
+
+// Get the time left (ms) until the non-blocking operation in progress times out (call poll()
+// when it elapses, even if the socket is not ready, so the operation fails)
+unsigned long MultiHTTPSClient::poll_time_left(void)
+{
+    unsigned long elapsed;
+
+    if(_async_state == ASYNC_STATE_IDLE)
+        return 0;
+    elapsed = _millis() - _async_t0;
+    if(elapsed >= _async_timeout)
+        return 0;
+    return _async_timeout - elapsed;
+}
+
+// Get last connection and request phases timings (just measured in MULTIHTTPSCLIENT_TIMINGS
+// builds, check measured phases bit mask)
+const http_timings* MultiHTTPSClient::get_timings(void)
+{
+    return &_timings;
+}
+
+// Clear measured phases timings
+void MultiHTTPSClient::clear_timings(void)
+{
+    memset(&_timings, 0, sizeof(_timings));
+}
+
+// Get traffic counters since last clear (just counted in MULTIHTTPSCLIENT_COUNTERS builds)
+const http_counters* MultiHTTPSClient::get_counters(void)
+{
+    return &_counters;
+}
+
+// Clear traffic counters
+void MultiHTTPSClient::clear_counters(void)
+{
+    memset(&_counters, 0, sizeof(_counters));
+}
+
+// Get heap (mbedtls allocations) and stack usage (just accounted in MULTIHTTPSCLIENT_MEMORY_STATS
+// builds)
+const http_memory_stats* MultiHTTPSClient::get_memory_stats(void)
+{
+    return &_memory;
+}
+
+// Clear memory stats (allocations counts and stack peak, heap peak restarts from current usage)
+void MultiHTTPSClient::clear_memory_stats(void)
+{
+#ifdef MULTIHTTPSCLIENT_MEMORY_STATS
+    http_memory_clear(&_memory);
+#endif
+}
+
 /**************************************************************************************************/
 
 /* Private Methods */
@@ -238,116 +531,164 @@ void MultiHTTPSClient::release_tls_elements(void)
     /* Not release in microcontrollers */
 }
 
+// Check if esp-tls is still waiting for the TCP connection (otherwise, it is doing the handshake)
+bool MultiHTTPSClient::tls_connecting(void)
+{
+    esp_tls_conn_state_t state;
+
+#if ESP_IDF_VERSION_MAJOR >= 5
+    if(esp_tls_get_conn_state(_tls, &state) != ESP_OK)
+        return false;
+#else
+    state = _tls->conn_state;
+#endif
+    return (state == ESP_TLS_CONNECTING);
+}
+
+// Abort non-blocking operation in progress and close the connection
+int8_t MultiHTTPSClient::async_fail(void)
+{
+    // Close the trace span of the operation in progress
+    if(_async_state == ASYNC_STATE_CONNECT)
+        _trace(CONNECT_END, 0);
+    else if((_async_state == ASYNC_STATE_WRITE_HEADER) ||
+            (_async_state == ASYNC_STATE_WRITE_BODY))
+        _trace(WRITE_END, 0);
+
+    _async_state = ASYNC_STATE_IDLE;
+    _async_want_write = false;
+    disconnect();
+    return ASYNC_ERROR;
+}
+
 // HTTPS Write
 size_t MultiHTTPSClient::write(const char* request)
 {
     size_t written_bytes = 0;
     int ret;
 
+    _stack_probe();
     do
     {
         ret = esp_tls_conn_write(_tls, request + written_bytes, strlen(request) -
             written_bytes);
         if(ret > 0)
+        {
             written_bytes += ret;
+            _counter_add(bytes_out, ret);
+        }
         else if(ret != MBEDTLS_ERR_SSL_WANT_READ  && ret != MBEDTLS_ERR_SSL_WANT_WRITE)
         {
             _printf(F("[HTTPS] Client write error 0x%x\n"), ret);
             break;
         }
+        else if(http_socket_wait(get_socket(), (ret == MBEDTLS_ERR_SSL_WANT_WRITE),
+                HTTP_WAIT_RESPONSE_TIMEOUT) != HTTP_SOCKET_READY)
+        {
+            _println(F("[HTTPS] Error: Client write timeout."));
+            break;
+        }
     } while(written_bytes < strlen(request));
 
     return written_bytes;
 }
 
-// HTTPS Read
-size_t MultiHTTPSClient::read(char* response, const size_t response_len)
+// HTTPS Read (socket is non-blocking, so it doesn't wait for data)
+// Returns number of bytes read, 0 if there is no data to read yet, or -1 if server closed the
+// connection or on error
+int MultiHTTPSClient::read(char* response, const size_t response_len)
 {
     ssize_t ret;
 
+    _stack_probe();
     ret = esp_tls_conn_read(_tls, response, response_len);
 
     if(ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE)
         return 0;
-    if(ret < 0)
-    {
-        _printf(F("[HTTPS] Client read error -0x%x\n"), -ret);
-        return 0;
-    }
     if(ret == 0)
     {
         _printf(F("[HTTPS] Lost connection while client was reading.\n"));
-        return 0;
+        return -1;
+    }
+    if(ret < 0)
+    {
+        _printf(F("[HTTPS] Client read error -0x%x\n"), (unsigned)-ret);
+        return -1;
     }
 
     return ret;
 }
 
-// HTTP Read Response
+// HTTP Read Response (until it is fully received, as given by its framing)
+// The whole response must be received before response_timeout, and responses without framing end
+// when the server closes the connection or after HTTP_RESPONSE_BETWEEN_BYTES_TIMEOUT without
+// receiving more bytes
+// Returns 0 on success, 1 on connection error, 2 on timeout and 3 if response doesn't fit
 uint8_t MultiHTTPSClient::read_response(char* response, const size_t response_max_len,
         const unsigned long response_timeout)
 {
-    unsigned long t0 = 0, t1 = 0, t2 = 0;
-    size_t num_bytes_read = 0;
+    unsigned long t0, t1, t2 = 0;
+    unsigned long wait_ms;
     size_t total_bytes_read = 0;
-    size_t response_len = response_max_len;
+    int rc;
 
+    _framing.reset();
     t0 = _millis();
     while(true)
     {
+        // Check for timeout
         t1 = _millis();
-
-        // Check for overflow
-        // Note: Due Arduino millis() return an unsigned long instead specific size type, lets just
-        // handle overflow by reseting counter (this time the timeout can be < 2*expected_timeout)
-        if(t1 < t0)
+        if(t1 - t0 >= response_timeout)
         {
-            t0 = 0;
-            continue;
+            _println(F("[HTTPS] Error: No response from server (timeout)."));
+            return 2;
         }
+        wait_ms = response_timeout - (t1 - t0);
 
-        // Check for timeout
-        if(t1-t0 >= response_timeout)
+        // Responses without framing are complete when no more bytes are received for a while
+        if((t2 != 0) && _framing.until_close())
         {
-            _println(F("[HTTPS] Error: No response from server (timeout)."));
-            return 2; // Timeout response
+            if(t1 - t2 >= HTTP_RESPONSE_BETWEEN_BYTES_TIMEOUT)
+                break;
+            if(HTTP_RESPONSE_BETWEEN_BYTES_TIMEOUT - (t1 - t2) < wait_ms)
+                wait_ms = HTTP_RESPONSE_BETWEEN_BYTES_TIMEOUT - (t1 - t2);
         }
 
-        // Check for response
-        num_bytes_read = read(response, response_len);
-        total_bytes_read = total_bytes_read + num_bytes_read;
-        if(total_bytes_read >= response_max_len)
+        rc = read(response + total_bytes_read, response_max_len - 1 - total_bytes_read);
+        if(rc == 0)
         {
-            _println(F("[HTTPS] Response read buffer full."));
-            return 3;
+            // Sleep until more bytes are received (or a timeout expires)
+            http_socket_wait(get_socket(), false, wait_ms);
+            continue;
         }
-        if(num_bytes_read == 0)
+        if(rc < 0)
         {
-            // Check for timeout without any incomming byte
-            if(t2 != 0)
-            {
-                t1 = _millis();
-                if(t1 < t2)
-                    t2 = t1;
-                if(t1-t2 >= HTTP_RESPONSE_BETWEEN_BYTES_TIMEOUT)
-                {
-                    // Assume full reception
-                    _println(F("[HTTPS] Response successfully received."));
-                    break;
-                }
-            }
+            // Response without framing ends when server closes the connection
+            if((total_bytes_read > 0) && _framing.until_close())
+                break;
+            return 1;
+        }
+
+        // First response bytes ends server wait phase, last ones ends transfer phase
+        if(total_bytes_read == 0)
+        {
+            _timing_phase(HTTP_PHASE_WAIT);
+            _trace(FIRST_BYTE, rc);
         }
-        else
+        _timing_update(HTTP_PHASE_TRANSFER);
+        _counter_add(bytes_in, rc);
+        total_bytes_read = total_bytes_read + rc;
+        t2 = _millis();
+        if(_framing.update(response, total_bytes_read) == HTTP_FRAMING_COMPLETE)
+            break;
+        if(total_bytes_read >= response_max_len - 1)
         {
-            _println(F("[HTTPS] Something partially received:"));
-            _println(response);
-            response = response + num_bytes_read;
-            response_len = response_len - num_bytes_read;
-            t2 = _millis();
+            _println(F("[HTTPS] Response read buffer full."));
+            return 3;
         }
-
-        _yield();
     }
+    _println(F("[HTTPS] Response successfully received."));
+    _trace(LAST_BYTE, total_bytes_read);
 
     return 0;
 }
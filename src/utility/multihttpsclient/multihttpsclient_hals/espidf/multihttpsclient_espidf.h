@@ -20,11 +20,28 @@
 /* Libraries */
 
 #include "esp_tls.h"
+#include "esp_idf_version.h"
 
 #include <inttypes.h>
 #include <stdint.h>
 #include <string.h>
 
+// Requests phases timings, traffic counters and memory accounting
+#include "../../multihttpsclient_timings.h"
+#include "../../multihttpsclient_counters.h"
+#include "../../multihttpsclient_memory.h"
+#include "../../multihttpsclient_log.h"
+#include "../../multihttpsclient_trace.h"
+
+// HTTP response framing parser
+#include "../../multihttpsclient_framing.h"
+
+// HTTP request header templates
+#include "../../multihttpsclient_header.h"
+
+// Non-blocking operations driver
+#include "../../multihttpsclient_async.h"
+
 /**************************************************************************************************/
 
 /* Constants */
@@ -35,12 +52,10 @@
 // HTTP response wait timeout (ms)
 #define HTTP_WAIT_RESPONSE_TIMEOUT 500
 
-// HTTP response between bytes receptions timeout (ms)
+// HTTP response between bytes receptions timeout (ms), it ends responses without framing
+// (responses with Content-Length or chunked transfer encoding end as soon as they are received)
 #define HTTP_RESPONSE_BETWEEN_BYTES_TIMEOUT 500
 
-// HTTP Request header max length
-#define HTTP_HEADER_MAX_LENGTH 256
-
 /**************************************************************************************************/
 
 class MultiHTTPSClient
@@ -50,6 +65,7 @@ class MultiHTTPSClient
         MultiHTTPSClient();
         void set_debug(const bool debug);
         void set_cert(const uint8_t* ca_pem_start, const uint8_t* ca_pem_end);
+        bool set_cert_der(const uint8_t* ca_der, const size_t ca_der_len);
         int8_t connect(const char* host, uint16_t port);
         void disconnect();
         bool is_connected();
@@ -59,20 +75,69 @@ class MultiHTTPSClient
                 const size_t request_len, const size_t request_response_max_size,
                 const unsigned long response_timeout=HTTP_WAIT_RESPONSE_TIMEOUT);
 
+        // Non-blocking requests (operations are started and then driven by poll() calls)
+        int8_t connect_async(const char* host, uint16_t port);
+        int8_t post_async(const char* uri, const char* host, char* request_response,
+                const size_t request_len, const size_t request_response_max_size,
+                const unsigned long response_timeout=HTTP_WAIT_RESPONSE_TIMEOUT);
+        int8_t poll();
+        int get_socket();
+        bool poll_wants_write();
+        unsigned long poll_time_left();
+
+        // Last connection and request phases timings (MULTIHTTPSCLIENT_TIMINGS builds)
+        const http_timings* get_timings();
+        void clear_timings();
+
+        // Traffic counters since last clear (MULTIHTTPSCLIENT_COUNTERS builds)
+        const http_counters* get_counters();
+        void clear_counters();
+
+        // Heap and stack usage (MULTIHTTPSCLIENT_MEMORY_STATS builds)
+        const http_memory_stats* get_memory_stats();
+        void clear_memory_stats();
+
     private:
+        // Private Data Types
+        typedef enum async_state
+        {
+            ASYNC_STATE_IDLE,
+            ASYNC_STATE_CONNECT,
+            ASYNC_STATE_WRITE_HEADER,
+            ASYNC_STATE_WRITE_BODY,
+            ASYNC_STATE_READ
+        } async_state;
+
         // Private Attributtes
-        char _http_header[HTTP_HEADER_MAX_LENGTH];
+        http_request_header _header;
         esp_tls_t* _tls;
         esp_tls_cfg_t* _tls_cfg;
         bool _connected;
         bool _debug;
+        async_state _async_state;
+        const char* _async_host;
+        uint16_t _async_port;
+        char* _async_buffer;
+        size_t _async_len;
+        size_t _async_body_len;
+        size_t _async_done;
+        size_t _async_max_size;
+        unsigned long _async_t0;
+        unsigned long _async_timeout;
+        bool _async_want_write;
+        http_timings _timings;
+        http_counters _counters;
+        http_memory_stats _memory;
+        http_response_framing _framing;
 
         // Private Methods
         void release_tls_elements();
         size_t write(const char* request);
-        size_t read(char* response, const size_t response_len);
+        int read(char* response, const size_t response_len);
         uint8_t read_response(char* response, const size_t response_max_len,
                 const unsigned long response_timeout);
+        bool tls_connecting();
+        int8_t async_fail();
 };
 
 /**************************************************************************************************/
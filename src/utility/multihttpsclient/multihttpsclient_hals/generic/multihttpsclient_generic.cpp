@@ -23,29 +23,62 @@
     #define _println(x) do { if(_debug) printf("%s\n", x); } while(0)
     #define _printf(...) do { if(_debug) printf(__VA_ARGS__); } while(0)
 #else
-    #define _print(x)
-    #define _println(x)
-    #define _printf(...)
+    #define _print(x) do { } while(0)
+    #define _println(x) do { } while(0)
+    #define _printf(...) do { } while(0)
 #endif
 
+// Requests and responses go to the log ring instead (no slow synchronous prints while requesting)
+#ifndef MULTIHTTPSCLIENT_NO_DEBUG
+    #define _log(level, phase, data, length) \
+        do { if(_debug) http_log_write(level, phase, data, length); } while(0)
+#else
+    #define _log(level, phase, data, length) do { } while(0)
+#endif
+
+// Trace points of this client (no code at all if trace is disabled)
+#define _trace(point, arg) HTTP_TRACE(point, this, arg)
+
 #define F(x) x
 #define PSTR(x) x
 #define snprintf_P(...) do { snprintf(__VA_ARGS__); } while(0)
 #define sscanf_P(...) do { sscanf(__VA_ARGS__); } while(0)
 
 #define PROGMEM
-#define _yield()
-
-// Initialize millis (just usefull for Generic)
-clock_t _millis_t0 = clock();
-#define _millis() (unsigned long)((clock() - ::_millis_t0)*1000.0/CLOCKS_PER_SEC)
+#define _yield() do { } while(0)
 
+// Monotonic millis (Note: clock() measures process CPU time, so it doesn't advance while waiting
+// for the server)
 #if defined(WIN32) || defined(_WIN32) // Windows
+    #define _millis() (unsigned long)(GetTickCount())
     #define _delay(x) do { Sleep(x); } while(0)
 #elif defined(__linux__)
+    static unsigned long _millis(void)
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (unsigned long)((ts.tv_sec*1000UL) + (ts.tv_nsec/1000000UL));
+    }
     #define _delay(x) do { usleep(x*1000); } while(0)
 #endif
 
+// Monotonic micros (just needed for requests phases timings)
+#ifdef MULTIHTTPSCLIENT_TIMINGS
+    static unsigned long _micros(void)
+    {
+    #if defined(WIN32) || defined(_WIN32) // Windows
+        LARGE_INTEGER freq, count;
+        QueryPerformanceFrequency(&freq);
+        QueryPerformanceCounter(&count);
+        return (unsigned long)((count.QuadPart*1000000) / freq.QuadPart);
+    #else
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (unsigned long)((ts.tv_sec*1000000UL) + (ts.tv_nsec/1000UL));
+    #endif
+    }
+#endif
+
 /**************************************************************************************************/
 
 /* Constructor & Destructor */
@@ -55,17 +88,38 @@ MultiHTTPSClient::MultiHTTPSClient(void)
 {
     _debug = false;
     _connected = false;
-    _http_header[0] = '\0';
     _cert_https_server = NULL;
+    _cert_der = NULL;
+    _cert_der_len = 0;
+    _async_state = ASYNC_STATE_IDLE;
+    _async_buffer = NULL;
+    _async_len = 0;
+    _async_body_len = 0;
+    _async_done = 0;
+    _async_max_size = 0;
+    _async_t0 = 0;
+    _async_timeout = 0;
+    _async_want_write = false;
+    _session_saved = false;
+    mbedtls_ssl_session_init(&_session);
+    mbedtls_x509_crt_init(&_cacert);
+    clear_timings();
+    clear_counters();
+    memset(&_memory, 0, sizeof(_memory));
 
+    _memory_scope();
     init();
 }
 
 // MultiHTTPSClient destructor, free mbedtls resources
 MultiHTTPSClient::~MultiHTTPSClient(void)
 {
+    _memory_scope();
+
     // Release all mbedtls context
     release_tls_elements();
+    mbedtls_x509_crt_free(&_cacert);
+    mbedtls_ssl_session_free(&_session);
 }
 
 /**************************************************************************************************/
@@ -87,59 +141,68 @@ void MultiHTTPSClient::set_cert(const uint8_t* ca_pem_start, const uint8_t* ca_p
 // Setup Server Certificate
 void MultiHTTPSClient::set_cert(const char* cert_https_server)
 {
+    _memory_scope();
+
     _cert_https_server = cert_https_server;
+    _cert_der = NULL;
+    _cert_der_len = 0;
+
+    // Don't resume sessions verified with the previous certificate
+    forget_session();
 
     // Release all mbedtls context
     release_tls_elements();
 
     // Initialize again the mbedtls context
     init();
+    load_cert();
+}
+
+// Setup Server Certificate from DER data (i.e. precompiled in flash, it is parsed in place
+// without base64 decoding nor copying it, so the data must be kept while it is in use)
+bool MultiHTTPSClient::set_cert_der(const uint8_t* ca_der, const size_t ca_der_len)
+{
+    _memory_scope();
+
+    _cert_https_server = NULL;
+    _cert_der = ca_der;
+    _cert_der_len = ca_der_len;
+
+    // Don't resume sessions verified with the previous certificate
+    forget_session();
+
+    // Release all mbedtls context
+    release_tls_elements();
+
+    // Initialize again the mbedtls context
+    init();
+    return load_cert();
 }
 
 // Make HTTPS client connection to server
 int8_t MultiHTTPSClient::connect(const char* host, uint16_t port)
 {
     int ret;
+    _memory_scope();
 
     // Start connection
-    char str_port[6];
-    snprintf(str_port, 6, "%d", port);
-    if((ret = mbedtls_net_connect(&_server_fd, host, str_port, MBEDTLS_NET_PROTO_TCP)) != 0)
-    {
-        _printf("[HTTPS] Error: Can't connect to server. ");
-        _printf("Start connection fail (mbedtls_net_connect returned %d).\n", ret);
-        return 0;
-    }
-
-    // Set SSL/TLS configuration
-    if((ret = mbedtls_ssl_config_defaults(&_tls_cfg, MBEDTLS_SSL_IS_CLIENT,
-        MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT)) != 0)
+    _timing_start();
+    _trace(CONNECT_BEGIN, 0);
+    if(!tcp_connect(host, port, false))
     {
-        _printf("[HTTPS] Error: Can't connect to server ");
-        _printf("Default SSL/TLS configuration fail ");
-        _printf("(mbedtls_ssl_config_defaults returned %d).\n", ret);
+        _trace(CONNECT_END, 0);
         return 0;
     }
-    mbedtls_ssl_conf_authmode(&_tls_cfg, MBEDTLS_SSL_VERIFY_OPTIONAL);
-    mbedtls_ssl_conf_ca_chain(&_tls_cfg, &_cacert, NULL);
-    mbedtls_ssl_conf_rng(&_tls_cfg, mbedtls_ctr_drbg_random, &_ctr_drbg);
-    mbedtls_ssl_conf_read_timeout(&_tls_cfg, HTTP_WAIT_RESPONSE_TIMEOUT);
-    //mbedtls_ssl_conf_dbg(&_tls_cfg, my_debug, stdout);
+    _timing_phase(HTTP_PHASE_TCP_CONNECT);
+    _trace(CONNECT_END, 1);
 
-    // SSL/TLS Server, Hostname and Bio setup
-    if((ret = mbedtls_ssl_setup( &_tls, &_tls_cfg)) != 0)
+    // Set SSL/TLS configuration, Hostname and Bio
+    _trace(HANDSHAKE_BEGIN, 0);
+    if(!tls_setup(host, false))
     {
-        _printf("[HTTPS] Error: Can't connect to server ");
-        _printf("SSL/TLS setup fail (mbedtls_ssl_setup returned %d).\n", ret);
+        _trace(HANDSHAKE_END, 0);
         return 0;
     }
-    if((ret = mbedtls_ssl_set_hostname(&_tls, host)) != 0)
-    {
-        _printf("[HTTPS] Error: Can't connect to server. ");
-        _printf("Hostname setup fail (mbedtls_ssl_set_hostname returned %d).\n", ret);
-        return 0;
-    }
-    mbedtls_ssl_set_bio(&_tls, &_server_fd, mbedtls_net_send, mbedtls_net_recv, NULL);
 
     // Perform SSL/TLS Handshake
     while((ret = mbedtls_ssl_handshake(&_tls)) != 0)
@@ -148,22 +211,20 @@ int8_t MultiHTTPSClient::connect(const char* host, uint16_t port)
         {
             _printf("[HTTPS] Error: Can't connect to server ");
             _printf("SSL/TLS handshake fail (mbedtls_ssl_handshake returned -0x%x).\n", -ret);
+            _trace(HANDSHAKE_END, 0);
             return 0;
         }
     }
 
     // Verify server certificate
-    uint32_t flags;
-    if(_cert_https_server != NULL)
+    if(verify_cert() != 1)
     {
-        if((flags = mbedtls_ssl_get_verify_result(&_tls)) != 0)
-        {
-            char vrfy_buf[512];
-            mbedtls_x509_crt_verify_info(vrfy_buf, sizeof(vrfy_buf), "  ! ", flags);
-            _printf("[HTTPS] Warning: Invalid Server Certificate.\n%s\n", vrfy_buf);
-            return -1;
-        }
+        _trace(HANDSHAKE_END, 0);
+        return -1;
     }
+    _timing_phase(HTTP_PHASE_TLS_HANDSHAKE);
+    _trace(HANDSHAKE_END, 1);
+    handshake_done();
 
     // Connection stablished and certificate verified
     _connected = true;
@@ -173,6 +234,8 @@ int8_t MultiHTTPSClient::connect(const char* host, uint16_t port)
 // HTTPS client disconnect from server
 void MultiHTTPSClient::disconnect(void)
 {
+    _memory_scope();
+
     // Close connection
     int ret = mbedtls_ssl_close_notify(&_tls);
     if((ret != 0) && (ret != MBEDTLS_ERR_SSL_WANT_READ) && (ret != MBEDTLS_ERR_SSL_WANT_WRITE))
@@ -197,29 +260,37 @@ bool MultiHTTPSClient::is_connected(void)
 uint8_t MultiHTTPSClient::get(const char* uri, const char* host, char* response,
         const size_t response_len, const unsigned long response_timeout)
 {
-    // Lets use response buffer for make the request first (for the sake of save memory)
-    char* request = response;
+    const char* request;
     uint8_t rc = 0;
+    _memory_scope();
 
-    // Create header request
-    snprintf_P(request, HTTP_HEADER_MAX_LENGTH, PSTR("GET %s HTTP/1.1\r\nHost: %s\r\n" \
-        "User-Agent: MultiHTTPSClient\r\nAccept: text/html,application/xml,application/json" \
-        "\r\n\r\n"), uri, host);
+    // Create header request (from the templates)
+    if(_header.build(HTTP_METHOD_GET, uri, host) == 0)
+    {
+        _println(F("[HTTPS] Error: HTTP request header doesn't fit."));
+        return 1;
+    }
+    request = _header.get();
 
     // Send request
-    _printf("HTTP GET request to send:\n%s", request);
+    _log(HTTP_LOG_DEBUG, HTTP_PHASE_WRITE, request, strlen(request));
+    _timing_start();
+    _trace(WRITE_BEGIN, 0);
     if(write(request) != strlen(request))
     {
         _println(F("[HTTPS] Error: Incomplete HTTP request sent (sent less bytes than expected)."));
+        _trace(WRITE_END, 0);
         return 1;
     }
+    _timing_phase(HTTP_PHASE_WRITE);
+    _trace(WRITE_END, strlen(request));
     _println(F("[HTTPS] GET request successfully sent."));
     memset(response, '\0', response_len);
 
     // Wait and read response
     _println(F("[HTTPS] Waiting for response..."));
     rc = read_response(response, response_len, response_timeout);
-    _printf("[HTTPS] Response: %s\n\n", response);
+    _log(HTTP_LOG_DEBUG, HTTP_PHASE_TRANSFER, response, strlen(response));
 
     return rc;
 }
@@ -231,37 +302,354 @@ uint8_t MultiHTTPSClient::post(const char* uri, const char* host, char* request_
         const size_t request_len, const size_t request_response_max_size,
         const unsigned long response_timeout)
 {
+    size_t request_size;
+    bool sent;
     uint8_t rc = 0;
+    _memory_scope();
 
-    // Create header request
-    snprintf_P(_http_header, HTTP_HEADER_MAX_LENGTH, PSTR("POST %s HTTP/1.1\r\nHost: %s\r\n" \
-        "User-Agent: MultiHTTPSClient\r\nAccept: text/html,application/xml,application/json" \
-        "\r\nContent-Type: application/json\r\nContent-Length: %" PRIu64 "\r\n\r\n"), uri,
-        host, (uint64_t)request_len);
-
-    // Send request
-    _printf("HTTP POST request to send:\n%s%s\n", _http_header, request_response);
-    if(write(_http_header) != strlen(_http_header))
+    // Create header request (from the templates)
+    if(_header.build(HTTP_METHOD_POST, uri, host, request_len) == 0)
     {
-        _println(F("[HTTPS] Error: Incomplete HTTP request sent (sent less bytes than expected)."));
+        _println(F("[HTTPS] Error: HTTP request header doesn't fit."));
         return 1;
     }
-    if(write(request_response) != strlen(request_response))
+
+    // Send request (header and body in a single write if the body buffer has room for both)
+    _log(HTTP_LOG_DEBUG, HTTP_PHASE_WRITE, _header.get(), _header.length());
+    _log(HTTP_LOG_DEBUG, HTTP_PHASE_WRITE, request_response, request_len);
+    _timing_start();
+    _trace(WRITE_BEGIN, 0);
+    request_size = _header.prepend(request_response, request_len, request_response_max_size);
+    if(request_size != 0)
+        sent = (write(request_response, request_size) == request_size);
+    else
+    {
+        sent = (write(_header.get(), _header.length()) == _header.length()) &&
+            (write(request_response, request_len) == request_len);
+    }
+    if(!sent)
     {
         _println(F("[HTTPS] Error: Incomplete HTTP request sent (sent less bytes than expected)."));
+        _trace(WRITE_END, 0);
         return 1;
     }
+    _timing_phase(HTTP_PHASE_WRITE);
+    _trace(WRITE_END, _header.length() + request_len);
     _println(F("[HTTPS] POST request successfully sent."));
     memset(request_response, '\0', request_response_max_size);
 
     // Wait and read response
     _println(F("[HTTPS] Waiting for response..."));
     rc = read_response(request_response, request_response_max_size, response_timeout);
-    _printf("[HTTPS] Response: %s\n\n", request_response);
+    _log(HTTP_LOG_DEBUG, HTTP_PHASE_TRANSFER, request_response, strlen(request_response));
 
     return rc;
 }
 
+// Start a non-blocking connection to server (use poll() until it returns ASYNC_DONE)
+// Note: DNS resolution is still blocking
+int8_t MultiHTTPSClient::connect_async(const char* host, uint16_t port)
+{
+    _memory_scope();
+
+    if(_async_state != ASYNC_STATE_IDLE)
+        return ASYNC_ERROR;
+    if(_connected)
+        return ASYNC_DONE;
+
+    // Start TCP connection without waiting for it
+    _timing_start();
+    _trace(CONNECT_BEGIN, 0);
+    if(!tcp_connect(host, port, true))
+    {
+        _trace(CONNECT_END, 0);
+        return ASYNC_ERROR;
+    }
+
+    // Set SSL/TLS configuration, Hostname and Bio
+    _async_state = ASYNC_STATE_TCP_CONNECT;
+    if(!tls_setup(host, true))
+        return async_fail();
+
+    _async_t0 = _millis();
+    _async_timeout = HTTP_WAIT_RESPONSE_TIMEOUT;
+    _async_want_write = true;
+
+    return poll();
+}
+
+// Start a non-blocking HTTP POST request (use poll() until it returns ASYNC_DONE)
+// Provide HTTP body in request_response argument
+// Argument request_response will be modified and returned as request response
+int8_t MultiHTTPSClient::post_async(const char* uri, const char* host, char* request_response,
+        const size_t request_len, const size_t request_response_max_size,
+        const unsigned long response_timeout)
+{
+    if(!_connected || (_async_state != ASYNC_STATE_IDLE))
+        return ASYNC_ERROR;
+
+    // Create header request (from the templates)
+    if(_header.build(HTTP_METHOD_POST, uri, host, request_len) == 0)
+    {
+        _println(F("[HTTPS] Error: HTTP request header doesn't fit."));
+        return ASYNC_ERROR;
+    }
+    _log(HTTP_LOG_DEBUG, HTTP_PHASE_WRITE, _header.get(), _header.length());
+    _log(HTTP_LOG_DEBUG, HTTP_PHASE_WRITE, request_response, request_len);
+    _timing_start();
+    _trace(WRITE_BEGIN, 0);
+
+    // Write header and body at once if the body buffer has room for both
+    _async_state = ASYNC_STATE_WRITE_BODY;
+    _async_len = _header.prepend(request_response, request_len, request_response_max_size);
+    if(_async_len == 0)
+    {
+        _async_state = ASYNC_STATE_WRITE_HEADER;
+        _async_len = _header.length();
+    }
+    _async_buffer = request_response;
+    _async_body_len = request_len;
+    _async_done = 0;
+    _async_max_size = request_response_max_size;
+    _async_t0 = _millis();
+    _async_timeout = response_timeout;
+    _async_want_write = true;
+
+    return poll();
+}
+
+// Drive the non-blocking operation in progress as far as possible without blocking
+// Returns ASYNC_IN_PROGRESS (wait for socket and call it again), ASYNC_DONE or ASYNC_ERROR
+int8_t MultiHTTPSClient::poll(void)
+{
+    int ret;
+    _memory_scope();
+
+    while(true)
+    {
+        if(_async_state == ASYNC_STATE_IDLE)
+            return ASYNC_DONE;
+
+        // Check for timeout
+        if(_millis() - _async_t0 >= _async_timeout)
+        {
+            _println(F("[HTTPS] Error: No response from server (timeout)."));
+            return async_fail();
+        }
+
+        switch(_async_state)
+        {
+            case ASYNC_STATE_TCP_CONNECT:
+                // Check if TCP connection has been stablished
+                ret = mbedtls_net_poll(&_server_fd, MBEDTLS_NET_POLL_WRITE, 0);
+                if(ret < 0)
+                    return async_fail();
+                if(ret == 0)
+                    return ASYNC_IN_PROGRESS;
+#if defined(__linux__)
+                {
+                    int sock_error = 0;
+                    socklen_t sock_error_len = sizeof(sock_error);
+                    getsockopt(_server_fd.fd, SOL_SOCKET, SO_ERROR, &sock_error,
+                        &sock_error_len);
+                    if(sock_error != 0)
+                    {
+                        _printf("[HTTPS] Error: Can't connect to server (socket error %d).\n",
+                            sock_error);
+                        return async_fail();
+                    }
+                }
+#endif
+                _timing_phase(HTTP_PHASE_TCP_CONNECT);
+                _trace(CONNECT_END, 1);
+                _trace(HANDSHAKE_BEGIN, 0);
+                _async_state = ASYNC_STATE_HANDSHAKE;
+                break;
+
+            case ASYNC_STATE_HANDSHAKE:
+                ret = mbedtls_ssl_handshake(&_tls);
+                if((ret == MBEDTLS_ERR_SSL_WANT_READ) || (ret == MBEDTLS_ERR_SSL_WANT_WRITE))
+                {
+                    _async_want_write = (ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+                    return ASYNC_IN_PROGRESS;
+                }
+                if(ret != 0)
+                {
+                    _printf("[HTTPS] Error: Can't connect to server ");
+                    _printf("SSL/TLS handshake fail (mbedtls_ssl_handshake returned -0x%x).\n",
+                        -ret);
+                    return async_fail();
+                }
+                if(verify_cert() != 1)
+                    return async_fail();
+                _timing_phase(HTTP_PHASE_TLS_HANDSHAKE);
+                _trace(HANDSHAKE_END, 1);
+                handshake_done();
+                _connected = true;
+                _async_state = ASYNC_STATE_IDLE;
+                return ASYNC_DONE;
+
+            case ASYNC_STATE_WRITE_HEADER:
+            case ASYNC_STATE_WRITE_BODY:
+            {
+                const char* data = (_async_state == ASYNC_STATE_WRITE_HEADER) ?
+                    _header.get() : _async_buffer;
+                ret = mbedtls_ssl_write(&_tls, (const unsigned char*)data + _async_done,
+                    _async_len - _async_done);
+                if((ret == MBEDTLS_ERR_SSL_WANT_READ) || (ret == MBEDTLS_ERR_SSL_WANT_WRITE))
+                {
+                    _async_want_write = (ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+                    return ASYNC_IN_PROGRESS;
+                }
+                if(ret < 0)
+                {
+                    _printf(F("[HTTPS] Client write error -0x%x\n"), -ret);
+                    return async_fail();
+                }
+                _counter_add(bytes_out, ret);
+                _async_done = _async_done + ret;
+                if(_async_done < _async_len)
+                    break;
+
+                // Header sent, continue with body; or body sent, wait for the response
+                _async_done = 0;
+                if(_async_state == ASYNC_STATE_WRITE_HEADER)
+                {
+                    _async_state = ASYNC_STATE_WRITE_BODY;
+                    _async_len = _async_body_len;
+                }
+                else
+                {
+                    _timing_phase(HTTP_PHASE_WRITE);
+                    _trace(WRITE_END, _header.length() + _async_body_len);
+                    _println(F("[HTTPS] POST request successfully sent."));
+                    memset(_async_buffer, '\0', _async_max_size);
+                    _framing.reset();
+                    _async_state = ASYNC_STATE_READ;
+                    _async_want_write = false;
+                }
+                break;
+            }
+
+            case ASYNC_STATE_READ:
+                ret = mbedtls_ssl_read(&_tls, (unsigned char*)_async_buffer + _async_done,
+                    _async_max_size - 1 - _async_done);
+                if((ret == MBEDTLS_ERR_SSL_WANT_READ) || (ret == MBEDTLS_ERR_SSL_WANT_WRITE))
+                {
+                    _async_want_write = (ret == MBEDTLS_ERR_SSL_WANT_WRITE);
+                    return ASYNC_IN_PROGRESS;
+                }
+                if((ret == 0) || (ret == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY))
+                {
+                    // Server closed the connection, response is complete if something was
+                    // received
+                    _async_state = ASYNC_STATE_IDLE;
+                    if(_async_done == 0)
+                        return async_fail();
+                    _trace(LAST_BYTE, _async_done);
+                    disconnect();
+                    return ASYNC_DONE;
+                }
+                if(ret < 0)
+                {
+                    _printf(F("[HTTPS] Client read error -0x%x\n"), -ret);
+                    return async_fail();
+                }
+                if(_async_done == 0)
+                {
+                    _timing_phase(HTTP_PHASE_WAIT);
+                    _trace(FIRST_BYTE, ret);
+                }
+                _timing_update(HTTP_PHASE_TRANSFER);
+                _counter_add(bytes_in, ret);
+                _async_done = _async_done + ret;
+                if(_framing.update(_async_buffer, _async_done) == HTTP_FRAMING_COMPLETE)
+                {
+                    _trace(LAST_BYTE, _async_done);
+                    _log(HTTP_LOG_DEBUG, HTTP_PHASE_TRANSFER, _async_buffer, _async_done);
+                    _async_state = ASYNC_STATE_IDLE;
+                    return ASYNC_DONE;
+                }
+                if(_async_done >= _async_max_size - 1)
+                {
+                    _println(F("[HTTPS] Response read buffer full."));
+                    return async_fail();
+                }
+                break;
+
+            default:
+                return async_fail();
+        }
+    }
+}
+
+// Get connection socket file descriptor (to wait for it with select() or poll())
+int MultiHTTPSClient::get_socket(void)
+{
+    return _server_fd.fd;
+}
+
+// Check if the non-blocking operation in progress is waiting for the socket to be writable
+// (otherwise, it is waiting for the socket to be readable)
+bool MultiHTTPSClient::poll_wants_write(void)
+{
+    return _async_want_write;
+}
+
+// Get the time left (ms) until the non-blocking operation in progress times out (call poll()
+// when it elapses, even if the socket is not ready, so the operation fails)
+unsigned long MultiHTTPSClient::poll_time_left(void)
+{
+    unsigned long elapsed;
+
+    if(_async_state == ASYNC_STATE_IDLE)
+        return 0;
+    elapsed = _millis() - _async_t0;
+    if(elapsed >= _async_timeout)
+        return 0;
+    return _async_timeout - elapsed;
+}
+
+// Get last connection and request phases timings (just measured in MULTIHTTPSCLIENT_TIMINGS
+// builds, check measured phases bit mask)
+const http_timings* MultiHTTPSClient::get_timings(void)
+{
+    return &_timings;
+}
+
+// Clear measured phases timings
+void MultiHTTPSClient::clear_timings(void)
+{
+    memset(&_timings, 0, sizeof(_timings));
+}
+
+// Get traffic counters since last clear (just counted in MULTIHTTPSCLIENT_COUNTERS builds)
+const http_counters* MultiHTTPSClient::get_counters(void)
+{
+    return &_counters;
+}
+
+// Clear traffic counters
+void MultiHTTPSClient::clear_counters(void)
+{
+    memset(&_counters, 0, sizeof(_counters));
+}
+
+// Get heap (mbedtls allocations) and stack usage (just accounted in MULTIHTTPSCLIENT_MEMORY_STATS
+// builds)
+const http_memory_stats* MultiHTTPSClient::get_memory_stats(void)
+{
+    return &_memory;
+}
+
+// Clear memory stats (allocations counts and stack peak, heap peak restarts from current usage)
+void MultiHTTPSClient::clear_memory_stats(void)
+{
+#ifdef MULTIHTTPSCLIENT_MEMORY_STATS
+    http_memory_clear(&_memory);
+#endif
+}
+
 /**************************************************************************************************/
 
 /* Private Methods */
@@ -275,7 +663,6 @@ bool MultiHTTPSClient::init(void)
     mbedtls_net_init(&_server_fd);
     mbedtls_ssl_init(&_tls);
     mbedtls_ssl_config_init(&_tls_cfg);
-    mbedtls_x509_crt_init(&_cacert);
     mbedtls_ctr_drbg_init(&_ctr_drbg);
     mbedtls_entropy_init(&_entropy);
     if((ret = mbedtls_ctr_drbg_seed(&_ctr_drbg, mbedtls_entropy_func, &_entropy,
@@ -286,14 +673,34 @@ bool MultiHTTPSClient::init(void)
         return false;
     }
 
-    // Load Certificate
-    if(_cert_https_server != NULL)
+    return true;
+}
+
+// Load the Certificate (it is parsed once here and kept between connections, so reconnections
+// doesn't need to parse it again)
+bool MultiHTTPSClient::load_cert(void)
+{
+    int ret = 0;
+
+    mbedtls_x509_crt_free(&_cacert);
+    mbedtls_x509_crt_init(&_cacert);
+    if(_cert_der != NULL)
+    {
+        ret = mbedtls_x509_crt_parse_der_nocopy(&_cacert, _cert_der, _cert_der_len);
+        if(ret < 0)
+        {
+            printf("[HTTPS] Error: Cannot load certificate. ");
+            printf("mbedtls_x509_crt_parse_der_nocopy returned -0x%x\n\n", -ret);
+            return false;
+        }
+    }
+    else if(_cert_https_server != NULL)
     {
         ret = mbedtls_x509_crt_parse(&_cacert, (const unsigned char*)_cert_https_server,
             strlen(_cert_https_server)+1);
         if(ret < 0)
         {
-            printf("[HTTPS] Error: Cannot initialize HTTPS client. ");
+            printf("[HTTPS] Error: Cannot load certificate. ");
             printf("mbedtls_x509_crt_parse returned -0x%x\n\n", -ret);
             return false;
         }
@@ -302,11 +709,203 @@ bool MultiHTTPSClient::init(void)
     return true;
 }
 
+// Resolve host and start a TCP connection to it (non-blocking connection returns without waiting
+// for it to be stablished)
+// Note: DNS resolution is always blocking
+bool MultiHTTPSClient::tcp_connect(const char* host, uint16_t port, const bool non_block)
+{
+    char str_port[6];
+
+    snprintf(str_port, 6, "%d", port);
+
+#if defined(__linux__)
+    struct addrinfo hints, *addr_list, *addr;
+    int fd = -1;
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+    if(getaddrinfo(host, str_port, &hints, &addr_list) != 0)
+    {
+        _printf("[HTTPS] Error: Can't connect to server (unknown host).\n");
+        return false;
+    }
+    _timing_phase(HTTP_PHASE_DNS);
+    for(addr = addr_list; addr != NULL; addr = addr->ai_next)
+    {
+        fd = socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
+        if(fd < 0)
+            continue;
+        no_delay(fd);
+        if(non_block)
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        if(::connect(fd, addr->ai_addr, addr->ai_addrlen) == 0)
+            break;
+        if(non_block && (errno == EINPROGRESS))
+            break;
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(addr_list);
+    if(fd < 0)
+    {
+        _printf("[HTTPS] Error: Can't connect to server (socket connect fail).\n");
+        return false;
+    }
+    _server_fd.fd = fd;
+#else
+    // Blocking TCP connection (DNS resolution time is measured as part of TCP connection), for
+    // non-blocking requests, just the TLS handshake is non-blocking
+    int ret = mbedtls_net_connect(&_server_fd, host, str_port, MBEDTLS_NET_PROTO_TCP);
+    if(ret != 0)
+    {
+        _printf("[HTTPS] Error: Can't connect to server ");
+        _printf("(mbedtls_net_connect returned %d).\n", ret);
+        return false;
+    }
+    if(non_block)
+        mbedtls_net_set_nonblock(&_server_fd);
+    no_delay(_server_fd.fd);
+#endif
+
+    return true;
+}
+
+// Disable Nagle algorithm in a socket, so small TLS records (handshake messages and requests)
+// are sent right away instead of waiting for the ACK of previous ones (server delayed ACK can
+// hold them up to 40 ms in Linux and 200 ms in Windows)
+void MultiHTTPSClient::no_delay(const int fd)
+{
+    int enable = 1;
+
+    if(setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, (const char*)&enable, sizeof(enable)) != 0)
+        _println(F("[HTTPS] Warning: Can't disable Nagle algorithm (TCP_NODELAY)."));
+}
+
+// Set SSL/TLS configuration, Hostname and Bio for a new connection
+// Blocking connections reads wait with a timeout (mbedtls_net_recv_timeout), so a stalled server
+// can't block them forever, while non-blocking ones never wait (poll() checks the timeout)
+bool MultiHTTPSClient::tls_setup(const char* host, const bool non_block)
+{
+    int ret;
+
+    // Set SSL/TLS configuration
+    if((ret = mbedtls_ssl_config_defaults(&_tls_cfg, MBEDTLS_SSL_IS_CLIENT,
+        MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_PRESET_DEFAULT)) != 0)
+    {
+        _printf("[HTTPS] Error: Can't connect to server ");
+        _printf("Default SSL/TLS configuration fail ");
+        _printf("(mbedtls_ssl_config_defaults returned %d).\n", ret);
+        return false;
+    }
+    mbedtls_ssl_conf_authmode(&_tls_cfg, MBEDTLS_SSL_VERIFY_OPTIONAL);
+    mbedtls_ssl_conf_ca_chain(&_tls_cfg, &_cacert, NULL);
+    mbedtls_ssl_conf_rng(&_tls_cfg, mbedtls_ctr_drbg_random, &_ctr_drbg);
+    mbedtls_ssl_conf_read_timeout(&_tls_cfg, HTTP_WAIT_RESPONSE_TIMEOUT);
+    //mbedtls_ssl_conf_dbg(&_tls_cfg, my_debug, stdout);
+
+    // SSL/TLS Server, Hostname and Bio setup
+    if((ret = mbedtls_ssl_setup( &_tls, &_tls_cfg)) != 0)
+    {
+        _printf("[HTTPS] Error: Can't connect to server ");
+        _printf("SSL/TLS setup fail (mbedtls_ssl_setup returned %d).\n", ret);
+        return false;
+    }
+    if((ret = mbedtls_ssl_set_hostname(&_tls, host)) != 0)
+    {
+        _printf("[HTTPS] Error: Can't connect to server. ");
+        _printf("Hostname setup fail (mbedtls_ssl_set_hostname returned %d).\n", ret);
+        return false;
+    }
+    if(non_block)
+        mbedtls_ssl_set_bio(&_tls, &_server_fd, mbedtls_net_send, mbedtls_net_recv, NULL);
+    else
+    {
+        mbedtls_ssl_set_bio(&_tls, &_server_fd, mbedtls_net_send, NULL,
+            mbedtls_net_recv_timeout);
+    }
+
+    // Try to resume previous connection session (abbreviated handshake if server accepts it)
+    if(_session_saved)
+    {
+        if((ret = mbedtls_ssl_set_session(&_tls, &_session)) != 0)
+        {
+            _printf("[HTTPS] Warning: Can't resume previous session ");
+            _printf("(mbedtls_ssl_set_session returned -0x%x).\n", -ret);
+        }
+    }
+
+    return true;
+}
+
+// Verify server certificate (if it was provided)
+int8_t MultiHTTPSClient::verify_cert(void)
+{
+    uint32_t flags;
+
+    if((_cert_https_server != NULL) || (_cert_der != NULL))
+    {
+        if((flags = mbedtls_ssl_get_verify_result(&_tls)) != 0)
+        {
+            char vrfy_buf[512];
+            mbedtls_x509_crt_verify_info(vrfy_buf, sizeof(vrfy_buf), "  ! ", flags);
+            _printf("[HTTPS] Warning: Invalid Server Certificate.\n%s\n", vrfy_buf);
+            return -1;
+        }
+    }
+
+    return 1;
+}
+
+// Account a completed handshake and keep its session to resume it in next connection
+// Note: A resumed session keeps the master secret of the session that was offered
+void MultiHTTPSClient::handshake_done(void)
+{
+    bool resumed;
+
+    resumed = _session_saved && (memcmp(_tls.session->master, _session.master,
+        sizeof(_session.master)) == 0);
+    if(resumed)
+        _counter_add(handshakes_resumed, 1);
+    else
+        _counter_add(handshakes_full, 1);
+
+    forget_session();
+    if(mbedtls_ssl_get_session(&_tls, &_session) == 0)
+        _session_saved = true;
+}
+
+// Release saved session (next connection will make a full handshake)
+void MultiHTTPSClient::forget_session(void)
+{
+    mbedtls_ssl_session_free(&_session);
+    mbedtls_ssl_session_init(&_session);
+    _session_saved = false;
+}
+
+// Abort non-blocking operation in progress and close the connection
+int8_t MultiHTTPSClient::async_fail(void)
+{
+    // Close the trace span of the operation in progress
+    if(_async_state == ASYNC_STATE_TCP_CONNECT)
+        _trace(CONNECT_END, 0);
+    else if(_async_state == ASYNC_STATE_HANDSHAKE)
+        _trace(HANDSHAKE_END, 0);
+    else if((_async_state == ASYNC_STATE_WRITE_HEADER) ||
+            (_async_state == ASYNC_STATE_WRITE_BODY))
+        _trace(WRITE_END, 0);
+
+    _async_state = ASYNC_STATE_IDLE;
+    _async_want_write = false;
+    disconnect();
+    return ASYNC_ERROR;
+}
+
 // Release all mbedtls context
 void MultiHTTPSClient::release_tls_elements(void)
 {
     mbedtls_net_free(&_server_fd);
-    mbedtls_x509_crt_free(&_cacert);
     mbedtls_ssl_free(&_tls);
     mbedtls_ssl_config_free(&_tls_cfg);
     mbedtls_ctr_drbg_free(&_ctr_drbg);
@@ -315,61 +914,139 @@ void MultiHTTPSClient::release_tls_elements(void)
 
 // HTTPS Write
 size_t MultiHTTPSClient::write(const char* request)
+{
+    return write(request, strlen(request));
+}
+
+// HTTPS Write of given length data (data bigger than a TLS record is sent in several records)
+size_t MultiHTTPSClient::write(const char* data, const size_t length)
 {
     size_t written_bytes = 0;
     int ret;
 
-    written_bytes = strlen(request);
-    while((ret = mbedtls_ssl_write(&_tls, (const unsigned char*)request, written_bytes)) <= 0)
+    _stack_probe();
+    while(written_bytes < length)
     {
-        if((ret != MBEDTLS_ERR_SSL_WANT_READ) && (ret != MBEDTLS_ERR_SSL_WANT_WRITE))
+        ret = mbedtls_ssl_write(&_tls, (const unsigned char*)data + written_bytes,
+            length - written_bytes);
+        if((ret == MBEDTLS_ERR_SSL_WANT_READ) || (ret == MBEDTLS_ERR_SSL_WANT_WRITE))
+            continue;
+        if(ret <= 0)
         {
             _printf(F("[HTTPS] Client write error -0x%x\n"), -ret);
-            return 0;
+            break;
         }
+        written_bytes = written_bytes + ret;
+        _counter_add(bytes_out, ret);
     }
-    written_bytes = ret;
 
     return written_bytes;
 }
 
-// HTTPS Read
-size_t MultiHTTPSClient::read(char* response, const size_t response_len)
+// HTTPS Read (wait for data up to the given timeout)
+// Returns number of bytes read, 0 if nothing was received in time, or -1 if server closed the
+// connection or on error
+int MultiHTTPSClient::read(char* response, const size_t response_len,
+        const unsigned long timeout)
 {
     int ret;
-_printf("Reading\n");
-    ret = mbedtls_ssl_read(&_tls, (unsigned char*)response, response_len);
-_printf("OK\n");
 
-    if(ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE)
-        return 0;
+    _stack_probe();
+    mbedtls_ssl_conf_read_timeout(&_tls_cfg, (uint32_t)timeout);
+    ret = mbedtls_ssl_read(&_tls, (unsigned char*)response, response_len);
 
-    if(ret < 0)
+    if((ret == MBEDTLS_ERR_SSL_WANT_READ) || (ret == MBEDTLS_ERR_SSL_WANT_WRITE) ||
+       (ret == MBEDTLS_ERR_SSL_TIMEOUT))
     {
-        _printf(F("[HTTPS] Client read error -0x%x\n"), -ret);
         return 0;
     }
-    if(ret == 0)
+    if((ret == 0) || (ret == MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY))
     {
         _printf(F("[HTTPS] Lost connection while client was reading.\n"));
-        return 0;
+        return -1;
     }
+    if(ret < 0)
+    {
+        _printf(F("[HTTPS] Client read error -0x%x\n"), -ret);
+        return -1;
+    }
+    _counter_add(bytes_in, ret);
 
-    return (size_t)ret;
+    return ret;
 }
 
-
-// HTTP Read Response
+// HTTP Read Response (until it is fully received, as given by its framing)
+// The whole response must be received before response_timeout, and responses without framing end
+// when the server closes the connection or after HTTP_RESPONSE_BETWEEN_BYTES_TIMEOUT without
+// receiving more bytes
+// Returns 0 on success, 1 on connection error, 2 on timeout and 3 if response doesn't fit
 uint8_t MultiHTTPSClient::read_response(char* response, const size_t response_max_len,
         const unsigned long response_timeout)
 {
-    size_t rc = 0;
+    unsigned long t0, t1, t2 = 0;
+    unsigned long wait_ms;
+    size_t total_bytes_read = 0;
+    int rc;
+
+    _framing.reset();
+    t0 = _millis();
+    while(true)
+    {
+        // Check for timeout
+        t1 = _millis();
+        if(t1 - t0 >= response_timeout)
+        {
+            _println(F("[HTTPS] Error: No response from server (timeout)."));
+            return 2;
+        }
+        wait_ms = response_timeout - (t1 - t0);
 
-    rc = read(response, response_max_len);
-    if(rc > 0)
-        return 0;
-    else
-        return 1;
+        // Responses without framing are complete when no more bytes are received for a while
+        if((t2 != 0) && _framing.until_close())
+        {
+            if(t1 - t2 >= HTTP_RESPONSE_BETWEEN_BYTES_TIMEOUT)
+                break;
+            if(HTTP_RESPONSE_BETWEEN_BYTES_TIMEOUT - (t1 - t2) < wait_ms)
+                wait_ms = HTTP_RESPONSE_BETWEEN_BYTES_TIMEOUT - (t1 - t2);
+        }
+
+        rc = read(response + total_bytes_read, response_max_len - 1 - total_bytes_read, wait_ms);
+        if(rc == 0)
+        {
+            // A connection opened with connect_async() has a non-blocking socket, so its reads
+            // return at once, wait for it here instead
+            if(_millis() - t1 < wait_ms)
+                http_socket_wait(get_socket(), false, wait_ms);
+            continue;
+        }
+        if(rc < 0)
+        {
+            // Response without framing ends when server closes the connection
+            if((total_bytes_read > 0) && _framing.until_close())
+                break;
+            return 1;
+        }
+
+        // First response bytes ends server wait phase, last ones ends transfer phase
+        if(total_bytes_read == 0)
+        {
+            _timing_phase(HTTP_PHASE_WAIT);
+            _trace(FIRST_BYTE, rc);
+        }
+        _timing_update(HTTP_PHASE_TRANSFER);
+        total_bytes_read = total_bytes_read + rc;
+        t2 = _millis();
+        if(_framing.update(response, total_bytes_read) == HTTP_FRAMING_COMPLETE)
+            break;
+        if(total_bytes_read >= response_max_len - 1)
+        {
+            _println(F("[HTTPS] Response read buffer full."));
+            return 3;
+        }
+    }
+    _trace(LAST_BYTE, total_bytes_read);
+
+    return 0;
 }
 
 /**************************************************************************************************/
@@ -21,9 +21,19 @@
 
 #if defined(WIN32) || defined(_WIN32) // Windows
     #include <windows.h>
+#elif defined(__linux__)
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <netdb.h>
+    #include <netinet/in.h>
+    #include <netinet/tcp.h>
+    #include <sys/socket.h>
+    #include <sys/types.h>
 #endif
 
+#include <ctype.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <time.h>
 #include <unistd.h>
 #include <inttypes.h>
@@ -39,6 +49,22 @@
 #include "mbedtls/debug.h"
 #include "mbedtls/error.h"
 
+// Requests phases timings, traffic counters and memory accounting
+#include "../../multihttpsclient_timings.h"
+#include "../../multihttpsclient_counters.h"
+#include "../../multihttpsclient_memory.h"
+#include "../../multihttpsclient_log.h"
+#include "../../multihttpsclient_trace.h"
+
+// HTTP response framing parser
+#include "../../multihttpsclient_framing.h"
+
+// HTTP request header templates
+#include "../../multihttpsclient_header.h"
+
+// Non-blocking operations driver
+#include "../../multihttpsclient_async.h"
+
 /**************************************************************************************************/
 
 /* Constants */
@@ -46,12 +72,10 @@
 // HTTP response wait timeout (ms)
 #define HTTP_WAIT_RESPONSE_TIMEOUT 5000
 
-// HTTP response between bytes receptions timeout (ms)
+// HTTP response between bytes receptions timeout (ms), it ends responses without framing
+// (responses with Content-Length or chunked transfer encoding end as soon as they are received)
 #define HTTP_RESPONSE_BETWEEN_BYTES_TIMEOUT 500
 
-// HTTP Request header max length
-#define HTTP_HEADER_MAX_LENGTH 256
-
 /**************************************************************************************************/
 
 class MultiHTTPSClient
@@ -63,6 +87,7 @@ class MultiHTTPSClient
         void set_debug(const bool debug);
         void set_cert(const char* cert_https_server);
         void set_cert(const uint8_t* ca_pem_start, const uint8_t* ca_pem_end);
+        bool set_cert_der(const uint8_t* ca_der, const size_t ca_der_len);
         int8_t connect(const char* host, uint16_t port);
         void disconnect();
         bool is_connected();
@@ -72,26 +97,85 @@ class MultiHTTPSClient
                 const size_t request_len, const size_t request_response_max_size,
                 const unsigned long response_timeout=HTTP_WAIT_RESPONSE_TIMEOUT);
 
+        // Non-blocking requests (operations are started and then driven by poll() calls)
+        int8_t connect_async(const char* host, uint16_t port);
+        int8_t post_async(const char* uri, const char* host, char* request_response,
+                const size_t request_len, const size_t request_response_max_size,
+                const unsigned long response_timeout=HTTP_WAIT_RESPONSE_TIMEOUT);
+        int8_t poll();
+        int get_socket();
+        bool poll_wants_write();
+        unsigned long poll_time_left();
+
+        // Last connection and request phases timings (MULTIHTTPSCLIENT_TIMINGS builds)
+        const http_timings* get_timings();
+        void clear_timings();
+
+        // Traffic counters since last clear (MULTIHTTPSCLIENT_COUNTERS builds)
+        const http_counters* get_counters();
+        void clear_counters();
+
+        // Heap and stack usage (MULTIHTTPSCLIENT_MEMORY_STATS builds)
+        const http_memory_stats* get_memory_stats();
+        void clear_memory_stats();
+
     private:
+        // Private Data Types
+        typedef enum async_state
+        {
+            ASYNC_STATE_IDLE,
+            ASYNC_STATE_TCP_CONNECT,
+            ASYNC_STATE_HANDSHAKE,
+            ASYNC_STATE_WRITE_HEADER,
+            ASYNC_STATE_WRITE_BODY,
+            ASYNC_STATE_READ
+        } async_state;
+
         // Private Attributtes
-        char _http_header[HTTP_HEADER_MAX_LENGTH];
+        http_request_header _header;
         const char* _cert_https_server;
+        const uint8_t* _cert_der;
+        size_t _cert_der_len;
         mbedtls_net_context _server_fd;
         mbedtls_entropy_context _entropy;
         mbedtls_ctr_drbg_context _ctr_drbg;
         mbedtls_ssl_context _tls;
         mbedtls_ssl_config _tls_cfg;
         mbedtls_x509_crt _cacert;
+        mbedtls_ssl_session _session;
+        bool _session_saved;
         bool _connected;
         bool _debug;
+        async_state _async_state;
+        char* _async_buffer;
+        size_t _async_len;
+        size_t _async_body_len;
+        size_t _async_done;
+        size_t _async_max_size;
+        unsigned long _async_t0;
+        unsigned long _async_timeout;
+        bool _async_want_write;
+        http_timings _timings;
+        http_counters _counters;
+        http_memory_stats _memory;
+        http_response_framing _framing;
 
         // Private Methods
         bool init();
+        bool load_cert();
         void release_tls_elements();
         size_t write(const char* request);
-        size_t read(char* response, const size_t response_len);
+        size_t write(const char* data, const size_t length);
+        int read(char* response, const size_t response_len, const unsigned long timeout);
         uint8_t read_response(char* response, const size_t response_max_len,
         const unsigned long response_timeout);
+        bool tcp_connect(const char* host, uint16_t port, const bool non_block);
+        void no_delay(const int fd);
+        bool tls_setup(const char* host, const bool non_block);
+        int8_t verify_cert();
+        void handshake_done();
+        void forget_session();
+        int8_t async_fail();
 };
 
 /**************************************************************************************************/
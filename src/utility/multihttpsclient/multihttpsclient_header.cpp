@@ -0,0 +1,219 @@
+/**************************************************************************************************/
+// File: multihttpsclient_header.cpp
+// Description: Portable HTTP/1.1 request header templates. The templates are built just when the
+//              request URI prefix (i.e. Bot token) or the host changes, and then each request just
+//              copies its path and Content-Length digits into it.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "multihttpsclient_header.h"
+
+#include <string.h>
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Header buffer room for the method, so the URI prefix is kept at the same position for "GET "
+// and "POST " requests
+#define METHOD_LENGTH 5
+
+// Header template parts (GET requests end after Accept field, and POST requests continue up to
+// Content-Length value)
+#define TEMPLATE_HOST "HTTP/1.1\r\nHost: "
+#define TEMPLATE_FIELDS "\r\nUser-Agent: MultiHTTPSClient\r\n" \
+    "Accept: text/html,application/xml,application/json\r\n"
+#define TEMPLATE_POST_FIELDS "Content-Type: application/json\r\nContent-Length: "
+
+// Host offset in the template (after the space that ends the URI)
+#define TEMPLATE_HOST_OFFSET (1 + sizeof(TEMPLATE_HOST) - 1)
+
+// Header end sequence
+#define HEADER_END "\r\n\r\n"
+#define HEADER_END_LENGTH 4
+
+// Max Content-Length digits (64 bits value)
+#define CONTENT_LENGTH_MAX_DIGITS 20
+
+/**************************************************************************************************/
+
+/* Constructor */
+
+// Request header constructor (templates are built on first request)
+http_request_header::http_request_header()
+{
+    reset();
+}
+
+/**************************************************************************************************/
+
+/* Public Methods */
+
+// Forget the templates (next request builds them again)
+void http_request_header::reset(void)
+{
+    _header[0] = '\0';
+    _template[0] = '\0';
+    _prefix_len = 0;
+    _host_len = 0;
+    _template_len = 0;
+    _start = 0;
+    _length = 0;
+}
+
+// Build the header of a request, patching the method, URI last segment and Content-Length value
+// into the templates (the templates are built again if URI prefix or host have changed)
+// Returns the header length (0 if it doesn't fit)
+size_t http_request_header::build(const uint8_t method, const char* uri, const char* host,
+        const size_t content_length)
+{
+    const char* path = strrchr(uri, '/');
+    size_t prefix_len = (path != NULL) ? (size_t)(path - uri) + 1 : 0;
+    size_t host_len = strlen(host);
+    size_t path_len = strlen(uri + prefix_len);
+    size_t template_len;
+    char digits[CONTENT_LENGTH_MAX_DIGITS];
+    size_t num_digits = 0;
+    uint64_t value = (uint64_t)content_length;
+    size_t length;
+
+    _length = 0;
+    if(!same_target(uri, prefix_len, host, host_len) &&
+       !set_target(uri, prefix_len, host, host_len))
+        return 0;
+
+    // GET requests don't have content fields
+    template_len = _template_len;
+    if(method != HTTP_METHOD_POST)
+        template_len = template_len - (sizeof(TEMPLATE_POST_FIELDS) - 1);
+    else
+    {
+        do
+        {
+            digits[CONTENT_LENGTH_MAX_DIGITS - 1 - num_digits] = '0' + (char)(value % 10);
+            num_digits = num_digits + 1;
+            value = value / 10;
+        } while(value != 0);
+    }
+    length = METHOD_LENGTH + _prefix_len + path_len + template_len + num_digits;
+    if(length + HEADER_END_LENGTH >= HTTP_HEADER_MAX_LENGTH)
+        return 0;
+
+    // Patch method, URI last segment and Content-Length value
+    if(method == HTTP_METHOD_POST)
+    {
+        memcpy(_header, "POST ", METHOD_LENGTH);
+        _start = 0;
+    }
+    else
+    {
+        memcpy(_header + 1, "GET ", METHOD_LENGTH - 1);
+        _start = 1;
+    }
+    length = METHOD_LENGTH + _prefix_len;
+    memcpy(_header + length, uri + _prefix_len, path_len);
+    length = length + path_len;
+    memcpy(_header + length, _template, template_len);
+    length = length + template_len;
+    if(method == HTTP_METHOD_POST)
+    {
+        memcpy(_header + length, digits + CONTENT_LENGTH_MAX_DIGITS - num_digits, num_digits);
+        length = length + num_digits;
+        memcpy(_header + length, HEADER_END, HEADER_END_LENGTH);
+        length = length + HEADER_END_LENGTH;
+    }
+    else
+    {
+        memcpy(_header + length, HEADER_END, HEADER_END_LENGTH/2);
+        length = length + HEADER_END_LENGTH/2;
+    }
+    _header[length] = '\0';
+    _length = length - _start;
+
+    return _length;
+}
+
+// Get last built header
+const char* http_request_header::get(void)
+{
+    return _header + _start;
+}
+
+// Get last built header length
+size_t http_request_header::length(void)
+{
+    return _length;
+}
+
+// Put last built header in front of the request body (in the body buffer), so the full request
+// can be sent with a single write (one TLS record and TCP segment, instead of a small header
+// segment that waits for the server delayed ACK with Nagle algorithm before the body is sent)
+// Returns the full request length, or 0 if the buffer has no room for it (body is not modified)
+size_t http_request_header::prepend(char* body, const size_t body_len,
+        const size_t body_max_size)
+{
+    if(_length + body_len >= body_max_size)
+        return 0;
+
+    memmove(body + _length, body, body_len);
+    memcpy(body, _header + _start, _length);
+    body[_length + body_len] = '\0';
+
+    return _length + body_len;
+}
+
+/**************************************************************************************************/
+
+/* Private Methods */
+
+// Check if the templates are the ones of an URI prefix and host
+bool http_request_header::same_target(const char* uri, const size_t prefix_len,
+        const char* host, const size_t host_len)
+{
+    if((_template_len == 0) || (prefix_len != _prefix_len) || (host_len != _host_len))
+        return false;
+    if(memcmp(_header + METHOD_LENGTH, uri, prefix_len) != 0)
+        return false;
+    return (memcmp(_template + TEMPLATE_HOST_OFFSET, host, host_len) == 0);
+}
+
+// Build the templates of an URI prefix and host
+bool http_request_header::set_target(const char* uri, const size_t prefix_len,
+        const char* host, const size_t host_len)
+{
+    size_t length = 0;
+
+    reset();
+    if((METHOD_LENGTH + prefix_len >= HTTP_HEADER_MAX_LENGTH) ||
+       (TEMPLATE_HOST_OFFSET + host_len + sizeof(TEMPLATE_FIELDS) - 1 +
+        sizeof(TEMPLATE_POST_FIELDS) - 1 >= HTTP_HEADER_TEMPLATE_MAX_LENGTH))
+        return false;
+
+    // URI prefix
+    memcpy(_header + METHOD_LENGTH, uri, prefix_len);
+
+    // Header fields from the space that ends the URI up to Content-Length name
+    _template[length] = ' ';
+    length = length + 1;
+    memcpy(_template + length, TEMPLATE_HOST, sizeof(TEMPLATE_HOST) - 1);
+    length = length + sizeof(TEMPLATE_HOST) - 1;
+    memcpy(_template + length, host, host_len);
+    length = length + host_len;
+    memcpy(_template + length, TEMPLATE_FIELDS, sizeof(TEMPLATE_FIELDS) - 1);
+    length = length + sizeof(TEMPLATE_FIELDS) - 1;
+    memcpy(_template + length, TEMPLATE_POST_FIELDS, sizeof(TEMPLATE_POST_FIELDS) - 1);
+    length = length + sizeof(TEMPLATE_POST_FIELDS) - 1;
+    _template[length] = '\0';
+
+    _prefix_len = prefix_len;
+    _host_len = host_len;
+    _template_len = length;
+
+    return true;
+}
+
+/**************************************************************************************************/
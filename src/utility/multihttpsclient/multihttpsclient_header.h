@@ -0,0 +1,77 @@
+/**************************************************************************************************/
+// File: multihttpsclient_header.h
+// Description: Portable HTTP/1.1 request header templates. The templates are built just when the
+//              request URI prefix (i.e. Bot token) or the host changes, and then each request just
+//              copies its path and Content-Length digits into it.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef MULTIHTTPSCLIENTHEADER_H_
+#define MULTIHTTPSCLIENTHEADER_H_
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// HTTP Request header max length
+#ifndef HTTP_HEADER_MAX_LENGTH
+    #define HTTP_HEADER_MAX_LENGTH 256
+#endif
+
+// HTTP Request header template (from the HTTP version to Content-Length name) max length, it
+// limits the host length (up to 43 characters)
+#ifndef HTTP_HEADER_TEMPLATE_MAX_LENGTH
+    #define HTTP_HEADER_TEMPLATE_MAX_LENGTH 192
+#endif
+
+// Request methods
+#define HTTP_METHOD_GET  0
+#define HTTP_METHOD_POST 1
+
+/**************************************************************************************************/
+
+/* Request Header Templates */
+
+// Request header of a client, the URI prefix (up to its last '/') is kept in the header buffer
+// and the rest of the header fields in the template, so a request patches the method, the URI
+// last segment (API command) and the Content-Length value
+class http_request_header
+{
+    public:
+        http_request_header();
+        void reset();
+        size_t build(const uint8_t method, const char* uri, const char* host,
+                const size_t content_length=0);
+        const char* get();
+        size_t length();
+        size_t prepend(char* body, const size_t body_len, const size_t body_max_size);
+
+    private:
+        char _header[HTTP_HEADER_MAX_LENGTH];
+        char _template[HTTP_HEADER_TEMPLATE_MAX_LENGTH];
+        size_t _prefix_len;
+        size_t _host_len;
+        size_t _template_len;
+        size_t _start;
+        size_t _length;
+
+        bool same_target(const char* uri, const size_t prefix_len, const char* host,
+                const size_t host_len);
+        bool set_target(const char* uri, const size_t prefix_len, const char* host,
+                const size_t host_len);
+};
+
+/**************************************************************************************************/
+
+#endif
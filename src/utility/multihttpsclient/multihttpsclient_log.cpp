@@ -0,0 +1,320 @@
+/**************************************************************************************************/
+// File: multihttpsclient_log.cpp
+// Description: Lock-free in-memory ring of fixed size debug log records, so requests and
+//              responses can be logged with debug enabled under load, and printed later from a
+//              background thread (Native) or when the application decides (drain on demand).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "multihttpsclient_log.h"
+
+/**************************************************************************************************/
+
+/* Check Build Configuration (just for debug enabled builds) */
+
+#ifndef MULTIHTTPSCLIENT_NO_DEBUG
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(ARDUINO)
+    #include <Arduino.h>
+#elif defined(ESP_IDF)
+    #include "esp_timer.h"
+#elif defined(WIN32) || defined(_WIN32)
+    #include <windows.h>
+    #include <atomic>
+    #include <chrono>
+    #include <thread>
+#else
+    #include <time.h>
+    #include <atomic>
+    #include <chrono>
+    #include <thread>
+#endif
+
+/**************************************************************************************************/
+
+/* Macros */
+
+// Ring positions and slots sequences accesses (ESP8266 is single core and has no preemptive
+// tasks, so there is no need of atomic operations, that it doesn't have)
+#if defined(ESP8266)
+    #define _load(x) (x)
+    #define _store(x, value) do { x = (value); } while(0)
+    #define _cas(x, expected, desired) \
+        (((x) == (expected)) ? ((x) = (desired), true) : ((expected) = (x), false))
+    #define _inc(x) do { x = x + 1; } while(0)
+#else
+    #define _load(x) __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+    #define _store(x, value) __atomic_store_n(&(x), (value), __ATOMIC_RELEASE)
+    #define _cas(x, expected, desired) __atomic_compare_exchange_n(&(x), &(expected), \
+        (desired), true, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)
+    #define _inc(x) __atomic_fetch_add(&(x), 1, __ATOMIC_RELAXED)
+#endif
+
+/**************************************************************************************************/
+
+/* Constants */
+
+#define HTTP_LOG_MASK (HTTP_LOG_RECORDS - 1)
+
+#if (HTTP_LOG_RECORDS & HTTP_LOG_MASK) != 0
+    #error HTTP_LOG_RECORDS must be a power of two
+#endif
+
+static const char* HTTP_LOG_LEVELS_NAMES[] = { "E", "W", "I", "D" };
+
+static const char* HTTP_LOG_PHASES_NAMES[HTTP_NUM_PHASES] =
+{
+    "dns", "tcp_connect", "tls_handshake", "write", "wait", "transfer"
+};
+
+/**************************************************************************************************/
+
+/* Data Types */
+
+// Ring slot
+// The sequence says the slot state for the ring position that maps to it: the position lap
+// (position without slot index bits) if it is free, or lap + 1 if it holds a record (so a zero
+// initialized ring is an empty ring)
+typedef struct http_log_slot
+{
+    uint32_t sequence;
+    http_log_record record;
+} http_log_slot;
+
+/**************************************************************************************************/
+
+/* Static Data */
+
+static http_log_slot log_ring[HTTP_LOG_RECORDS];
+static uint32_t log_write_pos = 0;
+static uint32_t log_read_pos = 0;
+static uint32_t log_dropped = 0;
+
+/**************************************************************************************************/
+
+/* Private Functions */
+
+// Get a milliseconds timestamp for the records
+static uint32_t log_now_ms(void)
+{
+#if defined(ARDUINO)
+    return (uint32_t)millis();
+#elif defined(ESP_IDF)
+    return (uint32_t)(esp_timer_get_time() / 1000);
+#elif defined(WIN32) || defined(_WIN32)
+    return (uint32_t)GetTickCount();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((ts.tv_sec*1000ULL) + (ts.tv_nsec/1000000ULL));
+#endif
+}
+
+/**************************************************************************************************/
+
+/* Functions */
+
+// Add a record to the log ring (never blocks, the record is dropped if the ring is full)
+// Just the first HTTP_LOG_EXCERPT_LENGTH - 1 bytes of data are copied
+bool http_log_write(const uint8_t level, const uint8_t phase, const char* data,
+    const size_t length)
+{
+    http_log_slot* slot;
+    uint32_t pos, lap, sequence;
+    size_t excerpt_length;
+
+    // Reserve a free slot
+    pos = _load(log_write_pos);
+    while(true)
+    {
+        slot = &log_ring[pos & HTTP_LOG_MASK];
+        lap = pos & ~((uint32_t)HTTP_LOG_MASK);
+        sequence = _load(slot->sequence);
+        if(sequence == lap)
+        {
+            if(_cas(log_write_pos, pos, pos + 1))
+                break;
+        }
+        else if((int32_t)(sequence - lap) < 0)
+        {
+            // Slot of previous lap still not read (ring full)
+            _inc(log_dropped);
+            return false;
+        }
+        else
+            pos = _load(log_write_pos);
+    }
+
+    // Fill the record and publish it
+    excerpt_length = length;
+    if(excerpt_length > HTTP_LOG_EXCERPT_LENGTH - 1)
+        excerpt_length = HTTP_LOG_EXCERPT_LENGTH - 1;
+    for(size_t i = 0; i < excerpt_length; i++)
+    {
+        if((uint8_t)data[i] < ' ')
+            slot->record.excerpt[i] = ' ';
+        else
+            slot->record.excerpt[i] = data[i];
+    }
+    slot->record.excerpt[excerpt_length] = '\0';
+    slot->record.time_ms = log_now_ms();
+    slot->record.length = (uint32_t)length;
+    slot->record.level = level;
+    slot->record.phase = phase;
+    _store(slot->sequence, lap + 1);
+
+    return true;
+}
+
+// Get and remove the oldest record from the log ring (false if it is empty)
+bool http_log_read(http_log_record* record)
+{
+    http_log_slot* slot;
+    uint32_t pos, lap, sequence;
+
+    // Take the oldest written slot
+    pos = _load(log_read_pos);
+    while(true)
+    {
+        slot = &log_ring[pos & HTTP_LOG_MASK];
+        lap = pos & ~((uint32_t)HTTP_LOG_MASK);
+        sequence = _load(slot->sequence);
+        if(sequence == lap + 1)
+        {
+            if(_cas(log_read_pos, pos, pos + 1))
+                break;
+        }
+        else if((int32_t)(sequence - (lap + 1)) < 0)
+            return false;
+        else
+            pos = _load(log_read_pos);
+    }
+
+    // Copy the record and free the slot for next lap
+    memcpy(record, &slot->record, sizeof(http_log_record));
+    _store(slot->sequence, lap + HTTP_LOG_RECORDS);
+
+    return true;
+}
+
+// Pass all records in the log ring to a sink (print them if no sink is given)
+// Returns the number of drained records
+size_t http_log_drain(http_log_sink sink, void* user_data)
+{
+    http_log_record record;
+    size_t num_records = 0;
+
+    if(sink == NULL)
+        sink = http_log_print;
+    while(http_log_read(&record))
+    {
+        sink(&record, user_data);
+        num_records = num_records + 1;
+    }
+
+    return num_records;
+}
+
+// Get number of records dropped because the log ring was full
+uint32_t http_log_dropped(void)
+{
+    return _load(log_dropped);
+}
+
+// Print a log record (default drain sink)
+void http_log_print(const http_log_record* record, void* user_data)
+{
+    const char* level = "?";
+    const char* phase = "-";
+
+    (void)user_data;
+    if(record->level <= HTTP_LOG_DEBUG)
+        level = HTTP_LOG_LEVELS_NAMES[record->level];
+    if(record->phase < HTTP_NUM_PHASES)
+        phase = HTTP_LOG_PHASES_NAMES[record->phase];
+
+#if defined(ARDUINO)
+    Serial.printf("[HTTPS] %lu %s %s (%lu bytes): %s\n", (unsigned long)record->time_ms, level,
+        phase, (unsigned long)record->length, record->excerpt);
+#else
+    printf("[HTTPS] %lu %s %s (%lu bytes): %s\n", (unsigned long)record->time_ms, level,
+        phase, (unsigned long)record->length, record->excerpt);
+#endif
+}
+
+/**************************************************************************************************/
+
+/* Background Drain Thread (just for Native builds) */
+
+#if !defined(ARDUINO) && !defined(ESP_IDF)
+
+// Drain thread holder (stop and join the thread at program exit)
+class http_log_drainer
+{
+    public:
+        std::thread thread;
+        std::atomic<bool> stop;
+        std::atomic<uint32_t> period_ms;
+
+        http_log_drainer() : stop(false), period_ms(HTTP_LOG_DRAIN_PERIOD_MS) {}
+        ~http_log_drainer()
+        {
+            stop = true;
+            if(thread.joinable())
+                thread.join();
+        }
+};
+
+static http_log_drainer log_drainer;
+
+// Drain thread loop (print all records periodically)
+static void log_drain_loop(void)
+{
+    while(!log_drainer.stop)
+    {
+        if(http_log_drain() == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(
+                (uint32_t)log_drainer.period_ms));
+        }
+        else
+            fflush(stdout);
+    }
+    http_log_drain();
+}
+
+// Launch a background thread that prints the log records (nothing to do if it is running)
+bool http_log_start_drain_thread(const uint32_t period_ms)
+{
+    log_drainer.period_ms = period_ms;
+    if(log_drainer.thread.joinable())
+        return true;
+    log_drainer.stop = false;
+    log_drainer.thread = std::thread(log_drain_loop);
+    return log_drainer.thread.joinable();
+}
+
+// Stop the background log drain thread (remaining records are printed before it ends)
+void http_log_stop_drain_thread(void)
+{
+    log_drainer.stop = true;
+    if(log_drainer.thread.joinable())
+        log_drainer.thread.join();
+}
+
+#endif
+
+/**************************************************************************************************/
+
+#endif
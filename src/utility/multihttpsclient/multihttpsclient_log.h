@@ -0,0 +1,99 @@
+/**************************************************************************************************/
+// File: multihttpsclient_log.h
+// Description: Lock-free in-memory ring of fixed size debug log records, so requests and
+//              responses can be logged with debug enabled under load, and printed later from a
+//              background thread (Native) or when the application decides (drain on demand).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef MULTIHTTPSCLIENTLOG_H_
+#define MULTIHTTPSCLIENTLOG_H_
+
+/**************************************************************************************************/
+
+/* Libraries Configurations */
+
+// Number of records in the ring (must be a power of two) and max data excerpt length of each one
+// Each record takes HTTP_LOG_EXCERPT_LENGTH + 16 bytes of RAM
+#ifndef HTTP_LOG_RECORDS
+    #if defined(ARDUINO) || defined(ESP_IDF)
+        #define HTTP_LOG_RECORDS 16
+    #else
+        #define HTTP_LOG_RECORDS 128
+    #endif
+#endif
+#ifndef HTTP_LOG_EXCERPT_LENGTH
+    #define HTTP_LOG_EXCERPT_LENGTH 112
+#endif
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "multihttpsclient_timings.h"
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Log levels
+#define HTTP_LOG_ERROR 0
+#define HTTP_LOG_WARNING 1
+#define HTTP_LOG_INFO 2
+#define HTTP_LOG_DEBUG 3
+
+// Records phases are the requests phases (HTTP_PHASE_*), or this one for not request phase logs
+#define HTTP_LOG_PHASE_NONE 0xFF
+
+// Default background drain period (Native)
+#define HTTP_LOG_DRAIN_PERIOD_MS 100
+
+/**************************************************************************************************/
+
+/* Data Types */
+
+// Log record (data excerpt is a null terminated copy of the first bytes of logged data, with
+// control characters replaced by spaces, and length is the full logged data length)
+typedef struct http_log_record
+{
+    uint32_t time_ms;
+    uint32_t length;
+    uint8_t level;
+    uint8_t phase;
+    char excerpt[HTTP_LOG_EXCERPT_LENGTH];
+} http_log_record;
+
+// Log records consumer
+typedef void (*http_log_sink)(const http_log_record* record, void* user_data);
+
+/**************************************************************************************************/
+
+/* Functions (just for debug enabled builds) */
+
+#ifndef MULTIHTTPSCLIENT_NO_DEBUG
+
+bool http_log_write(const uint8_t level, const uint8_t phase, const char* data,
+    const size_t length);
+bool http_log_read(http_log_record* record);
+size_t http_log_drain(http_log_sink sink=NULL, void* user_data=NULL);
+uint32_t http_log_dropped(void);
+void http_log_print(const http_log_record* record, void* user_data=NULL);
+
+// Background drain thread (just for Native builds)
+#if !defined(ARDUINO) && !defined(ESP_IDF)
+    bool http_log_start_drain_thread(const uint32_t period_ms=HTTP_LOG_DRAIN_PERIOD_MS);
+    void http_log_stop_drain_thread(void);
+#endif
+
+#endif
+
+/**************************************************************************************************/
+
+#endif
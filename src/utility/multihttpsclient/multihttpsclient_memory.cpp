@@ -0,0 +1,290 @@
+/**************************************************************************************************/
+// File: multihttpsclient_memory.cpp
+// Description: Optional heap and stack accounting (build with MULTIHTTPSCLIENT_MEMORY_STATS).
+//              mbedtls calloc/free are routed through MBEDTLS_PLATFORM_MEMORY hooks to count
+//              per client current and peak heap bytes and allocations, and a stack probe records
+//              the deepest stack usage seen from library entry points.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "multihttpsclient_memory.h"
+
+/**************************************************************************************************/
+
+/* Check Build Configuration (just for MULTIHTTPSCLIENT_MEMORY_STATS builds) */
+
+#ifdef MULTIHTTPSCLIENT_MEMORY_STATS
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <string.h>
+#include <assert.h>
+
+#if defined(ESP_IDF) || (defined(ARDUINO) && defined(ESP32))
+    #include "freertos/FreeRTOS.h"
+    #include "freertos/task.h"
+#endif
+
+// mbedtls allocations hooks (ESP8266 uses BearSSL, so there is just stack accounting there)
+#if !defined(ESP8266)
+    #include "mbedtls/platform.h"
+    #if defined(MBEDTLS_PLATFORM_MEMORY) && !defined(MBEDTLS_PLATFORM_CALLOC_MACRO)
+        #define HTTP_MEMORY_HOOKS
+    #endif
+#endif
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Allocation header (stats to account the free to, and allocation size), its size keeps the
+// returned memory aligned for any type (magic is just checked in debug builds, to catch a block
+// that was not allocated by the hooks)
+#define HTTP_MEMORY_HEADER_SIZE 16
+#define HTTP_MEMORY_MAGIC 0x6D656D73
+
+/**************************************************************************************************/
+
+/* Macros */
+
+// Current scope per thread (ESP8266 has no preemptive tasks, nor atomic operations, that are not
+// needed there)
+#if defined(ESP8266)
+    #define HTTP_MEMORY_THREAD_LOCAL
+    #define _load(x) (x)
+    #define _store(x, v) do { x = (v); } while(0)
+    #define _add(x, n) do { x = x + (n); } while(0)
+    #define _sub(x, n) do { x = x - (n); } while(0)
+    #define _cas(x, expected, value) ((x == expected) ? ((x = (value)), true) : false)
+#else
+    #define HTTP_MEMORY_THREAD_LOCAL __thread
+    #define _load(x) __atomic_load_n(&(x), __ATOMIC_RELAXED)
+    #define _store(x, v) __atomic_store_n(&(x), (v), __ATOMIC_RELAXED)
+    #define _add(x, n) __atomic_fetch_add(&(x), (n), __ATOMIC_RELAXED)
+    #define _sub(x, n) __atomic_fetch_sub(&(x), (n), __ATOMIC_RELAXED)
+    #define _cas(x, expected, value) __atomic_compare_exchange_n(&(x), &(expected), (value), \
+        false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)
+#endif
+
+/**************************************************************************************************/
+
+/* Data Types */
+
+typedef union http_memory_header
+{
+    struct
+    {
+        http_memory_stats* stats;
+        uint32_t size;
+        uint32_t magic;
+    } info;
+    uint8_t raw[HTTP_MEMORY_HEADER_SIZE];
+} http_memory_header;
+
+/**************************************************************************************************/
+
+/* Static Data */
+
+static http_memory_stats global_stats;
+static HTTP_MEMORY_THREAD_LOCAL http_memory_stats* scope_stats = NULL;
+static HTTP_MEMORY_THREAD_LOCAL uintptr_t scope_stack_base = 0;
+static bool hooks_installed = false;
+static bool scope_entered = false;
+
+/**************************************************************************************************/
+
+/* Private Functions */
+
+// Account an allocation (peak is updated with a compare and swap, so it is right even if some
+// threads allocate at the same time)
+static void account_alloc(http_memory_stats* stats, const uint32_t size)
+{
+    uint32_t current, peak;
+
+    _add(stats->allocs, 1);
+    _add(stats->current_bytes, size);
+    current = _load(stats->current_bytes);
+    peak = _load(stats->peak_bytes);
+    while(current > peak)
+    {
+        if(_cas(stats->peak_bytes, peak, current))
+            break;
+    }
+}
+
+static void account_free(http_memory_stats* stats, const uint32_t size)
+{
+    _add(stats->frees, 1);
+    _sub(stats->current_bytes, size);
+}
+
+#ifdef HTTP_MEMORY_HOOKS
+
+// mbedtls calloc hook: allocate room for the header, and account the allocation to the global
+// stats and to the current scope stats
+static void* hook_calloc(size_t n, size_t size)
+{
+    http_memory_header* header;
+    size_t total;
+
+    http_memory_stack_probe();
+
+    total = n * size;
+    if((size != 0) && (total / size != n))
+        return NULL;
+    header = (http_memory_header*)MBEDTLS_PLATFORM_STD_CALLOC(1, total + HTTP_MEMORY_HEADER_SIZE);
+    if(header == NULL)
+    {
+        _add(global_stats.failed_allocs, 1);
+        if(scope_stats != NULL)
+            _add(scope_stats->failed_allocs, 1);
+        return NULL;
+    }
+
+    header->info.stats = scope_stats;
+    header->info.size = (uint32_t)total;
+    header->info.magic = HTTP_MEMORY_MAGIC;
+    account_alloc(&global_stats, header->info.size);
+    if(scope_stats != NULL)
+        account_alloc(scope_stats, header->info.size);
+
+    return header->raw + HTTP_MEMORY_HEADER_SIZE;
+}
+
+// mbedtls free hook: the free is accounted to the stats of the allocation (that could be freed
+// from another scope)
+// Note: Hooks are installed before any mbedtls allocation (see http_memory_hooks_install()), so
+// every freed block has a header (memory before a block that has no header is never read)
+static void hook_free(void* ptr)
+{
+    http_memory_header* header;
+
+    if(ptr == NULL)
+        return;
+
+    header = (http_memory_header*)((uint8_t*)ptr - HTTP_MEMORY_HEADER_SIZE);
+    assert(header->info.magic == HTTP_MEMORY_MAGIC);
+    header->info.magic = 0;
+    account_free(&global_stats, header->info.size);
+    if(header->info.stats != NULL)
+        account_free(header->info.stats, header->info.size);
+    MBEDTLS_PLATFORM_STD_FREE(header);
+}
+
+// Install hooks before any static object constructor, so there is no mbedtls allocation done
+// before them (ESP-IDF and Arduino ESP32 run constructors before app_main() and setup() too)
+#if defined(__GNUC__)
+__attribute__((constructor(101))) static void hooks_auto_install(void)
+{
+    http_memory_hooks_install();
+}
+#endif
+
+#endif
+
+/**************************************************************************************************/
+
+/* Accounting Scope */
+
+// Hooks are not installed from here, as mbedtls could have allocated memory already
+http_memory_scope::http_memory_scope(http_memory_stats* stats)
+{
+    if(!_load(scope_entered))
+        _store(scope_entered, true);
+
+    _prev_stats = scope_stats;
+    _prev_stack_base = scope_stack_base;
+    scope_stats = stats;
+    if(scope_stack_base == 0)
+        scope_stack_base = (uintptr_t)this;
+}
+
+http_memory_scope::~http_memory_scope()
+{
+    scope_stats = _prev_stats;
+    scope_stack_base = _prev_stack_base;
+}
+
+/**************************************************************************************************/
+
+/* Functions */
+
+// Route mbedtls calloc/free through the accounting hooks (false if mbedtls is not built with
+// MBEDTLS_PLATFORM_MEMORY, so just stack is accounted)
+// Note: It must be called before any mbedtls allocation, as blocks allocated before can't be
+// freed through the hooks (it is called from a constructor in GCC builds, otherwise call it
+// at startup); once a client was used it is refused (asserted in debug builds)
+bool http_memory_hooks_install(void)
+{
+#ifdef HTTP_MEMORY_HOOKS
+    assert(hooks_installed || !_load(scope_entered));
+    if(!hooks_installed && !_load(scope_entered))
+        hooks_installed = (mbedtls_platform_set_calloc_free(hook_calloc, hook_free) == 0);
+#endif
+    return hooks_installed;
+}
+
+// Check if mbedtls heap allocations are being accounted
+bool http_memory_heap_accounted(void)
+{
+    return hooks_installed;
+}
+
+// Record the current stack depth (from the outermost scope) to the current scope stats
+// Note: It is called from mbedtls allocations (deep in handshake and records processing) and
+// from HALs read/write, so measured depth is a lower bound of the real peak
+__attribute__((noinline)) void http_memory_stack_probe(void)
+{
+    volatile uint8_t marker = 0;
+    uintptr_t depth;
+
+    if((scope_stats == NULL) || (scope_stack_base == 0))
+        return;
+
+    depth = scope_stack_base - (uintptr_t)&marker;
+    if((depth > UINT32_MAX) || (depth <= scope_stats->stack_peak_bytes))
+        return;
+    scope_stats->stack_peak_bytes = (uint32_t)depth;
+}
+
+// Get all mbedtls allocations stats (from all clients and from outside of them)
+void http_memory_get_global(http_memory_stats* stats)
+{
+    stats->current_bytes = _load(global_stats.current_bytes);
+    stats->peak_bytes = _load(global_stats.peak_bytes);
+    stats->allocs = _load(global_stats.allocs);
+    stats->frees = _load(global_stats.frees);
+    stats->failed_allocs = _load(global_stats.failed_allocs);
+    stats->stack_peak_bytes = 0;
+}
+
+// Clear memory stats (peak restarts from current usage)
+void http_memory_clear(http_memory_stats* stats)
+{
+    stats->peak_bytes = stats->current_bytes;
+    stats->allocs = 0;
+    stats->frees = 0;
+    stats->failed_allocs = 0;
+    stats->stack_peak_bytes = 0;
+}
+
+// Get current FreeRTOS task never used stack bytes (0 if not available), to size tasks stacks
+// together with the probed stack peak
+uint32_t http_memory_task_stack_unused(void)
+{
+#if defined(ESP_IDF) || (defined(ARDUINO) && defined(ESP32))
+    return (uint32_t)(uxTaskGetStackHighWaterMark(NULL) * sizeof(StackType_t));
+#else
+    return 0;
+#endif
+}
+
+/**************************************************************************************************/
+
+#endif
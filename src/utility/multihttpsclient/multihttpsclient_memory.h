@@ -0,0 +1,92 @@
+/**************************************************************************************************/
+// File: multihttpsclient_memory.h
+// Description: Optional heap and stack accounting (build with MULTIHTTPSCLIENT_MEMORY_STATS).
+//              mbedtls calloc/free are routed through MBEDTLS_PLATFORM_MEMORY hooks to count
+//              per client current and peak heap bytes and allocations, and a stack probe records
+//              the deepest stack usage seen from library entry points.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef MULTIHTTPSCLIENTMEMORY_H_
+#define MULTIHTTPSCLIENTMEMORY_H_
+
+/**************************************************************************************************/
+
+/* Libraries Configurations */
+
+// Enable memory accounting if uTLGBot memory stats are enabled
+#if defined(UTLGBOT_MEMORY_STATS) && !defined(MULTIHTTPSCLIENT_MEMORY_STATS)
+    #define MULTIHTTPSCLIENT_MEMORY_STATS
+#endif
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**************************************************************************************************/
+
+/* Data Types */
+
+// Memory usage of a client (heap bytes are mbedtls allocations, without accounting overhead;
+// stack peak is the deepest stack usage measured from the outermost client method call)
+typedef struct http_memory_stats
+{
+    uint32_t current_bytes;
+    uint32_t peak_bytes;
+    uint32_t allocs;
+    uint32_t frees;
+    uint32_t failed_allocs;
+    uint32_t stack_peak_bytes;
+} http_memory_stats;
+
+/**************************************************************************************************/
+
+/* Memory Accounting (just for MULTIHTTPSCLIENT_MEMORY_STATS builds) */
+
+#ifdef MULTIHTTPSCLIENT_MEMORY_STATS
+
+// Accounting scope: mbedtls allocations made while it lives (in the same thread) are accounted
+// to the given stats, and stack depth is measured from the outermost scope
+class http_memory_scope
+{
+    public:
+        http_memory_scope(http_memory_stats* stats);
+        ~http_memory_scope();
+
+    private:
+        http_memory_stats* _prev_stats;
+        uintptr_t _prev_stack_base;
+};
+
+bool http_memory_hooks_install();
+bool http_memory_heap_accounted();
+void http_memory_stack_probe();
+void http_memory_get_global(http_memory_stats* stats);
+void http_memory_clear(http_memory_stats* stats);
+uint32_t http_memory_task_stack_unused();
+
+#endif
+
+/**************************************************************************************************/
+
+/* Memory Accounting Macros (no code at all if memory accounting is disabled) */
+
+// Note: Each HAL provides a http_memory_stats _memory attribute
+#ifdef MULTIHTTPSCLIENT_MEMORY_STATS
+    #define _memory_scope() http_memory_scope _memory_scope_guard(&_memory)
+    #define _stack_probe() http_memory_stack_probe()
+#else
+    #define _memory_scope() do { } while(0)
+    #define _stack_probe() do { } while(0)
+#endif
+
+/**************************************************************************************************/
+
+#endif
@@ -0,0 +1,81 @@
+/**************************************************************************************************/
+// File: multihttpsclient_timings.h
+// Description: Optional HTTPS requests phases timings (build with MULTIHTTPSCLIENT_TIMINGS).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef MULTIHTTPSCLIENTTIMINGS_H_
+#define MULTIHTTPSCLIENTTIMINGS_H_
+
+/**************************************************************************************************/
+
+/* Libraries Configurations */
+
+// Enable requests phases timings if uTLGBot latency stats are enabled
+#if defined(UTLGBOT_LATENCY_STATS) && !defined(MULTIHTTPSCLIENT_TIMINGS)
+    #define MULTIHTTPSCLIENT_TIMINGS
+#endif
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <stdint.h>
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Request phases (not all of them can be measured in all HALs, i.e. ESP-IDF and Arduino
+// connections are measured as a whole TLS handshake phase)
+#define HTTP_PHASE_DNS           0
+#define HTTP_PHASE_TCP_CONNECT   1
+#define HTTP_PHASE_TLS_HANDSHAKE 2
+#define HTTP_PHASE_WRITE         3
+#define HTTP_PHASE_WAIT          4 // From request sent to first response byte
+#define HTTP_PHASE_TRANSFER      5 // From first to last response byte
+#define HTTP_NUM_PHASES          6
+
+/**************************************************************************************************/
+
+/* Data Types */
+
+// Last connection and request phases durations (us)
+typedef struct http_timings
+{
+    uint32_t phase_us[HTTP_NUM_PHASES];
+    uint32_t t_mark; // Current phase start time (us)
+    uint8_t measured; // Bit mask of measured phases since last clear
+} http_timings;
+
+/**************************************************************************************************/
+
+/* Timing Marks Macros (no code at all if timings are disabled) */
+
+// _timing_start(): Mark start of first phase
+// _timing_phase(phase): Phase ends now, next phase starts now
+// _timing_update(phase): Phase is still in progress, update its duration until now
+// Note: Each HAL provides _micros() and a http_timings _timings attribute
+#ifdef MULTIHTTPSCLIENT_TIMINGS
+    #define _timing_start() do { _timings.t_mark = (uint32_t)_micros(); } while(0)
+    #define _timing_phase(phase) do { \
+        uint32_t t_now = (uint32_t)_micros(); \
+        _timings.phase_us[phase] = t_now - _timings.t_mark; \
+        _timings.t_mark = t_now; \
+        _timings.measured = _timings.measured | (1 << (phase)); } while(0)
+    #define _timing_update(phase) do { \
+        _timings.phase_us[phase] = (uint32_t)_micros() - _timings.t_mark; \
+        _timings.measured = _timings.measured | (1 << (phase)); } while(0)
+#else
+    #define _timing_start() do { } while(0)
+    #define _timing_phase(phase) do { } while(0)
+    #define _timing_update(phase) do { } while(0)
+#endif
+
+/**************************************************************************************************/
+
+#endif
@@ -0,0 +1,271 @@
+/**************************************************************************************************/
+// File: multihttpsclient_trace.cpp
+// Description: Optional compile-time trace points at requests hot-path boundaries (build with
+//              MULTIHTTPSCLIENT_TRACE), recorded into a static events buffer and exported as
+//              Chrome trace-event JSON (and fired as USDT probes in Linux if sys/sdt.h exists).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "multihttpsclient_trace.h"
+
+/**************************************************************************************************/
+
+/* Check Build Configuration (just for MULTIHTTPSCLIENT_TRACE builds) */
+
+#ifdef MULTIHTTPSCLIENT_TRACE
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(ARDUINO)
+    #include <Arduino.h>
+    #if defined(ESP32)
+        #include "freertos/FreeRTOS.h"
+        #include "freertos/task.h"
+    #endif
+#elif defined(ESP_IDF)
+    #include "freertos/FreeRTOS.h"
+    #include "freertos/task.h"
+    #include "esp_timer.h"
+#elif defined(WIN32) || defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+/**************************************************************************************************/
+
+/* Macros */
+
+// Events buffer indexes accesses (ESP8266 is single core and has no preemptive tasks, so there
+// is no need of atomic operations, that it doesn't have)
+#if defined(ESP8266)
+    #define _load(x) (x)
+    #define _store(x, value) do { x = (value); } while(0)
+    #define _fetch_inc(x) (x++)
+#else
+    #define _load(x) __atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+    #define _store(x, value) __atomic_store_n(&(x), (value), __ATOMIC_RELEASE)
+    #define _fetch_inc(x) __atomic_fetch_add(&(x), 1, __ATOMIC_ACQ_REL)
+#endif
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Chrome trace-event JSON max length of each event
+#define HTTP_TRACE_JSON_EVENT_LENGTH 192
+#define HTTP_TRACE_JSON_BEGIN "{\"traceEvents\":["
+#define HTTP_TRACE_JSON_END "\n],\"displayTimeUnit\":\"ms\"}\n"
+
+// Trace points names, Chrome nestable async event phase (begin, end or instant) and argument name
+static const char* HTTP_TRACE_NAMES[HTTP_TRACE_NUM_POINTS] =
+{
+    "connect", "connect", "tls_handshake", "tls_handshake", "write", "write", "first_byte",
+    "last_byte", "parse", "parse", "dispatch", "dispatch"
+};
+static const char HTTP_TRACE_PHASES[HTTP_TRACE_NUM_POINTS] =
+{
+    'b', 'e', 'b', 'e', 'b', 'e', 'n', 'n', 'b', 'e', 'b', 'e'
+};
+static const char* HTTP_TRACE_ARGS[HTTP_TRACE_NUM_POINTS] =
+{
+    NULL, "ok", NULL, "ok", NULL, "bytes", "bytes", "bytes", NULL, "result", NULL, NULL
+};
+
+/**************************************************************************************************/
+
+/* Static Data */
+
+static http_trace_event trace_events[HTTP_TRACE_MAX_EVENTS];
+static uint32_t trace_next = 0;      // Next event to reserve (could be over max events)
+static uint32_t trace_committed = 0; // Number of fully written events
+static uint64_t trace_t0 = 0;
+static bool trace_enabled = false;
+
+/**************************************************************************************************/
+
+/* Private Functions */
+
+// Get monotonic time in microseconds
+static uint64_t trace_now_us(void)
+{
+#if defined(ARDUINO)
+    return (uint64_t)micros();
+#elif defined(ESP_IDF)
+    return (uint64_t)esp_timer_get_time();
+#elif defined(WIN32) || defined(_WIN32)
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (uint64_t)((count.QuadPart*1000000) / freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)((ts.tv_sec*1000000ULL) + (ts.tv_nsec/1000ULL));
+#endif
+}
+
+// Get an identifier of the calling thread (task)
+static uint32_t trace_thread_id(void)
+{
+#if defined(ESP_IDF) || (defined(ARDUINO) && defined(ESP32))
+    return (uint32_t)(uintptr_t)xTaskGetCurrentTaskHandle();
+#elif defined(ARDUINO)
+    return 0;
+#else
+    static uint32_t num_threads = 0;
+    static thread_local uint32_t thread_id = 0;
+    if(thread_id == 0)
+        thread_id = _fetch_inc(num_threads) + 1;
+    return thread_id;
+#endif
+}
+
+/**************************************************************************************************/
+
+/* Functions */
+
+// Record a trace point event (nothing to do if trace has not been started or the events buffer
+// is full)
+void http_trace(const uint8_t point, const void* id, const uint32_t arg)
+{
+    http_trace_event* event;
+    uint32_t index;
+
+    if(!_load(trace_enabled))
+        return;
+
+    index = _fetch_inc(trace_next);
+    if(index >= HTTP_TRACE_MAX_EVENTS)
+        return;
+
+    event = &trace_events[index];
+    event->time_us = (uint32_t)(trace_now_us() - trace_t0);
+    event->thread = trace_thread_id();
+    event->id = (uint32_t)(uintptr_t)id;
+    event->arg = arg;
+    event->point = point;
+    _fetch_inc(trace_committed);
+}
+
+// Clear recorded events and start recording
+void http_trace_start(void)
+{
+    _store(trace_enabled, false);
+    _store(trace_next, 0);
+    _store(trace_committed, 0);
+    trace_t0 = trace_now_us();
+    _store(trace_enabled, true);
+}
+
+// Stop recording (and wait for events that are being written right now)
+void http_trace_stop(void)
+{
+    _store(trace_enabled, false);
+    while(_load(trace_committed) < http_trace_num_events());
+}
+
+// Get number of recorded events
+uint32_t http_trace_num_events(void)
+{
+    uint32_t num_events = _load(trace_next);
+
+    if(num_events > HTTP_TRACE_MAX_EVENTS)
+        num_events = HTTP_TRACE_MAX_EVENTS;
+    return num_events;
+}
+
+// Get number of events that were not recorded because the events buffer was full
+uint32_t http_trace_dropped(void)
+{
+    uint32_t num_events = _load(trace_next);
+
+    if(num_events > HTTP_TRACE_MAX_EVENTS)
+        return num_events - HTTP_TRACE_MAX_EVENTS;
+    return 0;
+}
+
+// Get recorded events (stop recording before reading them)
+const http_trace_event* http_trace_events(void)
+{
+    return trace_events;
+}
+
+// Write recorded events as Chrome trace-event JSON (stop recording before writing them)
+// Each traced object (i.e. each client) is shown as a nestable async events track
+bool http_trace_write_json(http_trace_writer writer, void* user_data)
+{
+    char json_event[HTTP_TRACE_JSON_EVENT_LENGTH];
+    const http_trace_event* event;
+    uint32_t num_events = http_trace_num_events();
+    int length;
+
+    if(!writer(HTTP_TRACE_JSON_BEGIN, strlen(HTTP_TRACE_JSON_BEGIN), user_data))
+        return false;
+
+    for(uint32_t i = 0; i < num_events; i++)
+    {
+        event = &trace_events[i];
+        if(event->point >= HTTP_TRACE_NUM_POINTS)
+            continue;
+
+        length = snprintf(json_event, HTTP_TRACE_JSON_EVENT_LENGTH, "%s\n{\"name\":\"%s\"," \
+            "\"cat\":\"utlgbot\",\"ph\":\"%c\",\"id\":\"0x%08" PRIx32 "\",\"ts\":%" PRIu32 "," \
+            "\"pid\":1,\"tid\":%" PRIu32, (i == 0) ? "" : ",", HTTP_TRACE_NAMES[event->point],
+            HTTP_TRACE_PHASES[event->point], event->id, event->time_us, event->thread);
+        if(HTTP_TRACE_ARGS[event->point] != NULL)
+        {
+            length = length + snprintf(json_event + length,
+                HTTP_TRACE_JSON_EVENT_LENGTH - length, ",\"args\":{\"%s\":%" PRIu32 "}",
+                HTTP_TRACE_ARGS[event->point], event->arg);
+        }
+        length = length + snprintf(json_event + length, HTTP_TRACE_JSON_EVENT_LENGTH - length,
+            "}");
+
+        if(!writer(json_event, (size_t)length, user_data))
+            return false;
+    }
+
+    return writer(HTTP_TRACE_JSON_END, strlen(HTTP_TRACE_JSON_END), user_data);
+}
+
+#if !defined(ARDUINO)
+
+// File writer for trace export
+static bool trace_file_writer(const char* data, const size_t length, void* user_data)
+{
+    return (fwrite(data, 1, length, (FILE*)user_data) == length);
+}
+
+// Write recorded events as Chrome trace-event JSON file (open it in chrome://tracing or
+// https://ui.perfetto.dev)
+bool http_trace_export(const char* file_path)
+{
+    FILE* file;
+    bool rc;
+
+    file = fopen(file_path, "w");
+    if(file == NULL)
+        return false;
+    rc = http_trace_write_json(trace_file_writer, file);
+    if(fclose(file) != 0)
+        rc = false;
+
+    return rc;
+}
+
+#endif
+
+/**************************************************************************************************/
+
+#endif
@@ -0,0 +1,126 @@
+/**************************************************************************************************/
+// File: multihttpsclient_trace.h
+// Description: Optional compile-time trace points at requests hot-path boundaries (build with
+//              MULTIHTTPSCLIENT_TRACE), recorded into a static events buffer and exported as
+//              Chrome trace-event JSON (and fired as USDT probes in Linux if sys/sdt.h exists).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef MULTIHTTPSCLIENTTRACE_H_
+#define MULTIHTTPSCLIENTTRACE_H_
+
+/**************************************************************************************************/
+
+/* Libraries Configurations */
+
+// Enable trace points if uTLGBot trace is enabled
+#if defined(UTLGBOT_TRACE) && !defined(MULTIHTTPSCLIENT_TRACE)
+    #define MULTIHTTPSCLIENT_TRACE
+#endif
+
+// Maximum number of recorded events (each one takes 20 bytes of RAM)
+#ifndef HTTP_TRACE_MAX_EVENTS
+    #if defined(ARDUINO) || defined(ESP_IDF)
+        #define HTTP_TRACE_MAX_EVENTS 128
+    #else
+        #define HTTP_TRACE_MAX_EVENTS 65536
+    #endif
+#endif
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if defined(MULTIHTTPSCLIENT_TRACE) && defined(__linux__) && defined(__has_include)
+    #if __has_include(<sys/sdt.h>)
+        #include <sys/sdt.h>
+        #define HTTP_TRACE_USDT
+    #endif
+#endif
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Trace points (connection, handshake, request write and parse are spans, first and last
+// response bytes are instants)
+#define HTTP_TRACE_CONNECT_BEGIN   0
+#define HTTP_TRACE_CONNECT_END     1
+#define HTTP_TRACE_HANDSHAKE_BEGIN 2
+#define HTTP_TRACE_HANDSHAKE_END   3
+#define HTTP_TRACE_WRITE_BEGIN     4
+#define HTTP_TRACE_WRITE_END       5
+#define HTTP_TRACE_FIRST_BYTE      6
+#define HTTP_TRACE_LAST_BYTE       7
+#define HTTP_TRACE_PARSE_BEGIN     8
+#define HTTP_TRACE_PARSE_END       9
+#define HTTP_TRACE_DISPATCH_BEGIN  10
+#define HTTP_TRACE_DISPATCH_END    11
+#define HTTP_TRACE_NUM_POINTS      12
+
+/**************************************************************************************************/
+
+/* Data Types */
+
+// Recorded trace event (time is relative to trace start, id is the traced object, i.e. the
+// client, so each one gets its own timeline track)
+typedef struct http_trace_event
+{
+    uint32_t time_us;
+    uint32_t thread;
+    uint32_t id;
+    uint32_t arg;
+    uint8_t point;
+} http_trace_event;
+
+// Trace JSON output writer
+typedef bool (*http_trace_writer)(const char* data, const size_t length, void* user_data);
+
+/**************************************************************************************************/
+
+/* Trace Points Macro (no code at all if trace is disabled) */
+
+// Note: Point is the trace point name without HTTP_TRACE_ prefix (i.e. CONNECT_BEGIN), that is
+// also the USDT probe name of "utlgbot" provider
+#ifdef MULTIHTTPSCLIENT_TRACE
+    #ifdef HTTP_TRACE_USDT
+        #define HTTP_TRACE(point, id, arg) do { DTRACE_PROBE2(utlgbot, point, id, arg); \
+            http_trace(HTTP_TRACE_##point, id, (uint32_t)(arg)); } while(0)
+    #else
+        #define HTTP_TRACE(point, id, arg) \
+            do { http_trace(HTTP_TRACE_##point, id, (uint32_t)(arg)); } while(0)
+    #endif
+#else
+    #define HTTP_TRACE(point, id, arg) do { } while(0)
+#endif
+
+/**************************************************************************************************/
+
+/* Functions (just for trace enabled builds) */
+
+#ifdef MULTIHTTPSCLIENT_TRACE
+
+void http_trace(const uint8_t point, const void* id, const uint32_t arg);
+void http_trace_start(void);
+void http_trace_stop(void);
+uint32_t http_trace_num_events(void);
+uint32_t http_trace_dropped(void);
+const http_trace_event* http_trace_events(void);
+bool http_trace_write_json(http_trace_writer writer, void* user_data);
+
+#if !defined(ARDUINO)
+    bool http_trace_export(const char* file_path);
+#endif
+
+#endif
+
+/**************************************************************************************************/
+
+#endif
@@ -0,0 +1,374 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotaction.cpp
+// Description: Chat actions keep-alive scheduler for long-running handlers. It sends again the
+//              chat action (i.e. "typing") of each chat at an interval while a handler scope is
+//              alive, from its own sender (thread or task) and Bot connection.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "utlgbotaction.h"
+#include "utlgbotcommon.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Telegram flood control error code
+#define CHAT_ACTION_ERROR_TOO_MANY_REQUESTS 429
+
+/**************************************************************************************************/
+
+/* Constructor & Destructor */
+
+// Chat actions scheduler constructor, it sends the chat actions through the given Bot (use a Bot
+// just for it, so its connection is kept open between actions and the handlers never wait for it)
+// Note: The object holds the actions table (and ESP-IDF sender task stack), so create it as a
+// global or static object (not in a task stack)
+uTLGBotChatActions::uTLGBotChatActions(uTLGBot* bot)
+{
+    _bot = bot;
+    memset(_actions, 0, sizeof(_actions));
+    _num_active = 0;
+    _interval_ms = CHAT_ACTION_DEFAULT_INTERVAL_MS;
+#if !defined(ARDUINO)
+    _stop = false;
+#endif
+#if defined(ESP_IDF)
+    _mutex = xSemaphoreCreateMutexStatic(&_mutex_buffer);
+    _task = NULL;
+#endif
+}
+
+// Chat actions scheduler destructor, stop the sender
+uTLGBotChatActions::~uTLGBotChatActions(void)
+{
+#if !defined(ARDUINO)
+    stop();
+#endif
+}
+
+/**************************************************************************************************/
+
+/* Public Methods */
+
+// Set the interval to send again each chat action
+void uTLGBotChatActions::set_interval(const uint32_t interval_ms)
+{
+    lock();
+    _interval_ms = interval_ms;
+    unlock();
+}
+
+// Start a chat action, it is sent as soon as possible (by the sender, so the caller doesn't wait
+// for the request) and sent again at the interval until it is ended
+// Returns the action index to end it (-1 if actions table is full or arguments are too long)
+// Note: Scopes of the same chat and action share it, so it is kept until all of them end
+int16_t uTLGBotChatActions::begin(const char* chat_id, const char* action)
+{
+    int16_t free_slot = -1;
+    int16_t slot = -1;
+
+    if((strlen(chat_id) >= MAX_ID_LENGTH) || (strlen(action) >= CHAT_ACTION_MAX_LENGTH))
+        return -1;
+
+    lock();
+    for(uint16_t i = 0; i < UTLGBOT_CHAT_ACTIONS_MAX; i++)
+    {
+        if(_actions[i].users == 0)
+        {
+            if(free_slot == -1)
+                free_slot = (int16_t)i;
+            continue;
+        }
+        if((strcmp(_actions[i].chat_id, chat_id) == 0) &&
+           (strcmp(_actions[i].action, action) == 0))
+        {
+            slot = (int16_t)i;
+            break;
+        }
+    }
+    if(slot != -1)
+        _actions[slot].users = _actions[slot].users + 1;
+    else if(free_slot != -1)
+    {
+        slot = free_slot;
+        snprintf(_actions[slot].chat_id, MAX_ID_LENGTH, "%s", chat_id);
+        snprintf(_actions[slot].action, CHAT_ACTION_MAX_LENGTH, "%s", action);
+        _actions[slot].next_ms = utlgbot_now_ms();
+        _actions[slot].users = 1;
+        _num_active = _num_active + 1;
+    }
+    unlock();
+
+    // Let the sender send it now
+    if((slot != -1) && (slot == free_slot))
+        wake();
+
+    return slot;
+}
+
+// End a chat action (it is not sent again, and Telegram stops showing it when it expires or when
+// the Bot sends a message to the chat)
+void uTLGBotChatActions::end(const int16_t action)
+{
+    if((action < 0) || (action >= UTLGBOT_CHAT_ACTIONS_MAX))
+        return;
+
+    lock();
+    if(_actions[action].users > 0)
+    {
+        _actions[action].users = _actions[action].users - 1;
+        if(_actions[action].users == 0)
+            _num_active = _num_active - 1;
+    }
+    unlock();
+}
+
+// Send the chat action that has waited the longest among the ones that are due (just one
+// request is sent for each call, without holding the actions table, so handlers never wait for
+// it). In Arduino builds, call it from application loop (there is no sender task).
+// Returns true if a chat action request was sent
+bool uTLGBotChatActions::process(void)
+{
+    char chat_id[MAX_ID_LENGTH];
+    char action[CHAT_ACTION_MAX_LENGTH];
+    chat_action* due = NULL;
+    uint32_t now;
+    bool success;
+
+    // Get the due action and schedule its next send
+    lock();
+    now = utlgbot_now_ms();
+    for(uint16_t i = 0; i < UTLGBOT_CHAT_ACTIONS_MAX; i++)
+    {
+        if((_actions[i].users == 0) || !utlgbot_time_reached(now, _actions[i].next_ms))
+            continue;
+        if((due == NULL) || ((int32_t)(_actions[i].next_ms - due->next_ms) < 0))
+            due = &_actions[i];
+    }
+    if(due == NULL)
+    {
+        unlock();
+        return false;
+    }
+    memcpy(chat_id, due->chat_id, MAX_ID_LENGTH);
+    memcpy(action, due->action, CHAT_ACTION_MAX_LENGTH);
+    due->next_ms = now + _interval_ms;
+    unlock();
+
+    // Send it (flood control errors and requests without response retry it earlier or later)
+    success = _bot->sendChatAction(chat_id, action);
+    if(success)
+        return true;
+    lock();
+    if((due->users > 0) && (strcmp(due->chat_id, chat_id) == 0) &&
+       (strcmp(due->action, action) == 0))
+    {
+        now = utlgbot_now_ms();
+        if(_bot->get_last_error_code() == CHAT_ACTION_ERROR_TOO_MANY_REQUESTS)
+            due->next_ms = now + (_bot->get_retry_after() * 1000);
+        else if(_bot->get_last_error_code() == 0)
+            due->next_ms = now + CHAT_ACTION_RETRY_INTERVAL_MS;
+    }
+    unlock();
+
+    return true;
+}
+
+// Get number of active chat actions
+uint16_t uTLGBotChatActions::num_active(void)
+{
+    uint16_t num_active;
+
+    lock();
+    num_active = _num_active;
+    unlock();
+    return num_active;
+}
+
+#if defined(ESP_IDF)
+
+// Launch the sender task (no dynamic memory used)
+bool uTLGBotChatActions::start(const UBaseType_t priority, const BaseType_t core)
+{
+    if(_task != NULL)
+        return true;
+    if(_mutex == NULL)
+        return false;
+
+    _stop = false;
+    _task = xTaskCreateStaticPinnedToCore(sender_task, "utlgbot_actions",
+        UTLGBOT_CHAT_ACTIONS_TASK_STACK_SIZE/sizeof(StackType_t), this, priority, _task_stack,
+        &_task_buffer, core);
+
+    return (_task != NULL);
+}
+
+// Stop the sender task (it ends after the request in progress, if any)
+void uTLGBotChatActions::stop(void)
+{
+    if(_task == NULL)
+        return;
+
+    _stop = true;
+    wake();
+    while(_task != NULL)
+        vTaskDelay(1);
+}
+
+#elif !defined(ARDUINO)
+
+// Launch the sender thread
+bool uTLGBotChatActions::start(void)
+{
+    if(_thread.joinable())
+        return true;
+
+    _stop = false;
+    _thread = std::thread(&uTLGBotChatActions::sender_loop, this);
+    return true;
+}
+
+// Stop the sender thread (it ends after the request in progress, if any)
+void uTLGBotChatActions::stop(void)
+{
+    if(!_thread.joinable())
+        return;
+
+    lock();
+    _stop = true;
+    unlock();
+    wake();
+    _thread.join();
+}
+
+#endif
+
+/**************************************************************************************************/
+
+/* Private Methods */
+
+// Take the actions table
+void uTLGBotChatActions::lock(void)
+{
+#if defined(ESP_IDF)
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+#elif !defined(ARDUINO)
+    _mutex.lock();
+#endif
+}
+
+// Give back the actions table
+void uTLGBotChatActions::unlock(void)
+{
+#if defined(ESP_IDF)
+    xSemaphoreGive(_mutex);
+#elif !defined(ARDUINO)
+    _mutex.unlock();
+#endif
+}
+
+// Wake up the sender to check the due actions
+void uTLGBotChatActions::wake(void)
+{
+#if defined(ESP_IDF)
+    if(_task != NULL)
+        xTaskNotifyGive(_task);
+#elif !defined(ARDUINO)
+    _wake_cv.notify_one();
+#endif
+}
+
+// Get the time until next due action (table must be taken)
+uint32_t uTLGBotChatActions::time_to_next(const uint32_t now)
+{
+    uint32_t wait_ms = _interval_ms;
+
+    for(uint16_t i = 0; i < UTLGBOT_CHAT_ACTIONS_MAX; i++)
+    {
+        if(_actions[i].users == 0)
+            continue;
+        if(utlgbot_time_reached(now, _actions[i].next_ms))
+            return 0;
+        if(_actions[i].next_ms - now < wait_ms)
+            wait_ms = _actions[i].next_ms - now;
+    }
+    return wait_ms;
+}
+
+#if defined(ESP_IDF)
+
+// Sender task: send due actions and sleep until next one is due (or a new one is started)
+void uTLGBotChatActions::sender_task(void* arg)
+{
+    uTLGBotChatActions* actions = (uTLGBotChatActions*)arg;
+    uint32_t wait_ms;
+
+    while(!actions->_stop)
+    {
+        while(!actions->_stop && actions->process());
+        actions->lock();
+        wait_ms = actions->time_to_next(utlgbot_now_ms());
+        actions->unlock();
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait_ms) + 1);
+    }
+
+    actions->_task = NULL;
+    vTaskDelete(NULL);
+}
+
+#elif !defined(ARDUINO)
+
+// Sender thread: send due actions and sleep until next one is due (or a new one is started)
+void uTLGBotChatActions::sender_loop(void)
+{
+    uint32_t wait_ms;
+
+    while(true)
+    {
+        while(!_stop && process());
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        if(_stop)
+            break;
+        wait_ms = time_to_next(utlgbot_now_ms());
+        if(wait_ms > 0)
+            _wake_cv.wait_for(lock, std::chrono::milliseconds(wait_ms));
+    }
+}
+
+#endif
+
+/**************************************************************************************************/
+
+/* Chat Action Scope */
+
+// Chat action scope constructor, start the chat action
+uTLGBotChatActionScope::uTLGBotChatActionScope(uTLGBotChatActions* actions, const char* chat_id,
+    const char* action)
+{
+    _actions = actions;
+    _action = _actions->begin(chat_id, action);
+}
+
+// Chat action scope destructor, end the chat action
+uTLGBotChatActionScope::~uTLGBotChatActionScope(void)
+{
+    _actions->end(_action);
+}
+
+// Check if the chat action could be started
+bool uTLGBotChatActionScope::active(void)
+{
+    return (_action != -1);
+}
+
+/**************************************************************************************************/
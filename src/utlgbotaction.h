@@ -0,0 +1,155 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotaction.h
+// Description: Chat actions keep-alive scheduler for long-running handlers. It sends again the
+//              chat action (i.e. "typing") of each chat at an interval while a handler scope is
+//              alive, from its own sender (thread or task) and Bot connection.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef UTLGBOTACTION_H_
+#define UTLGBOTACTION_H_
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <inttypes.h>
+#include <stdint.h>
+
+#include "utlgbotlib.h"
+
+#if !defined(ARDUINO)
+    #include <atomic>
+#endif
+
+#if defined(ESP_IDF)
+    #include "freertos/FreeRTOS.h"
+    #include "freertos/task.h"
+    #include "freertos/semphr.h"
+#elif !defined(ARDUINO)
+    #include <chrono>
+    #include <condition_variable>
+    #include <mutex>
+    #include <thread>
+#endif
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Maximum number of chats with an active chat action
+#ifndef UTLGBOT_CHAT_ACTIONS_MAX
+    #if defined(ARDUINO) || defined(ESP_IDF)
+        #define UTLGBOT_CHAT_ACTIONS_MAX 4
+    #else
+        #define UTLGBOT_CHAT_ACTIONS_MAX 64
+    #endif
+#endif
+
+// ESP-IDF sender task stack size (bytes) and default priority
+#ifndef UTLGBOT_CHAT_ACTIONS_TASK_STACK_SIZE
+    #define UTLGBOT_CHAT_ACTIONS_TASK_STACK_SIZE 6144
+#endif
+#define DEFAULT_CHAT_ACTIONS_TASK_PRIORITY 4
+
+// Default interval to send again a chat action (ms), Telegram shows it for 5 seconds, so it is
+// sent before it expires (leaving time for the request round trip)
+#define CHAT_ACTION_DEFAULT_INTERVAL_MS 4000
+
+// Interval to retry a chat action that got no response (ms)
+#define CHAT_ACTION_RETRY_INTERVAL_MS 1000
+
+// Max chat action length ("upload_document")
+#define CHAT_ACTION_MAX_LENGTH 16
+
+/**************************************************************************************************/
+
+class uTLGBotChatActions
+{
+    public:
+        // Public Methods
+        uTLGBotChatActions(uTLGBot* bot);
+        ~uTLGBotChatActions();
+        void set_interval(const uint32_t interval_ms);
+        int16_t begin(const char* chat_id, const char* action=CHAT_ACTION_TYPING);
+        void end(const int16_t action);
+        bool process();
+        uint16_t num_active();
+#if defined(ESP_IDF)
+        bool start(const UBaseType_t priority=DEFAULT_CHAT_ACTIONS_TASK_PRIORITY,
+            const BaseType_t core=tskNO_AFFINITY);
+        void stop();
+#elif !defined(ARDUINO)
+        bool start();
+        void stop();
+#endif
+
+    private:
+        // Private Data Types
+        typedef struct chat_action
+        {
+            char chat_id[MAX_ID_LENGTH];
+            char action[CHAT_ACTION_MAX_LENGTH];
+            uint32_t next_ms;
+            uint16_t users;
+        } chat_action;
+
+        // Private Attributtes
+        uTLGBot* _bot;
+        chat_action _actions[UTLGBOT_CHAT_ACTIONS_MAX];
+        uint16_t _num_active;
+        uint32_t _interval_ms;
+#if !defined(ARDUINO)
+        std::atomic<bool> _stop;
+#endif
+#if defined(ESP_IDF)
+        SemaphoreHandle_t _mutex;
+        StaticSemaphore_t _mutex_buffer;
+        TaskHandle_t volatile _task;
+        StaticTask_t _task_buffer;
+        StackType_t _task_stack[UTLGBOT_CHAT_ACTIONS_TASK_STACK_SIZE/sizeof(StackType_t)];
+#elif !defined(ARDUINO)
+        std::mutex _mutex;
+        std::condition_variable _wake_cv;
+        std::thread _thread;
+#endif
+
+        // Private Methods
+        void lock();
+        void unlock();
+        void wake();
+        uint32_t time_to_next(const uint32_t now);
+#if defined(ESP_IDF)
+        static void sender_task(void* arg);
+#elif !defined(ARDUINO)
+        void sender_loop();
+#endif
+};
+
+/**************************************************************************************************/
+
+// Chat action handler scope: the chat action is kept alive from its construction until it is
+// destroyed (i.e. declare it at the start of a long-running handler)
+class uTLGBotChatActionScope
+{
+    public:
+        // Public Methods
+        uTLGBotChatActionScope(uTLGBotChatActions* actions, const char* chat_id,
+            const char* action=CHAT_ACTION_TYPING);
+        ~uTLGBotChatActionScope();
+        bool active();
+
+    private:
+        // Private Attributtes
+        uTLGBotChatActions* _actions;
+        int16_t _action;
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -0,0 +1,568 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotasync.cpp
+// Description: Native C++20 coroutines layer to receive and send messages without blocking,
+//              driven by a single thread scheduler.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Check Build System (just for Native builds with C++20 coroutines support) */
+
+#if !defined(ARDUINO) && !defined(ESP_IDF) && defined(__cpp_impl_coroutine)
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "utlgbotasync.h"
+#include "utlgbotmetrics.h"
+
+#if defined(WIN32) || defined(_WIN32)
+    #include <winsock2.h>
+    #include <windows.h>
+#else
+    #include <poll.h>
+#endif
+
+#include "utlgbotcommon.h"
+
+/**************************************************************************************************/
+
+/* Awaitables */
+
+// Next update awaitable constructor
+uTLGBotAsync::update_awaiter::update_awaiter(uTLGBotAsync* async, const char* chat_id)
+{
+    _async = async;
+    _msg = NULL;
+    if(chat_id != NULL)
+        _chat_id = chat_id;
+}
+
+// Don't suspend the flow if there is an already received message for it
+bool uTLGBotAsync::update_awaiter::await_ready(void)
+{
+    return _async->take_update(_chat_id, &_msg);
+}
+
+// Suspend the flow until a message for it is received
+void uTLGBotAsync::update_awaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    update_waiter waiter;
+
+    waiter.handle = handle;
+    waiter.chat_id = _chat_id;
+    waiter.msg = &_msg;
+    _async->_update_waiters.push_back(waiter);
+}
+
+// Get the received message (the flow must release it when it is done with it)
+tlg_type_message* uTLGBotAsync::update_awaiter::await_resume(void)
+{
+    return _msg;
+}
+
+// Send message awaitable constructor
+uTLGBotAsync::send_awaiter::send_awaiter(uTLGBotAsync* async, const char* chat_id,
+    const char* text, const bool escaped)
+{
+    _async = async;
+    _chat_id = chat_id;
+    _text = text;
+    _escaped = escaped;
+    _result = false;
+}
+
+// Always suspend the flow until the message is sent
+bool uTLGBotAsync::send_awaiter::await_ready(void)
+{
+    return false;
+}
+
+// Queue the message to be sent
+// Note: A text that doesn't fit in a message is split once here and queued as several ordered
+// requests with its bodies already built (the flow is resumed when the last one is sent, and the
+// result is false if any of them fails)
+void uTLGBotAsync::send_awaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    uTLGBotTextSplitter splitter(_text.c_str(), "", _escaped);
+    send_request request;
+
+    request.handle = nullptr;
+    request.command = API_CMD_SEND_MSG;
+    request.result = &_result;
+    _result = true;
+    while(!splitter.done())
+    {
+        if(!_async->_bot.create_msg_body(_async->_body_buffer, HTTP_MAX_RES_LENGTH,
+            _chat_id.c_str(), &splitter, "", false, false, 0, NULL))
+            break;
+        request.body = _async->_body_buffer;
+        if(splitter.done())
+            request.handle = handle;
+        _async->_send_queue.push_back(request);
+    }
+
+    // Body can't be created, queue a request without body to give the fail result to the flow
+    if(request.handle == nullptr)
+    {
+        request.handle = handle;
+        request.body.clear();
+        _async->_send_queue.push_back(request);
+    }
+}
+
+// Get send result
+bool uTLGBotAsync::send_awaiter::await_resume(void)
+{
+    return _result;
+}
+
+/**************************************************************************************************/
+
+/* Constructor & Destructor */
+
+// Async layer constructor (Bot client is used for getUpdates, and a second client for sends)
+uTLGBotAsync::uTLGBotAsync(uTLGBot& bot) : _bot(bot)
+{
+    _send_buffer[0] = '\0';
+    _body_buffer[0] = '\0';
+    _poll_state = ASYNC_OP_IDLE;
+    _send_state = ASYNC_OP_IDLE;
+    _send_reused = false;
+    _poll_retry_time = utlgbot_now_ms();
+    _stop = false;
+
+    if(_bot._tlg_api_ca_der != NULL)
+        _send_client.set_cert_der(_bot._tlg_api_ca_der, _bot._tlg_api_ca_der_len);
+    else if(_bot._tlg_api_ca_pem_start != NULL)
+        _send_client.set_cert(_bot._tlg_api_ca_pem_start, _bot._tlg_api_ca_pem_end);
+    _send_client.set_debug(_bot._debug_level > 1);
+}
+
+// Async layer destructor, release the frames of the flows that are still waiting
+// Note: A flow waits in a single place, and a send split in several requests has the flow handle
+// just in the last one
+uTLGBotAsync::~uTLGBotAsync(void)
+{
+    for(size_t i = 0; i < _ready.size(); i++)
+        _ready[i].destroy();
+    for(size_t i = 0; i < _update_waiters.size(); i++)
+        _update_waiters[i].handle.destroy();
+    for(size_t i = 0; i < _send_queue.size(); i++)
+    {
+        if(_send_queue[i].handle)
+            _send_queue[i].handle.destroy();
+    }
+}
+
+/**************************************************************************************************/
+
+/* Public Methods */
+
+// Get an awaitable for next received message (co_await bot.next_update())
+// If a chat ID is provided, just messages from that chat are returned to this flow
+uTLGBotAsync::update_awaiter uTLGBotAsync::next_update(const char* chat_id)
+{
+    return update_awaiter(this, chat_id);
+}
+
+// Get an awaitable that send a text message (co_await bot.send(chat_id, text))
+uTLGBotAsync::send_awaiter uTLGBotAsync::send(const char* chat_id, const char* text)
+{
+    return send_awaiter(this, chat_id, text, false);
+}
+
+// Get an awaitable that send an already JSON escaped text message, i.e. a received text
+// (co_await bot.send_escaped(msg->chat.id, msg->text))
+uTLGBotAsync::send_awaiter uTLGBotAsync::send_escaped(const char* chat_id, const char* text)
+{
+    return send_awaiter(this, chat_id, text, true);
+}
+
+// Release a received message, so its pool slot can be used for next received messages
+void uTLGBotAsync::release(tlg_type_message* msg)
+{
+    if(msg != NULL)
+        _free.push_back(msg);
+}
+
+// Run the scheduler until stop() is called
+void uTLGBotAsync::run(void)
+{
+    _stop = false;
+    while(!_stop)
+        run_once();
+}
+
+// Run a scheduler iteration: resume ready flows, drive requests and wait for sockets events
+void uTLGBotAsync::run_once(const unsigned long max_wait_ms)
+{
+    std::deque< std::coroutine_handle<> > ready;
+
+    // Resume flows (they can queue new requests or become ready again)
+    ready.swap(_ready);
+    while(!ready.empty())
+    {
+        std::coroutine_handle<> handle = ready.front();
+        ready.pop_front();
+        HTTP_TRACE(DISPATCH_BEGIN, this, 0);
+        handle.resume();
+        HTTP_TRACE(DISPATCH_END, this, 0);
+    }
+
+    drive_updates();
+    drive_sends();
+    wait_sockets(max_wait_ms);
+}
+
+// Stop the scheduler (run() returns after current iteration)
+void uTLGBotAsync::stop(void)
+{
+    _stop = true;
+}
+
+// Get number of flows waiting for a message
+size_t uTLGBotAsync::num_waiting_flows(void)
+{
+    return _update_waiters.size();
+}
+
+/**************************************************************************************************/
+
+/* Private Methods */
+
+// Take the first already received message for given chat (any chat if chat ID is empty)
+bool uTLGBotAsync::take_update(const std::string& chat_id, tlg_type_message** msg)
+{
+    for(std::deque<tlg_type_message*>::iterator it = _updates.begin(); it != _updates.end(); ++it)
+    {
+        if(chat_id.empty() || (chat_id == (*it)->chat.id))
+        {
+            *msg = *it;
+            _updates.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Take a free messages pool slot (pool grows when all slots are taken, and deque elements never
+// move, so taken slots stay valid)
+tlg_type_message* uTLGBotAsync::take_slot(void)
+{
+    tlg_type_message* msg;
+
+    if(_free.empty())
+    {
+        _pool.emplace_back();
+        return &_pool.back();
+    }
+    msg = _free.back();
+    _free.pop_back();
+    return msg;
+}
+
+// Give a received message to the flow waiting for that chat (or to the first flow waiting for
+// any chat), or keep it until some flow ask for it
+void uTLGBotAsync::dispatch_update(tlg_type_message* msg)
+{
+    std::deque<update_waiter>::iterator target = _update_waiters.end();
+
+    for(std::deque<update_waiter>::iterator it = _update_waiters.begin();
+        it != _update_waiters.end(); ++it)
+    {
+        if(it->chat_id == msg->chat.id)
+        {
+            target = it;
+            break;
+        }
+        if(it->chat_id.empty() && (target == _update_waiters.end()))
+            target = it;
+    }
+
+    if(target == _update_waiters.end())
+    {
+        _updates.push_back(msg);
+        return;
+    }
+
+    *(target->msg) = msg;
+    _ready.push_back(target->handle);
+    _update_waiters.erase(target);
+}
+
+// Queue a callback query answer ahead of any queued message, so it is sent before the flow that
+// handles the query is resumed (the request in progress, if any, stays first)
+void uTLGBotAsync::queue_callback_answer(const char* callback_query_id)
+{
+    std::deque<send_request>::iterator position = _send_queue.begin();
+    send_request request;
+
+    request.handle = nullptr;
+    request.command = API_CMD_ANSWER_CALLBACK;
+    if(_bot.create_answer_callback_body(_body_buffer, HTTP_MAX_RES_LENGTH, callback_query_id,
+        "", false))
+        request.body = _body_buffer;
+    request.result = NULL;
+    if((_send_state != ASYNC_OP_IDLE) && (position != _send_queue.end()))
+        ++position;
+    while((position != _send_queue.end()) &&
+          (strcmp(position->command, API_CMD_ANSWER_CALLBACK) == 0))
+        ++position;
+    _send_queue.insert(position, request);
+}
+
+// Drive getUpdates requests through Bot client (just while some flow is waiting for messages)
+void uTLGBotAsync::drive_updates(void)
+{
+    MultiHTTPSClient& client = _bot._client;
+    char uri[HTTP_MAX_URI_LENGTH];
+    int8_t rc;
+
+    while(true)
+    {
+        if(_poll_state == ASYNC_OP_IDLE)
+        {
+            if(_update_waiters.empty() ||
+               !utlgbot_time_reached(utlgbot_now_ms(), _poll_retry_time))
+                return;
+
+            if(!client.is_connected())
+            {
+                _poll_state = ASYNC_OP_CONNECT;
+                rc = client.connect_async(TELEGRAM_HOST, HTTPS_PORT);
+            }
+            else
+            {
+                _bot.create_getupdates_body(_bot._buffer, HTTP_MAX_RES_LENGTH);
+                snprintf(uri, HTTP_MAX_URI_LENGTH, "%s/%s", _bot._tlg_api, API_CMD_GET_UPDATES);
+                _poll_state = ASYNC_OP_REQUEST;
+                rc = client.post_async(uri, TELEGRAM_HOST, _bot._buffer, strlen(_bot._buffer),
+                    HTTP_MAX_RES_LENGTH,
+                    (_bot._long_poll_timeout*1000)+HTTP_WAIT_RESPONSE_TIMEOUT);
+            }
+        }
+        else
+            rc = client.poll();
+
+        if(rc == ASYNC_IN_PROGRESS)
+            return;
+        if(rc == ASYNC_ERROR)
+        {
+#if defined(UTLGBOT_LATENCY_STATS)
+            if(_poll_state == ASYNC_OP_REQUEST)
+                _bot.latency_record(API_CMD_GET_UPDATES, &client);
+#endif
+#if defined(UTLGBOT_METRICS)
+            if(_poll_state == ASYNC_OP_REQUEST)
+                metrics_request(API_CMD_GET_UPDATES, METRICS_RESULT_NO_RESPONSE);
+            metrics_record_client(&client);
+#endif
+            _poll_state = ASYNC_OP_IDLE;
+            _poll_retry_time = utlgbot_now_ms() + ASYNC_RETRY_DELAY;
+            return;
+        }
+
+        // Request completed, parse the response and give the message to its flow
+        if(_poll_state == ASYNC_OP_REQUEST)
+        {
+            tlg_type_message* msg = take_slot();
+            uint8_t num_updates = 0;
+#if defined(UTLGBOT_LATENCY_STATS)
+            _bot.latency_parse_begin();
+#endif
+            HTTP_TRACE(PARSE_BEGIN, &client, 0);
+            if(!_bot.tlg_parse_response(_bot._buffer, HTTP_MAX_RES_LENGTH))
+                _poll_retry_time = utlgbot_now_ms() + ASYNC_RETRY_DELAY;
+            else
+                num_updates = _bot.parse_update(_bot._buffer, msg);
+            HTTP_TRACE(PARSE_END, &client, num_updates);
+#if defined(UTLGBOT_LATENCY_STATS)
+            _bot.latency_parse_end();
+            _bot.latency_record(API_CMD_GET_UPDATES, &client);
+#endif
+#if defined(UTLGBOT_METRICS)
+            metrics_request(API_CMD_GET_UPDATES, _bot._metrics_result);
+            metrics_record_client(&client);
+#endif
+            if(num_updates != 0)
+            {
+                if(_bot._callback_auto_answer && (msg->update_type == UPDATE_CALLBACK_QUERY) &&
+                   (msg->callback_query.id[0] != '\0'))
+                {
+                    queue_callback_answer(msg->callback_query.id);
+                    msg->callback_query.answered = true;
+                }
+                dispatch_update(msg);
+            }
+            else
+                release(msg);
+
+            // Give the turn to ready flows and sends (a fast server would keep this loop busy)
+            _poll_state = ASYNC_OP_IDLE;
+            return;
+        }
+        _poll_state = ASYNC_OP_IDLE;
+    }
+}
+
+// Drive queued sendMessage and answerCallbackQuery requests through send client (one request at a
+// time)
+void uTLGBotAsync::drive_sends(void)
+{
+    char uri[HTTP_MAX_URI_LENGTH];
+    bool result;
+    int8_t rc;
+
+    while(true)
+    {
+        if(_send_state == ASYNC_OP_IDLE)
+        {
+            if(_send_queue.empty())
+                return;
+
+            if(!_send_client.is_connected())
+            {
+                _send_state = ASYNC_OP_CONNECT;
+                _send_reused = false;
+                rc = _send_client.connect_async(TELEGRAM_HOST, HTTPS_PORT);
+            }
+            else
+            {
+                // Copy the queued body into the request and response buffer
+                send_request& request = _send_queue.front();
+                if(request.body.empty() || (request.body.size() >= HTTP_MAX_RES_LENGTH))
+                    rc = ASYNC_ERROR;
+                else
+                {
+                    memcpy(_send_buffer, request.body.c_str(), request.body.size() + 1);
+                    snprintf(uri, HTTP_MAX_URI_LENGTH, "%s/%s", _bot._tlg_api,
+                        request.command);
+                    rc = _send_client.post_async(uri, TELEGRAM_HOST, _send_buffer,
+                        request.body.size(), HTTP_MAX_RES_LENGTH);
+                }
+                _send_state = ASYNC_OP_REQUEST;
+            }
+        }
+        else
+            rc = _send_client.poll();
+
+        if(rc == ASYNC_IN_PROGRESS)
+            return;
+
+        // Connected, continue with the request
+        if((rc == ASYNC_DONE) && (_send_state == ASYNC_OP_CONNECT))
+        {
+            _send_state = ASYNC_OP_IDLE;
+            continue;
+        }
+
+        // Server can close a kept alive connection while it is idle, so a request that fails on a
+        // reused connection is sent again once through a new connection
+        if((rc == ASYNC_ERROR) && (_send_state == ASYNC_OP_REQUEST) && _send_reused &&
+           !_send_queue.front().body.empty())
+        {
+            _send_reused = false;
+            _send_state = ASYNC_OP_IDLE;
+            continue;
+        }
+
+        // Request completed or failed, give the result to its flow
+        result = false;
+#if defined(UTLGBOT_LATENCY_STATS)
+        _bot.latency_parse_begin();
+#endif
+        if(rc == ASYNC_DONE)
+            result = _bot.tlg_parse_response(_send_buffer, HTTP_MAX_RES_LENGTH);
+#if defined(UTLGBOT_LATENCY_STATS)
+        _bot.latency_parse_end();
+        _bot.latency_record(_send_queue.front().command, &_send_client);
+#endif
+#if defined(UTLGBOT_METRICS)
+        metrics_request(_send_queue.front().command, (rc == ASYNC_DONE) ? _bot._metrics_result :
+            METRICS_RESULT_NO_RESPONSE);
+        metrics_record_client(&_send_client);
+#endif
+        if(_send_queue.front().result != NULL)
+            *(_send_queue.front().result) = *(_send_queue.front().result) && result;
+        if(_send_queue.front().handle)
+            _ready.push_back(_send_queue.front().handle);
+        _send_queue.pop_front();
+        _send_state = ASYNC_OP_IDLE;
+        _send_reused = true;
+    }
+}
+
+// Wait until some socket with an operation in progress is ready (or max wait time elapsed)
+void uTLGBotAsync::wait_sockets(const unsigned long max_wait_ms)
+{
+    unsigned long wait_ms = max_wait_ms;
+    uint32_t t_now;
+
+    // Don't wait if there are flows ready to run
+    if(!_ready.empty())
+        return;
+
+    // Don't wait more than next getUpdates retry time
+    t_now = utlgbot_now_ms();
+    if((_poll_state == ASYNC_OP_IDLE) && !_update_waiters.empty() &&
+       !utlgbot_time_reached(t_now, _poll_retry_time))
+    {
+        if(_poll_retry_time - t_now < wait_ms)
+            wait_ms = _poll_retry_time - t_now;
+    }
+
+#if defined(WIN32) || defined(_WIN32)
+    // Winsock select() fails without sockets, so just sleep if there is none
+    fd_set read_fds, write_fds;
+    struct timeval tv;
+    bool wait_socket = false;
+
+    FD_ZERO(&read_fds);
+    FD_ZERO(&write_fds);
+    if(_poll_state != ASYNC_OP_IDLE)
+    {
+        FD_SET((SOCKET)_bot._client.get_socket(),
+            _bot._client.poll_wants_write() ? &write_fds : &read_fds);
+        wait_socket = true;
+    }
+    if(_send_state != ASYNC_OP_IDLE)
+    {
+        FD_SET((SOCKET)_send_client.get_socket(),
+            _send_client.poll_wants_write() ? &write_fds : &read_fds);
+        wait_socket = true;
+    }
+    if(!wait_socket)
+    {
+        Sleep((DWORD)wait_ms);
+        return;
+    }
+    tv.tv_sec = (long)(wait_ms / 1000);
+    tv.tv_usec = (long)((wait_ms % 1000) * 1000);
+    select(0, &read_fds, &write_fds, NULL, &tv);
+#else
+    struct pollfd fds[2];
+    nfds_t num_fds = 0;
+
+    if(_poll_state != ASYNC_OP_IDLE)
+    {
+        fds[num_fds].fd = _bot._client.get_socket();
+        fds[num_fds].events = _bot._client.poll_wants_write() ? POLLOUT : POLLIN;
+        num_fds = num_fds + 1;
+    }
+    if(_send_state != ASYNC_OP_IDLE)
+    {
+        fds[num_fds].fd = _send_client.get_socket();
+        fds[num_fds].events = _send_client.poll_wants_write() ? POLLOUT : POLLIN;
+        num_fds = num_fds + 1;
+    }
+    ::poll(fds, num_fds, (int)wait_ms);
+#endif
+}
+
+/**************************************************************************************************/
+
+#endif
@@ -0,0 +1,178 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotasync.h
+// Description: Native C++20 coroutines layer to receive and send messages without blocking,
+//              driven by a single thread scheduler.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef UTLGBOTASYNC_H_
+#define UTLGBOTASYNC_H_
+
+/**************************************************************************************************/
+
+/* Check Build System (just for Native builds with C++20 coroutines support) */
+
+#if !defined(ARDUINO) && !defined(ESP_IDF) && defined(__cpp_impl_coroutine)
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <string>
+#include <vector>
+
+#include "utlgbotlib.h"
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Time to wait before retry a failed connection or getUpdates request (ms)
+#define ASYNC_RETRY_DELAY 1000
+
+// Scheduler maximum time waiting for sockets events in each run iteration (ms)
+#define ASYNC_MAX_WAIT 100
+
+/**************************************************************************************************/
+
+/* Data Types */
+
+// Coroutine task type for conversational flows (it starts running when called and its frame is
+// released when it finish)
+struct tlg_task
+{
+    struct promise_type
+    {
+        tlg_task get_return_object() { return tlg_task(); }
+        std::suspend_never initial_suspend() noexcept { return std::suspend_never(); }
+        std::suspend_never final_suspend() noexcept { return std::suspend_never(); }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+/**************************************************************************************************/
+
+class uTLGBotAsync
+{
+    private:
+        // Private Data Types
+        typedef enum async_op_state
+        {
+            ASYNC_OP_IDLE,
+            ASYNC_OP_CONNECT,
+            ASYNC_OP_REQUEST
+        } async_op_state;
+
+        typedef struct update_waiter
+        {
+            std::coroutine_handle<> handle;
+            std::string chat_id;
+            tlg_type_message** msg;
+        } update_waiter;
+
+        // Note: Requests are queued with its body already built (an empty body is a request that
+        // couldn't be built, so it just fails). Callback query answers are queued by the scheduler
+        // itself (no flow waiting for them, so handle and result are null)
+        typedef struct send_request
+        {
+            std::coroutine_handle<> handle;
+            const char* command;
+            std::string body;
+            bool* result;
+        } send_request;
+
+    public:
+        // Awaitable for next received message (of any chat or of a specific chat), it gets a
+        // messages pool slot (so flows frames just hold a pointer to the message)
+        class update_awaiter
+        {
+            public:
+                update_awaiter(uTLGBotAsync* async, const char* chat_id);
+                bool await_ready();
+                void await_suspend(std::coroutine_handle<> handle);
+                tlg_type_message* await_resume();
+
+            private:
+                uTLGBotAsync* _async;
+                std::string _chat_id;
+                tlg_type_message* _msg;
+        };
+
+        // Awaitable for a sent message result
+        class send_awaiter
+        {
+            public:
+                send_awaiter(uTLGBotAsync* async, const char* chat_id, const char* text,
+                    const bool escaped);
+                bool await_ready();
+                void await_suspend(std::coroutine_handle<> handle);
+                bool await_resume();
+
+            private:
+                uTLGBotAsync* _async;
+                std::string _chat_id;
+                std::string _text;
+                bool _escaped;
+                bool _result;
+        };
+
+        // Public Methods
+        uTLGBotAsync(uTLGBot& bot);
+        ~uTLGBotAsync();
+        update_awaiter next_update(const char* chat_id=NULL);
+        send_awaiter send(const char* chat_id, const char* text);
+        send_awaiter send_escaped(const char* chat_id, const char* text);
+        void release(tlg_type_message* msg);
+        void run();
+        void run_once(const unsigned long max_wait_ms=ASYNC_MAX_WAIT);
+        void stop();
+        size_t num_waiting_flows();
+
+    private:
+        // Private Attributtes
+        uTLGBot& _bot;
+        MultiHTTPSClient _send_client;
+        char _send_buffer[HTTP_MAX_RES_LENGTH];
+        char _body_buffer[HTTP_MAX_RES_LENGTH];
+        std::deque< std::coroutine_handle<> > _ready;
+        std::deque<update_waiter> _update_waiters;
+        std::deque<tlg_type_message> _pool;
+        std::vector<tlg_type_message*> _free;
+        std::deque<tlg_type_message*> _updates;
+        std::deque<send_request> _send_queue;
+        async_op_state _poll_state;
+        async_op_state _send_state;
+        bool _send_reused;
+        uint32_t _poll_retry_time;
+        bool _stop;
+
+        // Private Methods
+        bool take_update(const std::string& chat_id, tlg_type_message** msg);
+        tlg_type_message* take_slot();
+        void dispatch_update(tlg_type_message* msg);
+        void queue_callback_answer(const char* callback_query_id);
+        void drive_updates();
+        void drive_sends();
+        void wait_sockets(const unsigned long max_wait_ms);
+};
+
+/**************************************************************************************************/
+
+#endif
+
+/**************************************************************************************************/
+
+#endif
@@ -0,0 +1,259 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotbody.cpp
+// Description: Requests body writer, it appends body fields straight into a fixed size buffer
+//              keeping its length (no strlen() nor temporary copies for each appended field),
+//              escaping JSON string values. Without buffer, it just counts the body length.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "utlgbotbody.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+/**************************************************************************************************/
+
+/* Constructor */
+
+// Body writer constructor, it writes into the given buffer (always kept NUL terminated), or just
+// counts the length of the appended data if buffer is NULL
+uTLGBotBodyWriter::uTLGBotBodyWriter(char* buffer, const size_t buffer_size)
+{
+    _buffer = buffer;
+    _size = buffer_size;
+    clear();
+}
+
+/**************************************************************************************************/
+
+/* Public Methods */
+
+// Clear the body
+void uTLGBotBodyWriter::clear(void)
+{
+    _length = 0;
+    _overflow = false;
+    if(_size > 0)
+        _buffer[0] = '\0';
+}
+
+// Append a string
+bool uTLGBotBodyWriter::append(const char* str)
+{
+    return append(str, strlen(str));
+}
+
+// Append a string of given length (nothing is appended if it doesn't fit, and the body is
+// marked as overflowed)
+bool uTLGBotBodyWriter::append(const char* str, const size_t length)
+{
+    if(_buffer == NULL)
+    {
+        _length = _length + length;
+        return true;
+    }
+    if(_overflow || (_length + length >= _size))
+    {
+        _overflow = true;
+        return false;
+    }
+    memcpy(_buffer + _length, str, length);
+    _length = _length + length;
+    _buffer[_length] = '\0';
+
+    return true;
+}
+
+// Append a formatted string (nothing is appended if it doesn't fit, and the body is marked as
+// overflowed)
+bool uTLGBotBodyWriter::append_format(const char* format, ...)
+{
+    va_list args;
+    int len;
+
+    if(_overflow)
+        return false;
+    va_start(args, format);
+    if(_buffer == NULL)
+        len = vsnprintf(NULL, 0, format, args);
+    else
+        len = vsnprintf(_buffer + _length, _size - _length, format, args);
+    va_end(args);
+    if((_buffer == NULL) && (len >= 0))
+    {
+        _length = _length + (size_t)len;
+        return true;
+    }
+    if((len < 0) || (_length + (size_t)len >= _size))
+    {
+        _buffer[_length] = '\0';
+        _overflow = true;
+        return false;
+    }
+    _length = _length + (size_t)len;
+
+    return true;
+}
+
+// Append a string as JSON string value content
+bool uTLGBotBodyWriter::append_json(const char* str)
+{
+    return append_escaping(str, strlen(str), false);
+}
+
+// Append a string of given length as JSON string value content (quotes, backslashes and control
+// characters are escaped)
+bool uTLGBotBodyWriter::append_json(const char* str, const size_t length)
+{
+    return append_escaping(str, length, false);
+}
+
+// Append an already JSON escaped string as JSON string value content
+bool uTLGBotBodyWriter::append_json_escaped(const char* str)
+{
+    return append_escaping(str, strlen(str), true);
+}
+
+// Append an already JSON escaped string of given length as JSON string value content
+// Note: Texts and data received from Telegram are kept JSON escaped, so they can be sent back
+// without decoding them. Its valid JSON escape sequences are kept as they are, while quotes,
+// control characters and any other backslash are escaped
+bool uTLGBotBodyWriter::append_json_escaped(const char* str, const size_t length)
+{
+    return append_escaping(str, length, true);
+}
+
+// Get the body
+const char* uTLGBotBodyWriter::get(void)
+{
+    return _buffer;
+}
+
+// Get the body length
+size_t uTLGBotBodyWriter::length(void)
+{
+    return _length;
+}
+
+// Get how many bytes can still be appended
+size_t uTLGBotBodyWriter::available(void)
+{
+    if(_overflow || (_length + 1 >= _size))
+        return 0;
+    return _size - _length - 1;
+}
+
+// Check if something didn't fit in the body
+bool uTLGBotBodyWriter::overflow(void)
+{
+    return _overflow;
+}
+
+// Get the length of the valid JSON escape sequence at the start of a string (0 if there is none)
+// Note: An UTF-16 surrogate pair is a single escape sequence (a single character)
+size_t uTLGBotBodyWriter::escape_length(const char* str, const size_t length)
+{
+    uint16_t code[2] = { 0, 0 };
+
+    if((length < 2) || (str[0] != '\\'))
+        return 0;
+    if(strchr("\"\\/bfnrt", str[1]) != NULL)
+        return (str[1] != '\0') ? 2 : 0;
+    if(str[1] != 'u')
+        return 0;
+    for(uint8_t n = 0; n < 2; n++)
+    {
+        const char* sequence = str + (n * 6);
+        if((length < (size_t)((n * 6) + 6)) || (sequence[0] != '\\') || (sequence[1] != 'u'))
+            break;
+        for(uint8_t i = 2; i < 6; i++)
+        {
+            char c = sequence[i];
+            if((c >= '0') && (c <= '9'))
+                code[n] = (code[n] << 4) | (c - '0');
+            else if((c >= 'a') && (c <= 'f'))
+                code[n] = (code[n] << 4) | (c - 'a' + 10);
+            else if((c >= 'A') && (c <= 'F'))
+                code[n] = (code[n] << 4) | (c - 'A' + 10);
+            else
+                return (n == 0) ? 0 : 6;
+        }
+        if((code[0] < 0xD800) || (code[0] > 0xDBFF))
+            return 6;
+        if(n == 1)
+            return ((code[1] >= 0xDC00) && (code[1] <= 0xDFFF)) ? 12 : 6;
+    }
+    return 6;
+}
+
+/**************************************************************************************************/
+
+/* Private Methods */
+
+// Append a string of given length as JSON string value content, escaping it (valid JSON escape
+// sequences are kept if requested)
+bool uTLGBotBodyWriter::append_escaping(const char* str, const size_t length,
+    const bool keep_escapes)
+{
+    static const char hex[] = "0123456789abcdef";
+    char escaped[6] = { '\\', 'u', '0', '0', '0', '0' };
+    size_t run = 0;
+    size_t escape;
+    uint8_t c;
+
+    for(size_t i = 0; i < length; i++)
+    {
+        c = (uint8_t)str[i];
+        if((c >= 0x20) && (c != '"') && (c != '\\'))
+            continue;
+
+        // Append the characters that doesn't need escaping up to here
+        append(str + run, i - run);
+
+        // Keep valid escape sequences
+        if(keep_escapes && (c == '\\'))
+        {
+            escape = escape_length(str + i, length - i);
+            if(escape > 0)
+            {
+                append(str + i, escape);
+                i = i + escape - 1;
+                run = i + 1;
+                continue;
+            }
+        }
+
+        // Escape the character
+        switch(c)
+        {
+            case '"': escaped[1] = '"'; break;
+            case '\\': escaped[1] = '\\'; break;
+            case '\n': escaped[1] = 'n'; break;
+            case '\r': escaped[1] = 'r'; break;
+            case '\t': escaped[1] = 't'; break;
+            case '\b': escaped[1] = 'b'; break;
+            case '\f': escaped[1] = 'f'; break;
+            default: escaped[1] = 'u'; break;
+        }
+        if(escaped[1] == 'u')
+        {
+            escaped[4] = hex[c >> 4];
+            escaped[5] = hex[c & 0x0F];
+            append(escaped, 6);
+        }
+        else
+            append(escaped, 2);
+        run = i + 1;
+    }
+    append(str + run, length - run);
+
+    return !_overflow;
+}
+
+/**************************************************************************************************/
@@ -0,0 +1,59 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotbody.h
+// Description: Requests body writer, it appends body fields straight into a fixed size buffer
+//              keeping its length (no strlen() nor temporary copies for each appended field),
+//              escaping JSON string values. Without buffer, it just counts the body length.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef UTLGBOTBODY_H_
+#define UTLGBOTBODY_H_
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/**************************************************************************************************/
+
+class uTLGBotBodyWriter
+{
+    public:
+        // Public Methods
+        uTLGBotBodyWriter(char* buffer, const size_t buffer_size);
+        void clear();
+        bool append(const char* str);
+        bool append(const char* str, const size_t length);
+        bool append_format(const char* format, ...);
+        bool append_json(const char* str);
+        bool append_json(const char* str, const size_t length);
+        bool append_json_escaped(const char* str);
+        bool append_json_escaped(const char* str, const size_t length);
+        const char* get();
+        size_t length();
+        size_t available();
+        bool overflow();
+        static size_t escape_length(const char* str, const size_t length);
+
+    private:
+        // Private Attributtes
+        char* _buffer;
+        size_t _size;
+        size_t _length;
+        bool _overflow;
+
+        // Private Methods
+        bool append_escaping(const char* str, const size_t length, const bool keep_escapes);
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -0,0 +1,34 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotcerts.h
+// Description: Telegram API CA certificate in DER format (precompiled from res/certs PEM file by
+//              res/certs/pem2der.py), to load it with set_cert_der() without any base64 decoding
+//              nor copy of the certificate.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef UTLGBOTCERTS_H_
+#define UTLGBOTCERTS_H_
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/**************************************************************************************************/
+
+/* Telegram API CA Certificate */
+
+extern const uint8_t tlg_api_ca_der[];
+extern const size_t tlg_api_ca_der_len;
+
+/**************************************************************************************************/
+
+#endif
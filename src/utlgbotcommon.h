@@ -0,0 +1,111 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotcommon.h
+// Description: Internal helpers shared by the library modules, FNV-1a hashes and a wrap around
+//              safe monotonic milliseconds time (not part of the public interface).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef UTLGBOTCOMMON_H_
+#define UTLGBOTCOMMON_H_
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(ARDUINO)
+    #include <Arduino.h>
+#elif defined(ESP_IDF)
+    #include "esp_timer.h"
+#elif defined(WIN32) || defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// FNV-1a hashes parameters
+#define UTLGBOT_FNV32_OFFSET 2166136261UL
+#define UTLGBOT_FNV32_PRIME 16777619UL
+#define UTLGBOT_FNV64_OFFSET 14695981039346656037ULL
+#define UTLGBOT_FNV64_PRIME 1099511628211ULL
+
+/**************************************************************************************************/
+
+/* Hashes */
+
+// FNV-1a 32 bits hash of a data buffer
+static inline uint32_t utlgbot_fnv32(const void* data, const size_t len)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint32_t hash = (uint32_t)UTLGBOT_FNV32_OFFSET;
+
+    for(size_t i = 0; i < len; i++)
+        hash = (hash ^ bytes[i]) * (uint32_t)UTLGBOT_FNV32_PRIME;
+    return hash;
+}
+
+// FNV-1a 32 bits hash of a string
+static inline uint32_t utlgbot_fnv32_str(const char* str)
+{
+    uint32_t hash = (uint32_t)UTLGBOT_FNV32_OFFSET;
+
+    while(*str != '\0')
+    {
+        hash = (hash ^ (uint8_t)(*str)) * (uint32_t)UTLGBOT_FNV32_PRIME;
+        str++;
+    }
+    return hash;
+}
+
+// Continue a FNV-1a 64 bits hash with a string (start from UTLGBOT_FNV64_OFFSET)
+static inline uint64_t utlgbot_fnv64_str(uint64_t hash, const char* str)
+{
+    while(*str != '\0')
+    {
+        hash = (hash ^ (uint8_t)(*str)) * UTLGBOT_FNV64_PRIME;
+        str++;
+    }
+    return hash;
+}
+
+/**************************************************************************************************/
+
+/* Time */
+
+// Get monotonic time in milliseconds (wraps around every ~49 days, so just use it for
+// differences or with utlgbot_time_reached())
+static inline uint32_t utlgbot_now_ms(void)
+{
+#if defined(ARDUINO)
+    return (uint32_t)millis();
+#elif defined(ESP_IDF)
+    return (uint32_t)(esp_timer_get_time() / 1000);
+#elif defined(WIN32) || defined(_WIN32)
+    return (uint32_t)GetTickCount();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((ts.tv_sec*1000ULL) + (ts.tv_nsec/1000000ULL));
+#endif
+}
+
+// Check if a time has been reached (wrap around safe)
+static inline bool utlgbot_time_reached(const uint32_t now, const uint32_t time)
+{
+    return ((int32_t)(now - time) >= 0);
+}
+
+/**************************************************************************************************/
+
+#endif
@@ -0,0 +1,304 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotedit.cpp
+// Description: Coalescing editMessageText engine for live-updating messages. It keeps just the
+//              latest pending content of each message and sends it at the maximum edits rate
+//              allowed for its chat, skipping edits that doesn't change the message.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "utlgbotedit.h"
+#include "utlgbotcommon.h"
+
+#include <stdio.h>
+#include <string.h>
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Telegram flood control error code
+#define EDIT_ERROR_TOO_MANY_REQUESTS 429
+
+/**************************************************************************************************/
+
+/* Constructor */
+
+// Edit engine constructor, it sends the edits through the given Bot
+// Note: The object holds the pending texts of all messages, so create it as a global or static
+// object (not in a task stack)
+uTLGBotEditEngine::uTLGBotEditEngine(uTLGBot* bot)
+{
+    _bot = bot;
+    memset(_chats, 0, sizeof(_chats));
+    for(uint16_t i = 0; i < UTLGBOT_EDIT_MAX_MESSAGES; i++)
+    {
+        _messages[i].used = false;
+        _messages[i].pending = false;
+    }
+    _num_messages = 0;
+    _num_pending = 0;
+    _chat_interval_ms = EDIT_DEFAULT_CHAT_INTERVAL_MS;
+    _group_interval_ms = EDIT_DEFAULT_GROUP_INTERVAL_MS;
+    _global_interval_ms = EDIT_DEFAULT_GLOBAL_INTERVAL_MS;
+    _next_ms = utlgbot_now_ms();
+}
+
+/**************************************************************************************************/
+
+/* Public Methods */
+
+// Set minimum intervals between edits in a private chat, in a group and between any two edits
+void uTLGBotEditEngine::set_intervals(const uint32_t chat_ms, const uint32_t group_ms,
+    const uint32_t global_ms)
+{
+    _chat_interval_ms = chat_ms;
+    _group_interval_ms = group_ms;
+    _global_interval_ms = global_ms;
+}
+
+// Set the new content of a message (it replaces any previous pending content of the message,
+// and it is sent in a later process() call when the chat rate allows it)
+// Note: First edit of a message starts tracking it, use forget() when it is not updated anymore
+uint8_t uTLGBotEditEngine::edit(const char* chat_id, const uint64_t message_id, const char* text,
+    const char* parse_mode)
+{
+    edit_message* message;
+    uint64_t hash;
+    uint32_t c_hash, now;
+    int32_t chat, i;
+
+    if(strlen(text) >= MAX_TEXT_LENGTH)
+        return EDIT_TOO_LONG;
+    hash = content_hash(text, parse_mode);
+    now = utlgbot_now_ms();
+
+    // Get message (or start tracking it)
+    c_hash = utlgbot_fnv32_str(chat_id);
+    chat = find_chat(chat_id, c_hash);
+    i = (chat == -1) ? -1 : find_message(chat, message_id);
+    if(i == -1)
+    {
+        if(_num_messages >= UTLGBOT_EDIT_MAX_MESSAGES)
+            return EDIT_NO_ROOM;
+        if(chat == -1)
+        {
+            chat = add_chat(chat_id, c_hash, now);
+            if(chat == -1)
+                return EDIT_NO_ROOM;
+        }
+        for(i = 0; i < UTLGBOT_EDIT_MAX_MESSAGES; i++)
+        {
+            if(!_messages[i].used)
+                break;
+        }
+        message = &_messages[i];
+        message->message_id = message_id;
+        message->sent_hash = 0;
+        message->chat = (uint16_t)chat;
+        message->used = true;
+        message->pending = false;
+        _chats[chat].num_messages = _chats[chat].num_messages + 1;
+        _num_messages = _num_messages + 1;
+    }
+    message = &_messages[i];
+
+    // Skip content that is already pending, and drop the pending one if the new content is the
+    // one that was sent last
+    if(message->pending && (hash == message->pending_hash))
+        return EDIT_UNCHANGED;
+    if(hash == message->sent_hash)
+    {
+        if(message->pending)
+        {
+            message->pending = false;
+            _num_pending = _num_pending - 1;
+        }
+        return EDIT_UNCHANGED;
+    }
+
+    // Keep just the latest content (message keeps its place in the queue)
+    snprintf(message->text, MAX_TEXT_LENGTH, "%s", text);
+    snprintf(message->parse_mode, EDIT_MAX_PARSE_MODE_LENGTH, "%s", parse_mode);
+    message->pending_hash = hash;
+    if(!message->pending)
+    {
+        message->pending = true;
+        message->pending_since_ms = now;
+        _num_pending = _num_pending + 1;
+    }
+
+    return EDIT_QUEUED;
+}
+
+// Send the pending edit that has waited the longest among chats that can be edited now (call it
+// from application loop, just one edit request is sent for each call)
+// Returns true if an edit request was sent
+bool uTLGBotEditEngine::process(void)
+{
+    edit_message* message = NULL;
+    edit_chat* chat;
+    uint32_t now;
+    bool success;
+
+    if(_num_pending == 0)
+        return false;
+    now = utlgbot_now_ms();
+    if(!utlgbot_time_reached(now, _next_ms))
+        return false;
+
+    // Get oldest pending message of the chats that are allowed to be edited
+    for(uint16_t i = 0; i < UTLGBOT_EDIT_MAX_MESSAGES; i++)
+    {
+        if(!_messages[i].pending || !utlgbot_time_reached(now, _chats[_messages[i].chat].next_ms))
+            continue;
+        if((message == NULL) ||
+           ((int32_t)(_messages[i].pending_since_ms - message->pending_since_ms) < 0))
+        {
+            message = &_messages[i];
+        }
+    }
+    if(message == NULL)
+        return false;
+
+    // Send it and schedule next allowed edits
+    chat = &_chats[message->chat];
+    success = _bot->editMessageText(chat->id, message->message_id, message->text,
+        message->parse_mode);
+    now = utlgbot_now_ms();
+    _next_ms = now + _global_interval_ms;
+    chat->next_ms = now + ((chat->id[0] == '-') ? _group_interval_ms : _chat_interval_ms);
+    sent(message, success, now);
+
+    return true;
+}
+
+// Stop tracking a message (its pending content, if any, is discarded)
+bool uTLGBotEditEngine::forget(const char* chat_id, const uint64_t message_id)
+{
+    edit_message* message;
+    int32_t chat, i;
+
+    chat = find_chat(chat_id, utlgbot_fnv32_str(chat_id));
+    if(chat == -1)
+        return false;
+    i = find_message(chat, message_id);
+    if(i == -1)
+        return false;
+
+    message = &_messages[i];
+    if(message->pending)
+        _num_pending = _num_pending - 1;
+    message->pending = false;
+    message->used = false;
+    _num_messages = _num_messages - 1;
+    _chats[chat].num_messages = _chats[chat].num_messages - 1;
+    if(_chats[chat].num_messages == 0)
+        _chats[chat].id[0] = '\0';
+
+    return true;
+}
+
+// Get number of messages with pending content
+uint16_t uTLGBotEditEngine::num_pending(void)
+{
+    return _num_pending;
+}
+
+// Get number of tracked messages
+uint16_t uTLGBotEditEngine::num_messages(void)
+{
+    return _num_messages;
+}
+
+/**************************************************************************************************/
+
+/* Private Methods */
+
+// Get a chat index (-1 if it is not tracked)
+int32_t uTLGBotEditEngine::find_chat(const char* chat_id, const uint32_t hash)
+{
+    for(uint16_t i = 0; i < UTLGBOT_EDIT_MAX_CHATS; i++)
+    {
+        if((_chats[i].num_messages != 0) && (_chats[i].hash == hash) &&
+           (strcmp(_chats[i].id, chat_id) == 0))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Get a message index (-1 if it is not tracked)
+int32_t uTLGBotEditEngine::find_message(const uint16_t chat, const uint64_t message_id)
+{
+    for(uint16_t i = 0; i < UTLGBOT_EDIT_MAX_MESSAGES; i++)
+    {
+        if(_messages[i].used && (_messages[i].chat == chat) &&
+           (_messages[i].message_id == message_id))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Start tracking a chat (-1 if chats table is full)
+int32_t uTLGBotEditEngine::add_chat(const char* chat_id, const uint32_t hash, const uint32_t now)
+{
+    if(strlen(chat_id) >= MAX_ID_LENGTH)
+        return -1;
+    for(uint16_t i = 0; i < UTLGBOT_EDIT_MAX_CHATS; i++)
+    {
+        if(_chats[i].num_messages != 0)
+            continue;
+        snprintf(_chats[i].id, MAX_ID_LENGTH, "%s", chat_id);
+        _chats[i].hash = hash;
+        _chats[i].next_ms = now;
+        return i;
+    }
+    return -1;
+}
+
+// Update a message after its edit request
+// Flood control errors and requests without response keep the content pending to retry it
+// later. Any other error (i.e. "message is not modified" or message deleted) discards it.
+void uTLGBotEditEngine::sent(edit_message* message, const bool success, const uint32_t now)
+{
+    uint16_t error_code = _bot->get_last_error_code();
+    edit_chat* chat = &_chats[message->chat];
+
+    if(!success && (error_code == EDIT_ERROR_TOO_MANY_REQUESTS))
+    {
+        chat->next_ms = now + (_bot->get_retry_after() * 1000);
+        return;
+    }
+    if(!success && (error_code == 0))
+    {
+        chat->next_ms = now + EDIT_RETRY_INTERVAL_MS;
+        return;
+    }
+
+    message->sent_hash = message->pending_hash;
+    message->pending = false;
+    _num_pending = _num_pending - 1;
+}
+
+// Hash of a message content (FNV-1a 64 bits of text and parse mode)
+uint64_t uTLGBotEditEngine::content_hash(const char* text, const char* parse_mode)
+{
+    uint64_t hash;
+
+    hash = utlgbot_fnv64_str(UTLGBOT_FNV64_OFFSET, text);
+    hash = (hash ^ 0xFF) * UTLGBOT_FNV64_PRIME;
+    hash = utlgbot_fnv64_str(hash, parse_mode);
+
+    // Hash 0 means nothing sent
+    return (hash == 0) ? 1 : hash;
+}
+
+/**************************************************************************************************/
@@ -0,0 +1,124 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotedit.h
+// Description: Coalescing editMessageText engine for live-updating messages. It keeps just the
+//              latest pending content of each message and sends it at the maximum edits rate
+//              allowed for its chat, skipping edits that doesn't change the message.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef UTLGBOTEDIT_H_
+#define UTLGBOTEDIT_H_
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <inttypes.h>
+#include <stdint.h>
+
+#include "utlgbotlib.h"
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Maximum number of live messages and chats tracked by an edit engine (each message holds its
+// pending text in a static table, so keep it low in microcontrollers builds)
+#ifndef UTLGBOT_EDIT_MAX_MESSAGES
+    #if defined(ARDUINO) || defined(ESP_IDF)
+        #define UTLGBOT_EDIT_MAX_MESSAGES 4
+    #else
+        #define UTLGBOT_EDIT_MAX_MESSAGES 256
+    #endif
+#endif
+#ifndef UTLGBOT_EDIT_MAX_CHATS
+    #define UTLGBOT_EDIT_MAX_CHATS UTLGBOT_EDIT_MAX_MESSAGES
+#endif
+
+// Default minimum interval between edits in the same chat (ms), Telegram allows about one
+// message per second in a private chat and 20 messages per minute in a group
+#define EDIT_DEFAULT_CHAT_INTERVAL_MS 1000
+#define EDIT_DEFAULT_GROUP_INTERVAL_MS 3000
+
+// Default minimum interval between any two edits (ms), Telegram allows about 30 messages per
+// second to different chats
+#define EDIT_DEFAULT_GLOBAL_INTERVAL_MS 34
+
+// Interval to retry an edit that got no response (ms)
+#define EDIT_RETRY_INTERVAL_MS 5000
+
+// Max parse mode length ("MarkdownV2")
+#define EDIT_MAX_PARSE_MODE_LENGTH 12
+
+// edit() results
+#define EDIT_QUEUED     0 // New content will be sent
+#define EDIT_UNCHANGED  1 // Content is already sent or pending, nothing to do
+#define EDIT_NO_ROOM    2 // Messages or chats table is full
+#define EDIT_TOO_LONG   3 // Text doesn't fit in MAX_TEXT_LENGTH
+
+/**************************************************************************************************/
+
+class uTLGBotEditEngine
+{
+    public:
+        // Public Methods
+        uTLGBotEditEngine(uTLGBot* bot);
+        void set_intervals(const uint32_t chat_ms, const uint32_t group_ms,
+            const uint32_t global_ms);
+        uint8_t edit(const char* chat_id, const uint64_t message_id, const char* text,
+            const char* parse_mode="");
+        bool process();
+        bool forget(const char* chat_id, const uint64_t message_id);
+        uint16_t num_pending();
+        uint16_t num_messages();
+
+    private:
+        // Private Data Types
+        typedef struct edit_chat
+        {
+            char id[MAX_ID_LENGTH];
+            uint32_t hash;
+            uint32_t next_ms;
+            uint16_t num_messages;
+        } edit_chat;
+
+        typedef struct edit_message
+        {
+            uint64_t message_id;
+            uint64_t pending_hash;
+            uint64_t sent_hash;
+            uint32_t pending_since_ms;
+            uint16_t chat;
+            bool used;
+            bool pending;
+            char parse_mode[EDIT_MAX_PARSE_MODE_LENGTH];
+            char text[MAX_TEXT_LENGTH];
+        } edit_message;
+
+        // Private Attributtes
+        uTLGBot* _bot;
+        edit_chat _chats[UTLGBOT_EDIT_MAX_CHATS];
+        edit_message _messages[UTLGBOT_EDIT_MAX_MESSAGES];
+        uint16_t _num_messages;
+        uint16_t _num_pending;
+        uint32_t _chat_interval_ms;
+        uint32_t _group_interval_ms;
+        uint32_t _global_interval_ms;
+        uint32_t _next_ms;
+
+        // Private Methods
+        int32_t find_chat(const char* chat_id, const uint32_t hash);
+        int32_t find_message(const uint16_t chat, const uint64_t message_id);
+        int32_t add_chat(const char* chat_id, const uint32_t hash, const uint32_t now);
+        void sent(edit_message* message, const bool success, const uint32_t now);
+        static uint64_t content_hash(const char* text, const char* parse_mode);
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -0,0 +1,227 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotexecutor.cpp
+// Description: Native worker threads pool that handle received messages in parallel, keeping
+//              messages order inside each chat.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Check Build System (just for Native, it uses threads and dynamic memory) */
+
+#if !defined(ARDUINO) && !defined(ESP_IDF)
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "utlgbotexecutor.h"
+#include "utlgbotcommon.h"
+
+/**************************************************************************************************/
+
+/* Constructor & Destructor */
+
+// Executor constructor, launch the worker threads
+uTLGBotExecutor::uTLGBotExecutor(const uint8_t num_workers)
+{
+    _num_workers = num_workers;
+    if(_num_workers == 0)
+        _num_workers = 1;
+    _pending = 0;
+    _stop = false;
+
+    // Note: Workers vector is reserved, so it is never reallocated while threads are starting
+    _ready.resize(_num_workers);
+    _workers.reserve(_num_workers);
+    for(uint8_t i = 0; i < _num_workers; i++)
+        _workers.push_back(std::thread(&uTLGBotExecutor::worker_loop, this, i));
+}
+
+// Executor destructor, handle all pending messages and stop the worker threads
+uTLGBotExecutor::~uTLGBotExecutor(void)
+{
+    stop();
+}
+
+/**************************************************************************************************/
+
+/* Public Methods */
+
+// Queue a copy of given message to be handled in a worker thread
+// Messages of the same chat are handled one by one in the same order that they were submitted,
+// while messages of different chats are handled in parallel
+bool uTLGBotExecutor::submit(const tlg_type_message* msg, tlg_msg_handler handler,
+    void* user_data)
+{
+    executor_job* job;
+    executor_chat* chat;
+
+    if(handler == NULL)
+        return false;
+
+    // Copy the message outside the lock (uTLGBot reuse received_msg for next update)
+    job = new executor_job;
+    memcpy(&job->msg, msg, sizeof(tlg_type_message));
+    job->handler = handler;
+    job->user_data = user_data;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    if(_stop)
+    {
+        delete job;
+        return false;
+    }
+
+    // Get chat queue (create it if this chat has no pending messages)
+    std::map<std::string, executor_chat*>::iterator it = _chats.find(msg->chat.id);
+    if(it == _chats.end())
+    {
+        chat = new executor_chat;
+        chat->id = msg->chat.id;
+        chat->scheduled = false;
+        _chats[chat->id] = chat;
+    }
+    else
+        chat = it->second;
+    chat->jobs.push_back(job);
+    _pending = _pending + 1;
+
+    // Schedule the chat in its home worker if it is not already waiting or running
+    if(!chat->scheduled)
+    {
+        chat->scheduled = true;
+        _ready[utlgbot_fnv32_str(msg->chat.id) % _num_workers].push_back(chat);
+        _work_cv.notify_all();
+    }
+
+    return true;
+}
+
+// Wait until all submitted messages has been handled
+void uTLGBotExecutor::wait_idle(void)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while(_pending != 0)
+        _idle_cv.wait(lock);
+}
+
+// Handle all pending messages and stop the worker threads (no more messages will be accepted)
+void uTLGBotExecutor::stop(void)
+{
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _stop = true;
+        _work_cv.notify_all();
+    }
+
+    for(size_t i = 0; i < _workers.size(); i++)
+    {
+        if(_workers[i].joinable())
+            _workers[i].join();
+    }
+}
+
+// Get number of worker threads
+uint8_t uTLGBotExecutor::num_workers(void)
+{
+    return _num_workers;
+}
+
+// Get number of submitted messages not handled yet
+uint32_t uTLGBotExecutor::pending(void)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    return _pending;
+}
+
+/**************************************************************************************************/
+
+/* Private Methods */
+
+// Worker thread: take a ready chat and handle its messages in order
+void uTLGBotExecutor::worker_loop(const uint8_t worker)
+{
+    executor_chat* chat;
+    executor_job* job;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    while(true)
+    {
+        // Wait for a chat with pending messages (exit when stopped and all work is done)
+        while((chat = take_chat(worker)) == NULL)
+        {
+            if(_stop)
+                return;
+            _work_cv.wait(lock);
+        }
+
+        // Handle a batch of chat messages (without lock, so other chats keep running)
+        for(uint8_t n = 0; (n < EXECUTOR_MAX_BATCH) && !chat->jobs.empty(); n++)
+        {
+            job = chat->jobs.front();
+            chat->jobs.pop_front();
+
+            lock.unlock();
+            // Note: Each worker traces its own timeline track (worker index is the trace id)
+            HTTP_TRACE(DISPATCH_BEGIN, (const void*)(uintptr_t)worker, worker);
+            job->handler(&job->msg, worker, job->user_data);
+            HTTP_TRACE(DISPATCH_END, (const void*)(uintptr_t)worker, worker);
+            delete job;
+            lock.lock();
+
+            _pending = _pending - 1;
+        }
+
+        // Release chat queue if it is empty, or requeue it to let other chats run
+        if(chat->jobs.empty())
+        {
+            _chats.erase(chat->id);
+            delete chat;
+        }
+        else
+        {
+            _ready[worker].push_back(chat);
+            _work_cv.notify_all();
+        }
+
+        if(_pending == 0)
+            _idle_cv.notify_all();
+    }
+}
+
+// Get next ready chat for a worker, stealing a whole chat queue from the busiest worker if it
+// has nothing to do (must be called with lock)
+uTLGBotExecutor::executor_chat* uTLGBotExecutor::take_chat(const uint8_t worker)
+{
+    executor_chat* chat;
+    size_t victim_ready = 0;
+    uint8_t victim = worker;
+
+    if(!_ready[worker].empty())
+    {
+        chat = _ready[worker].front();
+        _ready[worker].pop_front();
+        return chat;
+    }
+
+    for(uint8_t i = 0; i < _num_workers; i++)
+    {
+        if(_ready[i].size() > victim_ready)
+        {
+            victim_ready = _ready[i].size();
+            victim = i;
+        }
+    }
+    if(victim_ready == 0)
+        return NULL;
+
+    chat = _ready[victim].back();
+    _ready[victim].pop_back();
+    return chat;
+}
+
+/**************************************************************************************************/
+
+#endif
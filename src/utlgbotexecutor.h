@@ -0,0 +1,110 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotexecutor.h
+// Description: Native worker threads pool that handle received messages in parallel, keeping
+//              messages order inside each chat.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef UTLGBOTEXECUTOR_H_
+#define UTLGBOTEXECUTOR_H_
+
+/**************************************************************************************************/
+
+/* Check Build System (just for Native, it uses threads and dynamic memory) */
+
+#if !defined(ARDUINO) && !defined(ESP_IDF)
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "utlgbotlib.h"
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Default number of worker threads
+#define DEFAULT_EXECUTOR_WORKERS 4
+
+// Maximum number of messages of a chat handled in a row before let other chats run
+#define EXECUTOR_MAX_BATCH 8
+
+/**************************************************************************************************/
+
+/* Data Types */
+
+// Message handler function (worker is the index of the thread that runs the handler, so each
+// worker can use its own uTLGBot object to send messages, uTLGBot is not thread safe)
+typedef void (*tlg_msg_handler)(const tlg_type_message* msg, uint8_t worker, void* user_data);
+
+/**************************************************************************************************/
+
+class uTLGBotExecutor
+{
+    public:
+        // Public Methods
+        uTLGBotExecutor(const uint8_t num_workers=DEFAULT_EXECUTOR_WORKERS);
+        ~uTLGBotExecutor();
+        bool submit(const tlg_type_message* msg, tlg_msg_handler handler, void* user_data=NULL);
+        void wait_idle();
+        void stop();
+        uint8_t num_workers();
+        uint32_t pending();
+
+    private:
+        // Private Data Types
+        typedef struct executor_job
+        {
+            tlg_type_message msg;
+            tlg_msg_handler handler;
+            void* user_data;
+        } executor_job;
+
+        typedef struct executor_chat
+        {
+            std::string id;
+            std::deque<executor_job*> jobs;
+            bool scheduled;
+        } executor_chat;
+
+        // Private Attributtes
+        std::vector<std::thread> _workers;
+        std::vector< std::deque<executor_chat*> > _ready;
+        std::map<std::string, executor_chat*> _chats;
+        std::mutex _mutex;
+        std::condition_variable _work_cv;
+        std::condition_variable _idle_cv;
+        uint32_t _pending;
+        uint8_t _num_workers;
+        bool _stop;
+
+        // Private Methods
+        void worker_loop(const uint8_t worker);
+        executor_chat* take_chat(const uint8_t worker);
+};
+
+/**************************************************************************************************/
+
+#endif
+
+/**************************************************************************************************/
+
+#endif
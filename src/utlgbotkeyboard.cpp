@@ -0,0 +1,135 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotkeyboard.cpp
+// Description: Reply and inline keyboards builder. Rows and buttons are written (JSON escaped)
+//              straight into a request body, or into a given buffer to serialize a static
+//              keyboard once and send it by reference as reply_markup.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "utlgbotkeyboard.h"
+
+/**************************************************************************************************/
+
+/* Constructors */
+
+// Keyboard constructor that serializes it into the given buffer (i.e. a static keyboard that is
+// built once and then sent by reference in many messages)
+uTLGBotKeyboard::uTLGBotKeyboard(char* buffer, const size_t buffer_size, const uint8_t type) :
+    _buffer_writer(buffer, buffer_size)
+{
+    _writer = &_buffer_writer;
+    begin(type);
+}
+
+// Keyboard constructor that writes it straight into a request body writer
+uTLGBotKeyboard::uTLGBotKeyboard(uTLGBotBodyWriter* writer, const uint8_t type) :
+    _buffer_writer(NULL, 0)
+{
+    _writer = writer;
+    begin(type);
+}
+
+/**************************************************************************************************/
+
+/* Public Methods */
+
+// Start a new row of buttons (next added button goes to it)
+bool uTLGBotKeyboard::row(void)
+{
+    if(_row_buttons > 0)
+        _new_row = true;
+    return !_writer->overflow();
+}
+
+// Add a button to current row (inline keyboards buttons send the callback data when pressed, or
+// the button text if there is no callback data)
+bool uTLGBotKeyboard::button(const char* text, const char* callback_data)
+{
+    begin_button(text);
+    if(!(_type & KEYBOARD_REPLY))
+    {
+        _writer->append(",\"callback_data\":\"");
+        _writer->append_json((callback_data[0] != '\0') ? callback_data : text);
+        _writer->append("\"");
+    }
+    return _writer->append("}");
+}
+
+// Add a button that opens an URL to current row (just for inline keyboards, Telegram rejects URL
+// buttons in reply keyboards, so nothing is added and false is returned)
+bool uTLGBotKeyboard::url_button(const char* text, const char* url)
+{
+    if(_type & KEYBOARD_REPLY)
+        return false;
+    begin_button(text);
+    _writer->append(",\"url\":\"");
+    _writer->append_json(url);
+    _writer->append("\"");
+    return _writer->append("}");
+}
+
+// End the keyboard (return false if it doesn't fit)
+bool uTLGBotKeyboard::end(void)
+{
+    if(!_ended)
+    {
+        _writer->append("]]");
+        if(_type & KEYBOARD_RESIZE)
+            _writer->append(",\"resize_keyboard\":true");
+        if(_type & KEYBOARD_ONE_TIME)
+            _writer->append(",\"one_time_keyboard\":true");
+        _writer->append("}");
+        _ended = true;
+    }
+    return !_writer->overflow();
+}
+
+// Get the keyboard reply_markup (NULL if it doesn't fit, or if it is not written into a buffer)
+const char* uTLGBotKeyboard::get(void)
+{
+    if((_writer->get() == NULL) || _writer->overflow())
+        return NULL;
+    return _writer->get() + _start;
+}
+
+/**************************************************************************************************/
+
+/* Private Methods */
+
+// Start the keyboard
+void uTLGBotKeyboard::begin(const uint8_t type)
+{
+    _type = type;
+    _row_buttons = 0;
+    _new_row = false;
+    _ended = false;
+    _start = _writer->length();
+    if(_type & KEYBOARD_REPLY)
+        _writer->append("{\"keyboard\":[[");
+    else
+        _writer->append("{\"inline_keyboard\":[[");
+}
+
+// Start a button (it starts a new row first if it was requested)
+void uTLGBotKeyboard::begin_button(const char* text)
+{
+    if(_new_row)
+    {
+        _writer->append("],[");
+        _row_buttons = 0;
+        _new_row = false;
+    }
+    if(_row_buttons > 0)
+        _writer->append(",");
+    _writer->append("{\"text\":\"");
+    _writer->append_json(text);
+    _writer->append("\"");
+    _row_buttons = _row_buttons + 1;
+}
+
+/**************************************************************************************************/
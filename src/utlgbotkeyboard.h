@@ -0,0 +1,80 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotkeyboard.h
+// Description: Reply and inline keyboards builder. Rows and buttons are written (JSON escaped)
+//              straight into a request body, or into a given buffer to serialize a static
+//              keyboard once and send it by reference as reply_markup.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef UTLGBOTKEYBOARD_H_
+#define UTLGBOTKEYBOARD_H_
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "utlgbotbody.h"
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Keyboard types and options
+#define KEYBOARD_INLINE   0x00 // Buttons attached to the message (callback data and URL buttons)
+#define KEYBOARD_REPLY    0x01 // Custom keyboard shown instead of the user keyboard
+#define KEYBOARD_RESIZE   0x02 // Reply keyboard buttons height fitted to its rows
+#define KEYBOARD_ONE_TIME 0x04 // Reply keyboard hidden when a button is pressed
+
+/**************************************************************************************************/
+
+/* Data Types */
+
+class uTLGBotKeyboard;
+
+// Keyboard builder function, it adds the rows and buttons of a keyboard that is being written
+// into a request body (it is called once to get the keyboard length and once to write it, so it
+// must add the same keyboard in both calls)
+typedef void (*tlg_keyboard_builder)(uTLGBotKeyboard* keyboard, void* user_data);
+
+/**************************************************************************************************/
+
+class uTLGBotKeyboard
+{
+    public:
+        // Public Methods
+        uTLGBotKeyboard(char* buffer, const size_t buffer_size,
+            const uint8_t type=KEYBOARD_INLINE);
+        uTLGBotKeyboard(uTLGBotBodyWriter* writer, const uint8_t type=KEYBOARD_INLINE);
+        bool row();
+        bool button(const char* text, const char* callback_data="");
+        bool url_button(const char* text, const char* url);
+        bool end();
+        const char* get();
+
+    private:
+        // Private Attributtes
+        uTLGBotBodyWriter _buffer_writer;
+        uTLGBotBodyWriter* _writer;
+        size_t _start;
+        uint8_t _type;
+        uint16_t _row_buttons;
+        bool _new_row;
+        bool _ended;
+
+        // Private Methods
+        void begin(const uint8_t type);
+        void begin_button(const char* text);
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -0,0 +1,160 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotlatency.cpp
+// Description: Per API method and per request phase latency histograms (build with
+//              UTLGBOT_LATENCY_STATS, otherwise it is not compiled at all).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "utlgbotlib.h"
+
+/**************************************************************************************************/
+
+/* Check Build Configuration (just for UTLGBOT_LATENCY_STATS builds) */
+
+#if defined(UTLGBOT_LATENCY_STATS)
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#if defined(ARDUINO)
+    // micros() from Arduino.h
+#elif defined(ESP_IDF)
+    #include "esp_timer.h"
+#elif defined(WIN32) || defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+/**************************************************************************************************/
+
+/* Phases Names */
+
+static const char* LATENCY_PHASE_NAMES[LATENCY_NUM_PHASES] =
+{
+    "dns", "tcp_connect", "tls_handshake", "write", "wait", "transfer", "parse"
+};
+
+/**************************************************************************************************/
+
+/* Functions */
+
+// Get monotonic time in microseconds (wraps around every ~71 minutes, so just use it for
+// differences)
+uint32_t latency_now_us(void)
+{
+#if defined(ARDUINO)
+    return (uint32_t)micros();
+#elif defined(ESP_IDF)
+    return (uint32_t)esp_timer_get_time();
+#elif defined(WIN32) || defined(_WIN32)
+    LARGE_INTEGER freq, count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (uint32_t)((count.QuadPart*1000000) / freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((ts.tv_sec*1000000ULL) + (ts.tv_nsec/1000ULL));
+#endif
+}
+
+// Get the name of a latency phase
+const char* latency_phase_name(const uint8_t phase)
+{
+    if(phase >= LATENCY_NUM_PHASES)
+        return "";
+    return LATENCY_PHASE_NAMES[phase];
+}
+
+// Clear a latency histogram
+void latency_histogram_clear(tlg_latency_histogram* histogram)
+{
+    memset(histogram, 0, sizeof(tlg_latency_histogram));
+    histogram->min_us = UINT32_MAX;
+}
+
+// Add a value to a latency histogram
+// Bucket index is got from the value highest bit position and the next two bits below it, so
+// it is just a few instructions (no loops nor divisions)
+void latency_histogram_add(tlg_latency_histogram* histogram, uint32_t value_us)
+{
+    uint32_t exponent;
+    uint8_t bucket;
+
+    if(value_us > LATENCY_MAX_US)
+        value_us = LATENCY_MAX_US;
+
+    if(value_us < LATENCY_SUB_BUCKETS)
+        bucket = (uint8_t)value_us;
+    else
+    {
+        exponent = 31 - __builtin_clz(value_us);
+        bucket = (uint8_t)((LATENCY_SUB_BUCKETS * (exponent - 1)) +
+            ((value_us >> (exponent - 2)) & (LATENCY_SUB_BUCKETS - 1)));
+    }
+
+    histogram->buckets[bucket] = histogram->buckets[bucket] + 1;
+    histogram->count = histogram->count + 1;
+    histogram->sum_us = histogram->sum_us + value_us;
+    if(value_us < histogram->min_us)
+        histogram->min_us = value_us;
+    if(value_us > histogram->max_us)
+        histogram->max_us = value_us;
+}
+
+// Get the value below which the given percentage of the samples are (0.0 - 100.0)
+// Returned value is the upper limit of the bucket that holds that percentile (limited to the
+// histogram max value)
+uint32_t latency_histogram_percentile(const tlg_latency_histogram* histogram,
+    const float percentile)
+{
+    uint64_t target, accumulated;
+    uint32_t value;
+
+    if(histogram->count == 0)
+        return 0;
+
+    target = (uint64_t)((histogram->count * (double)percentile / 100.0) + 0.5);
+    if(target == 0)
+        target = 1;
+
+    accumulated = 0;
+    for(uint8_t i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++)
+    {
+        accumulated = accumulated + histogram->buckets[i];
+        if(accumulated >= target)
+        {
+            if(i == LATENCY_HISTOGRAM_BUCKETS - 1)
+                return histogram->max_us;
+            value = latency_bucket_min(i + 1) - 1;
+            if(value > histogram->max_us)
+                value = histogram->max_us;
+            return value;
+        }
+    }
+
+    return histogram->max_us;
+}
+
+// Get the lowest value (us) accounted in a histogram bucket
+uint32_t latency_bucket_min(const uint8_t bucket)
+{
+    uint32_t exponent;
+
+    if(bucket < LATENCY_SUB_BUCKETS)
+        return bucket;
+
+    exponent = (bucket / LATENCY_SUB_BUCKETS) + 1;
+    return (uint32_t)(LATENCY_SUB_BUCKETS + (bucket % LATENCY_SUB_BUCKETS)) << (exponent - 2);
+}
+
+/**************************************************************************************************/
+
+#endif
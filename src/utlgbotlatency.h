@@ -0,0 +1,85 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotlatency.h
+// Description: Per API method and per request phase latency histograms (build with
+//              UTLGBOT_LATENCY_STATS, otherwise it is not compiled at all).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef UTLGBOTLATENCY_H_
+#define UTLGBOTLATENCY_H_
+
+/**************************************************************************************************/
+
+/* Check Build Configuration (just for UTLGBOT_LATENCY_STATS builds) */
+
+#if defined(UTLGBOT_LATENCY_STATS)
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <inttypes.h>
+#include <stdint.h>
+
+#include "utility/multihttpsclient/multihttpsclient.h"
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Latency phases (HTTP request phases measured by MultiHTTPSClient plus response parse)
+#define LATENCY_PHASE_PARSE HTTP_NUM_PHASES
+#define LATENCY_NUM_PHASES (HTTP_NUM_PHASES + 1)
+
+// Log-linear histogram buckets: each power of two range is split in LATENCY_SUB_BUCKETS linear
+// buckets (max 25% error), from 1us to LATENCY_MAX_US (longer values go to last bucket)
+// Each histogram takes ~432 bytes of RAM, and the Bot holds API_NUM_METHODS x
+// LATENCY_NUM_PHASES histograms (~21KB)
+#define LATENCY_SUB_BUCKETS 4
+#define LATENCY_MAX_US 0x07FFFFFFUL // ~134s
+#define LATENCY_HISTOGRAM_BUCKETS 104
+
+/**************************************************************************************************/
+
+/* Data Types */
+
+// Latency histogram of a phase (us)
+typedef struct tlg_latency_histogram
+{
+    uint32_t count;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+    uint32_t buckets[LATENCY_HISTOGRAM_BUCKETS];
+} tlg_latency_histogram;
+
+// Latency histograms of all phases of an API method
+typedef struct tlg_latency_stats
+{
+    tlg_latency_histogram phase[LATENCY_NUM_PHASES];
+} tlg_latency_stats;
+
+/**************************************************************************************************/
+
+/* Functions */
+
+uint32_t latency_now_us();
+const char* latency_phase_name(const uint8_t phase);
+void latency_histogram_clear(tlg_latency_histogram* histogram);
+void latency_histogram_add(tlg_latency_histogram* histogram, uint32_t value_us);
+uint32_t latency_histogram_percentile(const tlg_latency_histogram* histogram,
+    const float percentile);
+uint32_t latency_bucket_min(const uint8_t bucket);
+
+/**************************************************************************************************/
+
+#endif
+
+/**************************************************************************************************/
+
+#endif
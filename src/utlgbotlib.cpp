@@ -10,6 +10,7 @@
 /* Libraries */
 
 #include "utlgbotlib.h"
+#include "utlgbotmetrics.h"
 
 /**************************************************************************************************/
 
@@ -21,9 +22,9 @@
         #define _println(x) do { if(_debug_level) Serial.println(x); } while(0)
         #define _printf(...) do { if(_debug_level) Serial.printf(__VA_ARGS__); } while(0)
     #else
-        #define _print(x)
-        #define _println(x)
-        #define _printf(...)
+        #define _print(x) do { } while(0)
+        #define _println(x) do { } while(0)
+        #define _printf(...) do { } while(0)
     #endif
     #define _yield() do { yield(); } while(0)
 #elif defined(ESP_IDF) // ESP32 ESPIDF Framework
@@ -38,9 +39,9 @@
         #define _println(x) do { if(_debug_level) printf("%s\n", x); } while(0)
         #define _printf(...) do { if(_debug_level) printf(__VA_ARGS__); } while(0)
     #else
-        #define _print(x)
-        #define _println(x)
-        #define _printf(...)
+        #define _print(x) do { } while(0)
+        #define _println(x) do { } while(0)
+        #define _printf(...) do { } while(0)
     #endif
     #define _yield() do { taskYIELD(); } while(0)
 #else // Generic devices (intel, amd, arm) and OS (windows, Linux)
@@ -49,11 +50,21 @@
         #define _println(x) do { if(_debug_level) printf("%s\n", x); } while(0)
         #define _printf(...) do { if(_debug_level) printf(__VA_ARGS__); } while(0)
     #else
-        #define _print(x)
-        #define _println(x)
-        #define _printf(...)
+        #define _print(x) do { } while(0)
+        #define _println(x) do { } while(0)
+        #define _printf(...) do { } while(0)
     #endif
-    #define _yield()
+    #define _yield() do { } while(0)
+#endif
+
+// Unexpected and error responses go to the log ring instead of being printed (no slow
+// synchronous prints of the whole response buffer), while requests and responses are logged by
+// the client with debug level 2
+#ifndef UTLGBOT_NO_DEBUG
+    #define _log(level, data) do { if(_debug_level) \
+        http_log_write(level, HTTP_LOG_PHASE_NONE, data, strlen(data)); } while(0)
+#else
+    #define _log(level, data) do { } while(0)
 #endif
 
 // Functions Return Codes
@@ -61,6 +72,58 @@
 #define RC_BAD           -1
 #define RC_INVALID_INPUT -2
 
+// JSON boolean value string max size
+#define JSON_BOOL_STR_LENGTH 6
+
+// Updates types that holds a message
+#define UPDATE_MESSAGE_TYPES (UPDATE_MESSAGE | UPDATE_EDITED_MESSAGE | UPDATE_CHANNEL_POST | \
+    UPDATE_EDITED_CHANNEL_POST)
+
+// Latency stats hooks (no code at all if latency stats are disabled)
+#if defined(UTLGBOT_LATENCY_STATS)
+    #define _latency_parse_begin() do { latency_parse_begin(); } while(0)
+    #define _latency_parse_end() do { latency_parse_end(); } while(0)
+    #define _latency_record(command) do { latency_record(command, &_client); } while(0)
+#else
+    #define _latency_parse_begin() do { } while(0)
+    #define _latency_parse_end() do { } while(0)
+    #define _latency_record(command) do { } while(0)
+#endif
+
+// Metrics hooks (no code at all if metrics are disabled)
+#if defined(UTLGBOT_METRICS)
+    #define _metrics_add(counter) do { metrics_add(counter, 1); } while(0)
+    #define _metrics_result(result) do { _metrics_result = result; } while(0)
+    #define _metrics_request(command) do { metrics_request(command, _metrics_result); \
+        metrics_record_client(&_client); } while(0)
+#else
+    #define _metrics_add(counter) do { } while(0)
+    #define _metrics_result(result) do { } while(0)
+    #define _metrics_request(command) do { } while(0)
+#endif
+
+// Trace points of the Bot client requests (no code at all if trace is disabled)
+#define _trace(point, arg) HTTP_TRACE(point, &_client, arg)
+
+/**************************************************************************************************/
+
+/* API Methods Names (in API_METHOD_* indexes order) */
+
+static const char* API_METHODS_NAMES[API_NUM_METHODS] =
+{
+    API_CMD_GET_ME, API_CMD_SEND_MSG, API_CMD_GET_UPDATES, API_CMD_EDIT_MSG_TEXT,
+    API_CMD_ANSWER_CALLBACK, API_CMD_SEND_CHAT_ACTION, "other"
+};
+
+/* Updates Types Names (in UPDATE_* flags bits order) */
+
+static const char* UPDATE_TYPES_NAMES[UPDATE_NUM_TYPES] =
+{
+    "message", "edited_message", "channel_post", "edited_channel_post", "inline_query",
+    "chosen_inline_result", "callback_query", "shipping_query", "pre_checkout_query", "poll",
+    "poll_answer", "my_chat_member", "chat_member", "chat_join_request"
+};
+
 /**************************************************************************************************/
 
 /* Constructor & Destructor */
@@ -71,19 +134,39 @@ uTLGBot::uTLGBot(const char* token, const bool dont_keep_connection)
     snprintf(_token, TOKEN_LENGTH, "%s", token);
     snprintf(_tlg_api, TELEGRAM_API_LENGTH, "/bot%s", _token);
     memset(_buffer, '\0', HTTP_MAX_RES_LENGTH);
-    memset(_json_value_str, '\0', MAX_JSON_STR_LEN);
-    memset(_json_subvalue_str, '\0', MAX_JSON_SUBVAL_STR_LEN);
+    memset(_callback_answer, '\0', MAX_CALLBACK_ANSWER_LENGTH);
     memset(_json_elements, 0, (sizeof(jsmntok_t)*MAX_JSON_ELEMENTS));
-    memset(_json_subelements, 0, (sizeof(jsmntok_t)*MAX_JSON_SUBELEMENTS));
     _long_poll_timeout = DEFAULT_TELEGRAM_LONG_POLL_S;
     _last_received_msg = UINT64_MAX;
     _dont_keep_connection = dont_keep_connection;
+    _callback_auto_answer = true;
+    _update_fields = UPDATE_FIELDS_ALL;
+    set_allowed_updates(DEFAULT_ALLOWED_UPDATES);
+#if UTLGBOT_DEDUP_WINDOW > 0
+    memset(_dedup_bitmap, 0, sizeof(_dedup_bitmap));
+    _dedup_max = 0;
+    _dedup_started = false;
+#endif
     _debug_level = 0;
+    _last_error_code = 0;
+    _retry_after = 0;
     _tlg_api_ca_pem_start = NULL;
     _tlg_api_ca_pem_end = NULL;
+    _tlg_api_ca_der = NULL;
+    _tlg_api_ca_der_len = 0;
+#if defined(UTLGBOT_LATENCY_STATS)
+    _latency_parse_t0 = 0;
+    _latency_parse_us = 0;
+    _latency_parse_measured = false;
+    reset_latency_stats();
+#endif
+#if defined(UTLGBOT_METRICS)
+    _metrics_result = METRICS_RESULT_OK;
+    _connected_before = false;
+#endif
 
     // Clear message data
-    clear_msg_data();
+    clear_msg_data(&received_msg);
 }
 
 // TLGBot destructor
@@ -100,6 +183,13 @@ void uTLGBot::set_debug(const uint8_t debug_level)
     _debug_level = debug_level;
     if(_debug_level > 1)
         _client.set_debug(true);
+
+    // Native prints log records from a background thread (in other systems the application drain
+    // them with http_log_drain() when it has time to print)
+    #if !defined(ARDUINO) && !defined(ESP_IDF) && !defined(MULTIHTTPSCLIENT_NO_DEBUG)
+        if(_debug_level > 0)
+            http_log_start_drain_thread();
+    #endif
 }
 
 // Set/Modify actual Bot Token
@@ -115,10 +205,26 @@ void uTLGBot::set_cert(const uint8_t* ca_pem_start, const uint8_t* ca_pem_end)
 {
     _tlg_api_ca_pem_start = ca_pem_start;
     _tlg_api_ca_pem_end = ca_pem_end;
+    _tlg_api_ca_der = NULL;
+    _tlg_api_ca_der_len = 0;
 
     _client.set_cert(_tlg_api_ca_pem_start, _tlg_api_ca_pem_end);
 }
 
+// Set/Modify Telegram Server Certificate from DER data (by default, the precompiled Telegram API
+// CA certificate), it is parsed in place so the data must be kept while the Bot is in use
+bool uTLGBot::set_cert_der(const uint8_t* ca_der, const size_t ca_der_len)
+{
+    if(!_client.set_cert_der(ca_der, ca_der_len))
+        return false;
+
+    _tlg_api_ca_pem_start = NULL;
+    _tlg_api_ca_pem_end = NULL;
+    _tlg_api_ca_der = ca_der;
+    _tlg_api_ca_der_len = ca_der_len;
+    return true;
+}
+
 // Set/Modify Telegram Server Certificate
 void uTLGBot::set_cert(const char* cert_https_server)
 {
@@ -171,6 +277,10 @@ uint8_t uTLGBot::connect(void)
     }
 
     _println("[Bot] Successfully connected.");
+#if defined(UTLGBOT_METRICS)
+    _metrics_add(_connected_before ? METRICS_RECONNECTIONS : METRICS_CONNECTIONS);
+    _connected_before = true;
+#endif
 
     return true;
 }
@@ -214,6 +324,8 @@ uint8_t uTLGBot::getMe(void)
     // Send the request
     _println("[Bot] Trying to send getMe request...");
     request_result = tlg_get(API_CMD_GET_ME, _buffer, HTTP_MAX_RES_LENGTH);
+    _latency_record(API_CMD_GET_ME);
+    _metrics_request(API_CMD_GET_ME);
 
     // Check if request has fail
     if(request_result == 0)
@@ -227,11 +339,6 @@ uint8_t uTLGBot::getMe(void)
         return false;
     }
 
-    // Parse and check response
-    _println("\n[Bot] Response received:");
-    _println(_buffer);
-    _println(" ");
-
     // Disconnect from telegram server
     if(_dont_keep_connection && is_connected())
         disconnect();
@@ -239,23 +346,65 @@ uint8_t uTLGBot::getMe(void)
     return true;
 }
 
-// Request Bot send a reply keyboard markup
+// Request Bot send a reply keyboard markup (keyboard is a JSON array of buttons rows)
 uint8_t uTLGBot::sendReplyKeyboardMarkup(const char* chat_id, const char* text,
     const char* keyboard)
 {
-    snprintf(json_keyboard, MAX_KEYBOARD_MARKUP_LENGTH, "{\"keyboard\":%s}", keyboard);
-    return sendMessage(chat_id, text, "", false, false, 0, json_keyboard);
+    tlg_markup markup = { "", keyboard, NULL, NULL, KEYBOARD_REPLY, 0 };
+
+    return send_message(chat_id, text, "", false, false, 0, &markup, false);
+}
+
+// Request Bot send a text message with a keyboard, which rows and buttons are added by the
+// builder function straight into the request (check uTLGBotKeyboard)
+uint8_t uTLGBot::sendKeyboard(const char* chat_id, const char* text,
+    tlg_keyboard_builder keyboard, void* user_data, const uint8_t keyboard_type,
+    const char* parse_mode)
+{
+    tlg_markup markup = { "", NULL, keyboard, user_data, keyboard_type, 0 };
+
+    return send_message(chat_id, text, parse_mode, false, false, 0, &markup, false);
 }
 
 // Request Bot send text message to specified chat ID (The Bot should be in that Chat)
+// Note: Texts that doesn't fit in a message (or in the request buffer) are sent in several
+// messages, in order, cutting them at line or word ends and keeping its Markdown/HTML entities
+// balanced (reply_to_message_id is set in first message and reply_markup in the last one)
 uint8_t uTLGBot::sendMessage(const char* chat_id, const char* text, const char* parse_mode,
     bool disable_web_page_preview, bool disable_notification, uint64_t reply_to_message_id,
     const char* reply_markup)
 {
-    // Note: Due to undefined behavior if use same source and target in snprintf(), we need to
-    // use a temporary copy array (dont trust strncat)
-    char tmp[MAX_TMP_BUFFER_LENGTH];
-    uint8_t request_result;
+    tlg_markup markup = { reply_markup, NULL, NULL, NULL, KEYBOARD_INLINE, 0 };
+
+    return send_message(chat_id, text, parse_mode, disable_web_page_preview,
+        disable_notification, reply_to_message_id, (reply_markup[0] != '\0') ? &markup : NULL,
+        false);
+}
+
+// Request Bot send an already JSON escaped text message to specified chat ID (i.e. a received
+// text, that is kept JSON escaped, so it is sent back as it is instead of escaping it again)
+uint8_t uTLGBot::sendEscapedMessage(const char* chat_id, const char* text,
+    const char* parse_mode, bool disable_web_page_preview, bool disable_notification,
+    uint64_t reply_to_message_id, const char* reply_markup)
+{
+    tlg_markup markup = { reply_markup, NULL, NULL, NULL, KEYBOARD_INLINE, 0 };
+
+    return send_message(chat_id, text, parse_mode, disable_web_page_preview,
+        disable_notification, reply_to_message_id, (reply_markup[0] != '\0') ? &markup : NULL,
+        true);
+}
+
+// Request for check how many availables messages are waiting to be received
+uint8_t uTLGBot::getUpdates(void)
+{
+    return getUpdates(&received_msg);
+}
+
+// Request for check how many availables messages are waiting to be received, and get the
+// received message data into the provided message
+uint8_t uTLGBot::getUpdates(tlg_type_message* msg)
+{
+    uint8_t request_result, num_updates;
     bool connected;
 
     // Connect to telegram server
@@ -264,109 +413,58 @@ uint8_t uTLGBot::sendMessage(const char* chat_id, const char* text, const char*
     {
         connected = connect();
         if(!connected)
-            return false;
+            return 0;
     }
 
     // Create HTTP Body request data
-    snprintf(_buffer, HTTP_MAX_RES_LENGTH, "{\"chat_id\":%s, \"text\":\"%s\"}",
-        chat_id, text);
-    // If parse_mode is not empty
-    if(parse_mode[0] != '\0')
-    {
-        // If parse mode has an expected value
-        if((strcmp(parse_mode, "Markdown") == 0) || (strcmp(parse_mode, "HTML") == 0))
-        {
-            // Remove last brace and append the new field
-            _buffer[strlen(_buffer)-1] = '\0';
-            snprintf(tmp, MAX_TMP_BUFFER_LENGTH, ",\"parse_mode\":%s\"}", parse_mode);
-            if(!cstr_strncat(_buffer, HTTP_MAX_RES_LENGTH, tmp, strlen(tmp)))
-            {
-                cant_create_send_msg(_buffer);
-                return false;
-            }
-        }
-        else
-            _println("[Bot] Warning: Invalid parse_mode provided.");
-    }
-    // Remove last brace and append disable_web_page_preview value if true
-    if(disable_web_page_preview)
-    {
-        _buffer[strlen(_buffer)-1] = '\0';
-        if(!cstr_strncat(_buffer, HTTP_MAX_RES_LENGTH, ",\"disable_web_page_preview\":true}",
-            strlen(",\"disable_web_page_preview\":true}")))
-        {
-            cant_create_send_msg(_buffer);
-            return false;
-        }
-    }
-    // Remove last brace and append disable_notification value if true
-    if(disable_notification)
-    {
-        _buffer[strlen(_buffer)-1] = '\0';
-        if(!cstr_strncat(_buffer, HTTP_MAX_RES_LENGTH, ",\"disable_notification\":true}",
-            strlen(",\"disable_notification\":true}")))
-        {
-            cant_create_send_msg(_buffer);
-            return false;
-        }
-    }
-    // Remove last brace and append reply_to_message_id value if set
-    if(reply_to_message_id != 0)
-    {
-        _buffer[strlen(_buffer)-1] = '\0';
-        snprintf(tmp, MAX_TMP_BUFFER_LENGTH, ",\"reply_to_message_id\":%" PRIu64 "}",
-            reply_to_message_id);
-        if(!cstr_strncat(_buffer, HTTP_MAX_RES_LENGTH, tmp, strlen(tmp)))
-        {
-            cant_create_send_msg(_buffer);
-            return false;
-        }
-    }
-    // Remove last brace and append reply_markup if it is not empty
-    if(reply_markup[0] != '\0')
-    {
-        _buffer[strlen(_buffer)-1] = '\0';
-        snprintf(tmp, MAX_TMP_BUFFER_LENGTH, ",\"reply_markup\":%s}", reply_markup);
-        if(!cstr_strncat(_buffer, HTTP_MAX_RES_LENGTH, tmp, strlen(tmp)))
-        {
-            cant_create_send_msg(_buffer);
-            return false;
-        }
-    }
+    create_getupdates_body(_buffer, HTTP_MAX_RES_LENGTH);
 
     // Send the request
-    _println("[Bot] Trying to send message request...");
-    _println("Mesage to send:");
-    _println(_buffer);
-    _println("");
-    request_result = tlg_post(API_CMD_SEND_MSG, _buffer, strlen(_buffer), HTTP_MAX_RES_LENGTH);
+    _println("[Bot] Trying to send getUpdates request...");
+    request_result = tlg_post(API_CMD_GET_UPDATES, _buffer, strlen(_buffer), HTTP_MAX_RES_LENGTH,
+        (_long_poll_timeout*1000)+HTTP_WAIT_RESPONSE_TIMEOUT);
 
     // Check if request has fail
     if(request_result == false)
     {
         _println("[Bot] Command fail, no response received.");
+        _latency_record(API_CMD_GET_UPDATES);
+        _metrics_request(API_CMD_GET_UPDATES);
 
         // Disconnect from telegram server
         if(is_connected())
             disconnect();
 
-        return false;
+        return 0;
     }
 
-    // Parse and check response
-    _println("\n[Bot] Response received:");
-    _println(_buffer);
-    _println(" ");
+    // Parse received update
+    _latency_parse_begin();
+    _trace(PARSE_BEGIN, 0);
+    num_updates = parse_update(_buffer, msg);
+    _trace(PARSE_END, num_updates);
+    _latency_parse_end();
+    _latency_record(API_CMD_GET_UPDATES);
+    _metrics_request(API_CMD_GET_UPDATES);
+
+    // Answer a received callback query right now (before the application handles it), so the
+    // user button loading animation ends as soon as possible
+    if((num_updates != 0) && _callback_auto_answer &&
+       (msg->update_type == UPDATE_CALLBACK_QUERY) && (msg->callback_query.id[0] != '\0'))
+        msg->callback_query.answered = answerCallbackQuery(msg->callback_query.id);
 
     // Disconnect from telegram server
     if(_dont_keep_connection && is_connected())
         disconnect();
 
-    return true;
+    return num_updates;
 }
 
-// Request for check how many availables messages are waiting to be received
-uint8_t uTLGBot::getUpdates(void)
+// Edit the text of a message sent by the Bot
+// Note: Telegram rejects edits that doesn't change the message content, and limits edits rate
+// like messages, so use uTLGBotEditEngine to update live status messages
+uint8_t uTLGBot::editMessageText(const char* chat_id, const uint64_t message_id,
+    const char* text, const char* parse_mode, const char* reply_markup)
 {
     uint8_t request_result;
     bool connected;
@@ -377,364 +475,372 @@ uint8_t uTLGBot::getUpdates(void)
     {
         connected = connect();
         if(!connected)
-            return 0;
+            return false;
     }
 
-    // Create HTTP Body request data (Note that we limit messages to 1 and just allow text messages)
-    snprintf(_buffer, HTTP_MAX_RES_LENGTH, "{\"offset\":%" PRIu64 ", \"limit\":1, " \
-        "\"timeout\":%" PRIu8 ", \"allowed_updates\":[\"message\"]}", _last_received_msg,
-        _long_poll_timeout);
+    // Create HTTP Body request data
+    if(!create_edit_msg_body(_buffer, HTTP_MAX_RES_LENGTH, chat_id, message_id, text,
+        parse_mode, reply_markup))
+    {
+        cant_create_send_msg(_buffer);
+        return false;
+    }
 
     // Send the request
-    _println("[Bot] Trying to send getUpdates request...");
-    _println("Mesage to send:");
-    _println(_buffer);
-    _println("");
-    request_result = tlg_post(API_CMD_GET_UPDATES, _buffer, strlen(_buffer), HTTP_MAX_RES_LENGTH,
-        (_long_poll_timeout*1000)+HTTP_WAIT_RESPONSE_TIMEOUT);
+    _println("[Bot] Trying to send edit message request...");
+    request_result = tlg_post(API_CMD_EDIT_MSG_TEXT, _buffer, strlen(_buffer),
+        HTTP_MAX_RES_LENGTH);
+    _latency_record(API_CMD_EDIT_MSG_TEXT);
+    _metrics_request(API_CMD_EDIT_MSG_TEXT);
 
-    // Check if request has fail
+    // Check if request has fail (keep connection on API errors, i.e. too many requests)
     if(request_result == false)
     {
-        _println("[Bot] Command fail, no response received.");
-
-        // Disconnect from telegram server
-        if(is_connected())
+        _println("[Bot] Edit message fail.");
+        if((_last_error_code == 0) && is_connected())
             disconnect();
-
-        return 0;
+        return false;
     }
 
-    // Use a pointer to received buffer data
-    char* ptr_response = &(_buffer[0]);
+    // Disconnect from telegram server
+    if(_dont_keep_connection && is_connected())
+        disconnect();
 
-    // Remove any EOL character
-    cstr_rm_char(ptr_response, strlen(ptr_response), '\r');
-    cstr_rm_char(ptr_response, strlen(ptr_response), '\n');
+    return true;
+}
 
-    // Remove start and end list characters ('[' and ']') from response and just keep json structure
-    if(strlen(ptr_response) >= 2)
+// Answer a callback query sent from an inline keyboard button (optional text is shown to the user
+// as a notification, or as an alert if show_alert is set)
+// Note: The request is built and received in its own preallocated buffer, so the last received
+// message data is kept, and no message parse is needed for the response
+uint8_t uTLGBot::answerCallbackQuery(const char* callback_query_id, const char* text,
+    const bool show_alert)
+{
+    uint8_t request_result;
+    bool connected;
+
+    // Connect to telegram server
+    connected = is_connected();
+    if(!connected)
     {
-        if(ptr_response[strlen(ptr_response)-1] == ']')
-            ptr_response[strlen(ptr_response)-1] = '\0';
-        if(ptr_response[0] == '[')
-            ptr_response[0] = '\0';
-        ptr_response = ptr_response + 1;
+        connected = connect();
+        if(!connected)
+            return false;
     }
 
-    // Check if response is empty (there is no message)
-    if(ptr_response[0] == '\0')
+    // Create HTTP Body request data
+    if(!create_answer_callback_body(_callback_answer, MAX_CALLBACK_ANSWER_LENGTH,
+        callback_query_id, text, show_alert))
     {
-        _println("[Bot] There is not new message.");
+        cant_create_send_msg(_callback_answer);
+        return false;
+    }
 
-        // Disconnect from telegram server
-        if(_dont_keep_connection && is_connected())
-            disconnect();
+    // Send the request
+    _println("[Bot] Trying to send answer callback query request...");
+    request_result = tlg_post(API_CMD_ANSWER_CALLBACK, _callback_answer,
+        strlen(_callback_answer), MAX_CALLBACK_ANSWER_LENGTH);
+    _latency_record(API_CMD_ANSWER_CALLBACK);
+    _metrics_request(API_CMD_ANSWER_CALLBACK);
 
-        return 0;
-    }
-    else
+    // Check if request has fail (keep connection on API errors, i.e. query is too old)
+    if(request_result == false)
     {
-        _println("\n[Bot] Response received:");
-        _println(ptr_response);
-        _println(" ");
+        _println("[Bot] Answer callback query fail.");
+        if((_last_error_code == 0) && is_connected())
+            disconnect();
+        return false;
     }
 
-    // A new message received, so lets clear all message data
-    clear_msg_data();
-
-    /**********************************************************************************************/
-
-    /* Response JSON Parse */
+    // Disconnect from telegram server
+    if(_dont_keep_connection && is_connected())
+        disconnect();
 
-    uint32_t num_elements, num_subelements;
-    uint32_t key_position;
+    return true;
+}
 
-    // Clear json elements objects
-    memset(_json_elements, 0, (sizeof(jsmntok_t)*MAX_JSON_ELEMENTS));
-    memset(_json_subelements, 0, (sizeof(jsmntok_t)*MAX_JSON_SUBELEMENTS));
+// Send a chat action, the status shown to the chat users while the Bot prepares a response (i.e.
+// "typing"), it lasts 5 seconds or until the Bot sends a message (uTLGBotChatActions keeps it
+// alive for long-running handlers)
+// Note: The request is built and received in the preallocated callback answer buffer, so the last
+// received message data is kept
+uint8_t uTLGBot::sendChatAction(const char* chat_id, const char* action)
+{
+    uint8_t request_result;
 
-    // Parse message string as JSON and get each element
-    num_elements = json_parse_str(ptr_response, strlen(ptr_response), _json_elements,
-        MAX_JSON_ELEMENTS);
-    if(num_elements == 0)
+    // Connect to telegram server
+    if(!is_connected())
     {
-        _println("[Bot] Error: Bad JSON sintax from received response.");
-
-        // Ignore this message that can't be readed and increase counter to ask for the next one
-        _last_received_msg = _last_received_msg + 1;
-
-        // Disconnect from telegram server
-        if(_dont_keep_connection && is_connected())
-            disconnect();
-
-        return 0;
+        if(!connect())
+            return false;
     }
 
-    // Check and get value of key: update_id
-    key_position = json_has_key(ptr_response, _json_elements, num_elements, "update_id");
-    if(key_position != 0)
+    // Create HTTP Body request data
+    if(!create_chat_action_body(_callback_answer, MAX_CALLBACK_ANSWER_LENGTH, chat_id, action))
     {
-        // Get json element string
-        json_get_element_string(ptr_response, &_json_elements[key_position+1],
-            _json_value_str, MAX_JSON_STR_LEN);
-
-        // Save value in variable
-        sscanf(_json_value_str, "%" SCNu64, &_last_received_msg);
-
-        // Prepare variable to next update message request (offset)
-        _last_received_msg = _last_received_msg + 1;
+        cant_create_send_msg(_callback_answer);
+        return false;
     }
 
-    // Check and get value of key: message_id
-    key_position = json_has_key(ptr_response, _json_elements, num_elements,
-        "message_id");
-    if(key_position != 0)
-    {
-        // Get json element string
-        json_get_element_string(ptr_response, &_json_elements[key_position+1],
-            _json_value_str, MAX_JSON_STR_LEN);
+    // Send the request
+    _println("[Bot] Trying to send chat action request...");
+    request_result = tlg_post(API_CMD_SEND_CHAT_ACTION, _callback_answer,
+        strlen(_callback_answer), MAX_CALLBACK_ANSWER_LENGTH);
+    _latency_record(API_CMD_SEND_CHAT_ACTION);
+    _metrics_request(API_CMD_SEND_CHAT_ACTION);
 
-        // Save value in variable
-        sscanf(_json_value_str, "%" SCNd64, &received_msg.message_id);
+    // Check if request has fail (keep connection on API errors, i.e. chat not found)
+    if(request_result == false)
+    {
+        _println("[Bot] Send chat action fail.");
+        if((_last_error_code == 0) && is_connected())
+            disconnect();
+        return false;
     }
 
-    // Check and get value of key: date
-    key_position = json_has_key(ptr_response, _json_elements, num_elements, "date");
-    if(key_position != 0)
-    {
-        // Get json element string
-        json_get_element_string(ptr_response, &_json_elements[key_position+1],
-            _json_value_str, MAX_JSON_STR_LEN);
+    // Disconnect from telegram server
+    if(_dont_keep_connection && is_connected())
+        disconnect();
 
-        // Save value in variable
-        sscanf(_json_value_str, "%" SCNu32, &received_msg.date);
-    }
+    return true;
+}
 
-    // Check and get value of key: text
-    key_position = json_has_key(ptr_response, _json_elements, num_elements, "text");
-    if(key_position != 0)
-    {
-        // Get json element string
-        json_get_element_string(ptr_response, &_json_elements[key_position+1],
-        _json_value_str, MAX_JSON_STR_LEN);
+// Enable/Disable answering received callback queries inside getUpdates() (enabled by default)
+// Disable it to answer them with a text or an alert (call answerCallbackQuery() as soon as
+// possible, Telegram clients keep showing the button loading animation until then)
+void uTLGBot::set_callback_auto_answer(const bool enable)
+{
+    _callback_auto_answer = enable;
+}
 
-        // Save value in variable
-        snprintf(received_msg.text, MAX_TEXT_LENGTH, "%s", _json_value_str);
-    }
+// Set the types of updates to receive (UPDATE_* flags, default messages and callback queries,
+// and 0 for Telegram default types)
+// Note: The getUpdates "allowed_updates" list is created here, so it is not created for each
+// request. Telegram keeps the last list it got, so it applies from the next getUpdates request
+void uTLGBot::set_allowed_updates(const uint16_t update_types)
+{
+    size_t len;
 
-    // Check and get value of key: from
-    key_position = json_has_key(ptr_response, _json_elements, num_elements, "from");
-    if(key_position != 0)
+    len = snprintf(_allowed_updates, MAX_ALLOWED_UPDATES_LENGTH, "[");
+    for(uint8_t type = 0; type < UPDATE_NUM_TYPES; type++)
     {
-        // Get json element string
-        json_get_element_string(ptr_response, &_json_elements[key_position+1],
-            _json_value_str, MAX_JSON_STR_LEN);
+        if((update_types & (1 << type)) == 0)
+            continue;
+        len = len + snprintf(_allowed_updates + len, MAX_ALLOWED_UPDATES_LENGTH - len,
+            "%s\"%s\"", (len > 1) ? "," : "", UPDATE_TYPES_NAMES[type]);
+    }
+    snprintf(_allowed_updates + len, MAX_ALLOWED_UPDATES_LENGTH - len, "]");
+}
 
-        // Parse string "from" content as JSON and get each element
-        num_subelements = json_parse_str(_json_value_str, strlen(_json_value_str),
-            _json_subelements, MAX_JSON_SUBELEMENTS);
-        if(num_subelements == 0)
-            _println("[Bot] Error: Bad JSON sintax in \"from\" element.");
-        else
-        {
-            // Check and get value of key: id
-            key_position = json_has_key(_json_value_str, _json_subelements,
-                num_subelements, "id");
-            if(key_position != 0)
-            {
-                // Get json element string
-                json_get_element_string(_json_value_str,
-                    &_json_subelements[key_position+1],
-                    _json_subvalue_str, MAX_JSON_SUBVAL_STR_LEN);
+// Set the fields to extract from received updates (UPDATE_FIELD_* flags of all fields that the
+// application handlers read, default all of them)
+// Note: Not selected fields are not decoded at all and are left empty
+void uTLGBot::set_update_fields(const uint16_t update_fields)
+{
+    _update_fields = update_fields;
+}
 
-                // Save value in variable
-                strncpy(received_msg.from.id, _json_subvalue_str, MAX_ID_LENGTH);
-            }
+// Get the offset of next getUpdates request (last received update ID + 1)
+// Note: Save it after an update is handled, and restore it with set_updates_offset() at startup,
+// so a restart doesn't handle again the updates that the server had not confirmed yet
+uint64_t uTLGBot::get_updates_offset(void)
+{
+    return _last_received_msg;
+}
 
-            // Check and get value of key: is_bot
-            key_position = json_has_key(_json_value_str, _json_subelements,
-                num_subelements, "is_bot");
-            if(key_position != 0)
-            {
-                // Get json element string
-                json_get_element_string(_json_value_str,
-                    &_json_subelements[key_position+1],
-                    _json_subvalue_str, MAX_JSON_SUBVAL_STR_LEN);
-
-                // Save value in variable
-                if(strcmp(_json_subvalue_str, "true") == 0)
-                    received_msg.from.is_bot = true;
-                else
-                    received_msg.from.is_bot = false;
-            }
+// Set the offset of next getUpdates request (i.e. a saved one), updates with lower IDs are
+// confirmed to the server and any of them received later is dropped
+void uTLGBot::set_updates_offset(const uint64_t offset)
+{
+    _last_received_msg = offset;
+#if UTLGBOT_DEDUP_WINDOW > 0
+    memset(_dedup_bitmap, 0xFF, sizeof(_dedup_bitmap));
+    _dedup_max = offset - 1;
+    _dedup_started = (offset != 0);
+#endif
+}
 
-            // Check and get value of key: first_name
-            key_position = json_has_key(_json_value_str, _json_subelements,
-                num_subelements, "first_name");
-            if(key_position != 0)
-            {
-                // Get json element string
-                json_get_element_string(_json_value_str,
-                    &_json_subelements[key_position+1],
-                    _json_subvalue_str, MAX_JSON_SUBVAL_STR_LEN);
+// Get the Telegram "error_code" of last failed request (0 if last request got no response or an
+// unexpected one)
+uint16_t uTLGBot::get_last_error_code(void)
+{
+    return _last_error_code;
+}
 
-                // Save value in variable
-                strncpy(received_msg.from.first_name, _json_subvalue_str, MAX_USER_LENGTH);
-            }
+// Get the seconds to wait before repeat last request, if it was rejected due to flood control
+// (HTTP 429 "retry_after" parameter)
+uint32_t uTLGBot::get_retry_after(void)
+{
+    return _retry_after;
+}
 
-            // Check and get value of key: last_name
-            key_position = json_has_key(_json_value_str, _json_subelements,
-                num_subelements, "last_name");
-            if(key_position != 0)
-            {
-                // Get json element string
-                json_get_element_string(_json_value_str,
-                    &_json_subelements[key_position+1], _json_subvalue_str,
-                    MAX_JSON_SUBVAL_STR_LEN);
+// Get the stats index of an API command (API_METHOD_OTHER if it is not a known one)
+uint8_t uTLGBot::api_method(const char* command)
+{
+    for(uint8_t method = 0; method < API_METHOD_OTHER; method++)
+    {
+        if(strcmp(command, API_METHODS_NAMES[method]) == 0)
+            return method;
+    }
+    return API_METHOD_OTHER;
+}
 
-                // Save value in variable
-                strncpy(received_msg.from.last_name, _json_subvalue_str, MAX_USER_LENGTH);
-            }
+// Get the name of an API command stats index
+const char* uTLGBot::api_method_name(const uint8_t method)
+{
+    if(method >= API_NUM_METHODS)
+        return API_METHODS_NAMES[API_METHOD_OTHER];
+    return API_METHODS_NAMES[method];
+}
 
-            // Check and get value of key: username
-            key_position = json_has_key(_json_value_str, _json_subelements,
-                num_subelements, "username");
-            if(key_position != 0)
-            {
-                // Get json element string
-                json_get_element_string(_json_value_str,
-                    &_json_subelements[key_position+1], _json_subvalue_str,
-                    MAX_JSON_SUBVAL_STR_LEN);
+#if defined(UTLGBOT_LATENCY_STATS)
 
-                // Save value in variable
-                strncpy(received_msg.from.username, _json_subvalue_str, MAX_USERNAME_LENGTH);
-            }
+// Get a snapshot of the latency histograms of an API method (i.e. API_CMD_GET_UPDATES)
+bool uTLGBot::get_latency_stats(const char* command, tlg_latency_stats* stats)
+{
+    if(stats == NULL)
+        return false;
+    memcpy(stats, &_latency[api_method(command)], sizeof(tlg_latency_stats));
+    return true;
+}
 
-            // Check and get value of key: language_code
-            key_position = json_has_key(_json_value_str, _json_subelements,
-                num_subelements, "language_code");
-            if(key_position != 0)
-            {
-                // Get json element string
-                json_get_element_string(_json_value_str,
-                    &_json_subelements[key_position+1], _json_subvalue_str,
-                    MAX_JSON_SUBVAL_STR_LEN);
-
-                // Save value in variable
-                strncpy(received_msg.from.language_code, _json_subvalue_str, MAX_LANGUAGE_CODE_LENGTH);
-            }
-        }
+// Clear all latency histograms
+void uTLGBot::reset_latency_stats(void)
+{
+    for(uint8_t method = 0; method < API_NUM_METHODS; method++)
+    {
+        for(uint8_t phase = 0; phase < LATENCY_NUM_PHASES; phase++)
+            latency_histogram_clear(&_latency[method].phase[phase]);
     }
+}
 
-    // Check and get value of key: chat
-    key_position = json_has_key(ptr_response, _json_elements, num_elements, "chat");
-    if(key_position != 0)
+#endif
+
+// Get Bot connection heap (mbedtls allocations) and stack usage (just accounted in
+// UTLGBOT_MEMORY_STATS builds)
+const http_memory_stats* uTLGBot::get_memory_stats(void)
+{
+    return _client.get_memory_stats();
+}
+
+// Clear Bot connection memory stats (heap peak restarts from current usage)
+void uTLGBot::clear_memory_stats(void)
+{
+    _client.clear_memory_stats();
+}
+
+/**************************************************************************************************/
+
+/* Telegram API GET and POST Methods */
+
+// Make and send a HTTP GET request
+uint8_t uTLGBot::tlg_get(const char* command, char* response, const size_t response_len,
+    const unsigned long response_timeout)
+{
+    char uri[HTTP_MAX_URI_LENGTH];
+    uint8_t rc;
+
+    // Create URI and send GET request
+    _last_error_code = 0;
+    _retry_after = 0;
+    snprintf(uri, HTTP_MAX_URI_LENGTH, "%s/%s", _tlg_api, command);
+    if(_client.get(uri, TELEGRAM_HOST, response, response_len, response_timeout) > 0)
     {
-        // Get json element string
-        json_get_element_string(ptr_response, &_json_elements[key_position+1],
-            _json_value_str, MAX_JSON_STR_LEN);
+        _metrics_result(METRICS_RESULT_NO_RESPONSE);
+        return false;
+    }
 
-        // Parse string "from" content as JSON and get each element
-        num_subelements = json_parse_str(_json_value_str, strlen(_json_value_str),
-            _json_subelements, MAX_JSON_ELEMENTS);
-        if(num_subelements == 0)
-            _println("[Bot] Error: Bad JSON sintax in \"from\" element.");
-        else
-        {
-            // Check and get value of key: id
-            key_position = json_has_key(_json_value_str, _json_subelements,
-                num_subelements, "id");
-            if(key_position != 0)
-            {
-                // Get json element string
-                json_get_element_string(_json_value_str, &_json_subelements[key_position+1],
-                    _json_subvalue_str, MAX_JSON_SUBVAL_STR_LEN);
+    // Check response and just keep "result" value
+    _latency_parse_begin();
+    _trace(PARSE_BEGIN, 0);
+    rc = tlg_parse_response(response, response_len);
+    _trace(PARSE_END, rc);
+    _latency_parse_end();
 
-                // Save value in variable
-                strncpy(received_msg.chat.id, _json_subvalue_str, MAX_ID_LENGTH);
-            }
+    return rc;
+}
 
-            // Check and get value of key: type
-            key_position = json_has_key(_json_value_str, _json_subelements,
-                num_subelements, "type");
-            if(key_position != 0)
-            {
-                // Get json element string
-                json_get_element_string(_json_value_str, &_json_subelements[key_position+1],
-                    _json_subvalue_str, MAX_JSON_SUBVAL_STR_LEN);
+// Make and send a HTTP GET request
+uint8_t uTLGBot::tlg_post(const char* command, char* request_response, const size_t request_len,
+    const size_t request_response_max_size, const unsigned long response_timeout)
+{
+    char uri[HTTP_MAX_URI_LENGTH];
+    uint8_t rc;
 
-                // Save value in variable
-                strncpy(received_msg.chat.type, _json_subvalue_str, MAX_CHAT_TYPE_LENGTH);
-            }
+    // Create URI and send POST request
+    _last_error_code = 0;
+    _retry_after = 0;
+    snprintf(uri, HTTP_MAX_URI_LENGTH, "%s/%s", _tlg_api, command);
+    if(_client.post(uri, TELEGRAM_HOST, request_response, request_len,
+        request_response_max_size, response_timeout) > 0)
+    {
+        _metrics_result(METRICS_RESULT_NO_RESPONSE);
+        return false;
+    }
 
-            // Check and get value of key: title
-            key_position = json_has_key(_json_value_str, _json_subelements,
-                num_subelements, "title");
-            if(key_position != 0)
-            {
-                // Get json element string
-                json_get_element_string(_json_value_str, &_json_subelements[key_position+1],
-                    _json_subvalue_str, MAX_JSON_SUBVAL_STR_LEN);
+    // Check response and just keep "result" value
+    _latency_parse_begin();
+    _trace(PARSE_BEGIN, 0);
+    rc = tlg_parse_response(request_response, request_response_max_size);
+    _trace(PARSE_END, rc);
+    _latency_parse_end();
 
-                // Save value in variable
-                strncpy(received_msg.chat.title, _json_subvalue_str, MAX_CHAT_TITLE_LENGTH);
-            }
+    return rc;
+}
 
-            // Check and get value of key: username
-            key_position = json_has_key(_json_value_str, _json_subelements, num_subelements,
-                "username");
-            if(key_position != 0)
-            {
-                // Get json element string
-                json_get_element_string(_json_value_str, &_json_subelements[key_position+1],
-                    _json_subvalue_str, MAX_JSON_SUBVAL_STR_LEN);
+// Request Bot send a text message, in several messages if it doesn't fit in one
+uint8_t uTLGBot::send_message(const char* chat_id, const char* text, const char* parse_mode,
+    bool disable_web_page_preview, bool disable_notification, uint64_t reply_to_message_id,
+    tlg_markup* reply_markup, const bool escaped)
+{
+    uTLGBotTextSplitter splitter(text, parse_mode, escaped);
+    uint8_t request_result;
+    bool connected;
 
-                // Save value in variable
-                strncpy(received_msg.chat.username, _json_subvalue_str, MAX_USERNAME_LENGTH);
-            }
+    // Get reply_markup length (space for it is kept in each message body)
+    if(reply_markup != NULL)
+    {
+        uTLGBotBodyWriter counter(NULL, 0);
+        write_markup(&counter, reply_markup);
+        reply_markup->length = counter.length();
+    }
 
-            // Check and get value of key: first_name
-            key_position = json_has_key(_json_value_str, _json_subelements,
-                num_subelements, "first_name");
-            if(key_position != 0)
-            {
-                // Get json element string
-                json_get_element_string(_json_value_str, &_json_subelements[key_position+1],
-                    _json_subvalue_str, MAX_JSON_SUBVAL_STR_LEN);
+    while(!splitter.done())
+    {
+        // Connect to telegram server
+        connected = is_connected();
+        if(!connected)
+        {
+            connected = connect();
+            if(!connected)
+                return false;
+        }
 
-                // Save value in variable
-                strncpy(received_msg.chat.first_name, _json_subvalue_str, MAX_USER_LENGTH);
-            }
+        // Create HTTP Body request data with next text part
+        if(!create_msg_body(_buffer, HTTP_MAX_RES_LENGTH, chat_id, &splitter, parse_mode,
+            disable_web_page_preview, disable_notification, reply_to_message_id, reply_markup))
+        {
+            cant_create_send_msg(_buffer);
+            return false;
+        }
 
-            // Check and get value of key: last_name
-            key_position = json_has_key(_json_value_str, _json_subelements,
-                num_subelements, "last_name");
-            if(key_position != 0)
-            {
-                // Get json element string
-                json_get_element_string(_json_value_str, &_json_subelements[key_position+1],
-                    _json_subvalue_str, MAX_JSON_SUBVAL_STR_LEN);
+        // Send the request
+        _println("[Bot] Trying to send message request...");
+        request_result = tlg_post(API_CMD_SEND_MSG, _buffer, strlen(_buffer),
+            HTTP_MAX_RES_LENGTH);
+        _latency_record(API_CMD_SEND_MSG);
+        _metrics_request(API_CMD_SEND_MSG);
 
-                // Save value in variable
-                strncpy(received_msg.chat.last_name, _json_subvalue_str, MAX_USER_LENGTH);
-            }
+        // Check if request has fail
+        if(request_result == false)
+        {
+            _println("[Bot] Command fail, no response received.");
 
-            // Check and get value of key: is_bot
-            key_position = json_has_key(_json_value_str, _json_subelements, num_subelements,
-                "all_members_are_administrators");
-            if(key_position != 0)
-            {
-                // Get json element string
-                json_get_element_string(_json_value_str, &_json_subelements[key_position+1],
-                    _json_subvalue_str, MAX_JSON_SUBVAL_STR_LEN);
-
-                // Save value in variable
-                if(strcmp(_json_subvalue_str, "true") == 0)
-                    received_msg.chat.all_members_are_administrators = true;
-                else
-                    received_msg.chat.all_members_are_administrators = false;
-            }
+            // Disconnect from telegram server
+            if(is_connected())
+                disconnect();
+
+            return false;
         }
     }
 
@@ -742,199 +848,657 @@ uint8_t uTLGBot::getUpdates(void)
     if(_dont_keep_connection && is_connected())
         disconnect();
 
-    return 1;
+    return true;
 }
 
-/**************************************************************************************************/
-
-/* Telegram API GET and POST Methods */
+#if defined(UTLGBOT_LATENCY_STATS)
 
-// Make and send a HTTP GET request
-uint8_t uTLGBot::tlg_get(const char* command, char* response, const size_t response_len,
-    const unsigned long response_timeout)
+// Start measuring a response parse
+void uTLGBot::latency_parse_begin(void)
 {
-    char* response_init_pos = response;
-    char uri[HTTP_MAX_URI_LENGTH];
-    int32_t pos = 0;
-    uint32_t i = 0;
+    _latency_parse_t0 = latency_now_us();
+}
 
-    // Create URI and send GET request
-    snprintf(uri, HTTP_MAX_URI_LENGTH, "%s/%s", _tlg_api, command);
-    if(_client.get(uri, TELEGRAM_HOST, response, response_len, response_timeout) > 0)
-        return false;
+// End measuring a response parse (parse time of a request is accumulated until it is recorded)
+void uTLGBot::latency_parse_end(void)
+{
+    _latency_parse_us = _latency_parse_us + (latency_now_us() - _latency_parse_t0);
+    _latency_parse_measured = true;
+}
 
-    // Remove last character
-    response[strlen(response)-1] = '\0';
+// Add the last request measured phases timings to the API method histograms
+// Note: Connection phases are accounted to the first request sent after the connection
+void uTLGBot::latency_record(const char* command, MultiHTTPSClient* client)
+{
+    tlg_latency_stats* stats = &_latency[api_method(command)];
+    const http_timings* timings = client->get_timings();
 
-    // Check and remove response header (just keep response body)
-    pos = cstr_get_substr_pos_end(response, strlen(response), "\r\n\r\n", strlen("\r\n\r\n"));
-    if(pos == -1)
+    for(uint8_t phase = 0; phase < HTTP_NUM_PHASES; phase++)
     {
-        // Clear response if unexpected response
-        _println("[Bot] Unexpected response.");
-        _println(response);
-        memset(response, '\0', response_len);
-        return false;
+        if(timings->measured & (1 << phase))
+            latency_histogram_add(&stats->phase[phase], timings->phase_us[phase]);
     }
-    response = response + pos;
+    if(_latency_parse_measured)
+        latency_histogram_add(&stats->phase[LATENCY_PHASE_PARSE], _latency_parse_us);
 
-    // Check for and get request "ok" response key
-    // Note: We are assumming "ok" attribute comes before "response" attribute
-    pos = cstr_get_substr_pos_end(response, strlen(response), "\"ok\":", strlen("\"ok\":"));
-    if(pos == -1)
+    client->clear_timings();
+    _latency_parse_us = 0;
+    _latency_parse_measured = false;
+}
+
+#endif
+
+/**************************************************************************************************/
+
+/* Telegram API Requests and Responses Data */
+
+// Create sendMessage HTTP Body request data with the next part of the text that fits in it
+// Note: Text field is the last one, so the text part can take all the space that remains
+bool uTLGBot::create_msg_body(char* body, const size_t body_max_size, const char* chat_id,
+    uTLGBotTextSplitter* text, const char* parse_mode, bool disable_web_page_preview,
+    bool disable_notification, uint64_t reply_to_message_id, const tlg_markup* reply_markup)
+{
+    uTLGBotBodyWriter writer(body, body_max_size);
+    size_t text_max_size;
+
+    // Create HTTP Body request data
+    writer.append("{\"chat_id\":");
+    writer.append(chat_id);
+    // If parse_mode is not empty
+    if(parse_mode[0] != '\0')
     {
-        // Clear response if unexpected response
-        _println("[Bot] Unexpected response.");
-        _println(response);
-        memset(response, '\0', response_len);
+        // If parse mode has an expected value
+        if(uTLGBotTextSplitter::parse_mode_id(parse_mode) != SPLIT_MODE_PLAIN)
+        {
+            writer.append(",\"parse_mode\":\"");
+            writer.append(parse_mode);
+            writer.append("\"");
+        }
+        else
+            _println("[Bot] Warning: Invalid parse_mode provided.");
+    }
+    // Append disable_web_page_preview value if true
+    if(disable_web_page_preview)
+        writer.append(",\"disable_web_page_preview\":true");
+    // Append disable_notification value if true
+    if(disable_notification)
+        writer.append(",\"disable_notification\":true");
+    // Append reply_to_message_id value if set (just to the first message)
+    if((reply_to_message_id != 0) && (text->num_parts() == 0))
+        writer.append_format(",\"reply_to_message_id\":%" PRIu64, reply_to_message_id);
+
+    // Get next text part that fits with the remaining fields (reply_markup space is reserved
+    // even if it is just appended to the last part)
+    text_max_size = strlen(",\"text\":\"\"}");
+    if(reply_markup != NULL)
+        text_max_size = text_max_size + strlen(",\"reply_markup\":") + reply_markup->length;
+    if(writer.available() <= text_max_size)
         return false;
+    text_max_size = writer.available() - text_max_size;
+    if(!text->next(text_max_size))
+        return false;
+
+    // Append reply_markup if it is set (just to the last message)
+    if((reply_markup != NULL) && text->is_last())
+    {
+        writer.append(",\"reply_markup\":");
+        write_markup(&writer, reply_markup);
     }
-    response = response + pos;
+    writer.append(",\"text\":\"");
+    text->write(&writer);
+    writer.append("\"}");
 
-    // Check if request "ok" response value is "true"
-    if(strncmp(response, "true", strlen("true")) != 0)
+    return !writer.overflow();
+}
+
+// Write a reply_markup into a request body
+void uTLGBot::write_markup(uTLGBotBodyWriter* writer, const tlg_markup* markup)
+{
+    if(markup->builder != NULL)
     {
-        // Clear response due bad request response ("ok" != true)
-        _println("[Bot] Bad request.");
-        _println(response);
-        memset(response, '\0', response_len);
-        return false;
+        uTLGBotKeyboard keyboard(writer, markup->keyboard_type);
+        markup->builder(&keyboard, markup->user_data);
+        keyboard.end();
     }
+    else if(markup->keyboard != NULL)
+    {
+        writer->append("{\"keyboard\":");
+        writer->append(markup->keyboard);
+        writer->append("}");
+    }
+    else
+        writer->append(markup->json);
+}
 
-    // Remove root json response and just keep "result" attribute json value in response buffer
-    // i.e. for response: {"ok":true,"result":{"id":123456789,"first_name":"esp8266_Bot"}}
-    // just keep: {"id":123456789,"first_name":"esp8266_Bot"}
-    pos = cstr_get_substr_pos_end(response, strlen(response), "\"result\":", strlen("\"result\":"));
-    if(pos == -1)
+// Create editMessageText HTTP Body request data
+bool uTLGBot::create_edit_msg_body(char* body, const size_t body_max_size, const char* chat_id,
+    const uint64_t message_id, const char* text, const char* parse_mode,
+    const char* reply_markup)
+{
+    uTLGBotBodyWriter writer(body, body_max_size);
+
+    writer.append_format("{\"chat_id\":%s, \"message_id\":%" PRIu64 ", \"text\":\"", chat_id,
+        message_id);
+    writer.append_json(text);
+    writer.append("\"");
+    if(parse_mode[0] != '\0')
     {
-        // Clear response if unexpected response
-        _println("[Bot] Unexpected response.");
-        _println(response);
-        memset(response, '\0', response_len);
-        return false;
+        if(uTLGBotTextSplitter::parse_mode_id(parse_mode) != SPLIT_MODE_PLAIN)
+            writer.append_format(",\"parse_mode\":\"%s\"", parse_mode);
+        else
+            _println("[Bot] Warning: Invalid parse_mode provided.");
     }
-    response = response + pos;
+    if(reply_markup[0] != '\0')
+    {
+        writer.append(",\"reply_markup\":");
+        writer.append(reply_markup);
+    }
+    writer.append("}");
+
+    return !writer.overflow();
+}
+
+// Create answerCallbackQuery HTTP Body request data
+bool uTLGBot::create_answer_callback_body(char* body, const size_t body_max_size,
+    const char* callback_query_id, const char* text, const bool show_alert)
+{
+    uTLGBotBodyWriter writer(body, body_max_size);
 
-    // Move each byte to initial response address positions
-    i = 0;
-    while(i < strlen(response))
+    writer.append("{\"callback_query_id\":\"");
+    writer.append_json(callback_query_id);
+    writer.append("\"");
+    if(text[0] != '\0')
     {
-        response_init_pos[i] = response[i];
-        i = i + 1;
+        writer.append(",\"text\":\"");
+        writer.append_json(text);
+        writer.append("\"");
     }
-    response_init_pos[i] = '\0';
+    if(show_alert)
+        writer.append(",\"show_alert\":true");
+    writer.append("}");
 
-    return true;
+    return !writer.overflow();
 }
 
-// Make and send a HTTP GET request
-uint8_t uTLGBot::tlg_post(const char* command, char* request_response, const size_t request_len,
-    const size_t request_response_max_size, const unsigned long response_timeout)
+// Create sendChatAction HTTP Body request data
+bool uTLGBot::create_chat_action_body(char* body, const size_t body_max_size,
+    const char* chat_id, const char* action)
+{
+    uTLGBotBodyWriter writer(body, body_max_size);
+
+    writer.append("{\"chat_id\":\"");
+    writer.append_json(chat_id);
+    writer.append("\",\"action\":\"");
+    writer.append_json(action);
+    writer.append("\"}");
+
+    return !writer.overflow();
+}
+
+// Create getUpdates HTTP Body request data (Note that we limit messages to 1 and just allow the
+// updates types set by set_allowed_updates())
+void uTLGBot::create_getupdates_body(char* body, const size_t body_max_size)
+{
+    snprintf(body, body_max_size, "{\"offset\":%" PRIu64 ", \"limit\":1, " \
+        "\"timeout\":%" PRIu8 ", \"allowed_updates\":%s}", _last_received_msg,
+        _long_poll_timeout, _allowed_updates);
+}
+
+// Check a received HTTP response and just keep the "result" json value in the response buffer
+uint8_t uTLGBot::tlg_parse_response(char* request_response, const size_t request_response_max_size)
 {
     char* response_init_pos = request_response;
-    char uri[HTTP_MAX_URI_LENGTH];
+    size_t length = strlen(request_response);
     int32_t pos = 0;
-    uint32_t i = 0;
 
-    // Create URI and send POST request
-    snprintf(uri, HTTP_MAX_URI_LENGTH, "%s/%s", _tlg_api, command);
-    if(_client.post(uri, TELEGRAM_HOST, request_response, request_len,
-        request_response_max_size, response_timeout) > 0)
+    // Remove last character
+    if(length > 0)
     {
-        return false;
+        length = length - 1;
+        request_response[length] = '\0';
     }
 
-    // Remove last character
-    request_response[strlen(request_response)-1] = '\0';
-
     // Check and remove response header (just keep response body)
-    pos = cstr_get_substr_pos_end(request_response, strlen(request_response), "\r\n\r\n",
-        strlen("\r\n\r\n"));
+    pos = cstr_get_substr_pos_end(request_response, length, "\r\n\r\n", strlen("\r\n\r\n"));
     if(pos == -1)
     {
         // Clear response if unexpected response
         _println("[Bot] Unexpected response.");
-        _println(request_response);
-        memset(request_response, '\0', request_response_max_size);
+        _log(HTTP_LOG_WARNING, request_response);
+        _metrics_result(METRICS_RESULT_BAD_RESPONSE);
+        _metrics_add(METRICS_PARSE_FAILURES);
+        memset(response_init_pos, '\0', request_response_max_size);
         return false;
     }
     request_response = request_response + pos;
+    length = length - pos;
 
     // Check for and get request "ok" response key
     // Note: We are assumming "ok" attribute comes before "response" attribute
-    pos = cstr_get_substr_pos_end(request_response, strlen(request_response), "\"ok\":",
-        strlen("\"ok\":"));
+    pos = cstr_get_substr_pos_end(request_response, length, "\"ok\":", strlen("\"ok\":"));
     if(pos == -1)
     {
         // Clear response if unexpected response
         _println("[Bot] Unexpected response.");
-        _println(request_response);
-        memset(request_response, '\0', request_response_max_size);
+        _log(HTTP_LOG_WARNING, request_response);
+        _metrics_result(METRICS_RESULT_BAD_RESPONSE);
+        _metrics_add(METRICS_PARSE_FAILURES);
+        memset(response_init_pos, '\0', request_response_max_size);
         return false;
     }
     request_response = request_response + pos;
+    length = length - pos;
 
     // Check if request "ok" response value is "true"
     if(strncmp(request_response, "true", strlen("true")) != 0)
     {
         // Clear response due bad request response ("ok" != true)
         _println("[Bot] Bad request.");
-        _println(request_response);
-        memset(request_response, '\0', request_response_max_size);
+        _log(HTTP_LOG_WARNING, request_response);
+        _metrics_result((metrics_http_status(response_init_pos) == 429) ?
+            METRICS_RESULT_RATE_LIMITED : METRICS_RESULT_API_ERROR);
+
+        // Get error code and flood control wait time (i.e. {"ok":false,"error_code":429,
+        // "description":"...","parameters":{"retry_after":5}})
+        pos = cstr_get_substr_pos_end(request_response, length,
+            "\"error_code\":", strlen("\"error_code\":"));
+        if(pos != -1)
+            _last_error_code = (uint16_t)strtoul(request_response + pos, NULL, 10);
+        pos = cstr_get_substr_pos_end(request_response, length,
+            "\"retry_after\":", strlen("\"retry_after\":"));
+        if(pos != -1)
+            _retry_after = (uint32_t)strtoul(request_response + pos, NULL, 10);
+        memset(response_init_pos, '\0', request_response_max_size);
         return false;
     }
 
     // Remove root json response and just keep "result" attribute json value in response buffer
-    // i.e. for response: {"ok":true,"result":[{"id":123456789,"first_name":"esp8266_Bot"}]}
-    // just keep: [{"id":123456789,"first_name":"esp8266_Bot"}]
-    pos = cstr_get_substr_pos_end(request_response, strlen(request_response), "\"result\":",
-        strlen("\"result\":"));
+    // i.e. for response: {"ok":true,"result":{"id":123456789,"first_name":"esp8266_Bot"}}
+    // just keep: {"id":123456789,"first_name":"esp8266_Bot"}
+    pos = cstr_get_substr_pos_end(request_response, length, "\"result\":", strlen("\"result\":"));
     if(pos == -1)
     {
         // Clear response if unexpected response
         _println("[Bot] Unexpected response.");
-        _println(request_response);
-        memset(request_response, '\0', request_response_max_size);
+        _log(HTTP_LOG_WARNING, request_response);
+        _metrics_result(METRICS_RESULT_BAD_RESPONSE);
+        _metrics_add(METRICS_PARSE_FAILURES);
+        memset(response_init_pos, '\0', request_response_max_size);
         return false;
     }
     request_response = request_response + pos;
+    length = length - pos;
+
+    // Move the value (and its NUL terminator) to initial response address position at once
+    memmove(response_init_pos, request_response, length + 1);
+    _metrics_result(METRICS_RESULT_OK);
+
+    return true;
+}
+
+// Parse a received getUpdates "result" and get the update data (return number of updates)
+// Note: Just the fields selected by set_update_fields() are extracted, each one directly from the
+// update JSON elements (no values copies nor sub-objects parses)
+uint8_t uTLGBot::parse_update(char* response, tlg_type_message* msg)
+{
+    // Use a pointer to received buffer data
+    char* ptr_response = response;
+
+    // Remove any EOL character
+    cstr_rm_char(ptr_response, strlen(ptr_response), '\r');
+    cstr_rm_char(ptr_response, strlen(ptr_response), '\n');
 
-    // Move each byte to initial response address positions
-    i = 0;
-    while(i < strlen(request_response))
+    // Remove start and end list characters ('[' and ']') from response and just keep json structure
+    if(strlen(ptr_response) >= 2)
     {
-        response_init_pos[i] = request_response[i];
-        i = i + 1;
-        _yield();
+        if(ptr_response[strlen(ptr_response)-1] == ']')
+            ptr_response[strlen(ptr_response)-1] = '\0';
+        if(ptr_response[0] == '[')
+            ptr_response[0] = '\0';
+        ptr_response = ptr_response + 1;
+    }
+
+    // Check if response is empty (there is no message)
+    if(ptr_response[0] == '\0')
+    {
+        _println("[Bot] There is not new message.");
+        return 0;
+    }
+
+#if UTLGBOT_DEDUP_WINDOW > 0
+    // Drop an already received update before parsing it (server "update_id" is the first key of
+    // an update object, so its value is got without any JSON parse)
+    int32_t pos = cstr_get_substr_pos_end(ptr_response, strlen(ptr_response), "\"update_id\":",
+        strlen("\"update_id\":"));
+    if(pos != -1)
+    {
+        uint64_t update_id = strtoull(ptr_response + pos, NULL, 10);
+        if(!dedup_update(update_id))
+        {
+            _println("[Bot] Duplicated update dropped.");
+            _metrics_add(METRICS_SKIPPED_UPDATES);
+            if((_last_received_msg == UINT64_MAX) || (update_id >= _last_received_msg))
+                _last_received_msg = update_id + 1;
+            return 0;
+        }
+    }
+#endif
+
+    // A new message received, so lets clear all message data
+    clear_msg_data(msg);
+
+    /**********************************************************************************************/
+
+    /* Response JSON Parse */
+
+    uint32_t num_elements;
+    uint32_t key_position, update, message;
+    char number[MAX_ID_LENGTH];
+
+    // Clear json elements objects
+    memset(_json_elements, 0, (sizeof(jsmntok_t)*MAX_JSON_ELEMENTS));
+
+    // Parse message string as JSON and get each element (all fields are got from these elements,
+    // no other parse is done)
+    num_elements = json_parse_str(ptr_response, strlen(ptr_response), _json_elements,
+        MAX_JSON_ELEMENTS);
+    if(num_elements == 0)
+    {
+        _println("[Bot] Error: Bad JSON sintax from received response.");
+        _metrics_add(METRICS_PARSE_FAILURES);
+        _metrics_add(METRICS_SKIPPED_UPDATES);
+
+        // Ignore this message that can't be readed and increase counter to ask for the next one
+        _last_received_msg = _last_received_msg + 1;
+        return 0;
+    }
+
+    // Check and get value of key: update_id (and prepare next update request offset, an older
+    // update received out of order doesn't move it back)
+    if(json_get_child_string(ptr_response, _json_elements, num_elements, 0, "update_id", number,
+        MAX_ID_LENGTH))
+    {
+        uint64_t update_id = strtoull(number, NULL, 10);
+        if((_last_received_msg == UINT64_MAX) || (update_id >= _last_received_msg))
+            _last_received_msg = update_id + 1;
+    }
+
+    // Get the update type and its object (first update key that is a known update type)
+    update = 0;
+    for(uint8_t type = 0; type < UPDATE_NUM_TYPES; type++)
+    {
+        update = json_get_child_object(ptr_response, _json_elements, num_elements, 0,
+            UPDATE_TYPES_NAMES[type]);
+        if(update != 0)
+        {
+            msg->update_type = (uint16_t)(1 << type);
+            break;
+        }
+    }
+    if(update == 0)
+    {
+        _println("[Bot] Unknown update type received.");
+        _metrics_add(METRICS_SKIPPED_UPDATES);
+        return 0;
+    }
+
+    // Get the message of the update (for callback queries, the message that holds the pressed
+    // button, if it was not sent in inline mode)
+    message = 0;
+    if(msg->update_type & UPDATE_MESSAGE_TYPES)
+        message = update;
+    else if(msg->update_type == UPDATE_CALLBACK_QUERY)
+    {
+        message = json_get_child_object(ptr_response, _json_elements, num_elements, update,
+            "message");
     }
-    response_init_pos[i] = '\0';
 
+    // Message ID
+    if((message != 0) && (_update_fields & UPDATE_FIELD_MESSAGE_ID))
+    {
+        if(json_get_child_string(ptr_response, _json_elements, num_elements, message,
+            "message_id", number, MAX_ID_LENGTH))
+        {
+            msg->message_id = strtoll(number, NULL, 10);
+        }
+    }
+
+    // Date (of the message, or of the update for chat members updates)
+    if(_update_fields & UPDATE_FIELD_DATE)
+    {
+        if(json_get_child_string(ptr_response, _json_elements, num_elements,
+            (message != 0) ? message : update, "date", number, MAX_ID_LENGTH))
+        {
+            msg->date = (uint32_t)strtoul(number, NULL, 10);
+        }
+    }
+
+    // Text (message text or media caption, or inline query text)
+    // Note: The text of the message that holds a pressed button is not a received text
+    if(_update_fields & UPDATE_FIELD_TEXT)
+    {
+        if(msg->update_type & UPDATE_MESSAGE_TYPES)
+        {
+            if(!json_get_child_string(ptr_response, _json_elements, num_elements, message,
+                "text", msg->text, MAX_TEXT_LENGTH))
+            {
+                json_get_child_string(ptr_response, _json_elements, num_elements, message,
+                    "caption", msg->text, MAX_TEXT_LENGTH);
+            }
+        }
+        else if(msg->update_type & (UPDATE_INLINE_QUERY | UPDATE_CHOSEN_INLINE_RESULT))
+        {
+            json_get_child_string(ptr_response, _json_elements, num_elements, update, "query",
+                msg->text, MAX_TEXT_LENGTH);
+        }
+    }
+
+    // From (the user that sent the message, pressed the button, or changed the chat member)
+    key_position = json_get_child_object(ptr_response, _json_elements, num_elements, update,
+        "from");
+    if(key_position != 0)
+        parse_user(ptr_response, num_elements, key_position, &msg->from);
+
+    // Chat (of the message, or of the update for chat members updates)
+    key_position = json_get_child_object(ptr_response, _json_elements, num_elements,
+        (message != 0) ? message : update, "chat");
+    if(key_position != 0)
+        parse_chat(ptr_response, num_elements, key_position, &msg->chat);
+
+    // Callback query (ID is always got if it is going to be auto-answered)
+    if(msg->update_type == UPDATE_CALLBACK_QUERY)
+    {
+        if((_update_fields & UPDATE_FIELD_QUERY) || _callback_auto_answer)
+        {
+            json_get_child_string(ptr_response, _json_elements, num_elements, update, "id",
+                msg->callback_query.id, MAX_CALLBACK_QUERY_ID_LENGTH);
+        }
+        if(_update_fields & UPDATE_FIELD_QUERY)
+        {
+            json_get_child_string(ptr_response, _json_elements, num_elements, update, "data",
+                msg->callback_query.data, MAX_CALLBACK_DATA_LENGTH);
+        }
+    }
+
+    // Inline query (for chosen inline results, the ID of the chosen result)
+    if((msg->update_type & (UPDATE_INLINE_QUERY | UPDATE_CHOSEN_INLINE_RESULT)) &&
+       (_update_fields & UPDATE_FIELD_QUERY))
+    {
+        json_get_child_string(ptr_response, _json_elements, num_elements, update,
+            (msg->update_type == UPDATE_INLINE_QUERY) ? "id" : "result_id",
+            msg->inline_query.id, MAX_CALLBACK_QUERY_ID_LENGTH);
+        json_get_child_string(ptr_response, _json_elements, num_elements, update, "offset",
+            msg->inline_query.offset, MAX_INLINE_QUERY_OFFSET_LENGTH);
+    }
+
+    // Chat member old and new status
+    if((msg->update_type & (UPDATE_MY_CHAT_MEMBER | UPDATE_CHAT_MEMBER)) &&
+       (_update_fields & UPDATE_FIELD_MEMBER_STATUS))
+    {
+        key_position = json_get_child_object(ptr_response, _json_elements, num_elements, update,
+            "old_chat_member");
+        if(key_position != 0)
+        {
+            json_get_child_string(ptr_response, _json_elements, num_elements, key_position,
+                "status", msg->chat_member.old_status, MAX_MEMBER_STATUS_LENGTH);
+        }
+        key_position = json_get_child_object(ptr_response, _json_elements, num_elements, update,
+            "new_chat_member");
+        if(key_position != 0)
+        {
+            json_get_child_string(ptr_response, _json_elements, num_elements, key_position,
+                "status", msg->chat_member.new_status, MAX_MEMBER_STATUS_LENGTH);
+        }
+    }
+
+    return 1;
+}
+
+#if UTLGBOT_DEDUP_WINDOW > 0
+
+// Check and mark an update ID in the sliding bitmap of latest UTLGBOT_DEDUP_WINDOW update IDs,
+// return false if it was already received (or it is older than the window)
+bool uTLGBot::dedup_update(const uint64_t update_id)
+{
+    uint64_t id;
+    uint32_t bit;
+
+    // First received update
+    if(!_dedup_started)
+    {
+        _dedup_started = true;
+        _dedup_max = update_id;
+        memset(_dedup_bitmap, 0, sizeof(_dedup_bitmap));
+        bit = (uint32_t)(update_id & (UTLGBOT_DEDUP_WINDOW - 1));
+        _dedup_bitmap[bit >> 3] |= (uint8_t)(1 << (bit & 7));
+        return true;
+    }
+
+    // Newer update, slide the window clearing the bits of the skipped IDs
+    if(update_id > _dedup_max)
+    {
+        if((update_id - _dedup_max) >= UTLGBOT_DEDUP_WINDOW)
+            memset(_dedup_bitmap, 0, sizeof(_dedup_bitmap));
+        else
+        {
+            for(id = _dedup_max + 1; id < update_id; id++)
+            {
+                bit = (uint32_t)(id & (UTLGBOT_DEDUP_WINDOW - 1));
+                _dedup_bitmap[bit >> 3] &= (uint8_t)~(1 << (bit & 7));
+            }
+        }
+        _dedup_max = update_id;
+        bit = (uint32_t)(update_id & (UTLGBOT_DEDUP_WINDOW - 1));
+        _dedup_bitmap[bit >> 3] |= (uint8_t)(1 << (bit & 7));
+        return true;
+    }
+
+    // Older update, drop it if it is out of the window or it was received
+    if((_dedup_max - update_id) >= UTLGBOT_DEDUP_WINDOW)
+        return false;
+    bit = (uint32_t)(update_id & (UTLGBOT_DEDUP_WINDOW - 1));
+    if(_dedup_bitmap[bit >> 3] & (1 << (bit & 7)))
+        return false;
+    _dedup_bitmap[bit >> 3] |= (uint8_t)(1 << (bit & 7));
     return true;
 }
 
+#endif
+
+// Get the selected fields of an update user object (object element index)
+void uTLGBot::parse_user(const char* json_str, const uint32_t num_elements,
+    const uint32_t object, tlg_type_user* user)
+{
+    char value[JSON_BOOL_STR_LENGTH];
+
+    if(_update_fields & UPDATE_FIELD_FROM_ID)
+    {
+        json_get_child_string(json_str, _json_elements, num_elements, object, "id", user->id,
+            MAX_ID_LENGTH);
+    }
+    if(_update_fields & UPDATE_FIELD_FROM_NAME)
+    {
+        if(json_get_child_string(json_str, _json_elements, num_elements, object, "is_bot",
+            value, JSON_BOOL_STR_LENGTH))
+        {
+            user->is_bot = (strcmp(value, "true") == 0);
+        }
+        json_get_child_string(json_str, _json_elements, num_elements, object, "first_name",
+            user->first_name, MAX_USER_LENGTH);
+        json_get_child_string(json_str, _json_elements, num_elements, object, "last_name",
+            user->last_name, MAX_USER_LENGTH);
+        json_get_child_string(json_str, _json_elements, num_elements, object, "username",
+            user->username, MAX_USERNAME_LENGTH);
+    }
+    if(_update_fields & UPDATE_FIELD_FROM_LANGUAGE)
+    {
+        json_get_child_string(json_str, _json_elements, num_elements, object, "language_code",
+            user->language_code, MAX_LANGUAGE_CODE_LENGTH);
+    }
+}
+
+// Get the selected fields of an update chat object (object element index)
+void uTLGBot::parse_chat(const char* json_str, const uint32_t num_elements,
+    const uint32_t object, tlg_type_chat* chat)
+{
+    char value[JSON_BOOL_STR_LENGTH];
+
+    if(_update_fields & UPDATE_FIELD_CHAT_ID)
+    {
+        json_get_child_string(json_str, _json_elements, num_elements, object, "id", chat->id,
+            MAX_ID_LENGTH);
+    }
+    if(_update_fields & UPDATE_FIELD_CHAT_INFO)
+    {
+        json_get_child_string(json_str, _json_elements, num_elements, object, "type",
+            chat->type, MAX_CHAT_TYPE_LENGTH);
+        json_get_child_string(json_str, _json_elements, num_elements, object, "title",
+            chat->title, MAX_CHAT_TITLE_LENGTH);
+        json_get_child_string(json_str, _json_elements, num_elements, object, "username",
+            chat->username, MAX_USERNAME_LENGTH);
+        json_get_child_string(json_str, _json_elements, num_elements, object, "first_name",
+            chat->first_name, MAX_USER_LENGTH);
+        json_get_child_string(json_str, _json_elements, num_elements, object, "last_name",
+            chat->last_name, MAX_USER_LENGTH);
+        if(json_get_child_string(json_str, _json_elements, num_elements, object,
+            "all_members_are_administrators", value, JSON_BOOL_STR_LENGTH))
+        {
+            chat->all_members_are_administrators = (strcmp(value, "true") == 0);
+        }
+    }
+}
+
 /**************************************************************************************************/
 
 /* Private Auxiliar Methods */
 
 // Clear and set all received message data to default values
-void uTLGBot::clear_msg_data(void)
-{
-    received_msg.message_id = 0;
-    received_msg.date = 0;
-    received_msg.text[0] = '\0';
-    received_msg.from.id[0] = '\0';
-    received_msg.from.is_bot = false;
-    received_msg.from.first_name[0] = '\0';
-    received_msg.from.last_name[0] = '\0';
-    received_msg.from.username[0] = '\0';
-    received_msg.from.language_code[0] = '\0';
-    received_msg.chat.id[0] = '\0';
-    received_msg.chat.type[0] = '\0';
-    received_msg.chat.title[0] = '\0';
-    received_msg.chat.username[0] = '\0';
-    received_msg.chat.first_name[0] ='\0';
-    received_msg.chat.last_name[0] = '\0';
-    received_msg.chat.all_members_are_administrators = false;
+void uTLGBot::clear_msg_data(tlg_type_message* msg)
+{
+    msg->update_type = 0;
+    msg->message_id = 0;
+    msg->date = 0;
+    msg->text[0] = '\0';
+    msg->from.id[0] = '\0';
+    msg->from.is_bot = false;
+    msg->from.first_name[0] = '\0';
+    msg->from.last_name[0] = '\0';
+    msg->from.username[0] = '\0';
+    msg->from.language_code[0] = '\0';
+    msg->chat.id[0] = '\0';
+    msg->chat.type[0] = '\0';
+    msg->chat.title[0] = '\0';
+    msg->chat.username[0] = '\0';
+    msg->chat.first_name[0] ='\0';
+    msg->chat.last_name[0] = '\0';
+    msg->chat.all_members_are_administrators = false;
+    msg->callback_query.id[0] = '\0';
+    msg->callback_query.data[0] = '\0';
+    msg->callback_query.answered = false;
+    msg->inline_query.id[0] = '\0';
+    msg->inline_query.offset[0] = '\0';
+    msg->chat_member.old_status[0] = '\0';
+    msg->chat_member.new_status[0] = '\0';
 }
 
 // Send message fail to be created
@@ -1003,6 +1567,68 @@ uint32_t uTLGBot::json_has_key(const char* json_str, jsmntok_t* json_tokens,
     return 0;
 }
 
+// Check if given json object element (index of the object token) contains the provided key as a
+// direct child (keys of nested objects are skipped), and return the key element index (or 0)
+uint32_t uTLGBot::json_has_child_key(const char* json_str, jsmntok_t* json_tokens,
+    const uint32_t num_tokens, const uint32_t object, const char* key)
+{
+    uint32_t i, value;
+
+    if((object >= num_tokens) || (json_tokens[object].type != JSMN_OBJECT))
+        return 0;
+
+    i = object + 1;
+    while(((i + 1) < num_tokens) && (json_tokens[i].start < json_tokens[object].end))
+    {
+        // Check if key and json element string are the same
+        if((json_tokens[i].type == JSMN_STRING) &&
+           (strlen(key) == (unsigned int)(json_tokens[i].end-json_tokens[i].start)) &&
+           (strncmp(json_str + json_tokens[i].start, key,
+            json_tokens[i].end - json_tokens[i].start) == 0))
+        {
+            return i;
+        }
+
+        // Skip the key value and all its nested elements (elements are in document order)
+        value = i + 1;
+        i = value + 1;
+        while((i < num_tokens) && (json_tokens[i].start < json_tokens[value].end))
+            i = i + 1;
+
+        _yield();
+    }
+    return 0;
+}
+
+// Get the element index of the object value of a direct child key of given json object (or 0)
+uint32_t uTLGBot::json_get_child_object(const char* json_str, jsmntok_t* json_tokens,
+    const uint32_t num_tokens, const uint32_t object, const char* key)
+{
+    uint32_t key_position;
+
+    key_position = json_has_child_key(json_str, json_tokens, num_tokens, object, key);
+    if((key_position == 0) || (json_tokens[key_position+1].type != JSMN_OBJECT))
+        return 0;
+    return key_position + 1;
+}
+
+// Get the string value of a direct child key of given json object (it is truncated to fit in the
+// provided string, and always null terminated)
+bool uTLGBot::json_get_child_string(const char* json_str, jsmntok_t* json_tokens,
+    const uint32_t num_tokens, const uint32_t object, const char* key, char* converted_str,
+    const uint32_t converted_str_size)
+{
+    uint32_t key_position;
+
+    key_position = json_has_child_key(json_str, json_tokens, num_tokens, object, key);
+    if(key_position == 0)
+        return false;
+    json_get_element_string(json_str, &json_tokens[key_position+1], converted_str,
+        converted_str_size - 1);
+    converted_str[converted_str_size-1] = '\0';
+    return true;
+}
+
 // Get the corresponding string of given json element (token)
 void uTLGBot::json_get_element_string(const char* json_str, jsmntok_t* token, char* converted_str,
     const uint32_t converted_str_len)
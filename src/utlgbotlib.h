@@ -49,21 +49,31 @@
 
 #include <inttypes.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include "utility/multihttpsclient/multihttpsclient.h"
 #include "utility/jsmn/jsmn.h"
+#include "utlgbotrouter.h"
+#include "utlgbotlatency.h"
+#include "utlgbotsplit.h"
+#include "utlgbotkeyboard.h"
+#include "utlgbotcerts.h"
 
 /**************************************************************************************************/
 
 /* Constants */
 
-// Telegram HTTPS Server Port
-#define HTTPS_PORT 443
+// Telegram HTTPS Server Port (can be overridden at build time, i.e. to use a local test server)
+#ifndef HTTPS_PORT
+    #define HTTPS_PORT 443
+#endif
 
 // Telegram Server address and address lenght
 #define TELEGRAM_SERVER "https://api.telegram.org"
-#define TELEGRAM_HOST "api.telegram.org"
+#ifndef TELEGRAM_HOST
+    #define TELEGRAM_HOST "api.telegram.org"
+#endif
 #define TELEGRAM_SERVER_LENGTH 28
 
 // Bot token max lenght (Note: Actual token lenght is 46, but it seems was increased in the past,
@@ -87,6 +97,10 @@
 #define MAX_URL_LENGTH 64
 #define MAX_STICKER_NAME 32
 #define MAX_TEXT_LENGTH 4097 // Yes, it is 4097 instead 4096 (telegram big brain)
+#define MAX_CALLBACK_QUERY_ID_LENGTH 32
+#define MAX_CALLBACK_DATA_LENGTH 65 // 1-64 bytes
+#define MAX_INLINE_QUERY_OFFSET_LENGTH 65
+#define MAX_MEMBER_STATUS_LENGTH 16
 
 // Memory usage level apply
 #undef MAX_TEXT_LENGTH
@@ -117,15 +131,30 @@
 #define HTTP_MAX_URI_LENGTH 128
 #define HTTP_MAX_RES_LENGTH MAX_TEXT_LENGTH + 1024
 
-// JSON Max values length
-#define MAX_JSON_STR_LEN MAX_TEXT_LENGTH
-#define MAX_JSON_SUBVAL_STR_LEN 512
-#define MAX_JSON_ELEMENTS 64
-#define MAX_JSON_SUBELEMENTS 32
+// JSON Max number of elements of a response
+// Note: A callback_query update carries the whole message with its inline keyboard, so keep enough
+// tokens for them (each keyboard button takes 5 tokens)
+#ifndef MAX_JSON_ELEMENTS
+    #define MAX_JSON_ELEMENTS 128
+#endif
+
+// Number of latest update IDs tracked to drop redelivered updates (sliding bitmap, a power of two
+// multiple of 8, 0 to disable it)
+#ifndef UTLGBOT_DEDUP_WINDOW
+    #if defined(ARDUINO) || defined(ESP_IDF)
+        #define UTLGBOT_DEDUP_WINDOW 256
+    #else
+        #define UTLGBOT_DEDUP_WINDOW 4096
+    #endif
+#endif
+#if (UTLGBOT_DEDUP_WINDOW & (UTLGBOT_DEDUP_WINDOW - 1)) || (UTLGBOT_DEDUP_WINDOW % 8)
+    #error "UTLGBOT_DEDUP_WINDOW must be a power of two multiple of 8 (or 0)."
+#endif
 
 // Others
-#define MAX_KEYBOARD_MARKUP_LENGTH 128
-#define MAX_TMP_BUFFER_LENGTH MAX_KEYBOARD_MARKUP_LENGTH*2
+// answerCallbackQuery and sendChatAction request and response buffer (preallocated, so a callback
+// can be answered, or a chat action sent, without touching the Bot main buffer)
+#define MAX_CALLBACK_ANSWER_LENGTH 1024
 
 /**************************************************************************************************/
 
@@ -135,6 +164,71 @@
 #define API_CMD_GET_ME "getMe"
 #define API_CMD_SEND_MSG "sendMessage"
 #define API_CMD_GET_UPDATES "getUpdates"
+#define API_CMD_EDIT_MSG_TEXT "editMessageText"
+#define API_CMD_ANSWER_CALLBACK "answerCallbackQuery"
+#define API_CMD_SEND_CHAT_ACTION "sendChatAction"
+
+// Commands indexes for per API method stats (any other command is accounted as "other")
+#define API_METHOD_GET_ME       0
+#define API_METHOD_SEND_MSG     1
+#define API_METHOD_GET_UPDATES  2
+#define API_METHOD_EDIT_MSG     3
+#define API_METHOD_ANSWER_CB    4
+#define API_METHOD_CHAT_ACTION  5
+#define API_METHOD_OTHER        6
+#define API_NUM_METHODS         7
+
+// Chat actions (sendChatAction status shown to the users, it lasts 5 seconds or until the Bot
+// sends a message to the chat)
+#define CHAT_ACTION_TYPING          "typing"
+#define CHAT_ACTION_UPLOAD_PHOTO    "upload_photo"
+#define CHAT_ACTION_RECORD_VIDEO    "record_video"
+#define CHAT_ACTION_UPLOAD_VIDEO    "upload_video"
+#define CHAT_ACTION_RECORD_VOICE    "record_voice"
+#define CHAT_ACTION_UPLOAD_VOICE    "upload_voice"
+#define CHAT_ACTION_UPLOAD_DOCUMENT "upload_document"
+#define CHAT_ACTION_CHOOSE_STICKER  "choose_sticker"
+#define CHAT_ACTION_FIND_LOCATION   "find_location"
+
+/**************************************************************************************************/
+
+/* Telegram Updates Types and Fields */
+
+// Update types (flags to set the updates to receive with set_allowed_updates(), and received
+// update type in tlg_type_message update_type)
+#define UPDATE_MESSAGE              0x0001
+#define UPDATE_EDITED_MESSAGE       0x0002
+#define UPDATE_CHANNEL_POST         0x0004
+#define UPDATE_EDITED_CHANNEL_POST  0x0008
+#define UPDATE_INLINE_QUERY         0x0010
+#define UPDATE_CHOSEN_INLINE_RESULT 0x0020
+#define UPDATE_CALLBACK_QUERY       0x0040
+#define UPDATE_SHIPPING_QUERY       0x0080
+#define UPDATE_PRE_CHECKOUT_QUERY   0x0100
+#define UPDATE_POLL                 0x0200
+#define UPDATE_POLL_ANSWER          0x0400
+#define UPDATE_MY_CHAT_MEMBER       0x0800
+#define UPDATE_CHAT_MEMBER          0x1000
+#define UPDATE_CHAT_JOIN_REQUEST    0x2000
+#define UPDATE_NUM_TYPES            14
+#define DEFAULT_ALLOWED_UPDATES (UPDATE_MESSAGE | UPDATE_CALLBACK_QUERY)
+
+// Update fields (flags to set the fields that are extracted from received updates with
+// set_update_fields(), any other field is left empty)
+#define UPDATE_FIELD_MESSAGE_ID     0x0001
+#define UPDATE_FIELD_DATE           0x0002
+#define UPDATE_FIELD_TEXT           0x0004 // Text, caption or inline query text
+#define UPDATE_FIELD_FROM_ID        0x0008
+#define UPDATE_FIELD_FROM_NAME      0x0010 // is_bot, first_name, last_name and username
+#define UPDATE_FIELD_FROM_LANGUAGE  0x0020
+#define UPDATE_FIELD_CHAT_ID        0x0040
+#define UPDATE_FIELD_CHAT_INFO      0x0080 // type, title, username, names and admins flag
+#define UPDATE_FIELD_QUERY          0x0100 // Callback and inline queries IDs, data and offset
+#define UPDATE_FIELD_MEMBER_STATUS  0x0200
+#define UPDATE_FIELDS_ALL           0xFFFF
+
+// getUpdates "allowed_updates" list max length
+#define MAX_ALLOWED_UPDATES_LENGTH 256
 
 /**************************************************************************************************/
 
@@ -169,14 +263,51 @@ typedef struct tlg_type_chat
     //bool can_set_sticker_set; // Uninplemented
 } tlg_type_chat;
 
+// CallbackQuery: https://core.telegram.org/bots/api#callbackquery
+// Note: Query sender and the message with the pressed button (message_id, chat) are given in the
+// tlg_type_message that holds it
+typedef struct tlg_type_callback_query
+{
+    char id[MAX_CALLBACK_QUERY_ID_LENGTH];
+    char data[MAX_CALLBACK_DATA_LENGTH];
+    bool answered; // Already answered by the Bot (auto-answer)
+    //char inline_message_id[MAX_ID_LENGTH]; // Uninplemented
+    //char chat_instance[MAX_ID_LENGTH]; // Uninplemented
+    //char game_short_name[MAX_STICKER_NAME]; // Uninplemented
+} tlg_type_callback_query;
+
+// InlineQuery: https://core.telegram.org/bots/api#inlinequery
+// Note: Query text is given in the tlg_type_message text, and for chosen_inline_result updates,
+// the ID is the chosen result ID
+typedef struct tlg_type_inline_query
+{
+    char id[MAX_CALLBACK_QUERY_ID_LENGTH];
+    char offset[MAX_INLINE_QUERY_OFFSET_LENGTH];
+} tlg_type_inline_query;
+
+// ChatMemberUpdated: https://core.telegram.org/bots/api#chatmemberupdated
+// Note: Chat, user and date are given in the tlg_type_message that holds it
+typedef struct tlg_type_chat_member_updated
+{
+    char old_status[MAX_MEMBER_STATUS_LENGTH];
+    char new_status[MAX_MEMBER_STATUS_LENGTH];
+} tlg_type_chat_member_updated;
+
 // Message: https://core.telegram.org/bots/api#message
+// Note: It holds any received update, update_type tells which one. For callback_query updates,
+// "from" is the user that pressed the button, and message_id, date and chat are from the message
+// that holds the button
 typedef struct tlg_type_message
 {
+    uint16_t update_type;
     int64_t message_id;
     tlg_type_user from;
     uint32_t date;
     tlg_type_chat chat;
     char text[MAX_TEXT_LENGTH];
+    tlg_type_callback_query callback_query;
+    tlg_type_inline_query inline_query;
+    tlg_type_chat_member_updated chat_member;
     //tlg_type_user forward_from;
     //tlg_type_chat forward_from_chat;
     //int32_t forward_from_message_id;
@@ -187,6 +318,23 @@ typedef struct tlg_type_message
 
 class uTLGBot
 {
+    // Non-blocking coroutines layer reuse Bot requests and responses data handling
+    friend class uTLGBotAsync;
+
+    private:
+        // Private Data Types
+        // Note: Just one of json (a serialized reply_markup), keyboard (reply keyboard rows array)
+        // or builder is set
+        typedef struct tlg_markup
+        {
+            const char* json;
+            const char* keyboard;
+            tlg_keyboard_builder builder;
+            void* user_data;
+            uint8_t keyboard_type;
+            size_t length;
+        } tlg_markup;
+
     public:
         // Public Attributtes
         tlg_type_message received_msg;
@@ -198,6 +346,8 @@ class uTLGBot
         void set_token(const char* token);
         void set_cert(const uint8_t* ca_pem_start, const uint8_t* ca_pem_end=NULL);
         void set_cert(const char* cert_https_server);
+        bool set_cert_der(const uint8_t* ca_der=tlg_api_ca_der,
+            const size_t ca_der_len=tlg_api_ca_der_len);
         void set_polling_timeout(const uint8_t seconds);
         char* get_token();
         uint8_t get_polling_timeout();
@@ -208,27 +358,81 @@ class uTLGBot
         uint8_t sendMessage(const char* chat_id, const char* text, const char* parse_mode="",
             bool disable_web_page_preview=false, bool disable_notification=false,
             uint64_t reply_to_message_id=0, const char* reply_markup="");
+        uint8_t sendEscapedMessage(const char* chat_id, const char* text,
+            const char* parse_mode="", bool disable_web_page_preview=false,
+            bool disable_notification=false, uint64_t reply_to_message_id=0,
+            const char* reply_markup="");
         uint8_t sendReplyKeyboardMarkup(const char* chat_id, const char* text,
             const char* keyboard);
+        uint8_t sendKeyboard(const char* chat_id, const char* text,
+            tlg_keyboard_builder keyboard, void* user_data=NULL,
+            const uint8_t keyboard_type=KEYBOARD_INLINE, const char* parse_mode="");
         uint8_t getUpdates();
+        uint8_t getUpdates(tlg_type_message* msg);
+        uint8_t editMessageText(const char* chat_id, const uint64_t message_id, const char* text,
+            const char* parse_mode="", const char* reply_markup="");
+        uint8_t answerCallbackQuery(const char* callback_query_id, const char* text="",
+            const bool show_alert=false);
+        uint8_t sendChatAction(const char* chat_id, const char* action=CHAT_ACTION_TYPING);
+        void set_callback_auto_answer(const bool enable);
+        void set_allowed_updates(const uint16_t update_types);
+        void set_update_fields(const uint16_t update_fields);
+        uint64_t get_updates_offset();
+        void set_updates_offset(const uint64_t offset);
+        uint16_t get_last_error_code();
+        uint32_t get_retry_after();
+        static uint8_t api_method(const char* command);
+        static const char* api_method_name(const uint8_t method);
+#if defined(UTLGBOT_LATENCY_STATS)
+        bool get_latency_stats(const char* command, tlg_latency_stats* stats);
+        void reset_latency_stats();
+#endif
+        const http_memory_stats* get_memory_stats();
+        void clear_memory_stats();
+#if defined(UTLGBOT_BENCH_ACCESS)
+        // Requests build and responses parse without network, just for the native benchmarks
+        // library build (defined in the benchmarks target)
+        bool bench_create_msg_body(const char* chat_id, const char* text,
+            const char* parse_mode);
+        uint8_t bench_extract_update(const char* response);
+#endif
 
     private:
         // Private Attributtes
         MultiHTTPSClient _client;
         const uint8_t* _tlg_api_ca_pem_start;
         const uint8_t* _tlg_api_ca_pem_end;
+        const uint8_t* _tlg_api_ca_der;
+        size_t _tlg_api_ca_der_len;
         uint8_t _long_poll_timeout;
         char _token[TOKEN_LENGTH];
         char _tlg_api[TELEGRAM_API_LENGTH];
         char _buffer[HTTP_MAX_RES_LENGTH];
         jsmntok_t _json_elements[MAX_JSON_ELEMENTS];
-        jsmntok_t _json_subelements[MAX_JSON_SUBELEMENTS];
-        char _json_value_str[MAX_JSON_STR_LEN];
-        char _json_subvalue_str[MAX_JSON_SUBVAL_STR_LEN];
-        char json_keyboard[MAX_KEYBOARD_MARKUP_LENGTH];
+        char _callback_answer[MAX_CALLBACK_ANSWER_LENGTH];
+        bool _callback_auto_answer;
+        char _allowed_updates[MAX_ALLOWED_UPDATES_LENGTH];
+        uint16_t _update_fields;
+#if UTLGBOT_DEDUP_WINDOW > 0
+        uint8_t _dedup_bitmap[UTLGBOT_DEDUP_WINDOW/8];
+        uint64_t _dedup_max;
+        bool _dedup_started;
+#endif
         uint64_t _last_received_msg;
         bool _dont_keep_connection;
         uint8_t _debug_level;
+        uint16_t _last_error_code;
+        uint32_t _retry_after;
+#if defined(UTLGBOT_LATENCY_STATS)
+        tlg_latency_stats _latency[API_NUM_METHODS];
+        uint32_t _latency_parse_t0;
+        uint32_t _latency_parse_us;
+        bool _latency_parse_measured;
+#endif
+#if defined(UTLGBOT_METRICS)
+        uint8_t _metrics_result;
+        bool _connected_before;
+#endif
 
         // Private Methods
         uint8_t tlg_get(const char* command, char* response, const size_t response_len,
@@ -236,13 +440,50 @@ class uTLGBot
         uint8_t tlg_post(const char* command, char* request_response, const size_t request_len,
             const size_t request_response_max_size,
             const unsigned long response_timeout=HTTP_WAIT_RESPONSE_TIMEOUT);
+        uint8_t tlg_parse_response(char* request_response, const size_t request_response_max_size);
+#if defined(UTLGBOT_LATENCY_STATS)
+        void latency_parse_begin();
+        void latency_parse_end();
+        void latency_record(const char* command, MultiHTTPSClient* client);
+#endif
 
-        void clear_msg_data();
+        uint8_t send_message(const char* chat_id, const char* text, const char* parse_mode,
+            bool disable_web_page_preview, bool disable_notification,
+            uint64_t reply_to_message_id, tlg_markup* reply_markup, const bool escaped);
+        bool create_msg_body(char* body, const size_t body_max_size, const char* chat_id,
+            uTLGBotTextSplitter* text, const char* parse_mode, bool disable_web_page_preview,
+            bool disable_notification, uint64_t reply_to_message_id,
+            const tlg_markup* reply_markup);
+        void write_markup(uTLGBotBodyWriter* writer, const tlg_markup* markup);
+        bool create_edit_msg_body(char* body, const size_t body_max_size, const char* chat_id,
+            const uint64_t message_id, const char* text, const char* parse_mode,
+            const char* reply_markup);
+        bool create_answer_callback_body(char* body, const size_t body_max_size,
+            const char* callback_query_id, const char* text, const bool show_alert);
+        bool create_chat_action_body(char* body, const size_t body_max_size,
+            const char* chat_id, const char* action);
+        void create_getupdates_body(char* body, const size_t body_max_size);
+        uint8_t parse_update(char* response, tlg_type_message* msg);
+#if UTLGBOT_DEDUP_WINDOW > 0
+        bool dedup_update(const uint64_t update_id);
+#endif
+        void parse_user(const char* json_str, const uint32_t num_elements,
+            const uint32_t object, tlg_type_user* user);
+        void parse_chat(const char* json_str, const uint32_t num_elements,
+            const uint32_t object, tlg_type_chat* chat);
+        void clear_msg_data(tlg_type_message* msg);
         void cant_create_send_msg(const char* msg);
         uint32_t json_parse_str(const char* json_str, const size_t json_str_len,
             jsmntok_t* json_tokens, const uint32_t json_tokens_len);
         uint32_t json_has_key(const char* json_str, jsmntok_t* json_tokens,
             const uint32_t num_tokens, const char* key);
+        uint32_t json_has_child_key(const char* json_str, jsmntok_t* json_tokens,
+            const uint32_t num_tokens, const uint32_t object, const char* key);
+        uint32_t json_get_child_object(const char* json_str, jsmntok_t* json_tokens,
+            const uint32_t num_tokens, const uint32_t object, const char* key);
+        bool json_get_child_string(const char* json_str, jsmntok_t* json_tokens,
+            const uint32_t num_tokens, const uint32_t object, const char* key,
+            char* converted_str, const uint32_t converted_str_size);
         void json_get_element_string(const char* json_str, jsmntok_t* token, char* converted_str,
             const uint32_t converted_str_len);
         uint8_t json_get_key_value(const char* key, const char* json_str, jsmntok_t* tokens,
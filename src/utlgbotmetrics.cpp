@@ -0,0 +1,482 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotmetrics.cpp
+// Description: Runtime counters (requests, traffic, connections, parse failures...) and gauges,
+//              rendered in Prometheus text format and served by a tiny local HTTP endpoint in
+//              Native builds (build with UTLGBOT_METRICS, otherwise it is not compiled at all).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "utlgbotmetrics.h"
+
+/**************************************************************************************************/
+
+/* Check Build Configuration (just for UTLGBOT_METRICS builds) */
+
+#if defined(UTLGBOT_METRICS)
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#if !defined(ARDUINO) && !defined(ESP_IDF)
+    #include <atomic>
+    #include <mutex>
+#endif
+
+#if defined(__linux__) && !defined(ARDUINO) && !defined(ESP_IDF)
+    #include <arpa/inet.h>
+    #include <netinet/in.h>
+    #include <poll.h>
+    #include <sys/socket.h>
+    #include <unistd.h>
+#endif
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Endpoint accept loop wake up period to check for stop (ms)
+#define METRICS_SERVER_POLL_PERIOD 200
+
+// Endpoint max request length and receive timeout (ms)
+#define METRICS_MAX_REQUEST_LENGTH 1024
+#define METRICS_REQUEST_TIMEOUT 1000
+
+/**************************************************************************************************/
+
+/* Counters and Results Names */
+
+typedef struct metrics_counter_info
+{
+    const char* name;
+    const char* labels;
+    const char* help;
+} metrics_counter_info;
+
+// Counters info (in METRICS_* counters order, counters with same name must be consecutive)
+static const metrics_counter_info METRICS_COUNTERS_INFO[METRICS_REQUESTS] =
+{
+    { "utlgbot_sent_bytes_total", "", "HTTPS bytes sent (headers and bodies)." },
+    { "utlgbot_received_bytes_total", "", "HTTPS bytes received (headers and bodies)." },
+    { "utlgbot_connections_total", "", "Connections to the Telegram server." },
+    { "utlgbot_reconnections_total", "",
+        "Connections to the Telegram server after a previous one was closed or lost." },
+    { "utlgbot_tls_handshakes_total", "type=\"full\"", "TLS handshakes by type." },
+    { "utlgbot_tls_handshakes_total", "type=\"resumed\"", "TLS handshakes by type." },
+    { "utlgbot_parse_failures_total", "",
+        "Unexpected responses and updates that can't be parsed." },
+    { "utlgbot_skipped_updates_total", "",
+        "Updates skipped (bad JSON syntax, unknown update type or duplicated update)." }
+};
+
+// Requests results names (in METRICS_RESULT_* order)
+static const char* METRICS_RESULTS_NAMES[METRICS_NUM_RESULTS] =
+{
+    "ok", "no_response", "bad_response", "api_error", "rate_limited"
+};
+
+/**************************************************************************************************/
+
+/* Counters Storage */
+
+#if !defined(ARDUINO) && !defined(ESP_IDF)
+
+// Native: each thread has its own counters block (increments are lock-free relaxed stores of its
+// own block), and blocks are just added on snapshot
+typedef struct metrics_block
+{
+    std::atomic<uint64_t> counter[METRICS_NUM_COUNTERS];
+    struct metrics_block* prev;
+    struct metrics_block* next;
+} metrics_block;
+
+// Registered blocks list (lock is just taken on thread first use, thread exit and snapshot)
+static std::mutex metrics_mutex;
+static metrics_block* metrics_blocks = NULL;
+static uint64_t metrics_retired[METRICS_NUM_COUNTERS];
+
+// Thread counters block, registered on thread first use and added to retired counters on exit
+class metrics_thread_block
+{
+    public:
+        metrics_block block;
+
+        metrics_thread_block()
+        {
+            for(uint8_t i = 0; i < METRICS_NUM_COUNTERS; i++)
+                block.counter[i].store(0, std::memory_order_relaxed);
+
+            std::unique_lock<std::mutex> lock(metrics_mutex);
+            block.prev = NULL;
+            block.next = metrics_blocks;
+            if(metrics_blocks != NULL)
+                metrics_blocks->prev = &block;
+            metrics_blocks = &block;
+        }
+
+        ~metrics_thread_block()
+        {
+            std::unique_lock<std::mutex> lock(metrics_mutex);
+            for(uint8_t i = 0; i < METRICS_NUM_COUNTERS; i++)
+            {
+                metrics_retired[i] = metrics_retired[i] +
+                    block.counter[i].load(std::memory_order_relaxed);
+            }
+            if(block.prev != NULL)
+                block.prev->next = block.next;
+            else
+                metrics_blocks = block.next;
+            if(block.next != NULL)
+                block.next->prev = block.prev;
+        }
+};
+
+static metrics_thread_block& metrics_local(void)
+{
+    static thread_local metrics_thread_block local;
+    return local;
+}
+
+#else
+
+// Microcontrollers: a single counters block (increments from different tasks could be lost if
+// they happen at the same time)
+static uint32_t metrics_counters[METRICS_NUM_COUNTERS];
+
+#endif
+
+// Registered gauges (register them before start serving metrics)
+typedef struct metrics_gauge_info
+{
+    const char* name;
+    const char* help;
+    tlg_metrics_gauge gauge;
+    void* user_data;
+} metrics_gauge_info;
+
+static metrics_gauge_info metrics_gauges[METRICS_MAX_GAUGES];
+static uint8_t metrics_num_gauges = 0;
+
+/**************************************************************************************************/
+
+/* Functions */
+
+// Increase a counter of current thread
+void metrics_add(const uint8_t counter, const uint32_t n)
+{
+    if(counter >= METRICS_NUM_COUNTERS)
+        return;
+
+#if !defined(ARDUINO) && !defined(ESP_IDF)
+    std::atomic<uint64_t>& c = metrics_local().block.counter[counter];
+    c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+#else
+    metrics_counters[counter] = metrics_counters[counter] + n;
+#endif
+}
+
+// Account an API request result
+void metrics_request(const char* command, const uint8_t result)
+{
+    if(result >= METRICS_NUM_RESULTS)
+        return;
+    metrics_add(METRICS_REQUESTS + (uTLGBot::api_method(command) * METRICS_NUM_RESULTS) + result,
+        1);
+}
+
+// Move a client traffic counters to current thread counters
+void metrics_record_client(MultiHTTPSClient* client)
+{
+    const http_counters* counters = client->get_counters();
+
+    if(counters->bytes_out != 0)
+        metrics_add(METRICS_BYTES_OUT, counters->bytes_out);
+    if(counters->bytes_in != 0)
+        metrics_add(METRICS_BYTES_IN, counters->bytes_in);
+    if(counters->handshakes_full != 0)
+        metrics_add(METRICS_HANDSHAKES_FULL, counters->handshakes_full);
+    if(counters->handshakes_resumed != 0)
+        metrics_add(METRICS_HANDSHAKES_RESUMED, counters->handshakes_resumed);
+    client->clear_counters();
+}
+
+// Get the status code of a HTTP response (0 if it is not a HTTP response)
+uint16_t metrics_http_status(const char* response)
+{
+    const char* status;
+
+    if(strncmp(response, "HTTP/", strlen("HTTP/")) != 0)
+        return 0;
+    status = strchr(response, ' ');
+    if(status == NULL)
+        return 0;
+    return (uint16_t)strtoul(status + 1, NULL, 10);
+}
+
+// Get a snapshot of all counters (aggregated from all threads)
+void metrics_snapshot(tlg_metrics* metrics)
+{
+#if !defined(ARDUINO) && !defined(ESP_IDF)
+    std::unique_lock<std::mutex> lock(metrics_mutex);
+
+    for(uint8_t i = 0; i < METRICS_NUM_COUNTERS; i++)
+        metrics->counter[i] = metrics_retired[i];
+    for(metrics_block* block = metrics_blocks; block != NULL; block = block->next)
+    {
+        for(uint8_t i = 0; i < METRICS_NUM_COUNTERS; i++)
+        {
+            metrics->counter[i] = metrics->counter[i] +
+                block->counter[i].load(std::memory_order_relaxed);
+        }
+    }
+#else
+    for(uint8_t i = 0; i < METRICS_NUM_COUNTERS; i++)
+        metrics->counter[i] = metrics_counters[i];
+#endif
+}
+
+// Register a gauge (i.e. a queue depth), its getter is called on each render
+// Name must follow Prometheus metric names rules, and it is not copied (use literals)
+bool metrics_add_gauge(const char* name, const char* help, tlg_metrics_gauge gauge,
+    void* user_data)
+{
+    if((gauge == NULL) || (metrics_num_gauges >= METRICS_MAX_GAUGES))
+        return false;
+
+    metrics_gauges[metrics_num_gauges].name = name;
+    metrics_gauges[metrics_num_gauges].help = help;
+    metrics_gauges[metrics_num_gauges].gauge = gauge;
+    metrics_gauges[metrics_num_gauges].user_data = user_data;
+    metrics_num_gauges = metrics_num_gauges + 1;
+
+    return true;
+}
+
+// Append formatted text to a render buffer (just if it fits)
+static bool render_append(char* buffer, const size_t buffer_size, size_t* len,
+    const char* format, ...)
+{
+    va_list args;
+    int n;
+
+    va_start(args, format);
+    n = vsnprintf(buffer + *len, buffer_size - *len, format, args);
+    va_end(args);
+    if((n < 0) || ((size_t)n >= buffer_size - *len))
+    {
+        buffer[*len] = '\0';
+        return false;
+    }
+    *len = *len + n;
+
+    return true;
+}
+
+// Render all counters and gauges in Prometheus text exposition format
+// Returns rendered length (output is truncated at a line end if buffer is not big enough)
+size_t metrics_render(char* buffer, const size_t buffer_size)
+{
+    const metrics_counter_info* info;
+    tlg_metrics metrics;
+    uint8_t i, method, result;
+    size_t len = 0;
+    bool ok = true;
+
+    if(buffer_size == 0)
+        return 0;
+    buffer[0] = '\0';
+    metrics_snapshot(&metrics);
+
+    // Requests by method and result
+    ok = ok && render_append(buffer, buffer_size, &len,
+        "# HELP utlgbot_requests_total Telegram API requests by method and result.\n"
+        "# TYPE utlgbot_requests_total counter\n");
+    for(method = 0; ok && (method < API_NUM_METHODS); method++)
+    {
+        for(result = 0; ok && (result < METRICS_NUM_RESULTS); result++)
+        {
+            ok = render_append(buffer, buffer_size, &len,
+                "utlgbot_requests_total{method=\"%s\",result=\"%s\"} %" PRIu64 "\n",
+                uTLGBot::api_method_name(method), METRICS_RESULTS_NAMES[result],
+                metrics.counter[METRICS_REQUESTS + (method * METRICS_NUM_RESULTS) + result]);
+        }
+    }
+
+    // Other counters
+    for(i = 0; ok && (i < METRICS_REQUESTS); i++)
+    {
+        info = &METRICS_COUNTERS_INFO[i];
+        if((i == 0) || (strcmp(info->name, METRICS_COUNTERS_INFO[i-1].name) != 0))
+        {
+            ok = render_append(buffer, buffer_size, &len, "# HELP %s %s\n# TYPE %s counter\n",
+                info->name, info->help, info->name);
+        }
+        if(info->labels[0] != '\0')
+        {
+            ok = ok && render_append(buffer, buffer_size, &len, "%s{%s} %" PRIu64 "\n",
+                info->name, info->labels, metrics.counter[i]);
+        }
+        else
+        {
+            ok = ok && render_append(buffer, buffer_size, &len, "%s %" PRIu64 "\n", info->name,
+                metrics.counter[i]);
+        }
+    }
+
+    // Gauges
+    for(i = 0; ok && (i < metrics_num_gauges); i++)
+    {
+        ok = render_append(buffer, buffer_size, &len,
+            "# HELP %s %s\n# TYPE %s gauge\n%s %" PRId64 "\n", metrics_gauges[i].name,
+            metrics_gauges[i].help, metrics_gauges[i].name, metrics_gauges[i].name,
+            metrics_gauges[i].gauge(metrics_gauges[i].user_data));
+    }
+
+    return len;
+}
+
+/**************************************************************************************************/
+
+/* Metrics HTTP Endpoint (just for Native Linux builds) */
+
+#if defined(__linux__) && !defined(ARDUINO) && !defined(ESP_IDF)
+
+// Metrics endpoint constructor
+uTLGBotMetricsServer::uTLGBotMetricsServer(void)
+{
+    _fd = -1;
+    _stop = false;
+    _response[0] = '\0';
+}
+
+// Metrics endpoint destructor, stop serving
+uTLGBotMetricsServer::~uTLGBotMetricsServer(void)
+{
+    stop();
+}
+
+// Start serving metrics at http://address:port/metrics from a background thread
+// Note: Default address just accepts local scrapes
+bool uTLGBotMetricsServer::start(const uint16_t port, const char* address)
+{
+    struct sockaddr_in addr;
+    int reuse = 1;
+
+    if(_fd >= 0)
+        return true;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if(inet_pton(AF_INET, address, &addr.sin_addr) != 1)
+        return false;
+
+    _fd = socket(AF_INET, SOCK_STREAM, 0);
+    if(_fd < 0)
+        return false;
+    setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if((bind(_fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) || (listen(_fd, 4) != 0))
+    {
+        close(_fd);
+        _fd = -1;
+        return false;
+    }
+
+    _stop = false;
+    _thread = std::thread(&uTLGBotMetricsServer::server_loop, this);
+
+    return true;
+}
+
+// Stop serving metrics
+void uTLGBotMetricsServer::stop(void)
+{
+    if(_fd < 0)
+        return;
+
+    _stop = true;
+    if(_thread.joinable())
+        _thread.join();
+    close(_fd);
+    _fd = -1;
+}
+
+// Endpoint thread: accept scrapes one by one until stopped
+void uTLGBotMetricsServer::server_loop(void)
+{
+    struct pollfd pfd;
+    int client_fd;
+
+    pfd.fd = _fd;
+    pfd.events = POLLIN;
+    while(!_stop)
+    {
+        if(::poll(&pfd, 1, METRICS_SERVER_POLL_PERIOD) <= 0)
+            continue;
+        client_fd = accept(_fd, NULL, NULL);
+        if(client_fd < 0)
+            continue;
+        handle_client(client_fd);
+        close(client_fd);
+    }
+}
+
+// Read a scrape request and send the metrics response
+void uTLGBotMetricsServer::handle_client(const int fd)
+{
+    char request[METRICS_MAX_REQUEST_LENGTH];
+    char header[128];
+    struct pollfd pfd;
+    size_t request_len = 0;
+    size_t body_len;
+    ssize_t n;
+
+    // Read request header
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    request[0] = '\0';
+    while(strstr(request, "\r\n\r\n") == NULL)
+    {
+        if(request_len >= METRICS_MAX_REQUEST_LENGTH - 1)
+            return;
+        if(::poll(&pfd, 1, METRICS_REQUEST_TIMEOUT) <= 0)
+            return;
+        n = recv(fd, request + request_len, METRICS_MAX_REQUEST_LENGTH - 1 - request_len, 0);
+        if(n <= 0)
+            return;
+        request_len = request_len + n;
+        request[request_len] = '\0';
+    }
+
+    // Just metrics resource is served
+    if((strncmp(request, "GET /metrics ", strlen("GET /metrics ")) != 0) &&
+       (strncmp(request, "GET / ", strlen("GET / ")) != 0))
+    {
+        snprintf(header, sizeof(header), "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n"
+            "Connection: close\r\n\r\n");
+        send(fd, header, strlen(header), MSG_NOSIGNAL);
+        return;
+    }
+
+    body_len = metrics_render(_response, METRICS_MAX_RESPONSE_LENGTH);
+    snprintf(header, sizeof(header), "HTTP/1.1 200 OK\r\n" \
+        "Content-Type: text/plain; version=0.0.4\r\nContent-Length: %" PRIu64 "\r\n" \
+        "Connection: close\r\n\r\n", (uint64_t)body_len);
+    send(fd, header, strlen(header), MSG_NOSIGNAL);
+    send(fd, _response, body_len, MSG_NOSIGNAL);
+}
+
+#endif
+
+/**************************************************************************************************/
+
+#endif
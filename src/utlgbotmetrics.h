@@ -0,0 +1,134 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotmetrics.h
+// Description: Runtime counters (requests, traffic, connections, parse failures...) and gauges,
+//              rendered in Prometheus text format and served by a tiny local HTTP endpoint in
+//              Native builds (build with UTLGBOT_METRICS, otherwise it is not compiled at all).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef UTLGBOTMETRICS_H_
+#define UTLGBOTMETRICS_H_
+
+/**************************************************************************************************/
+
+/* Check Build Configuration (just for UTLGBOT_METRICS builds) */
+
+#if defined(UTLGBOT_METRICS)
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "utlgbotlib.h"
+
+#if defined(__linux__) && !defined(ARDUINO) && !defined(ESP_IDF)
+    #include <atomic>
+    #include <thread>
+#endif
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Counters
+#define METRICS_BYTES_OUT           0
+#define METRICS_BYTES_IN            1
+#define METRICS_CONNECTIONS         2
+#define METRICS_RECONNECTIONS       3
+#define METRICS_HANDSHAKES_FULL     4
+#define METRICS_HANDSHAKES_RESUMED  5
+#define METRICS_PARSE_FAILURES      6
+#define METRICS_SKIPPED_UPDATES     7
+#define METRICS_REQUESTS            8 // METRICS_REQUESTS + (method*METRICS_NUM_RESULTS) + result
+#define METRICS_NUM_COUNTERS (METRICS_REQUESTS + (API_NUM_METHODS*METRICS_NUM_RESULTS))
+
+// Requests results
+#define METRICS_RESULT_OK           0
+#define METRICS_RESULT_NO_RESPONSE  1 // Send fail, read fail or response timeout
+#define METRICS_RESULT_BAD_RESPONSE 2 // Unexpected response
+#define METRICS_RESULT_API_ERROR    3 // Response "ok" is not true
+#define METRICS_RESULT_RATE_LIMITED 4 // HTTP 429 Too Many Requests
+#define METRICS_NUM_RESULTS         5
+
+// Maximum number of registered gauges
+#ifndef METRICS_MAX_GAUGES
+    #define METRICS_MAX_GAUGES 8
+#endif
+
+// Metrics endpoint default address and port, and max response length
+#define METRICS_DEFAULT_ADDRESS "127.0.0.1"
+#define METRICS_DEFAULT_PORT 9464
+#define METRICS_MAX_RESPONSE_LENGTH 8192
+
+/**************************************************************************************************/
+
+/* Data Types */
+
+// Snapshot of all counters (aggregated from all threads)
+typedef struct tlg_metrics
+{
+    uint64_t counter[METRICS_NUM_COUNTERS];
+} tlg_metrics;
+
+// Gauge value getter (i.e. a queue depth)
+typedef int64_t (*tlg_metrics_gauge)(void* user_data);
+
+/**************************************************************************************************/
+
+/* Functions */
+
+void metrics_add(const uint8_t counter, const uint32_t n);
+void metrics_request(const char* command, const uint8_t result);
+void metrics_record_client(MultiHTTPSClient* client);
+uint16_t metrics_http_status(const char* response);
+void metrics_snapshot(tlg_metrics* metrics);
+bool metrics_add_gauge(const char* name, const char* help, tlg_metrics_gauge gauge,
+    void* user_data);
+size_t metrics_render(char* buffer, const size_t buffer_size);
+
+/**************************************************************************************************/
+
+/* Metrics HTTP Endpoint (just for Native Linux builds) */
+
+#if defined(__linux__) && !defined(ARDUINO) && !defined(ESP_IDF)
+
+class uTLGBotMetricsServer
+{
+    public:
+        // Public Methods
+        uTLGBotMetricsServer();
+        ~uTLGBotMetricsServer();
+        bool start(const uint16_t port=METRICS_DEFAULT_PORT,
+            const char* address=METRICS_DEFAULT_ADDRESS);
+        void stop();
+
+    private:
+        // Private Attributtes
+        int _fd;
+        std::thread _thread;
+        std::atomic<bool> _stop;
+        char _response[METRICS_MAX_RESPONSE_LENGTH];
+
+        // Private Methods
+        void server_loop();
+        void handle_client(const int fd);
+};
+
+#endif
+
+/**************************************************************************************************/
+
+#endif
+
+/**************************************************************************************************/
+
+#endif
@@ -0,0 +1,356 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotrouter.cpp
+// Description: Bot commands router that dispatch received "/command" texts to its handlers.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "utlgbotrouter.h"
+#include "utlgbotcommon.h"
+#include "utility/multihttpsclient/multihttpsclient_trace.h"
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Empty perfect hash slot mark
+#define ROUTER_EMPTY_SLOT 0xFFFF
+
+// Average number of commands per perfect hash bucket
+#define ROUTER_BUCKET_SIZE 4
+
+// Maximum number of commands that can share a perfect hash bucket
+#define ROUTER_MAX_BUCKET_SIZE 32
+
+// Maximum displacement value to try for each bucket before give up
+#define ROUTER_MAX_DISPLACEMENT 0xFFFF
+
+/**************************************************************************************************/
+
+/* Constructor */
+
+// Router constructor, start with an empty commands table
+uTLGBotRouter::uTLGBotRouter(void)
+{
+    _bot_username[0] = '\0';
+    _bot_username_len = 0;
+    _default_handler = NULL;
+    _default_user_data = NULL;
+    clear();
+}
+
+/**************************************************************************************************/
+
+/* Public Methods */
+
+// Set Bot username to check "/command@botname" commands (commands addressed to other Bots in a
+// group will be ignored)
+void uTLGBotRouter::set_bot_username(const char* username)
+{
+    if(username[0] == '@')
+        username = username + 1;
+    snprintf(_bot_username, MAX_BOT_USERNAME_LENGTH, "%s", username);
+    _bot_username_len = strlen(_bot_username);
+}
+
+// Register a command handler (command can be given with or without the initial "/")
+// Note: The command string is not copied, so it must remains valid while router is used
+bool uTLGBotRouter::add(const char* command, tlg_cmd_handler handler, void* user_data)
+{
+    size_t command_len;
+
+    if(command[0] == '/')
+        command = command + 1;
+    command_len = strlen(command);
+
+    // Check for invalid command or full table
+    if((command_len == 0) || (command_len > MAX_COMMAND_LENGTH) || (handler == NULL))
+        return false;
+    if(_num_entries >= UTLGBOT_ROUTER_MAX_COMMANDS)
+        return false;
+
+    // Check for duplicate commands
+    for(uint16_t i = 0; i < _num_entries; i++)
+    {
+        if((_entries[i].command_len == command_len) &&
+            (memcmp(_entries[i].command, command, command_len) == 0))
+        {
+            return false;
+        }
+    }
+
+    _entries[_num_entries].command = command;
+    _entries[_num_entries].command_len = (uint8_t)command_len;
+    _entries[_num_entries].hash = utlgbot_fnv32(command, command_len);
+    _entries[_num_entries].handler = handler;
+    _entries[_num_entries].user_data = user_data;
+    _num_entries = _num_entries + 1;
+    _compiled = false;
+
+    return true;
+}
+
+// Set the handler to be called for unknown commands
+void uTLGBotRouter::set_default(tlg_cmd_handler handler, void* user_data)
+{
+    _default_handler = handler;
+    _default_user_data = user_data;
+}
+
+// Build the perfect hash table of registered commands (hash and displace), so each dispatch just
+// need to hash the received command once and compare it with a single candidate
+// Note: Call it once after all commands are added (and before any dispatch() call)
+bool uTLGBotRouter::compile(void)
+{
+    uint16_t members[ROUTER_MAX_BUCKET_SIZE];
+    uint16_t num_members, max_bucket_size;
+    uint32_t num_slots;
+
+    _compiled = false;
+    if(_num_entries == 0)
+    {
+        _compiled = true;
+        return true;
+    }
+
+    // Slots table size: power of two with a load factor below 0.8 (limited to table capacity)
+    num_slots = 1;
+    while(num_slots < (uint32_t)_num_entries + (_num_entries/4))
+        num_slots = num_slots << 1;
+    while(num_slots > (UTLGBOT_ROUTER_MAX_COMMANDS*2))
+        num_slots = num_slots >> 1;
+    _slots_mask = (uint16_t)(num_slots - 1);
+    _num_buckets = (_num_entries + ROUTER_BUCKET_SIZE - 1) / ROUTER_BUCKET_SIZE;
+
+    for(uint32_t i = 0; i < num_slots; i++)
+        _slots[i] = ROUTER_EMPTY_SLOT;
+
+    // Get biggest bucket size
+    max_bucket_size = 0;
+    for(uint16_t b = 0; b < _num_buckets; b++)
+    {
+        _displacements[b] = 0;
+        num_members = 0;
+        for(uint16_t i = 0; i < _num_entries; i++)
+        {
+            if((_entries[i].hash % _num_buckets) == b)
+                num_members = num_members + 1;
+        }
+        if(num_members > max_bucket_size)
+            max_bucket_size = num_members;
+    }
+    if(max_bucket_size > ROUTER_MAX_BUCKET_SIZE)
+        return false;
+
+    // Place buckets from the biggest to the smallest one, looking for a displacement value that
+    // put all the bucket commands in free slots
+    for(uint16_t size = max_bucket_size; size > 0; size--)
+    {
+        for(uint16_t b = 0; b < _num_buckets; b++)
+        {
+            // Get bucket commands
+            num_members = 0;
+            for(uint16_t i = 0; i < _num_entries; i++)
+            {
+                if((_entries[i].hash % _num_buckets) == b)
+                {
+                    members[num_members] = i;
+                    num_members = num_members + 1;
+                }
+            }
+            if(num_members != size)
+                continue;
+
+            // Find a displacement without collisions
+            uint32_t d;
+            for(d = 0; d <= ROUTER_MAX_DISPLACEMENT; d++)
+            {
+                uint16_t placed = 0;
+                while(placed < num_members)
+                {
+                    uint32_t slot = slot_hash(_entries[members[placed]].hash, d) & _slots_mask;
+                    if(_slots[slot] != ROUTER_EMPTY_SLOT)
+                        break;
+                    _slots[slot] = members[placed];
+                    placed = placed + 1;
+                }
+                if(placed == num_members)
+                    break;
+
+                // Collision, undo bucket placement and try next displacement
+                for(uint16_t i = 0; i < placed; i++)
+                    _slots[slot_hash(_entries[members[i]].hash, d) & _slots_mask] =
+                        ROUTER_EMPTY_SLOT;
+            }
+            if(d > ROUTER_MAX_DISPLACEMENT)
+                return false;
+            _displacements[b] = (uint16_t)d;
+        }
+    }
+
+    _compiled = true;
+    return true;
+}
+
+// Remove all registered commands
+void uTLGBotRouter::clear(void)
+{
+    _num_entries = 0;
+    _num_buckets = 0;
+    _slots_mask = 0;
+    _compiled = false;
+}
+
+// Get number of registered commands
+uint16_t uTLGBotRouter::count(void)
+{
+    return _num_entries;
+}
+
+// Parse a received text and call the corresponding command handler (call compile() after
+// registering the commands, or ROUTER_NOT_COMPILED is returned)
+uint8_t uTLGBotRouter::dispatch(const char* text)
+{
+    tlg_cmd cmd;
+    const char* bot_name;
+    uint8_t bot_name_len;
+    int32_t entry;
+
+    if(!parse(text, &cmd, &bot_name, &bot_name_len))
+        return ROUTER_NOT_A_COMMAND;
+
+    // Ignore commands addressed to other Bots
+    if((bot_name_len != 0) && (_bot_username_len != 0))
+    {
+        if(bot_name_len != _bot_username_len)
+            return ROUTER_OTHER_BOT;
+        for(uint8_t i = 0; i < bot_name_len; i++)
+        {
+            if(tolower((unsigned char)bot_name[i]) !=
+                tolower((unsigned char)_bot_username[i]))
+            {
+                return ROUTER_OTHER_BOT;
+            }
+        }
+    }
+
+    // Perfect hash table must be built after last added command (it is not built here, so
+    // dispatch just reads the router and can be called from many threads)
+    if(!_compiled)
+        return ROUTER_NOT_COMPILED;
+
+    entry = lookup(cmd.name, cmd.name_len);
+    if(entry == -1)
+    {
+        if(_default_handler != NULL)
+        {
+            HTTP_TRACE(DISPATCH_BEGIN, this, 0);
+            _default_handler(&cmd, _default_user_data);
+            HTTP_TRACE(DISPATCH_END, this, 0);
+        }
+        return ROUTER_UNKNOWN_CMD;
+    }
+
+    HTTP_TRACE(DISPATCH_BEGIN, this, 0);
+    _entries[entry].handler(&cmd, _entries[entry].user_data);
+    HTTP_TRACE(DISPATCH_END, this, 0);
+    return ROUTER_DISPATCHED;
+}
+
+// Parse a "/command@botname arg1 arg2..." text (arguments are pointers inside the given text)
+bool uTLGBotRouter::parse(const char* text, tlg_cmd* cmd, const char** bot_name,
+    uint8_t* bot_name_len)
+{
+    const char* ptr;
+
+    *bot_name = NULL;
+    *bot_name_len = 0;
+    if(text[0] != '/')
+        return false;
+
+    // Command name
+    ptr = text + 1;
+    while((*ptr != '\0') && (*ptr != '@') && !isspace((unsigned char)*ptr))
+        ptr = ptr + 1;
+    if((ptr == text + 1) || (ptr - (text + 1) > MAX_COMMAND_LENGTH))
+        return false;
+    cmd->name = text + 1;
+    cmd->name_len = (uint8_t)(ptr - (text + 1));
+
+    // Bot username
+    if(*ptr == '@')
+    {
+        ptr = ptr + 1;
+        *bot_name = ptr;
+        while((*ptr != '\0') && !isspace((unsigned char)*ptr))
+            ptr = ptr + 1;
+        if(ptr - *bot_name >= MAX_BOT_USERNAME_LENGTH)
+            return false;
+        *bot_name_len = (uint8_t)(ptr - *bot_name);
+    }
+
+    // Arguments
+    while(isspace((unsigned char)*ptr))
+        ptr = ptr + 1;
+    cmd->args = ptr;
+    cmd->args_len = (uint16_t)strlen(ptr);
+    cmd->argc = 0;
+    while((*ptr != '\0') && (cmd->argc < MAX_COMMAND_ARGS))
+    {
+        cmd->argv[cmd->argc].str = ptr;
+        while((*ptr != '\0') && !isspace((unsigned char)*ptr))
+            ptr = ptr + 1;
+        cmd->argv[cmd->argc].len = (uint16_t)(ptr - cmd->argv[cmd->argc].str);
+        cmd->argc = cmd->argc + 1;
+        while(isspace((unsigned char)*ptr))
+            ptr = ptr + 1;
+    }
+
+    return true;
+}
+
+/**************************************************************************************************/
+
+/* Private Methods */
+
+// Get a command slot from its hash and the bucket displacement value (murmur3 finalizer mix)
+uint32_t uTLGBotRouter::slot_hash(const uint32_t hash, const uint16_t displacement)
+{
+    uint32_t h = hash ^ (displacement * 0x9E3779B9U);
+
+    h = h ^ (h >> 16);
+    h = h * 0x85EBCA6BU;
+    h = h ^ (h >> 13);
+    h = h * 0xC2B2AE35U;
+    h = h ^ (h >> 16);
+
+    return h;
+}
+
+// Get the registered command entry index of given command (-1 if not found)
+int32_t uTLGBotRouter::lookup(const char* command, const uint8_t command_len)
+{
+    uint32_t h;
+    uint16_t slot;
+
+    if(_num_entries == 0)
+        return -1;
+
+    h = utlgbot_fnv32(command, command_len);
+    slot = _slots[slot_hash(h, _displacements[h % _num_buckets]) & _slots_mask];
+    if(slot == ROUTER_EMPTY_SLOT)
+        return -1;
+    if((_entries[slot].command_len != command_len) || (_entries[slot].hash != h) ||
+        (memcmp(_entries[slot].command, command, command_len) != 0))
+    {
+        return -1;
+    }
+
+    return slot;
+}
+
+/**************************************************************************************************/
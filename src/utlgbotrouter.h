@@ -0,0 +1,128 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotrouter.h
+// Description: Bot commands router that dispatch received "/command" texts to its handlers.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef UTLGBOTROUTER_H_
+#define UTLGBOTROUTER_H_
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <ctype.h>
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Maximum number of commands that can be registered in a router (commands table is static, so
+// keep it low in microcontrollers builds)
+#ifndef UTLGBOT_ROUTER_MAX_COMMANDS
+    #if defined(ARDUINO) || defined(ESP_IDF)
+        #define UTLGBOT_ROUTER_MAX_COMMANDS 16
+    #else
+        #define UTLGBOT_ROUTER_MAX_COMMANDS 1024
+    #endif
+#endif
+
+// Telegram command max length (without "/" and "@botname")
+#define MAX_COMMAND_LENGTH 32
+
+// Maximum number of arguments splitted from a command text
+#define MAX_COMMAND_ARGS 8
+
+// Bot username max length (for "/command@botname" check)
+#define MAX_BOT_USERNAME_LENGTH 33
+
+// Router dispatch results
+#define ROUTER_DISPATCHED     0
+#define ROUTER_NOT_A_COMMAND  1
+#define ROUTER_UNKNOWN_CMD    2
+#define ROUTER_OTHER_BOT      3
+#define ROUTER_NOT_COMPILED   4
+
+/**************************************************************************************************/
+
+/* Data Types */
+
+// Command argument (a view inside the received text, nothing is copied)
+typedef struct tlg_cmd_arg
+{
+    const char* str;
+    uint16_t len;
+} tlg_cmd_arg;
+
+// Received command and its splitted arguments
+typedef struct tlg_cmd
+{
+    const char* name;
+    uint8_t name_len;
+    const char* args;
+    uint16_t args_len;
+    uint8_t argc;
+    tlg_cmd_arg argv[MAX_COMMAND_ARGS];
+} tlg_cmd;
+
+// Command handler function
+typedef void (*tlg_cmd_handler)(const tlg_cmd* cmd, void* user_data);
+
+/**************************************************************************************************/
+
+class uTLGBotRouter
+{
+    public:
+        // Public Methods
+        uTLGBotRouter();
+        void set_bot_username(const char* username);
+        bool add(const char* command, tlg_cmd_handler handler, void* user_data=NULL);
+        void set_default(tlg_cmd_handler handler, void* user_data=NULL);
+        bool compile();
+        void clear();
+        uint16_t count();
+        uint8_t dispatch(const char* text);
+        static bool parse(const char* text, tlg_cmd* cmd, const char** bot_name,
+            uint8_t* bot_name_len);
+
+    private:
+        // Private Data Types
+        typedef struct router_entry
+        {
+            const char* command;
+            uint8_t command_len;
+            uint32_t hash;
+            tlg_cmd_handler handler;
+            void* user_data;
+        } router_entry;
+
+        // Private Attributtes
+        router_entry _entries[UTLGBOT_ROUTER_MAX_COMMANDS];
+        uint16_t _displacements[UTLGBOT_ROUTER_MAX_COMMANDS];
+        uint16_t _slots[UTLGBOT_ROUTER_MAX_COMMANDS*2];
+        uint16_t _num_entries;
+        uint16_t _num_buckets;
+        uint16_t _slots_mask;
+        tlg_cmd_handler _default_handler;
+        void* _default_user_data;
+        char _bot_username[MAX_BOT_USERNAME_LENGTH];
+        uint8_t _bot_username_len;
+        bool _compiled;
+
+        // Private Methods
+        static uint32_t slot_hash(const uint32_t hash, const uint16_t displacement);
+        int32_t lookup(const char* command, const uint8_t command_len);
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -0,0 +1,172 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotrxengine.cpp
+// Description: ESP-IDF FreeRTOS task that receive messages in background into a static messages
+//              pool, and pass them to the application through a queue of pool slots indexes.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Check Build System (just for ESP-IDF, or native tests build with the FreeRTOS POSIX shim) */
+
+#if defined(ESP_IDF) || defined(UTLGBOT_FREERTOS_POSIX)
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "utlgbotrxengine.h"
+
+/**************************************************************************************************/
+
+/* Constructor */
+
+// Receive engine constructor, it uses its own Bot object (own connection and buffers), so the
+// application Bot can send messages at the same time that the engine is receiving
+// Note: The object holds the messages pool and the task stack, so create it as a global or static
+// object (not in a task stack)
+uTLGBotRxEngine::uTLGBotRxEngine(const char* token) : _bot(token)
+{
+    _free_queue = NULL;
+    _ready_queue = NULL;
+    _task = NULL;
+}
+
+/**************************************************************************************************/
+
+/* Public Methods */
+
+// Enable/Disable receiver Bot debug prints
+void uTLGBotRxEngine::set_debug(const uint8_t debug_level)
+{
+    _bot.set_debug(debug_level);
+}
+
+// Set/Modify Telegram Server Certificate
+void uTLGBotRxEngine::set_cert(const uint8_t* ca_pem_start, const uint8_t* ca_pem_end)
+{
+    _bot.set_cert(ca_pem_start, ca_pem_end);
+}
+
+// Set/Modify Telegram Server Certificate from DER data (precompiled Telegram API CA by default)
+bool uTLGBotRxEngine::set_cert_der(const uint8_t* ca_der, const size_t ca_der_len)
+{
+    return _bot.set_cert_der(ca_der, ca_der_len);
+}
+
+// Set/Modify Telegram getUpdates polling request timeout
+void uTLGBotRxEngine::set_polling_timeout(const uint8_t seconds)
+{
+    _bot.set_polling_timeout(seconds);
+}
+
+// Set the types of updates to receive (UPDATE_* flags)
+void uTLGBotRxEngine::set_allowed_updates(const uint16_t update_types)
+{
+    _bot.set_allowed_updates(update_types);
+}
+
+// Set the fields to extract from received updates (UPDATE_FIELD_* flags)
+void uTLGBotRxEngine::set_update_fields(const uint16_t update_fields)
+{
+    _bot.set_update_fields(update_fields);
+}
+
+// Get the offset of next getUpdates request of the receiver Bot (to save it)
+uint64_t uTLGBotRxEngine::get_updates_offset(void)
+{
+    return _bot.get_updates_offset();
+}
+
+// Set the offset of next getUpdates request of the receiver Bot (i.e. a saved one, before start)
+void uTLGBotRxEngine::set_updates_offset(const uint64_t offset)
+{
+    _bot.set_updates_offset(offset);
+}
+
+// Create the queues and launch the receiver task (no dynamic memory used)
+bool uTLGBotRxEngine::start(const UBaseType_t priority, const BaseType_t core)
+{
+    if(_task != NULL)
+        return true;
+
+    _free_queue = xQueueCreateStatic(UTLGBOT_RX_POOL_SIZE, sizeof(uint8_t), _free_storage,
+        &_free_queue_buffer);
+    _ready_queue = xQueueCreateStatic(UTLGBOT_RX_POOL_SIZE, sizeof(uint8_t), _ready_storage,
+        &_ready_queue_buffer);
+    if((_free_queue == NULL) || (_ready_queue == NULL))
+        return false;
+
+    // All pool slots start free
+    for(uint8_t i = 0; i < UTLGBOT_RX_POOL_SIZE; i++)
+        xQueueSend(_free_queue, &i, 0);
+
+    _task = xTaskCreateStaticPinnedToCore(rx_task, "utlgbot_rx",
+        UTLGBOT_RX_TASK_STACK_SIZE/sizeof(StackType_t), this, priority, _task_stack,
+        &_task_buffer, core);
+
+    return (_task != NULL);
+}
+
+// Wait for a received message (NULL if no message was received in the given time)
+// The message stays in its pool slot until it is given back with release()
+tlg_type_message* uTLGBotRxEngine::receive(const TickType_t wait_ticks)
+{
+    uint8_t slot;
+
+    if(_ready_queue == NULL)
+        return NULL;
+    if(xQueueReceive(_ready_queue, &slot, wait_ticks) != pdTRUE)
+        return NULL;
+
+    return &_pool[slot];
+}
+
+// Give back a received message pool slot, so the receiver task can use it again
+void uTLGBotRxEngine::release(tlg_type_message* msg)
+{
+    uint8_t slot;
+
+    if((msg < &_pool[0]) || (msg > &_pool[UTLGBOT_RX_POOL_SIZE-1]))
+        return;
+    slot = (uint8_t)(msg - &_pool[0]);
+    xQueueSend(_free_queue, &slot, 0);
+}
+
+// Get number of received messages waiting to be handled
+UBaseType_t uTLGBotRxEngine::num_pending(void)
+{
+    if(_ready_queue == NULL)
+        return 0;
+    return uxQueueMessagesWaiting(_ready_queue);
+}
+
+/**************************************************************************************************/
+
+/* Private Methods */
+
+// Receiver task: take a free pool slot, parse next received message directly into it and queue
+// the slot index to the application
+void uTLGBotRxEngine::rx_task(void* arg)
+{
+    uTLGBotRxEngine* engine = (uTLGBotRxEngine*)arg;
+    uint8_t slot;
+
+    while(true)
+    {
+        // Wait for a free slot (pool full means application is not handling messages, so stop
+        // asking for more to the server)
+        if(xQueueReceive(engine->_free_queue, &slot, portMAX_DELAY) != pdTRUE)
+            continue;
+
+        while(!engine->_bot.getUpdates(&engine->_pool[slot]))
+            vTaskDelay(RX_ENGINE_RETRY_DELAY/portTICK_PERIOD_MS);
+
+        xQueueSend(engine->_ready_queue, &slot, portMAX_DELAY);
+    }
+}
+
+/**************************************************************************************************/
+
+#endif
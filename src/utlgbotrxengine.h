@@ -0,0 +1,98 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotrxengine.h
+// Description: ESP-IDF FreeRTOS task that receive messages in background into a static messages
+//              pool, and pass them to the application through a queue of pool slots indexes.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef UTLGBOTRXENGINE_H_
+#define UTLGBOTRXENGINE_H_
+
+/**************************************************************************************************/
+
+/* Check Build System (just for ESP-IDF, or native tests build with the FreeRTOS POSIX shim) */
+
+#if defined(ESP_IDF) || defined(UTLGBOT_FREERTOS_POSIX)
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+#include "utlgbotlib.h"
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Number of messages in the pool (each one takes sizeof(tlg_type_message) bytes of RAM)
+#ifndef UTLGBOT_RX_POOL_SIZE
+    #define UTLGBOT_RX_POOL_SIZE 2
+#endif
+
+// Receiver task stack size (bytes)
+#ifndef UTLGBOT_RX_TASK_STACK_SIZE
+    #define UTLGBOT_RX_TASK_STACK_SIZE 8192
+#endif
+
+// Receiver task default priority
+#define DEFAULT_RX_TASK_PRIORITY 5
+
+// Time to wait after a getUpdates without messages or failed before ask again (ms)
+#define RX_ENGINE_RETRY_DELAY 100
+
+/**************************************************************************************************/
+
+class uTLGBotRxEngine
+{
+    public:
+        // Public Methods
+        uTLGBotRxEngine(const char* token);
+        void set_debug(const uint8_t debug_level);
+        void set_cert(const uint8_t* ca_pem_start, const uint8_t* ca_pem_end=NULL);
+        bool set_cert_der(const uint8_t* ca_der=tlg_api_ca_der,
+            const size_t ca_der_len=tlg_api_ca_der_len);
+        void set_polling_timeout(const uint8_t seconds);
+        void set_allowed_updates(const uint16_t update_types);
+        void set_update_fields(const uint16_t update_fields);
+        uint64_t get_updates_offset();
+        void set_updates_offset(const uint64_t offset);
+        bool start(const UBaseType_t priority=DEFAULT_RX_TASK_PRIORITY,
+            const BaseType_t core=tskNO_AFFINITY);
+        tlg_type_message* receive(const TickType_t wait_ticks=portMAX_DELAY);
+        void release(tlg_type_message* msg);
+        UBaseType_t num_pending();
+
+    private:
+        // Private Attributtes
+        uTLGBot _bot;
+        tlg_type_message _pool[UTLGBOT_RX_POOL_SIZE];
+        uint8_t _free_storage[UTLGBOT_RX_POOL_SIZE];
+        uint8_t _ready_storage[UTLGBOT_RX_POOL_SIZE];
+        StaticQueue_t _free_queue_buffer;
+        StaticQueue_t _ready_queue_buffer;
+        QueueHandle_t _free_queue;
+        QueueHandle_t _ready_queue;
+        StackType_t _task_stack[UTLGBOT_RX_TASK_STACK_SIZE/sizeof(StackType_t)];
+        StaticTask_t _task_buffer;
+        TaskHandle_t _task;
+
+        // Private Methods
+        static void rx_task(void* arg);
+};
+
+/**************************************************************************************************/
+
+#endif
+
+/**************************************************************************************************/
+
+#endif
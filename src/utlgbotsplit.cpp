@@ -0,0 +1,655 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotsplit.cpp
+// Description: Long texts splitter. It walks a UTF-8 text and gets it in parts that fit in a
+//              Telegram message (UTF-16 code units count) and in a request body, cutting at line
+//              or word boundaries and keeping Markdown/HTML entities balanced between parts.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "utlgbotsplit.h"
+
+#include <string.h>
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Text tokens types
+#define TOKEN_CHAR    0
+#define TOKEN_SPACE   1
+#define TOKEN_NEWLINE 2
+#define TOKEN_OPEN    3 // Entity start (tag or marker)
+#define TOKEN_CLOSE   4 // Entity end (tag or marker)
+
+// Markdown links states (a link is not cut if it fits in a part)
+#define LINK_NONE 0
+#define LINK_TEXT 1
+
+// Maximum HTML tag, HTML character reference, pre block language and Markdown link lengths
+#define MAX_HTML_TAG_LENGTH 256
+#define MAX_HTML_REFERENCE_LENGTH 10
+#define MAX_PRE_LANGUAGE_LENGTH 32
+#define MAX_MARKDOWN_LINK_LENGTH 2048
+
+/**************************************************************************************************/
+
+/* Constructor */
+
+// Text splitter constructor, it gets parts of the given text (the text is not copied, so it must
+// stay unchanged while the splitter is used)
+// If the text is already JSON escaped (i.e. a received text), its escape sequences are single
+// characters and are written as they are
+uTLGBotTextSplitter::uTLGBotTextSplitter(const char* text, const char* parse_mode,
+    const bool escaped)
+{
+    _text = text;
+    _length = strlen(text);
+    _mode = parse_mode_id(parse_mode);
+    _escaped = escaped;
+    _start = 0;
+    _end = 0;
+    _num_parts = 0;
+    _num_open = 0;
+    _num_close = 0;
+    _num_stack = 0;
+    _link = LINK_NONE;
+}
+
+/**************************************************************************************************/
+
+/* Public Methods */
+
+// Get next part of the text, up to max_units UTF-16 code units and max_bytes JSON escaped bytes
+// (entities reopened at its start and closed at its end included)
+// Note: A part is cut after the last line end, or after the last word if there is no line end in
+// its second half, or at any character otherwise (never inside a UTF-8 sequence, an HTML tag or
+// character reference, a Markdown escape or link, nor just after an entity start). A Markdown link
+// bigger than a part is cut inside its text, closed with its URL and reopened in next part. An
+// empty text gets a single empty part
+bool uTLGBotTextSplitter::next(const size_t max_bytes, const uint16_t max_units)
+{
+    split_token token;
+    size_t pos, cut, cut_any, cut_space, cut_newline, bytes, closers, token_closers, remaining;
+    size_t text_bytes;
+    uint32_t units;
+    int8_t index;
+
+    if(done())
+        return false;
+
+    // Next part starts where previous one ends, with previous part unclosed entities reopened
+    _start = _end;
+    memcpy(_open, _close, _num_close*sizeof(split_entity));
+    _num_open = _num_close;
+    memcpy(_stack, _open, _num_open*sizeof(split_entity));
+    _num_stack = _num_open;
+    _link = LINK_NONE;
+    bytes = 0;
+    closers = 0;
+    for(uint8_t i = 0; i < _num_open; i++)
+    {
+        bytes = bytes + _open[i].open_bytes;
+        closers = closers + closer_bytes(&_open[i]);
+        if(is_link(&_open[i]))
+            _link = LINK_TEXT;
+    }
+
+    // All remaining text fits, so it is the last part and there is no need to scan its tokens
+    // (each byte is at most one UTF-16 code unit and six JSON escaped bytes, so its escaped
+    // length is just got if it could not fit)
+    remaining = _length - _start;
+    if(remaining <= max_units)
+    {
+        text_bytes = remaining * 6;
+        if(bytes + text_bytes > max_bytes)
+            text_bytes = json_bytes(_text + _start, remaining);
+        if(bytes + text_bytes <= max_bytes)
+        {
+            _end = _length;
+            _num_close = 0;
+            _num_parts = _num_parts + 1;
+            return true;
+        }
+    }
+
+    // Take tokens while they fit, keeping the cut candidates
+    units = 0;
+    pos = _start;
+    cut_any = _start;
+    cut_space = _start;
+    cut_newline = _start;
+    token.length = 0;
+    while(pos < _length)
+    {
+        scan_token(pos, &token);
+        token_closers = closers;
+        if((token.type == TOKEN_OPEN) && (_num_stack < SPLIT_MAX_ENTITIES))
+            token_closers = token_closers + closer_bytes(&token.entity);
+        else if(token.type == TOKEN_CLOSE)
+        {
+            index = stack_find(token.entity.name, token.entity.name_len);
+            if(index >= 0)
+                token_closers = token_closers - closer_bytes(&_stack[index]);
+        }
+        if((units + token.units > max_units) ||
+           (bytes + token.bytes + token_closers > max_bytes))
+            break;
+        apply_token(&token);
+        pos = pos + token.length;
+        units = units + token.units;
+        bytes = bytes + token.bytes;
+        closers = token_closers;
+        if((_link == LINK_NONE) && (token.type != TOKEN_OPEN))
+        {
+            cut_any = pos;
+            if(token.type == TOKEN_NEWLINE)
+                cut_newline = pos;
+            else if(token.type == TOKEN_SPACE)
+                cut_space = pos;
+        }
+    }
+
+    // Choose the cut (all remaining text fits, a line end or a word end that doesn't leave a too
+    // short part, or any other candidate)
+    if(pos >= _length)
+        cut = _length;
+    else if(cut_newline > _start + ((cut_any - _start) / 2))
+        cut = cut_newline;
+    else if(cut_space > _start + ((cut_any - _start) / 2))
+        cut = cut_space;
+    else
+        cut = cut_any;
+
+    // No candidate (a single token or link bigger than a part), so cut it anyway
+    if(cut == _start)
+        cut = (pos > _start) ? pos : (pos + token.length);
+
+    // Get the entities that are still open at the cut
+    if(cut != pos)
+    {
+        memcpy(_stack, _open, _num_open*sizeof(split_entity));
+        _num_stack = _num_open;
+        _link = LINK_NONE;
+        for(uint8_t i = 0; i < _num_open; i++)
+        {
+            if(is_link(&_open[i]))
+                _link = LINK_TEXT;
+        }
+        for(pos = _start; pos < cut; pos = pos + token.length)
+        {
+            scan_token(pos, &token);
+            apply_token(&token);
+        }
+    }
+    _end = cut;
+    if(_end < _length)
+    {
+        memcpy(_close, _stack, _num_stack*sizeof(split_entity));
+        _num_close = _num_stack;
+    }
+    else
+        _num_close = 0;
+    _num_parts = _num_parts + 1;
+
+    return true;
+}
+
+// Write current part as JSON string value content: entities reopened, part text and entities
+// closed
+bool uTLGBotTextSplitter::write(uTLGBotBodyWriter* writer)
+{
+    for(uint8_t i = 0; i < _num_open; i++)
+        append_text(writer, _open[i].open, _open[i].open_len);
+    append_text(writer, _text + _start, _end - _start);
+    for(uint8_t i = _num_close; i > 0; i--)
+    {
+        if(_mode == SPLIT_MODE_HTML)
+        {
+            writer->append("</", 2);
+            writer->append(_close[i-1].name, _close[i-1].name_len);
+            writer->append(">", 1);
+        }
+        else
+            append_text(writer, _close[i-1].name, _close[i-1].name_len);
+    }
+
+    return !writer->overflow();
+}
+
+// Check if all the text parts has been got
+bool uTLGBotTextSplitter::done(void)
+{
+    return ((_num_parts > 0) && (_end >= _length));
+}
+
+// Check if current part is the last one
+bool uTLGBotTextSplitter::is_last(void)
+{
+    return (_end >= _length);
+}
+
+// Get number of parts got
+uint16_t uTLGBotTextSplitter::num_parts(void)
+{
+    return _num_parts;
+}
+
+// Get current part text (without reopened and closed entities)
+const char* uTLGBotTextSplitter::part_text(void)
+{
+    return _text + _start;
+}
+
+// Get current part text length (without reopened and closed entities)
+size_t uTLGBotTextSplitter::part_length(void)
+{
+    return _end - _start;
+}
+
+// Get parse mode identifier of a parse mode name
+uint8_t uTLGBotTextSplitter::parse_mode_id(const char* parse_mode)
+{
+    if(strcmp(parse_mode, "Markdown") == 0)
+        return SPLIT_MODE_MARKDOWN;
+    if(strcmp(parse_mode, "MarkdownV2") == 0)
+        return SPLIT_MODE_MARKDOWN_V2;
+    if(strcmp(parse_mode, "HTML") == 0)
+        return SPLIT_MODE_HTML;
+    return SPLIT_MODE_PLAIN;
+}
+
+/**************************************************************************************************/
+
+/* Private Methods */
+
+// Scan the token that starts at given text position (without applying it)
+void uTLGBotTextSplitter::scan_token(const size_t pos, split_token* token)
+{
+    token->type = TOKEN_CHAR;
+    token->link = _link;
+    if((_mode == SPLIT_MODE_MARKDOWN) || (_mode == SPLIT_MODE_MARKDOWN_V2))
+        scan_markdown(pos, token);
+    else if(_mode == SPLIT_MODE_HTML)
+        scan_html(pos, token);
+    else
+        scan_char(pos, token);
+}
+
+// Scan a Markdown token (escaped character, pre/code block marker, link delimiter, formatting
+// marker or character)
+void uTLGBotTextSplitter::scan_markdown(const size_t pos, split_token* token)
+{
+    const char* text = _text + pos;
+    size_t remaining = _length - pos;
+    size_t marker_len = 0;
+    bool code = false;
+    int8_t index;
+
+    // Inside code and pre blocks, just its end marker is a token
+    if(_num_stack > 0)
+        code = (_stack[_num_stack-1].name[0] == '`');
+
+    // Escaped character, by a backslash (a JSON escaped backslash in already escaped texts, where
+    // other JSON escape sequences are single characters), MarkdownV2 escapes inside code blocks too
+    if(text[0] == '\\')
+    {
+        size_t backslash = 1;
+
+        if(_escaped && (uTLGBotBodyWriter::escape_length(text, remaining) > 0))
+            backslash = (text[1] == '\\') ? 2 : 0;
+        if((backslash > 0) && (remaining > backslash) &&
+           (!code || (_mode == SPLIT_MODE_MARKDOWN_V2)))
+        {
+            scan_char(pos + backslash, token);
+            token->type = TOKEN_CHAR;
+            token->length = token->length + backslash;
+            token->bytes = token->bytes + 2;
+            return;
+        }
+        scan_char(pos, token);
+        return;
+    }
+
+    // Pre and code blocks markers
+    if(text[0] == '`')
+    {
+        marker_len = ((remaining >= 3) && (strncmp(text, "```", 3) == 0)) ? 3 : 1;
+        if(code && (_stack[_num_stack-1].name_len != marker_len))
+        {
+            scan_char(pos, token);
+            return;
+        }
+        token->type = code ? TOKEN_CLOSE : TOKEN_OPEN;
+        token->length = marker_len;
+        token->entity.open = text;
+        token->entity.open_len = marker_len;
+        token->entity.name = text;
+        token->entity.name_len = marker_len;
+
+        // Pre block language is part of its start marker (reopened with it)
+        if(!code && (marker_len == 3))
+        {
+            size_t i = 3;
+            while((i < remaining) && (i < 3 + MAX_PRE_LANGUAGE_LENGTH) &&
+                  (text[i] != '\n') && (text[i] != ' ') && (text[i] != '`'))
+                i++;
+            if((i > 3) && (i < remaining) && (text[i] == '\n'))
+            {
+                token->length = i + 1;
+                token->entity.open_len = i + 1;
+            }
+        }
+        token->entity.open_bytes = json_bytes(text, token->entity.open_len);
+        token->units = 0;
+        token->bytes = json_bytes(text, token->length);
+        return;
+    }
+    if(code)
+    {
+        scan_char(pos, token);
+        return;
+    }
+
+    // Links (link text start is an entity start, and its end with the URL is the entity end, so
+    // a link can be closed and reopened as any other entity)
+    if((text[0] == '[') && (_link == LINK_NONE))
+    {
+        size_t end_length;
+        size_t end = link_end(pos, &end_length);
+        if(end > 0)
+        {
+            token->type = TOKEN_OPEN;
+            token->length = 1;
+            token->units = 0;
+            token->bytes = 1;
+            token->link = LINK_TEXT;
+            token->entity.open = text;
+            token->entity.open_len = 1;
+            token->entity.open_bytes = 1;
+            token->entity.name = _text + end;
+            token->entity.name_len = (uint16_t)end_length;
+            return;
+        }
+    }
+    if((text[0] == ']') && (_link == LINK_TEXT))
+    {
+        for(int8_t i = (int8_t)_num_stack - 1; i >= 0; i--)
+        {
+            if(_stack[i].name != text)
+                continue;
+            token->type = TOKEN_CLOSE;
+            token->length = _stack[i].name_len;
+            token->units = 0;
+            token->bytes = json_bytes(text, token->length);
+            token->link = LINK_NONE;
+            token->entity = _stack[i];
+            return;
+        }
+    }
+    // Formatting markers (toggles)
+    if((text[0] == '*') || (text[0] == '_'))
+        marker_len = 1;
+    if(_mode == SPLIT_MODE_MARKDOWN_V2)
+    {
+        if((remaining > 1) && (((text[0] == '_') && (text[1] == '_')) ||
+           ((text[0] == '|') && (text[1] == '|'))))
+            marker_len = 2;
+        else if(text[0] == '~')
+            marker_len = 1;
+    }
+    if(marker_len == 0)
+    {
+        scan_char(pos, token);
+        return;
+    }
+    index = stack_find(text, marker_len);
+    token->type = (index >= 0) ? TOKEN_CLOSE : TOKEN_OPEN;
+    token->length = marker_len;
+    token->units = 0;
+    token->bytes = marker_len;
+    token->entity.open = text;
+    token->entity.open_len = marker_len;
+    token->entity.open_bytes = marker_len;
+    token->entity.name = text;
+    token->entity.name_len = marker_len;
+}
+
+// Scan an HTML token (tag, character reference or character)
+void uTLGBotTextSplitter::scan_html(const size_t pos, split_token* token)
+{
+    const char* text = _text + pos;
+    size_t remaining = _length - pos;
+    size_t i;
+
+    // Tag
+    if(text[0] == '<')
+    {
+        for(i = 1; (i < remaining) && (i < MAX_HTML_TAG_LENGTH); i++)
+        {
+            if((text[i] == '>') || (text[i] == '<'))
+                break;
+        }
+        if((i < remaining) && (text[i] == '>'))
+        {
+            size_t name_start = (text[1] == '/') ? 2 : 1;
+            size_t name_end = name_start;
+            while((name_end < i) && (text[name_end] != ' ') && (text[name_end] != '/') &&
+                  (text[name_end] != '\n'))
+                name_end++;
+            if(name_end > name_start)
+            {
+                token->length = i + 1;
+                token->units = 0;
+                token->bytes = json_bytes(text, token->length);
+                token->entity.open = text;
+                token->entity.open_len = token->length;
+                token->entity.open_bytes = token->bytes;
+                token->entity.name = text + name_start;
+                token->entity.name_len = (name_end - name_start);
+                if(name_start == 2)
+                    token->type = TOKEN_CLOSE;
+                else if(text[i-1] != '/')
+                    token->type = TOKEN_OPEN;
+                return;
+            }
+        }
+    }
+
+    // Character reference (a single character)
+    if(text[0] == '&')
+    {
+        for(i = 1; (i < remaining) && (i < MAX_HTML_REFERENCE_LENGTH); i++)
+        {
+            if(text[i] == ';')
+            {
+                if(i == 1)
+                    break;
+                token->length = i + 1;
+                token->units = 1;
+                token->bytes = token->length;
+                return;
+            }
+            if(!(((text[i] >= 'a') && (text[i] <= 'z')) || ((text[i] >= 'A') &&
+                (text[i] <= 'Z')) || ((text[i] >= '0') && (text[i] <= '9')) || (text[i] == '#')))
+                break;
+        }
+    }
+
+    scan_char(pos, token);
+}
+
+// Scan a UTF-8 character or a JSON escape sequence (characters out of the Basic Multilingual
+// Plane are two UTF-16 code units, and invalid sequences are taken byte by byte)
+void uTLGBotTextSplitter::scan_char(const size_t pos, split_token* token)
+{
+    const char* text = _text + pos;
+    size_t remaining = _length - pos;
+    uint8_t c = (uint8_t)text[0];
+
+    token->length = _escaped ? uTLGBotBodyWriter::escape_length(text, remaining) : 0;
+    if(token->length > 0)
+    {
+        token->units = (token->length == 12) ? 2 : 1;
+        token->bytes = token->length;
+        if(text[1] == 'n')
+            token->type = TOKEN_NEWLINE;
+        else
+            token->type = TOKEN_CHAR;
+        return;
+    }
+    token->length = 1;
+    token->units = 1;
+    if((c >= 0xC2) && (c <= 0xDF))
+        token->length = 2;
+    else if((c >= 0xE0) && (c <= 0xEF))
+        token->length = 3;
+    else if((c >= 0xF0) && (c <= 0xF4))
+    {
+        token->length = 4;
+        token->units = 2;
+    }
+    if(token->length > remaining)
+        token->length = 1;
+    for(size_t i = 1; i < token->length; i++)
+    {
+        if(((uint8_t)text[i] & 0xC0) != 0x80)
+        {
+            token->length = 1;
+            token->units = 1;
+            break;
+        }
+    }
+    token->bytes = json_bytes(text, token->length);
+    if(c == '\n')
+        token->type = TOKEN_NEWLINE;
+    else if(c == ' ')
+        token->type = TOKEN_SPACE;
+    else
+        token->type = TOKEN_CHAR;
+}
+
+// Apply a scanned token to the entities stack and link state
+void uTLGBotTextSplitter::apply_token(const split_token* token)
+{
+    int8_t index;
+
+    _link = token->link;
+    if(token->type == TOKEN_OPEN)
+    {
+        if(_num_stack < SPLIT_MAX_ENTITIES)
+        {
+            _stack[_num_stack] = token->entity;
+            _num_stack = _num_stack + 1;
+        }
+    }
+    else if(token->type == TOKEN_CLOSE)
+    {
+        index = stack_find(token->entity.name, token->entity.name_len);
+        if(index >= 0)
+        {
+            memmove(&_stack[index], &_stack[index+1],
+                (_num_stack - index - 1)*sizeof(split_entity));
+            _num_stack = _num_stack - 1;
+        }
+    }
+}
+
+// Find the end of a Markdown link that starts at given text position ("](URL)" position, or 0 if
+// it is not a link), and get that end length
+size_t uTLGBotTextSplitter::link_end(const size_t pos, size_t* length)
+{
+    size_t max = pos + MAX_MARKDOWN_LINK_LENGTH;
+    size_t end = 0;
+
+    if(max > _length)
+        max = _length;
+    for(size_t i = pos + 1; i < max; i++)
+    {
+        if(_text[i] == '\\')
+            i++;
+        else if((end == 0) && (_text[i] == ']'))
+        {
+            if((i + 1 >= max) || (_text[i+1] != '('))
+                return 0;
+            end = i;
+            i++;
+        }
+        else if((end > 0) && (_text[i] == ')'))
+        {
+            *length = i + 1 - end;
+            return end;
+        }
+    }
+    return 0;
+}
+
+// Check if an entity is a Markdown link
+bool uTLGBotTextSplitter::is_link(const split_entity* entity)
+{
+    return ((_mode != SPLIT_MODE_HTML) && (entity->name[0] == ']'));
+}
+
+// Find the innermost open entity with given name (-1 if there is none)
+int8_t uTLGBotTextSplitter::stack_find(const char* name, const uint16_t name_len)
+{
+    for(int8_t i = (int8_t)_num_stack - 1; i >= 0; i--)
+    {
+        if((_stack[i].name_len == name_len) && (strncmp(_stack[i].name, name, name_len) == 0))
+            return i;
+    }
+    return -1;
+}
+
+// Get the length of an entity end (HTML closing tag, Markdown marker or Markdown link end)
+size_t uTLGBotTextSplitter::closer_bytes(const split_entity* entity)
+{
+    if(_mode == SPLIT_MODE_HTML)
+        return entity->name_len + 3;
+    return json_bytes(entity->name, entity->name_len);
+}
+
+// Get the length of a string once it is escaped as a JSON string (escape sequences of already
+// escaped texts are kept)
+size_t uTLGBotTextSplitter::json_bytes(const char* str, const size_t length)
+{
+    size_t bytes = 0;
+    size_t escape;
+
+    for(size_t i = 0; i < length; i++)
+    {
+        if(_escaped && (str[i] == '\\'))
+        {
+            escape = uTLGBotBodyWriter::escape_length(str + i, length - i);
+            if(escape > 0)
+            {
+                bytes = bytes + escape;
+                i = i + escape - 1;
+                continue;
+            }
+        }
+        if((str[i] == '"') || (str[i] == '\\') || (str[i] == '\n') || (str[i] == '\r') ||
+           (str[i] == '\t') || (str[i] == '\b') || (str[i] == '\f'))
+            bytes = bytes + 2;
+        else if((uint8_t)str[i] < 0x20)
+            bytes = bytes + 6;
+        else
+            bytes = bytes + 1;
+    }
+    return bytes;
+}
+
+// Append a piece of the text to a request body as JSON string value content
+bool uTLGBotTextSplitter::append_text(uTLGBotBodyWriter* writer, const char* str,
+    const size_t length)
+{
+    if(_escaped)
+        return writer->append_json_escaped(str, length);
+    return writer->append_json(str, length);
+}
+
+/**************************************************************************************************/
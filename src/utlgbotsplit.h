@@ -0,0 +1,114 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotsplit.h
+// Description: Long texts splitter. It walks a UTF-8 text and gets it in parts that fit in a
+//              Telegram message (UTF-16 code units count) and in a request body, cutting at line
+//              or word boundaries and keeping Markdown/HTML entities balanced between parts.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef UTLGBOTSPLIT_H_
+#define UTLGBOTSPLIT_H_
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "utlgbotbody.h"
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Telegram message text maximum length (UTF-16 code units, after entities parsing)
+#define SPLIT_MAX_UNITS 4096
+
+// Maximum nested entities kept balanced between parts (deeper ones are not reopened)
+#define SPLIT_MAX_ENTITIES 8
+
+// Text parse modes
+#define SPLIT_MODE_PLAIN       0
+#define SPLIT_MODE_MARKDOWN    1
+#define SPLIT_MODE_MARKDOWN_V2 2
+#define SPLIT_MODE_HTML        3
+
+/**************************************************************************************************/
+
+class uTLGBotTextSplitter
+{
+    private:
+        // Private Data Types
+        typedef struct split_entity
+        {
+            const char* open;
+            const char* name;
+            uint16_t open_len;
+            uint16_t open_bytes;
+            uint16_t name_len;
+        } split_entity;
+
+        typedef struct split_token
+        {
+            size_t length;
+            uint16_t units;
+            uint16_t bytes;
+            uint8_t type;
+            uint8_t link;
+            split_entity entity;
+        } split_token;
+
+    public:
+        // Public Methods
+        uTLGBotTextSplitter(const char* text, const char* parse_mode="",
+            const bool escaped=false);
+        bool next(const size_t max_bytes, const uint16_t max_units=SPLIT_MAX_UNITS);
+        bool write(uTLGBotBodyWriter* writer);
+        bool done();
+        bool is_last();
+        uint16_t num_parts();
+        const char* part_text();
+        size_t part_length();
+        static uint8_t parse_mode_id(const char* parse_mode);
+
+    private:
+        // Private Attributtes
+        const char* _text;
+        size_t _length;
+        uint8_t _mode;
+        bool _escaped;
+        size_t _start;
+        size_t _end;
+        uint16_t _num_parts;
+        split_entity _open[SPLIT_MAX_ENTITIES];
+        uint8_t _num_open;
+        split_entity _close[SPLIT_MAX_ENTITIES];
+        uint8_t _num_close;
+        split_entity _stack[SPLIT_MAX_ENTITIES];
+        uint8_t _num_stack;
+        uint8_t _link;
+
+        // Private Methods
+        void scan_token(const size_t pos, split_token* token);
+        void scan_markdown(const size_t pos, split_token* token);
+        void scan_html(const size_t pos, split_token* token);
+        void scan_char(const size_t pos, split_token* token);
+        void apply_token(const split_token* token);
+        size_t link_end(const size_t pos, size_t* length);
+        bool is_link(const split_entity* entity);
+        int8_t stack_find(const char* name, const uint16_t name_len);
+        size_t closer_bytes(const split_entity* entity);
+        size_t json_bytes(const char* str, const size_t length);
+        bool append_text(uTLGBotBodyWriter* writer, const char* str, const size_t length);
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -0,0 +1,510 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotstate.cpp
+// Description: Per chat state store, an open addressing hash table of fixed size records keyed by
+//              chat ID. Native POSIX builds keep it in a memory mapped file (persistent and crash
+//              safe), microcontrollers and other builds keep it in a bounded static RAM table.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "utlgbotstate.h"
+#include "utlgbotcommon.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(UTLGBOT_STATE_MMAP)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// File header identifier ("TGST") and layout version
+#define STATE_MAGIC 0x54534754UL
+#define STATE_VERSION 1
+
+// Slots states
+#define STATE_SLOT_EMPTY   0
+#define STATE_SLOT_USED    1
+#define STATE_SLOT_DELETED 2
+
+// Minimum number of slots
+#define STATE_MIN_CAPACITY 8
+
+/**************************************************************************************************/
+
+/* Constructor & Destructor */
+
+// State store constructor (open() a store before use it)
+// Note: Without memory mapped file store, the object holds the RAM table, so create it as a global
+// or static object (not in a task stack)
+uTLGBotStateStore::uTLGBotStateStore()
+{
+    _base = NULL;
+    _header = NULL;
+    _size = 0;
+    _slot_size = 0;
+    _copy_size = 0;
+    _num_copies = 1;
+#if defined(UTLGBOT_STATE_MMAP)
+    _fd = -1;
+#endif
+}
+
+// State store destructor (it is closed cleanly)
+uTLGBotStateStore::~uTLGBotStateStore()
+{
+    close();
+}
+
+/**************************************************************************************************/
+
+/* Public Methods */
+
+// Open the store at given file path (ignored for RAM table), creating it with the given number of
+// slots (rounded up to a power of two) if it doesn't exist
+// An existing store keeps its own capacity (capacity can be 0), but it must have the same record
+// size. A store that was not closed cleanly (process crash or power loss) is recovered here
+bool uTLGBotStateStore::open(const char* path, const uint16_t record_size,
+    const uint32_t capacity)
+{
+    close();
+
+    if((record_size == 0) || (record_size > STATE_MAX_RECORD_SIZE))
+        return false;
+
+    // Each slot holds its chat ID and state, and the copies of its record
+    _copy_size = sizeof(state_copy) + ((record_size + 7) & ~((size_t)7));
+    if(!map(path, record_size, capacity))
+    {
+        unmap();
+        return false;
+    }
+
+    // Recover a store that was not closed cleanly, and mark it as in use
+    if(_header->clean == 0)
+        recount();
+    _header->clean = 0;
+#if defined(UTLGBOT_STATE_MMAP)
+    msync(_base, sizeof(state_header), MS_SYNC);
+#endif
+
+    return true;
+}
+
+// Close the store (the file is marked as cleanly closed, so next open doesn't need recovery)
+void uTLGBotStateStore::close()
+{
+    if(_header == NULL)
+        return;
+
+    _header->clean = 1;
+    sync();
+    unmap();
+}
+
+// Check if the store is open
+bool uTLGBotStateStore::is_open()
+{
+    return (_header != NULL);
+}
+
+// Get the record of a chat (NULL if there is no record for it)
+// Note: The returned pointer is valid until next put() or erase() of the same chat
+const void* uTLGBotStateStore::get(const int64_t chat_id)
+{
+    uint32_t insert_index;
+    int64_t index;
+    state_copy* copy;
+
+    if(_header == NULL)
+        return NULL;
+
+    index = find(chat_id, &insert_index);
+    if(index < 0)
+        return NULL;
+    copy = current_copy(slot((uint32_t)index));
+
+    return (const void*)(copy + 1);
+}
+
+// Set the record of a chat (record size is the one set at open)
+// The new record is written in the slot copy that doesn't hold the current record, and it becomes
+// the current one when its sequence number is written, so a crash while writing keeps the previous
+// record (in RAM table, there is a single copy that is written in place)
+// Note: The copy is invalidated (sequence 0) before the record is written, and its sequence number
+// is published with a release store after it, so readers that load the sequence with acquire never
+// take a half written copy as the current one
+bool uTLGBotStateStore::put(const int64_t chat_id, const void* record)
+{
+    uint32_t insert_index, seq;
+    int64_t index;
+    state_slot* target;
+    state_copy* current;
+    state_copy* copy;
+
+    if(_header == NULL)
+        return false;
+
+    index = find(chat_id, &insert_index);
+
+    // Update an existing record
+    if(index >= 0)
+    {
+        target = slot((uint32_t)index);
+        current = current_copy(target);
+        copy = current;
+        if(_num_copies > 1)
+            copy = (current == slot_copy(target, 0)) ? slot_copy(target, 1) : slot_copy(target, 0);
+        seq = current->seq + 1;
+        if(seq == 0)
+            seq = 1;
+        copy->seq = 0;
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        memcpy(copy + 1, record, _header->record_size);
+        copy->check = check(copy) ^ seq;
+        __atomic_store_n(&copy->seq, seq, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    // Add a new record (keep the load below the max, so there is always an empty slot that ends the
+    // lookups)
+    if(insert_index == UINT32_MAX)
+        return false;
+    target = slot(insert_index);
+    if((target->state == STATE_SLOT_EMPTY) &&
+       (_header->used >= ((uint64_t)_header->capacity * STATE_MAX_LOAD) / 256))
+    {
+        return false;
+    }
+    for(uint8_t i = 1; i < _num_copies; i++)
+        slot_copy(target, i)->seq = 0;
+    copy = slot_copy(target, 0);
+    copy->seq = 0;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(copy + 1, record, _header->record_size);
+    copy->check = check(copy) ^ 1;
+    __atomic_store_n(&copy->seq, 1, __ATOMIC_RELEASE);
+    target->chat_id = chat_id;
+    if(target->state == STATE_SLOT_EMPTY)
+        _header->used = _header->used + 1;
+    target->state = STATE_SLOT_USED;
+    _header->count = _header->count + 1;
+
+    return true;
+}
+
+// Remove the record of a chat
+bool uTLGBotStateStore::erase(const int64_t chat_id)
+{
+    uint32_t insert_index, mask;
+    int64_t index;
+
+    if(_header == NULL)
+        return false;
+
+    index = find(chat_id, &insert_index);
+    if(index < 0)
+        return false;
+    slot((uint32_t)index)->state = STATE_SLOT_DELETED;
+    _header->count = _header->count - 1;
+
+    // Deleted slots followed by an empty slot don't take part in any lookup, so empty them (this
+    // keeps the used slots low when chats come and go)
+    mask = _header->capacity - 1;
+    while((slot((uint32_t)index)->state == STATE_SLOT_DELETED) &&
+          (slot((uint32_t)((index + 1) & mask))->state == STATE_SLOT_EMPTY))
+    {
+        slot((uint32_t)index)->state = STATE_SLOT_EMPTY;
+        _header->used = _header->used - 1;
+        index = (index - 1) & mask;
+    }
+
+    return true;
+}
+
+// Flush the memory mapped file to storage (records survive a process crash without it, just a
+// power loss needs it, so call it when it fits the application, not for each put())
+bool uTLGBotStateStore::sync()
+{
+    if(_header == NULL)
+        return false;
+#if defined(UTLGBOT_STATE_MMAP)
+    return (msync(_base, _size, MS_SYNC) == 0);
+#else
+    return true;
+#endif
+}
+
+// Get number of stored records
+uint32_t uTLGBotStateStore::count()
+{
+    if(_header == NULL)
+        return 0;
+    return _header->count;
+}
+
+// Get number of slots of the store (records that can be stored are limited to STATE_MAX_LOAD)
+uint32_t uTLGBotStateStore::capacity()
+{
+    if(_header == NULL)
+        return 0;
+    return _header->capacity;
+}
+
+// Get the store key of a received chat ID string (i.e. received_msg.chat.id)
+int64_t uTLGBotStateStore::key(const char* chat_id)
+{
+    return (int64_t)strtoll(chat_id, NULL, 10);
+}
+
+/**************************************************************************************************/
+
+/* Private Methods */
+
+#if defined(UTLGBOT_STATE_MMAP)
+
+// Open or create the store file and map it
+bool uTLGBotStateStore::map(const char* path, const uint16_t record_size, const uint32_t capacity)
+{
+    state_header header;
+    struct stat st;
+    uint32_t slots;
+    bool create;
+
+    _num_copies = 2;
+    _slot_size = sizeof(state_slot) + (_num_copies * _copy_size);
+
+    _fd = ::open(path, O_RDWR | O_CREAT, 0644);
+    if(_fd < 0)
+        return false;
+    if(fstat(_fd, &st) != 0)
+        return false;
+
+    // Get the layout from an existing file or create a new one (file is sparse, all its slots
+    // start empty)
+    create = (st.st_size == 0);
+    if(create)
+    {
+        if(capacity == 0)
+            return false;
+        slots = STATE_MIN_CAPACITY;
+        while((slots < capacity) && (slots < 0x80000000UL))
+            slots = slots << 1;
+        memset(&header, 0, sizeof(state_header));
+        header.magic = STATE_MAGIC;
+        header.version = STATE_VERSION;
+        header.record_size = record_size;
+        header.capacity = slots;
+        header.clean = 1;
+        _size = sizeof(state_header) + ((size_t)slots * _slot_size);
+        if(ftruncate(_fd, (off_t)_size) != 0)
+            return false;
+        if(pwrite(_fd, &header, sizeof(state_header), 0) != (ssize_t)sizeof(state_header))
+            return false;
+    }
+    else
+    {
+        if(pread(_fd, &header, sizeof(state_header), 0) != (ssize_t)sizeof(state_header))
+            return false;
+        if((header.magic != STATE_MAGIC) || (header.version != STATE_VERSION) ||
+           (header.record_size != record_size) || (header.capacity < STATE_MIN_CAPACITY) ||
+           ((header.capacity & (header.capacity - 1)) != 0))
+        {
+            return false;
+        }
+        _size = sizeof(state_header) + ((size_t)header.capacity * _slot_size);
+        if((size_t)st.st_size != _size)
+            return false;
+    }
+
+    _base = (uint8_t*)mmap(NULL, _size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if(_base == MAP_FAILED)
+    {
+        _base = NULL;
+        return false;
+    }
+    _header = (state_header*)_base;
+
+    return true;
+}
+
+// Unmap and close the store file
+void uTLGBotStateStore::unmap()
+{
+    if(_base != NULL)
+        munmap(_base, _size);
+    if(_fd >= 0)
+        ::close(_fd);
+    _fd = -1;
+    _base = NULL;
+    _header = NULL;
+    _size = 0;
+}
+
+#else
+
+// Setup the store in the RAM table (as many slots as requested that fit in it)
+bool uTLGBotStateStore::map(const char* path, const uint16_t record_size, const uint32_t capacity)
+{
+    uint32_t slots, max_slots;
+
+    (void)path;
+    _num_copies = 1;
+    _slot_size = sizeof(state_slot) + (_num_copies * _copy_size);
+
+    max_slots = (uint32_t)((sizeof(_ram) - sizeof(state_header)) / _slot_size);
+    slots = STATE_MIN_CAPACITY;
+    while((slots < capacity) && ((slots << 1) <= max_slots))
+        slots = slots << 1;
+    if(slots > max_slots)
+        return false;
+
+    _base = (uint8_t*)_ram;
+    _size = sizeof(state_header) + ((size_t)slots * _slot_size);
+    memset(_base, 0, _size);
+    _header = (state_header*)_base;
+    _header->magic = STATE_MAGIC;
+    _header->version = STATE_VERSION;
+    _header->record_size = record_size;
+    _header->capacity = slots;
+    _header->clean = 1;
+
+    return true;
+}
+
+// Release the RAM table
+void uTLGBotStateStore::unmap()
+{
+    _base = NULL;
+    _header = NULL;
+    _size = 0;
+}
+
+#endif
+
+// Get a slot by its index
+uTLGBotStateStore::state_slot* uTLGBotStateStore::slot(const uint32_t index)
+{
+    return (state_slot*)(_base + sizeof(state_header) + ((size_t)index * _slot_size));
+}
+
+// Get a record copy of a slot
+uTLGBotStateStore::state_copy* uTLGBotStateStore::slot_copy(state_slot* slot, const uint8_t copy)
+{
+    return (state_copy*)((uint8_t*)(slot + 1) + ((size_t)copy * _copy_size));
+}
+
+// Get the copy of a slot that holds its current record (the one with latest sequence number)
+uTLGBotStateStore::state_copy* uTLGBotStateStore::current_copy(state_slot* slot)
+{
+    state_copy* current = slot_copy(slot, 0);
+    uint32_t current_seq = __atomic_load_n(&current->seq, __ATOMIC_ACQUIRE);
+    state_copy* copy;
+    uint32_t seq;
+
+    for(uint8_t i = 1; i < _num_copies; i++)
+    {
+        copy = slot_copy(slot, i);
+        seq = __atomic_load_n(&copy->seq, __ATOMIC_ACQUIRE);
+        if((seq != 0) && ((current_seq == 0) || ((int32_t)(seq - current_seq) > 0)))
+        {
+            current = copy;
+            current_seq = seq;
+        }
+    }
+    return current;
+}
+
+// Look for the slot of a chat (linear probing), return its index or -1 if it is not found, and
+// the first free slot index where it can be added (UINT32_MAX if the table is full)
+int64_t uTLGBotStateStore::find(const int64_t chat_id, uint32_t* insert_index)
+{
+    uint32_t mask = _header->capacity - 1;
+    uint32_t index = hash(chat_id) & mask;
+    state_slot* s;
+
+    *insert_index = UINT32_MAX;
+    for(uint32_t probe = 0; probe < _header->capacity; probe++)
+    {
+        s = slot(index);
+        if(s->state == STATE_SLOT_EMPTY)
+        {
+            if(*insert_index == UINT32_MAX)
+                *insert_index = index;
+            return -1;
+        }
+        if(s->state == STATE_SLOT_DELETED)
+        {
+            if(*insert_index == UINT32_MAX)
+                *insert_index = index;
+        }
+        else if(s->chat_id == chat_id)
+            return index;
+        index = (index + 1) & mask;
+    }
+    return -1;
+}
+
+// Recover a store that was not closed cleanly: discard records copies that were not completely
+// written, remove slots added without any complete record, and count records and used slots
+void uTLGBotStateStore::recount()
+{
+    state_slot* s;
+    state_copy* copy;
+    bool valid;
+
+    _header->count = 0;
+    _header->used = 0;
+    for(uint32_t i = 0; i < _header->capacity; i++)
+    {
+        s = slot(i);
+        if(s->state == STATE_SLOT_EMPTY)
+            continue;
+        _header->used = _header->used + 1;
+        if(s->state != STATE_SLOT_USED)
+            continue;
+
+        valid = false;
+        for(uint8_t c = 0; c < _num_copies; c++)
+        {
+            copy = slot_copy(s, c);
+            if(copy->seq == 0)
+                continue;
+            if((check(copy) ^ copy->seq) != copy->check)
+                copy->seq = 0;
+            else
+                valid = true;
+        }
+        if(!valid)
+            s->state = STATE_SLOT_DELETED;
+        else
+            _header->count = _header->count + 1;
+    }
+}
+
+// Get the check value of a record copy (FNV-1a of its record)
+uint32_t uTLGBotStateStore::check(const state_copy* copy)
+{
+    return utlgbot_fnv32(copy + 1, _header->record_size);
+}
+
+// Get the slot hash of a chat ID (splitmix64 finalizer, chat IDs are not random at all)
+uint32_t uTLGBotStateStore::hash(const int64_t chat_id)
+{
+    uint64_t h = (uint64_t)chat_id;
+
+    h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    h = (h ^ (h >> 27)) * 0x94D049BB133111EBULL;
+    h = h ^ (h >> 31);
+    return (uint32_t)h;
+}
@@ -0,0 +1,123 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: utlgbotstate.h
+// Description: Per chat state store, an open addressing hash table of fixed size records keyed by
+//              chat ID. Native POSIX builds keep it in a memory mapped file (persistent and crash
+//              safe), microcontrollers and other builds keep it in a bounded static RAM table.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef UTLGBOTSTATE_H_
+#define UTLGBOTSTATE_H_
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stddef.h>
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Memory mapped file store (Native POSIX builds), otherwise a static RAM table is used
+#if !defined(ARDUINO) && !defined(ESP_IDF) && (defined(__linux__) || defined(__APPLE__))
+    #define UTLGBOT_STATE_MMAP
+#endif
+
+// RAM table size (bytes) for builds without memory mapped file store (slots that fit in it are
+// used, so keep records small in microcontrollers builds)
+#ifndef UTLGBOT_STATE_RAM_SIZE
+    #if defined(ARDUINO) || defined(ESP_IDF)
+        #define UTLGBOT_STATE_RAM_SIZE 2048
+    #else
+        #define UTLGBOT_STATE_RAM_SIZE 1048576
+    #endif
+#endif
+
+// Maximum record size (bytes)
+#define STATE_MAX_RECORD_SIZE 4096
+
+// Maximum slots load (used slots per 256), lookups keep short probe sequences below it
+#define STATE_MAX_LOAD 224
+
+/**************************************************************************************************/
+
+class uTLGBotStateStore
+{
+    public:
+        // Public Methods
+        uTLGBotStateStore();
+        ~uTLGBotStateStore();
+        bool open(const char* path, const uint16_t record_size, const uint32_t capacity);
+        void close();
+        bool is_open();
+        const void* get(const int64_t chat_id);
+        bool put(const int64_t chat_id, const void* record);
+        bool erase(const int64_t chat_id);
+        bool sync();
+        uint32_t count();
+        uint32_t capacity();
+        static int64_t key(const char* chat_id);
+
+    private:
+        // Private Data Types
+        typedef struct state_header
+        {
+            uint32_t magic;
+            uint16_t version;
+            uint16_t record_size;
+            uint32_t capacity;
+            uint32_t count;
+            uint32_t used;
+            uint32_t clean;
+            uint8_t reserved[40];
+        } state_header;
+
+        typedef struct state_slot
+        {
+            int64_t chat_id;
+            uint32_t state;
+            uint32_t reserved;
+        } state_slot;
+
+        typedef struct state_copy
+        {
+            uint32_t seq;
+            uint32_t check;
+        } state_copy;
+
+        // Private Attributtes
+        uint8_t* _base;
+        state_header* _header;
+        size_t _size;
+        size_t _slot_size;
+        size_t _copy_size;
+        uint8_t _num_copies;
+#if defined(UTLGBOT_STATE_MMAP)
+        int _fd;
+#else
+        uint64_t _ram[UTLGBOT_STATE_RAM_SIZE/sizeof(uint64_t)];
+#endif
+
+        // Private Methods
+        bool map(const char* path, const uint16_t record_size, const uint32_t capacity);
+        void unmap();
+        state_slot* slot(const uint32_t index);
+        state_copy* slot_copy(state_slot* slot, const uint8_t copy);
+        state_copy* current_copy(state_slot* slot);
+        int64_t find(const int64_t chat_id, uint32_t* insert_index);
+        void recount();
+        uint32_t check(const state_copy* copy);
+        static uint32_t hash(const int64_t chat_id);
+};
+
+/**************************************************************************************************/
+
+#endif
@@ -0,0 +1,55 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: FreeRTOS.h
+// Description: Host FreeRTOS POSIX shim (just the FreeRTOS and ESP-IDF API subset used by the
+//              library, implemented with pthreads) to build and test ESP-IDF code natively.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef FREERTOS_POSIX_FREERTOS_H_
+#define FREERTOS_POSIX_FREERTOS_H_
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <pthread.h>
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Ticks of 1 ms (as ESP-IDF default CONFIG_FREERTOS_HZ=1000)
+#define configTICK_RATE_HZ 1000
+#define portTICK_PERIOD_MS (1000/configTICK_RATE_HZ)
+#define portMAX_DELAY ((TickType_t)0xffffffffUL)
+
+#define pdFALSE ((BaseType_t)0)
+#define pdTRUE ((BaseType_t)1)
+#define pdPASS pdTRUE
+#define pdFAIL pdFALSE
+#define errQUEUE_FULL pdFALSE
+#define errQUEUE_EMPTY pdFALSE
+
+#define pdMS_TO_TICKS(ms) ((TickType_t)(((TickType_t)(ms)*configTICK_RATE_HZ)/1000))
+
+/**************************************************************************************************/
+
+/* Data Types */
+
+// ESP-IDF port types (stack sizes are in bytes)
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+typedef uint8_t StackType_t;
+
+/**************************************************************************************************/
+
+#endif
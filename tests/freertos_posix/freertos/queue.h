@@ -0,0 +1,52 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: queue.h
+// Description: Host FreeRTOS POSIX shim queues (fixed size items copied into a static storage,
+//              blocking send and receive with ticks timeout).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef FREERTOS_POSIX_QUEUE_H_
+#define FREERTOS_POSIX_QUEUE_H_
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "FreeRTOS.h"
+
+/**************************************************************************************************/
+
+/* Data Types */
+
+typedef struct StaticQueue_t
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    uint8_t* storage;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+} StaticQueue_t;
+
+typedef StaticQueue_t* QueueHandle_t;
+
+/**************************************************************************************************/
+
+/* Functions */
+
+QueueHandle_t xQueueCreateStatic(const UBaseType_t length, const UBaseType_t item_size,
+    uint8_t* storage, StaticQueue_t* queue_buffer);
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t wait_ticks);
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t wait_ticks);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+
+/**************************************************************************************************/
+
+#endif
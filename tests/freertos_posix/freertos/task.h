@@ -0,0 +1,55 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: task.h
+// Description: Host FreeRTOS POSIX shim tasks (each task is a detached pthread).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef FREERTOS_POSIX_TASK_H_
+#define FREERTOS_POSIX_TASK_H_
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include "FreeRTOS.h"
+
+/**************************************************************************************************/
+
+/* Constants */
+
+#define tskNO_AFFINITY ((BaseType_t)0x7fffffff)
+
+/**************************************************************************************************/
+
+/* Data Types */
+
+typedef void (*TaskFunction_t)(void* arg);
+
+typedef struct StaticTask_t
+{
+    pthread_t thread;
+    TaskFunction_t function;
+    void* arg;
+} StaticTask_t;
+
+typedef StaticTask_t* TaskHandle_t;
+
+/**************************************************************************************************/
+
+/* Functions */
+
+// Note: Given stack buffer, priority and core are not used (tasks run in a thread with default
+// host stack), so task stack size must be checked on target
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t function, const char* name,
+    const uint32_t stack_depth, void* arg, UBaseType_t priority, StackType_t* stack_buffer,
+    StaticTask_t* task_buffer, const BaseType_t core);
+void vTaskDelay(const TickType_t ticks);
+
+/**************************************************************************************************/
+
+#endif
@@ -0,0 +1,186 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: freertos_posix.cpp
+// Description: Host FreeRTOS POSIX shim (just the FreeRTOS and ESP-IDF API subset used by the
+//              library, implemented with pthreads) to build and test ESP-IDF code natively.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+
+/**************************************************************************************************/
+
+/* Private Functions */
+
+// Get absolute time of a ticks timeout from now (pthread condition wait deadline)
+static void ticks_deadline(const TickType_t ticks, struct timespec* deadline)
+{
+    uint64_t ms = (uint64_t)ticks * portTICK_PERIOD_MS;
+
+    clock_gettime(CLOCK_REALTIME, deadline);
+    deadline->tv_sec = deadline->tv_sec + (time_t)(ms / 1000);
+    deadline->tv_nsec = deadline->tv_nsec + (long)((ms % 1000) * 1000000);
+    if(deadline->tv_nsec >= 1000000000L)
+    {
+        deadline->tv_sec = deadline->tv_sec + 1;
+        deadline->tv_nsec = deadline->tv_nsec - 1000000000L;
+    }
+}
+
+// Wait for a queue condition until the ticks timeout (false on timeout)
+static bool queue_wait(QueueHandle_t queue, pthread_cond_t* cond, const TickType_t wait_ticks,
+    const struct timespec* deadline)
+{
+    if(wait_ticks == 0)
+        return false;
+    if(wait_ticks == portMAX_DELAY)
+        return (pthread_cond_wait(cond, &queue->mutex) == 0);
+    return (pthread_cond_timedwait(cond, &queue->mutex, deadline) != ETIMEDOUT);
+}
+
+// Task thread entry point
+static void* task_thread(void* arg)
+{
+    StaticTask_t* task = (StaticTask_t*)arg;
+
+    task->function(task->arg);
+    return NULL;
+}
+
+/**************************************************************************************************/
+
+/* Queues */
+
+// Create a queue that use the given items storage and queue buffer (no dynamic memory)
+QueueHandle_t xQueueCreateStatic(const UBaseType_t length, const UBaseType_t item_size,
+    uint8_t* storage, StaticQueue_t* queue_buffer)
+{
+    if((length == 0) || (item_size == 0) || (storage == NULL) || (queue_buffer == NULL))
+        return NULL;
+
+    pthread_mutex_init(&queue_buffer->mutex, NULL);
+    pthread_cond_init(&queue_buffer->not_empty, NULL);
+    pthread_cond_init(&queue_buffer->not_full, NULL);
+    queue_buffer->storage = storage;
+    queue_buffer->length = length;
+    queue_buffer->item_size = item_size;
+    queue_buffer->head = 0;
+    queue_buffer->count = 0;
+
+    return queue_buffer;
+}
+
+// Copy an item to the back of the queue (wait for free space up to the given ticks)
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t wait_ticks)
+{
+    struct timespec deadline;
+    UBaseType_t tail;
+
+    if(wait_ticks != portMAX_DELAY)
+        ticks_deadline(wait_ticks, &deadline);
+
+    pthread_mutex_lock(&queue->mutex);
+    while(queue->count == queue->length)
+    {
+        if(!queue_wait(queue, &queue->not_full, wait_ticks, &deadline))
+        {
+            pthread_mutex_unlock(&queue->mutex);
+            return errQUEUE_FULL;
+        }
+    }
+    tail = (queue->head + queue->count) % queue->length;
+    memcpy(queue->storage + (tail * queue->item_size), item, queue->item_size);
+    queue->count = queue->count + 1;
+    pthread_cond_signal(&queue->not_empty);
+    pthread_mutex_unlock(&queue->mutex);
+
+    return pdPASS;
+}
+
+// Copy out and remove the front item of the queue (wait for an item up to the given ticks)
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t wait_ticks)
+{
+    struct timespec deadline;
+
+    if(wait_ticks != portMAX_DELAY)
+        ticks_deadline(wait_ticks, &deadline);
+
+    pthread_mutex_lock(&queue->mutex);
+    while(queue->count == 0)
+    {
+        if(!queue_wait(queue, &queue->not_empty, wait_ticks, &deadline))
+        {
+            pthread_mutex_unlock(&queue->mutex);
+            return errQUEUE_EMPTY;
+        }
+    }
+    memcpy(item, queue->storage + (queue->head * queue->item_size), queue->item_size);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count = queue->count - 1;
+    pthread_cond_signal(&queue->not_full);
+    pthread_mutex_unlock(&queue->mutex);
+
+    return pdPASS;
+}
+
+// Get number of items in the queue
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    UBaseType_t count;
+
+    pthread_mutex_lock(&queue->mutex);
+    count = queue->count;
+    pthread_mutex_unlock(&queue->mutex);
+
+    return count;
+}
+
+/**************************************************************************************************/
+
+/* Tasks */
+
+// Launch a task in a new detached thread
+TaskHandle_t xTaskCreateStaticPinnedToCore(TaskFunction_t function, const char* name,
+    const uint32_t stack_depth, void* arg, UBaseType_t priority, StackType_t* stack_buffer,
+    StaticTask_t* task_buffer, const BaseType_t core)
+{
+    (void)name;
+    (void)stack_depth;
+    (void)priority;
+    (void)stack_buffer;
+    (void)core;
+
+    if((function == NULL) || (task_buffer == NULL))
+        return NULL;
+
+    task_buffer->function = function;
+    task_buffer->arg = arg;
+    if(pthread_create(&task_buffer->thread, NULL, task_thread, task_buffer) != 0)
+        return NULL;
+    pthread_detach(task_buffer->thread);
+
+    return task_buffer;
+}
+
+// Block the calling task for the given ticks
+void vTaskDelay(const TickType_t ticks)
+{
+    struct timespec delay;
+    uint64_t ms = (uint64_t)ticks * portTICK_PERIOD_MS;
+
+    delay.tv_sec = (time_t)(ms / 1000);
+    delay.tv_nsec = (long)((ms % 1000) * 1000000);
+    nanosleep(&delay, NULL);
+}
+
+/**************************************************************************************************/
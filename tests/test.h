@@ -0,0 +1,57 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: test.h
+// Description: Native tests checks (each test is an executable that returns non zero if any
+//              check fails, run by ctest).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Include Guard */
+
+#ifndef TEST_H_
+#define TEST_H_
+
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <stdio.h>
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Port of tests local TLS mock server (tests library connects to it)
+#ifndef UTLGBOT_TEST_PORT
+    #define UTLGBOT_TEST_PORT 18453
+#endif
+
+/**************************************************************************************************/
+
+/* Macros */
+
+// Check a condition, print it and count it as failed if it is false
+#define TEST_CHECK(condition) \
+    do \
+    { \
+        if(!(condition)) \
+        { \
+            fprintf(stderr, "%s:%d: Check failed: %s\n", __FILE__, __LINE__, #condition); \
+            test_failures++; \
+        } \
+    } while(0)
+
+// Test result to return from main
+#define TEST_RESULT() ((test_failures == 0) ? 0 : 1)
+
+/**************************************************************************************************/
+
+/* Global Data */
+
+static unsigned test_failures = 0;
+
+/**************************************************************************************************/
+
+#endif
@@ -0,0 +1,166 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: test_async.cpp
+// Description: Native test of multihttpsclient non-blocking operations against the local TLS mock
+//              server: poll() through TCP connect, TLS handshake, request write and response read,
+//              and the response timeout and connection fail paths.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <string.h>
+
+#include <chrono>
+#include <thread>
+
+#include "test.h"
+#include "bench_tls_server.h"
+#include "utility/multihttpsclient/multihttpsclient.h"
+
+/**************************************************************************************************/
+
+/* Constants */
+
+#define TEST_HOST "localhost"
+#define TEST_URI "/bot123456789:ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghi/sendMessage"
+#define TEST_BODY "{\"chat_id\":111111111,\"text\":\"Hello\"}"
+
+// Request timeout of timeout path and server response delay (longer than the timeout), and
+// server response delay to keep a request in progress
+#define TEST_TIMEOUT 300
+#define TEST_SERVER_DELAY 1500
+#define TEST_SHORT_DELAY 100
+
+// Port without server (connection refused)
+#define TEST_CLOSED_PORT (UTLGBOT_TEST_PORT + 1)
+
+/**************************************************************************************************/
+
+/* Private Functions */
+
+static unsigned long now_ms()
+{
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Drive an operation with poll() until it ends (waiting for the socket between calls), and count
+// the poll() calls that returned in progress
+static int8_t run(MultiHTTPSClient* client, int8_t result, unsigned* num_polls)
+{
+    *num_polls = 0;
+    while(result == ASYNC_IN_PROGRESS)
+    {
+        *num_polls = *num_polls + 1;
+        TEST_CHECK(client->poll_time_left() > 0);
+        http_socket_wait(client->get_socket(), client->poll_wants_write(),
+            client->poll_time_left());
+        result = client->poll();
+    }
+    TEST_CHECK(client->poll_time_left() == 0);
+    return result;
+}
+
+// Wait for the server to count the requests (it counts a request after writing its response, so
+// the client can get the response first)
+static bool wait_requests(uTLGBotBenchServer* server, const uint32_t num_requests)
+{
+    unsigned long t0 = now_ms();
+
+    while(server->num_requests() < num_requests)
+    {
+        if(now_ms() - t0 >= HTTP_WAIT_RESPONSE_TIMEOUT)
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return (server->num_requests() == num_requests);
+}
+
+// Start a sendMessage request
+static int8_t post(MultiHTTPSClient* client, char* buffer, const size_t buffer_size,
+    const unsigned long timeout)
+{
+    snprintf(buffer, buffer_size, "%s", TEST_BODY);
+    return client->post_async(TEST_URI, TEST_HOST, buffer, strlen(buffer), buffer_size, timeout);
+}
+
+/**************************************************************************************************/
+
+/* Main Function */
+
+int main()
+{
+    static uTLGBotBenchServer server;
+    static MultiHTTPSClient client;
+    static char buffer[4096];
+    unsigned num_polls;
+    unsigned long t0, elapsed;
+
+    if(!server.start(UTLGBOT_TEST_PORT))
+    {
+        fprintf(stderr, "Test server can't be started\n");
+        return 1;
+    }
+    client.set_cert(server.cert_pem());
+
+    // Requests need a connection
+    TEST_CHECK(post(&client, buffer, sizeof(buffer), TEST_TIMEOUT) == ASYNC_ERROR);
+
+    // TCP connect and TLS handshake (handshake waits for server flights, so it takes some polls)
+    TEST_CHECK(run(&client, client.connect_async(TEST_HOST, UTLGBOT_TEST_PORT), &num_polls) ==
+        ASYNC_DONE);
+    TEST_CHECK(num_polls > 0);
+    TEST_CHECK(client.is_connected());
+    TEST_CHECK(client.poll() == ASYNC_DONE);
+
+    // Request write and response read, twice through the kept alive connection
+    for(int i = 0; i < 2; i++)
+    {
+        TEST_CHECK(run(&client, post(&client, buffer, sizeof(buffer), HTTP_WAIT_RESPONSE_TIMEOUT),
+            &num_polls) == ASYNC_DONE);
+        TEST_CHECK(strncmp(buffer, "HTTP/1.1 200 OK\r\n", 17) == 0);
+        TEST_CHECK(strstr(buffer, "\"message_id\":4242") != NULL);
+        TEST_CHECK(client.is_connected());
+    }
+    TEST_CHECK(wait_requests(&server, 2));
+
+    // Only one operation at a time (server delays the response, so the first one is in progress)
+    server.set_response_delay(TEST_SHORT_DELAY);
+    TEST_CHECK(post(&client, buffer, sizeof(buffer), HTTP_WAIT_RESPONSE_TIMEOUT) ==
+        ASYNC_IN_PROGRESS);
+    TEST_CHECK(post(&client, buffer, sizeof(buffer), HTTP_WAIT_RESPONSE_TIMEOUT) == ASYNC_ERROR);
+    TEST_CHECK(run(&client, ASYNC_IN_PROGRESS, &num_polls) == ASYNC_DONE);
+    TEST_CHECK(num_polls > 0);
+
+    // Response timeout: the request fails when the timeout expires and the connection is closed
+    server.set_response_delay(TEST_SERVER_DELAY);
+    t0 = now_ms();
+    TEST_CHECK(run(&client, post(&client, buffer, sizeof(buffer), TEST_TIMEOUT), &num_polls) ==
+        ASYNC_ERROR);
+    elapsed = now_ms() - t0;
+    TEST_CHECK((elapsed >= TEST_TIMEOUT) && (elapsed < TEST_SERVER_DELAY));
+    TEST_CHECK(!client.is_connected());
+    server.set_response_delay(0);
+
+    // Connection can be stablished again after a fail
+    TEST_CHECK(run(&client, client.connect_async(TEST_HOST, UTLGBOT_TEST_PORT), &num_polls) ==
+        ASYNC_DONE);
+    TEST_CHECK(run(&client, post(&client, buffer, sizeof(buffer), HTTP_WAIT_RESPONSE_TIMEOUT),
+        &num_polls) == ASYNC_DONE);
+    TEST_CHECK(strstr(buffer, "\"message_id\":4242") != NULL);
+    client.disconnect();
+
+    // Connection refused
+    TEST_CHECK(run(&client, client.connect_async(TEST_HOST, TEST_CLOSED_PORT), &num_polls) ==
+        ASYNC_ERROR);
+    TEST_CHECK(!client.is_connected());
+
+    server.stop();
+    printf("test_async: %s\n", (test_failures == 0) ? "OK" : "FAIL");
+    return TEST_RESULT();
+}
+
+/**************************************************************************************************/
@@ -0,0 +1,164 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: test_coroutines.cpp
+// Description: Native test of uTLGBotAsync C++20 coroutines layer against the local TLS mock
+//              server: flows that await received messages (of any chat or of a specific chat)
+//              and sends (a long text split in several requests included), messages pool slots
+//              release and reuse, and destruction of flows that are still waiting.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <string.h>
+
+#include <chrono>
+#include <string>
+
+#include "test.h"
+#include "bench_tls_server.h"
+#include "utlgbotasync.h"
+
+/**************************************************************************************************/
+
+/* Constants */
+
+#define TEST_TOKEN "123456789:ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghi"
+
+// Message sent in each getUpdates response, and a chat without messages
+#define TEST_MESSAGE "{\"message_id\":77,\"from\":{\"id\":111111111,\"is_bot\":false," \
+    "\"first_name\":\"John\"},\"chat\":{\"id\":111111111,\"first_name\":\"John\"," \
+    "\"type\":\"private\"},\"date\":1700000000,\"text\":\"hello\"}"
+#define TEST_CHAT_ID "111111111"
+#define TEST_SILENT_CHAT_ID "222222222"
+
+// Max time to run the scheduler until flows end (ms)
+#define TEST_RUN_TIMEOUT 10000
+
+/**************************************************************************************************/
+
+/* Data Types */
+
+typedef struct flow_result
+{
+    bool received;
+    bool chat_filtered;
+    bool distinct;
+    bool sent;
+    bool reused;
+    bool long_sent;
+    bool done;
+} flow_result;
+
+/**************************************************************************************************/
+
+/* Private Functions */
+
+static unsigned long now_ms()
+{
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Check a received message
+static bool check_message(const tlg_type_message* msg)
+{
+    return ((msg != NULL) && (msg->update_type == UPDATE_MESSAGE) && (msg->message_id == 77) &&
+        (strcmp(msg->chat.id, TEST_CHAT_ID) == 0) && (strcmp(msg->text, "hello") == 0) &&
+        (strcmp(msg->from.first_name, "John") == 0));
+}
+
+/**************************************************************************************************/
+
+/* Flows */
+
+// Receive messages of any chat and of a specific chat, send replies and release the messages
+static tlg_task receive_flow(uTLGBotAsync& async, flow_result* result, const char* long_text)
+{
+    tlg_type_message* first = co_await async.next_update();
+    tlg_type_message* second = co_await async.next_update(TEST_CHAT_ID);
+    tlg_type_message* third;
+
+    result->received = check_message(first);
+    result->chat_filtered = check_message(second);
+    result->distinct = (first != second);
+    result->sent = co_await async.send(first->chat.id, "reply");
+    async.release(first);
+    async.release(second);
+
+    // Released slots are used for next messages (no other flow is waiting, so no message was
+    // received while sending)
+    third = co_await async.next_update();
+    result->reused = check_message(third) && ((third == first) || (third == second));
+    result->long_sent = co_await async.send(third->chat.id, long_text);
+    async.release(third);
+    result->done = true;
+}
+
+// Wait for a message of a chat without messages (it is still waiting when the test ends)
+static tlg_task silent_flow(uTLGBotAsync& async)
+{
+    tlg_type_message* msg = co_await async.next_update(TEST_SILENT_CHAT_ID);
+
+    async.release(msg);
+}
+
+/**************************************************************************************************/
+
+/* Main Function */
+
+int main()
+{
+    static uTLGBotBenchServer server;
+    flow_result result;
+    std::string long_text;
+    unsigned long t0;
+
+    memset(&result, 0, sizeof(result));
+    for(unsigned i = 0; i < 2000; i++)
+        long_text = long_text + "word ";
+    server.set_updates_message(TEST_MESSAGE);
+    if(!server.start(UTLGBOT_TEST_PORT))
+    {
+        fprintf(stderr, "Test server can't be started\n");
+        return 1;
+    }
+
+    {
+        // Send client takes the Bot certificate when the async layer is created
+        uTLGBot bot(TEST_TOKEN);
+        bot.set_cert((const uint8_t*)server.cert_pem());
+        uTLGBotAsync async(bot);
+
+        // Flows run until their first co_await when they are called
+        receive_flow(async, &result, long_text.c_str());
+        TEST_CHECK(async.num_waiting_flows() == 1);
+
+        t0 = now_ms();
+        while(!result.done && (now_ms() - t0 < TEST_RUN_TIMEOUT))
+            async.run_once();
+
+        TEST_CHECK(result.done);
+        TEST_CHECK(result.received);
+        TEST_CHECK(result.chat_filtered);
+        TEST_CHECK(result.distinct);
+        TEST_CHECK(result.sent);
+        TEST_CHECK(result.reused);
+        TEST_CHECK(result.long_sent);
+
+        // Messages of other chats don't resume the silent flow (its frame is destroyed with the
+        // async layer while it is still waiting)
+        silent_flow(async);
+        for(unsigned i = 0; i < 10; i++)
+            async.run_once(10);
+        TEST_CHECK(async.num_waiting_flows() == 1);
+    }
+
+    server.stop();
+
+    return TEST_RESULT();
+}
+
+/**************************************************************************************************/
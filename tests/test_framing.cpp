@@ -0,0 +1,133 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: test_framing.cpp
+// Description: Native test of HTTP response framing parser, with responses received byte by byte
+//              (Content-Length, chunked transfer encoding with extensions and trailers, and
+//              responses that end when the server closes the connection).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <string.h>
+
+#include "test.h"
+#include "utility/multihttpsclient/multihttpsclient_framing.h"
+
+/**************************************************************************************************/
+
+/* Constants */
+
+#define HEADER_OK "HTTP/1.1 200 OK\r\nServer: nginx\r\nContent-Type: application/json\r\n"
+#define BODY "{\"ok\":true,\"result\":[]}"
+
+// Content-Length framing (field name is case insensitive)
+#define RESPONSE_LENGTH HEADER_OK "Content-Length: 23\r\nConnection: keep-alive\r\n\r\n" BODY
+#define RESPONSE_LENGTH_LOWER HEADER_OK "content-length:23\r\n\r\n" BODY
+#define RESPONSE_LENGTH_EMPTY "HTTP/1.1 204 No Content\r\nContent-Length: 0\r\n\r\n"
+
+// Chunked framing (chunk extensions, upper and lower case hex sizes, and trailer fields)
+#define RESPONSE_CHUNKED HEADER_OK "Transfer-Encoding: chunked\r\n\r\n" \
+    "7\r\n{\"ok\":t\r\n" \
+    "a;name=value\r\nrue,\"resul\r\n" \
+    "6\r\nt\":[]}\r\n" \
+    "0\r\n\r\n"
+#define RESPONSE_CHUNKED_TRAILERS HEADER_OK "transfer-encoding: chunked\r\n\r\n" \
+    "0000F\r\n{\"ok\":true,\"res\r\n" \
+    "8\r\nult\":[]}\r\n" \
+    "0;last\r\nX-Trailer: one\r\nX-Other-Trailer: two\r\n\r\n"
+
+// Response without framing (it ends when the server closes the connection)
+#define RESPONSE_UNTIL_CLOSE "HTTP/1.0 200 OK\r\nConnection: close\r\n\r\n" BODY
+
+// Invalid chunk size
+#define RESPONSE_CHUNKED_INVALID HEADER_OK "Transfer-Encoding: chunked\r\n\r\nzz\r\n" BODY
+
+/**************************************************************************************************/
+
+/* Private Functions */
+
+// Feed a response byte by byte (each update gets the whole response received so far, as read
+// loops do), and get the result of last update and the number of bytes fed until it
+static uint8_t feed(http_response_framing* framing, const char* response, size_t* fed)
+{
+    size_t length = strlen(response);
+    uint8_t result = HTTP_FRAMING_INCOMPLETE;
+
+    framing->reset();
+    *fed = 0;
+    while((*fed < length) && (result == HTTP_FRAMING_INCOMPLETE))
+    {
+        *fed = *fed + 1;
+        result = framing->update(response, *fed);
+    }
+
+    return result;
+}
+
+// Check that a response is complete just when its last byte is received
+static void check_complete(const char* response, const size_t header_length)
+{
+    http_response_framing framing;
+    size_t fed;
+
+    TEST_CHECK(feed(&framing, response, &fed) == HTTP_FRAMING_COMPLETE);
+    TEST_CHECK(fed == strlen(response));
+    TEST_CHECK(framing.header_length() == header_length);
+    TEST_CHECK(!framing.until_close());
+
+    // Same result with the response received at once
+    framing.reset();
+    TEST_CHECK(framing.update(response, strlen(response)) == HTTP_FRAMING_COMPLETE);
+}
+
+// Length of a response header (up to the empty line, included)
+static size_t header_length(const char* response)
+{
+    return (size_t)(strstr(response, "\r\n\r\n") - response) + 4;
+}
+
+/**************************************************************************************************/
+
+/* Main Function */
+
+int main()
+{
+    http_response_framing framing;
+    size_t fed;
+
+    // Content-Length
+    check_complete(RESPONSE_LENGTH, header_length(RESPONSE_LENGTH));
+    check_complete(RESPONSE_LENGTH_LOWER, header_length(RESPONSE_LENGTH_LOWER));
+    check_complete(RESPONSE_LENGTH_EMPTY, strlen(RESPONSE_LENGTH_EMPTY));
+
+    // Chunked (chunk size lines are split across updates when fed byte by byte)
+    check_complete(RESPONSE_CHUNKED, header_length(RESPONSE_CHUNKED));
+    check_complete(RESPONSE_CHUNKED_TRAILERS, header_length(RESPONSE_CHUNKED_TRAILERS));
+
+    // Chunked response split in the middle of a chunk size line and of the last chunk line
+    framing.reset();
+    fed = strstr(RESPONSE_CHUNKED, "a;na") + 1 - RESPONSE_CHUNKED;
+    TEST_CHECK(framing.update(RESPONSE_CHUNKED, fed) == HTTP_FRAMING_INCOMPLETE);
+    fed = strlen(RESPONSE_CHUNKED) - 3;
+    TEST_CHECK(framing.update(RESPONSE_CHUNKED, fed) == HTTP_FRAMING_INCOMPLETE);
+    TEST_CHECK(framing.update(RESPONSE_CHUNKED, strlen(RESPONSE_CHUNKED)) ==
+        HTTP_FRAMING_COMPLETE);
+
+    // Until close: never complete, the read loop ends it when the connection is closed
+    TEST_CHECK(feed(&framing, RESPONSE_UNTIL_CLOSE, &fed) == HTTP_FRAMING_INCOMPLETE);
+    TEST_CHECK(fed == strlen(RESPONSE_UNTIL_CLOSE));
+    TEST_CHECK(framing.until_close());
+    TEST_CHECK(framing.header_length() == header_length(RESPONSE_UNTIL_CLOSE));
+
+    // Invalid chunk size
+    TEST_CHECK(feed(&framing, RESPONSE_CHUNKED_INVALID, &fed) == HTTP_FRAMING_ERROR);
+    TEST_CHECK(fed < strlen(RESPONSE_CHUNKED_INVALID));
+
+    printf("test_framing: %s\n", (test_failures == 0) ? "OK" : "FAIL");
+    return TEST_RESULT();
+}
+
+/**************************************************************************************************/
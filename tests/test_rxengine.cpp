@@ -0,0 +1,106 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: test_rxengine.cpp
+// Description: Native test of ESP-IDF receive engine (built with the FreeRTOS POSIX shim) against
+//              the local TLS mock server: pool slots flow, pool full backpressure and receive
+//              timeout.
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <string.h>
+
+#include <chrono>
+#include <thread>
+
+#include "test.h"
+#include "bench_tls_server.h"
+#include "utlgbotrxengine.h"
+
+/**************************************************************************************************/
+
+/* Constants */
+
+#define TEST_TOKEN "123456789:ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghi"
+
+// Message sent in each getUpdates response
+#define TEST_MESSAGE "{\"message_id\":77,\"from\":{\"id\":111111111,\"is_bot\":false," \
+    "\"first_name\":\"John\"},\"chat\":{\"id\":111111111,\"first_name\":\"John\"," \
+    "\"type\":\"private\"},\"date\":1700000000,\"text\":\"hello\"}"
+
+// Max time to wait for a received message (ticks) and time to check that no more requests are
+// sent while the pool is full (ms)
+#define TEST_RECEIVE_TIMEOUT (5000/portTICK_PERIOD_MS)
+#define TEST_IDLE_TIME 300
+
+/**************************************************************************************************/
+
+/* Global Data */
+
+// Engine holds the messages pool and task stack, so it is a static object (as in ESP-IDF)
+static uTLGBotRxEngine RxEngine(TEST_TOKEN);
+
+/**************************************************************************************************/
+
+/* Main Function */
+
+int main()
+{
+    static uTLGBotBenchServer server;
+    tlg_type_message* msg[3];
+
+    server.set_updates_message(TEST_MESSAGE);
+    if(!server.start(UTLGBOT_TEST_PORT))
+    {
+        fprintf(stderr, "Test server can't be started\n");
+        return 1;
+    }
+
+    // Nothing received before start
+    TEST_CHECK(RxEngine.receive(0) == NULL);
+    TEST_CHECK(RxEngine.num_pending() == 0);
+
+    RxEngine.set_cert((const uint8_t*)server.cert_pem());
+    TEST_CHECK(RxEngine.start());
+
+    // Each pool slot is filled with a parsed message and passed once
+    msg[0] = RxEngine.receive(TEST_RECEIVE_TIMEOUT);
+    msg[1] = RxEngine.receive(TEST_RECEIVE_TIMEOUT);
+    TEST_CHECK((msg[0] != NULL) && (msg[1] != NULL) && (msg[0] != msg[1]));
+    for(int i = 0; i < 2; i++)
+    {
+        if(msg[i] == NULL)
+            continue;
+        TEST_CHECK(msg[i]->update_type == UPDATE_MESSAGE);
+        TEST_CHECK(msg[i]->message_id == 77);
+        TEST_CHECK(strcmp(msg[i]->chat.id, "111111111") == 0);
+        TEST_CHECK(strcmp(msg[i]->text, "hello") == 0);
+    }
+    TEST_CHECK(RxEngine.get_updates_offset() == BENCH_SERVER_FIRST_UPDATE_ID + 2);
+
+    // Pool full: no more requests to the server and receive times out
+    std::this_thread::sleep_for(std::chrono::milliseconds(TEST_IDLE_TIME));
+    TEST_CHECK(server.num_requests() == 2);
+    TEST_CHECK(RxEngine.receive(TEST_IDLE_TIME/portTICK_PERIOD_MS) == NULL);
+    TEST_CHECK(RxEngine.num_pending() == 0);
+
+    // A released slot is used again for next message (foreign pointers are ignored)
+    RxEngine.release(NULL);
+    if(msg[0] != NULL)
+        RxEngine.release(msg[0]);
+    msg[2] = RxEngine.receive(TEST_RECEIVE_TIMEOUT);
+    TEST_CHECK((msg[2] != NULL) && (msg[2] == msg[0]));
+    std::this_thread::sleep_for(std::chrono::milliseconds(TEST_IDLE_TIME));
+    TEST_CHECK(server.num_requests() == 3);
+    TEST_CHECK(RxEngine.get_updates_offset() == BENCH_SERVER_FIRST_UPDATE_ID + 3);
+
+    // Note: Receiver task is left waiting for a free slot (it has no stop)
+    server.stop();
+    printf("test_rxengine: %s\n", (test_failures == 0) ? "OK" : "FAIL");
+    return TEST_RESULT();
+}
+
+/**************************************************************************************************/
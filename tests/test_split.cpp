@@ -0,0 +1,278 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: test_split.cpp
+// Description: Native test of long texts splitter (plain and already JSON escaped texts, HTML and
+//              Markdown entities kept balanced between parts, Markdown links and pre blocks, and
+//              UTF-16 code units limit with characters out of the Basic Multilingual Plane).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "test.h"
+#include "utlgbotsplit.h"
+
+/**************************************************************************************************/
+
+/* Constants */
+
+// Part buffer size (bigger than any part, so parts are limited just by max_bytes)
+#define PART_BUFFER_SIZE 32768
+
+// Emoji out of the Basic Multilingual Plane (4 UTF-8 bytes, 2 UTF-16 code units)
+#define EMOJI "\xF0\x9F\x98\x80"
+
+/**************************************************************************************************/
+
+/* Private Functions */
+
+// Split a text and get all its parts as written in a request body
+static std::vector<std::string> split(const char* text, const char* parse_mode,
+    const size_t max_bytes, const uint16_t max_units=SPLIT_MAX_UNITS, const bool escaped=false)
+{
+    static char buffer[PART_BUFFER_SIZE];
+    uTLGBotTextSplitter splitter(text, parse_mode, escaped);
+    std::vector<std::string> parts;
+
+    while(splitter.next(max_bytes, max_units))
+    {
+        uTLGBotBodyWriter writer(buffer, sizeof(buffer));
+        TEST_CHECK(splitter.write(&writer));
+        TEST_CHECK(writer.length() <= max_bytes);
+        parts.push_back(std::string(writer.get(), writer.length()));
+        if(parts.size() > 100)
+            break;
+    }
+    TEST_CHECK(splitter.done());
+    TEST_CHECK(splitter.num_parts() == parts.size());
+
+    return parts;
+}
+
+// Get the number of UTF-16 code units of an UTF-8 string
+static size_t units(const std::string& str)
+{
+    size_t units = 0;
+
+    for(size_t i = 0; i < str.length(); i++)
+    {
+        uint8_t c = (uint8_t)str[i];
+        if((c & 0xC0) == 0x80)
+            continue;
+        units = units + ((c >= 0xF0) ? 2 : 1);
+    }
+    return units;
+}
+
+// Join split parts
+static std::string join(const std::vector<std::string>& parts)
+{
+    std::string text;
+
+    for(size_t i = 0; i < parts.size(); i++)
+        text = text + parts[i];
+    return text;
+}
+
+/**************************************************************************************************/
+
+/* Tests */
+
+// Plain texts (a short text is a single part, and long ones are cut at line or word ends)
+static void test_plain(void)
+{
+    std::vector<std::string> parts;
+    std::string text;
+
+    parts = split("", "", 4096);
+    TEST_CHECK((parts.size() == 1) && (parts[0] == ""));
+    parts = split("Hello \"world\"", "", 4096);
+    TEST_CHECK((parts.size() == 1) && (parts[0] == "Hello \\\"world\\\""));
+
+    for(unsigned i = 0; i < 2000; i++)
+        text = text + "word ";
+    parts = split(text.c_str(), "", 8192);
+    TEST_CHECK(parts.size() == 3);
+    TEST_CHECK(join(parts) == text);
+    for(size_t i = 0; i < parts.size(); i++)
+    {
+        TEST_CHECK(units(parts[i]) <= SPLIT_MAX_UNITS);
+        if(i + 1 < parts.size())
+            TEST_CHECK(parts[i][parts[i].length()-1] == ' ');
+    }
+
+    // Line end in second half of the part is preferred to a later word end
+    text = std::string(60, 'a') + "\n" + std::string(20, 'b') + " " + std::string(40, 'c');
+    parts = split(text.c_str(), "", 1024, 100);
+    TEST_CHECK(parts.size() == 2);
+    TEST_CHECK(parts[0] == std::string(60, 'a') + "\\n");
+
+    // Bytes limit with escaped characters
+    text = "";
+    for(unsigned i = 0; i < 50; i++)
+        text = text + "\"quoted\" ";
+    parts = split(text.c_str(), "", 64);
+    TEST_CHECK(parts.size() > 1);
+}
+
+// Backslashes of application texts are escaped, while already escaped texts (received texts) are
+// written as they are, with its escape sequences as single characters
+static void test_escaped(void)
+{
+    std::vector<std::string> parts;
+    std::string text;
+
+    parts = split("C:\\new \\u0041", "", 4096);
+    TEST_CHECK((parts.size() == 1) && (parts[0] == "C:\\\\new \\\\u0041"));
+    parts = split("C:\\new \\u0041 \"", "", 4096, SPLIT_MAX_UNITS, true);
+    TEST_CHECK((parts.size() == 1) && (parts[0] == "C:\\new \\u0041 \\\""));
+
+    // Escaped line end is a line end, and escape sequences are never cut
+    text = std::string(60, 'a') + "\\n" + std::string(20, 'b') + " " + std::string(40, 'c');
+    parts = split(text.c_str(), "", 1024, 100, true);
+    TEST_CHECK(parts.size() == 2);
+    TEST_CHECK(parts[0] == std::string(60, 'a') + "\\n");
+    TEST_CHECK(join(parts) == text);
+    text = std::string(99, 'a') + "\\ud83d\\ude00";
+    parts = split(text.c_str(), "", 1024, 100, true);
+    TEST_CHECK(parts.size() == 2);
+    TEST_CHECK(parts[1] == "\\ud83d\\ude00");
+
+    // Markdown escape of an escaped text (a JSON escaped backslash) is a single character
+    text = "*" + std::string(99, 'a') + "\\\\*b*";
+    parts = split(text.c_str(), "Markdown", 1024, 100, true);
+    TEST_CHECK(parts.size() == 2);
+    TEST_CHECK(parts[0] == "*" + std::string(99, 'a') + "\\\\**");
+    TEST_CHECK(parts[1] == "*b*");
+}
+
+// HTML entities are closed at the end of a part and reopened at the start of next one (tags and
+// character references are never cut)
+static void test_html(void)
+{
+    std::vector<std::string> parts;
+    std::string text;
+
+    text = "<b>" + std::string(150, 'a') + " <a href=\"http://x.y\">link</a></b> &amp; end";
+    parts = split(text.c_str(), "HTML", 120, 100);
+    TEST_CHECK(parts.size() == 2);
+    TEST_CHECK(parts[0] == "<b>" + std::string(100, 'a') + "</b>");
+    TEST_CHECK(parts[1].compare(0, 3 + 50, "<b>" + std::string(50, 'a')) == 0);
+
+    text = std::string(98, 'a') + "&amp;b";
+    parts = split(text.c_str(), "HTML", 100);
+    TEST_CHECK(parts.size() == 2);
+    TEST_CHECK(parts[0] == std::string(98, 'a'));
+    TEST_CHECK(parts[1] == "&amp;b");
+}
+
+// Markdown entities are closed and reopened, and links are not cut unless a link is bigger than a
+// part (then it is closed with its URL and reopened)
+static void test_markdown(void)
+{
+    std::vector<std::string> parts;
+    std::string text;
+
+    text = "*" + std::string(150, 'a') + "*";
+    parts = split(text.c_str(), "Markdown", 1024, 100);
+    TEST_CHECK(parts.size() == 2);
+    TEST_CHECK(parts[0] == "*" + std::string(100, 'a') + "*");
+    TEST_CHECK(parts[1] == "*" + std::string(50, 'a') + "*");
+
+    // Link that doesn't fit in the rest of the part goes to next part
+    text = std::string(80, 'a') + " [" + std::string(30, 'b') + "](http://x.y/_a_)";
+    parts = split(text.c_str(), "Markdown", 1024, 100);
+    TEST_CHECK(parts.size() == 2);
+    TEST_CHECK(parts[0] == std::string(80, 'a') + " ");
+    TEST_CHECK(parts[1] == "[" + std::string(30, 'b') + "](http://x.y/_a_)");
+
+    // Link bigger than a part
+    text = "[" + std::string(150, 'b') + "](http://x.y/_a_) end";
+    parts = split(text.c_str(), "Markdown", 1024, 100);
+    TEST_CHECK(parts.size() == 2);
+    TEST_CHECK(parts[0] == "[" + std::string(100, 'b') + "](http://x.y/_a_)");
+    TEST_CHECK(parts[1] == "[" + std::string(50, 'b') + "](http://x.y/_a_) end");
+
+    // Link bigger than a part with formatting inside its text (MarkdownV2)
+    text = "[*" + std::string(150, 'b') + "*](http://x.y)";
+    parts = split(text.c_str(), "MarkdownV2", 1024, 100);
+    TEST_CHECK(parts.size() == 2);
+    TEST_CHECK(parts[0] == "[*" + std::string(100, 'b') + "*](http://x.y)");
+    TEST_CHECK(parts[1] == "[*" + std::string(50, 'b') + "*](http://x.y)");
+
+    // Not a link
+    text = "[" + std::string(150, 'b');
+    parts = split(text.c_str(), "Markdown", 1024, 100);
+    TEST_CHECK(parts.size() == 2);
+    TEST_CHECK(join(parts) == text);
+}
+
+// Pre blocks are reopened with their language, and markers inside them are not entities
+static void test_pre(void)
+{
+    std::vector<std::string> parts;
+    std::string text, code;
+
+    for(unsigned i = 0; i < 20; i++)
+        code = code + "x = *y_\n";
+    text = "```python\n" + code + "```";
+    parts = split(text.c_str(), "Markdown", 1024, 100);
+    TEST_CHECK(parts.size() == 2);
+    TEST_CHECK(parts[0].compare(0, 11, "```python\\n") == 0);
+    TEST_CHECK(parts[0].compare(parts[0].length() - 5, 5, "\\n```") == 0);
+    TEST_CHECK(parts[1].compare(0, 11, "```python\\n") == 0);
+    TEST_CHECK(parts[1].compare(parts[1].length() - 5, 5, "\\n```") == 0);
+}
+
+// UTF-16 code units limit (characters out of the BMP are two units, and are never cut)
+static void test_utf16(void)
+{
+    std::vector<std::string> parts;
+    std::string text;
+
+    text = std::string(SPLIT_MAX_UNITS - 2, 'a') + EMOJI;
+    parts = split(text.c_str(), "", 8192);
+    TEST_CHECK((parts.size() == 1) && (parts[0] == text));
+
+    text = std::string(SPLIT_MAX_UNITS - 1, 'a') + EMOJI;
+    parts = split(text.c_str(), "", 8192);
+    TEST_CHECK(parts.size() == 2);
+    TEST_CHECK(parts[0] == std::string(SPLIT_MAX_UNITS - 1, 'a'));
+    TEST_CHECK(parts[1] == EMOJI);
+
+    // Characters of the BMP are a single unit (three UTF-8 bytes)
+    text = "";
+    for(unsigned i = 0; i < SPLIT_MAX_UNITS; i++)
+        text = text + "\xE2\x82\xAC";
+    parts = split(text.c_str(), "", 16384);
+    TEST_CHECK((parts.size() == 1) && (parts[0] == text));
+    text = text + EMOJI;
+    parts = split(text.c_str(), "", 16384);
+    TEST_CHECK(parts.size() == 2);
+    TEST_CHECK(parts[1] == EMOJI);
+}
+
+/**************************************************************************************************/
+
+/* Main Function */
+
+int main(void)
+{
+    test_plain();
+    test_escaped();
+    test_html();
+    test_markdown();
+    test_pre();
+    test_utf16();
+
+    return TEST_RESULT();
+}
+
+/**************************************************************************************************/
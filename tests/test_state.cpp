@@ -0,0 +1,177 @@
+/**************************************************************************************************/
+// Project: uTLGBotLib
+// File: test_state.cpp
+// Description: Native test of per chat state store memory mapped file: records survive reopening
+//              the store, and a store that was not closed cleanly with a torn record write is
+//              recovered with the previous copy of the record (or without the record if it was
+//              being added).
+// Created on: 17 oct. 2026
+// Last modified date: 17 oct. 2026
+// Version: 1.0.0
+/**************************************************************************************************/
+
+/* Libraries */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "test.h"
+#include "utlgbotstate.h"
+
+/**************************************************************************************************/
+
+/* Constants */
+
+#define TEST_CHAT_ID 111111111
+#define TEST_NEW_CHAT_ID 222222222
+#define TEST_CAPACITY 16
+
+// File header "clean" field offset (magic, version, record_size, capacity, count and used before)
+#define HEADER_CLEAN_OFFSET 20
+
+/**************************************************************************************************/
+
+/* Data Types */
+
+typedef struct test_record
+{
+    uint32_t step;
+    char name[28];
+} test_record;
+
+/**************************************************************************************************/
+
+/* Private Functions */
+
+// Create a record with a name that can be found in the store file
+static test_record record(const uint32_t step, const char* name)
+{
+    test_record r;
+
+    memset(&r, 0, sizeof(r));
+    r.step = step;
+    snprintf(r.name, sizeof(r.name), "%s", name);
+    return r;
+}
+
+// Read the whole store file
+static std::vector<char> read_file(const char* path)
+{
+    std::vector<char> data;
+    FILE* file = fopen(path, "rb");
+    char chunk[4096];
+    size_t n;
+
+    if(file == NULL)
+        return data;
+    while((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        data.insert(data.end(), chunk, chunk + n);
+    fclose(file);
+    return data;
+}
+
+// Write the whole store file
+static void write_file(const char* path, const std::vector<char>& data)
+{
+    FILE* file = fopen(path, "wb");
+
+    if(file == NULL)
+        return;
+    fwrite(data.data(), 1, data.size(), file);
+    fclose(file);
+}
+
+// Simulate a crash while a record was written: the store is marked as not closed cleanly, and the
+// record copy that holds the given name gets a byte that was not written
+static bool tear_record(const char* path, const char* name)
+{
+    std::vector<char> data = read_file(path);
+    std::string content(data.begin(), data.end());
+    size_t pos = content.find(name);
+
+    if((pos == std::string::npos) || (data.size() < HEADER_CLEAN_OFFSET + 4))
+        return false;
+    data[pos] = 0;
+    memset(&data[HEADER_CLEAN_OFFSET], 0, 4);
+    write_file(path, data);
+    return true;
+}
+
+/**************************************************************************************************/
+
+/* Tests */
+
+// Records survive closing and reopening the store
+static void test_reopen(const char* path)
+{
+    uTLGBotStateStore store;
+    test_record r = record(1, "first");
+    const test_record* got;
+
+    TEST_CHECK(store.open(path, sizeof(test_record), TEST_CAPACITY));
+    TEST_CHECK(store.put(TEST_CHAT_ID, &r));
+    r = record(2, "second");
+    TEST_CHECK(store.put(TEST_CHAT_ID, &r));
+    store.close();
+
+    TEST_CHECK(store.open(path, sizeof(test_record), 0));
+    got = (const test_record*)store.get(TEST_CHAT_ID);
+    TEST_CHECK((got != NULL) && (got->step == 2) && (strcmp(got->name, "second") == 0));
+    TEST_CHECK(store.count() == 1);
+    store.close();
+}
+
+// A torn update keeps the previous record, and a torn add removes the record
+static void test_torn_write(const char* path)
+{
+    uTLGBotStateStore store;
+    test_record r = record(3, "torn-update");
+    const test_record* got;
+
+    TEST_CHECK(store.open(path, sizeof(test_record), 0));
+    TEST_CHECK(store.put(TEST_CHAT_ID, &r));
+    r = record(1, "torn-add");
+    TEST_CHECK(store.put(TEST_NEW_CHAT_ID, &r));
+    TEST_CHECK(store.count() == 2);
+    store.close();
+
+    TEST_CHECK(tear_record(path, "torn-update"));
+    TEST_CHECK(tear_record(path, "torn-add"));
+    TEST_CHECK(store.open(path, sizeof(test_record), 0));
+    got = (const test_record*)store.get(TEST_CHAT_ID);
+    TEST_CHECK((got != NULL) && (got->step == 2) && (strcmp(got->name, "second") == 0));
+    TEST_CHECK(store.get(TEST_NEW_CHAT_ID) == NULL);
+    TEST_CHECK(store.count() == 1);
+
+    // Recovered record is updated as usual
+    r = record(4, "after");
+    TEST_CHECK(store.put(TEST_CHAT_ID, &r));
+    got = (const test_record*)store.get(TEST_CHAT_ID);
+    TEST_CHECK((got != NULL) && (got->step == 4) && (strcmp(got->name, "after") == 0));
+    store.close();
+}
+
+/**************************************************************************************************/
+
+/* Main Function */
+
+int main(void)
+{
+    char path[64];
+
+    snprintf(path, sizeof(path), "/tmp/utlgbot_test_state_%d.bin", (int)getpid());
+    unlink(path);
+
+    test_reopen(path);
+    test_torn_write(path);
+
+    unlink(path);
+
+    return TEST_RESULT();
+}
+
+/**************************************************************************************************/